@@ -142,6 +142,50 @@ inline T fromBigEndian( _In const& _bytes ) {
     return ret;
 }
 
+/// Variant of fromBigEndian for fixed-width numbers such as u160 and u256, which assembles
+/// whole limbs instead of shifting the number for every byte.
+/// @a _bytes must not be longer than the number.
+template < class T >
+inline T fromBigEndianLimbs( bytesConstRef _bytes ) {
+    using Limb = boost::multiprecision::limb_type;
+    size_t const count = ( _bytes.size() + sizeof( Limb ) - 1 ) / sizeof( Limb );
+    T ret = 0;
+    if ( !count )
+        return ret;
+    auto& backend = ret.backend();
+    backend.resize( count, count );
+    _byte_ const* end = _bytes.data() + _bytes.size();
+    for ( size_t i = 0; i < count; ++i ) {
+        _byte_ const* begin = end - std::min< size_t >( sizeof( Limb ), end - _bytes.data() );
+        Limb limb = 0;
+        for ( _byte_ const* b = begin; b != end; ++b )
+            limb = ( limb << 8 ) | *b;
+        backend.limbs()[i] = limb;
+        end = begin;
+    }
+    backend.normalize();
+    return ret;
+}
+
+/// Variant of toBigEndian for fixed-width numbers such as u160 and u256, which writes whole limbs
+/// without leading zero bytes to @a o_out.
+/// @returns number of bytes written, none for zero.
+template < class T >
+inline size_t toBigEndianLimbs( T const& _val, _byte_* o_out ) {
+    using Limb = boost::multiprecision::limb_type;
+    auto const& backend = _val.backend();
+    _byte_* out = o_out;
+    for ( size_t i = backend.size(); i-- > 0; ) {
+        Limb const limb = backend.limbs()[i];
+        for ( int shift = ( sizeof( Limb ) - 1 ) * 8; shift >= 0; shift -= 8 ) {
+            _byte_ const b = _byte_( limb >> shift );
+            if ( b || out != o_out )
+                *out++ = b;
+        }
+    }
+    return out - o_out;
+}
+
 /// Convenience functions for toBigEndian
 inline std::string toBigEndianString( u256 _val ) {
     std::string ret( 32, '\0' );
@@ -0,0 +1,539 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file DeltaLogDB.cpp
+ * @date 2020
+ */
+
+#include "DeltaLogDB.h"
+
+#include "Log.h"
+
+#include <boost/crc.hpp>
+
+#include <secp256k1_sha256.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+
+namespace dev {
+namespace db {
+
+namespace {
+// record is a header of payload size, checksum and sequence number followed by payload
+size_t const c_headerSize = 16;
+
+enum Operation : char { Kill = 0, Insert = 1 };
+
+void putNumber( std::string& _out, uint64_t _value, size_t _bytes ) {
+    for ( size_t i = 0; i < _bytes; ++i )
+        _out.push_back( static_cast< char >( _value >> ( 8 * i ) ) );
+}
+
+uint64_t getNumber( char const* _in, size_t _bytes ) {
+    uint64_t ret = 0;
+    for ( size_t i = 0; i < _bytes; ++i )
+        ret |= uint64_t( static_cast< unsigned char >( _in[i] ) ) << ( 8 * i );
+    return ret;
+}
+
+uint32_t checksum( uint64_t _sequence, Slice _payload ) {
+    boost::crc_32_type crc;
+    std::string sequence;
+    putNumber( sequence, _sequence, 8 );
+    crc.process_bytes( sequence.data(), sequence.size() );
+    crc.process_bytes( _payload.data(), _payload.size() );
+    return crc.checksum();
+}
+
+void throwIOError( char const* _operation, boost::filesystem::path const& _path ) {
+    BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_dbStatusCode( DatabaseStatus::IOError )
+                                           << errinfo_dbStatusString( std::string( _operation ) +
+                                                                      ": " + strerror( errno ) )
+                                           << errinfo_path( _path.string() ) );
+}
+}  // namespace
+
+class DeltaLogDB::Batch : public WriteBatchFace {
+public:
+    void insert( Slice _key, Slice _value ) override {
+        ops[_key.toString()] = _value.toString();
+    }
+    void kill( Slice _key ) override { ops[_key.toString()] = boost::none; }
+
+    void encode( std::string& _out ) const {
+        for ( auto const& op : ops ) {
+            _out.push_back( op.second ? Insert : Kill );
+            putNumber( _out, op.first.size(), 4 );
+            _out += op.first;
+            if ( op.second ) {
+                putNumber( _out, op.second->size(), 4 );
+                _out += *op.second;
+            }
+        }
+    }
+
+    // @returns false if the payload is malformed
+    bool decode( Slice _payload ) {
+        char const* in = _payload.data();
+        char const* const end = in + _payload.size();
+        auto const readString = [&]( std::string& _value ) {
+            if ( end - in < 4 )
+                return false;
+            size_t const size = getNumber( in, 4 );
+            in += 4;
+            if ( size_t( end - in ) < size )
+                return false;
+            _value.assign( in, size );
+            in += size;
+            return true;
+        };
+        while ( in != end ) {
+            char const operation = *in++;
+            std::string key;
+            if ( !readString( key ) )
+                return false;
+            if ( operation == Kill )
+                ops[key] = boost::none;
+            else if ( operation == Insert ) {
+                std::string value;
+                if ( !readString( value ) )
+                    return false;
+                ops[key] = std::move( value );
+            } else
+                return false;
+        }
+        return true;
+    }
+
+    // last operation on each key, boost::none for kill
+    std::map< std::string, boost::optional< std::string > > ops;
+};
+
+class DeltaLogDB::Snapshot : public DatabaseFace {
+public:
+    Snapshot( std::unique_ptr< DatabaseFace > _backend, Pending _pending )
+        : m_backend( std::move( _backend ) ), m_pending( std::move( _pending ) ) {}
+
+    std::string lookup( Slice _key ) const override {
+        if ( auto value = find( m_pending, _key ) )
+            return value->value_or( std::string() );
+        return m_backend->lookup( _key );
+    }
+    bool exists( Slice _key ) const override {
+        if ( auto value = find( m_pending, _key ) )
+            return value->is_initialized();
+        return m_backend->exists( _key );
+    }
+    void insert( Slice, Slice ) override { throwReadOnly(); }
+    void kill( Slice ) override { throwReadOnly(); }
+
+    std::unique_ptr< WriteBatchFace > createWriteBatch() const override {
+        return std::unique_ptr< WriteBatchFace >( new Batch() );
+    }
+    void commit( std::unique_ptr< WriteBatchFace > ) override { throwReadOnly(); }
+
+    void forEach( std::function< bool( Slice, Slice ) > f ) const override {
+        forEachInRange( Slice(), Slice(), f );
+    }
+    void forEachInRange(
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const override {
+        DeltaLogDB::forEachInRange( m_pending, *m_backend, _begin, _end, f );
+    }
+
+    h256 hashBase() const override {
+        if ( m_pending.empty() )
+            return m_backend->hashBase();
+        // same as LevelDB::hashBase
+        secp256k1_sha256_t ctx;
+        secp256k1_sha256_initialize( &ctx );
+        forEach( [&]( Slice _key, Slice _value ) {
+            secp256k1_sha256_write(
+                &ctx, reinterpret_cast< uint8_t const* >( _key.data() ), _key.size() );
+            secp256k1_sha256_write(
+                &ctx, reinterpret_cast< uint8_t const* >( _value.data() ), _value.size() );
+            return true;
+        } );
+        h256 hash;
+        secp256k1_sha256_finalize( &ctx, hash.data() );
+        return hash;
+    }
+
+    std::unique_ptr< DatabaseFace > snapshot() const override {
+        return std::unique_ptr< DatabaseFace >( new Snapshot( m_backend->snapshot(), m_pending ) );
+    }
+
+private:
+    static void throwReadOnly() {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "Cannot write to snapshot" ) );
+    }
+
+    std::unique_ptr< DatabaseFace > m_backend;
+    Pending const m_pending;
+};
+
+DeltaLogDB::DeltaLogDB(
+    std::unique_ptr< DatabaseFace > _backend, boost::filesystem::path const& _logPath )
+    : m_backend( std::move( _backend ) ), m_logPath( _logPath ) {
+    m_logFd = ::open( m_logPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+    if ( m_logFd < 0 )
+        throwIOError( "open", m_logPath );
+    try {
+        replay();
+    } catch ( ... ) {
+        ::close( m_logFd );
+        throw;
+    }
+    m_applier = std::thread( [this]() { applyPending(); } );
+}
+
+DeltaLogDB::~DeltaLogDB() {
+    {
+        std::unique_lock< std::shared_mutex > lock( m_pendingMutex );
+        m_stopping = true;
+    }
+    m_pendingChanged.notify_all();
+    m_applier.join();
+    try {
+        checkpoint();
+    } catch ( ... ) {
+        cwarn << "Delta log is kept for replay: "
+              << boost::current_exception_diagnostic_information();
+    }
+    ::close( m_logFd );
+}
+
+void DeltaLogDB::replay() {
+    struct stat st;
+    if ( ::fstat( m_logFd, &st ) != 0 )
+        throwIOError( "fstat", m_logPath );
+    std::string log( st.st_size, '\0' );
+    for ( size_t done = 0; done < log.size(); ) {
+        ssize_t const n = ::pread( m_logFd, &log[done], log.size() - done, done );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 )
+            throwIOError( "read", m_logPath );
+        if ( n == 0 ) {
+            log.resize( done );
+            break;
+        }
+        done += n;
+    }
+
+    size_t position = 0;
+    while ( log.size() - position >= c_headerSize ) {
+        char const* header = log.data() + position;
+        size_t const size = getNumber( header, 4 );
+        uint32_t const crc = getNumber( header + 4, 4 );
+        uint64_t const sequence = getNumber( header + 8, 8 );
+        if ( log.size() - position - c_headerSize < size )
+            break;
+        Slice const payload( header + c_headerSize, size );
+        // the tail may be torn by a crash, or left over from before truncation
+        if ( checksum( sequence, payload ) != crc || ( m_replayed && sequence != m_sequence ) )
+            break;
+        Batch batch;
+        if ( !batch.decode( payload ) )
+            break;
+        apply( batch );
+        m_sequence = sequence + 1;
+        ++m_replayed;
+        position += c_headerSize + size;
+    }
+    if ( position != log.size() )
+        cwarn << "Ignoring " << log.size() - position << " bytes at the end of " << m_logPath;
+    if ( m_replayed )
+        cnote << "Replayed " << m_replayed << " batches from " << m_logPath;
+
+    m_logSize = log.size();
+    checkpoint();
+}
+
+void DeltaLogDB::append( Batch const& _batch ) {
+    std::string record;
+    record.reserve( 4096 );
+    record.resize( c_headerSize );
+    _batch.encode( record );
+    Slice const payload( record.data() + c_headerSize, record.size() - c_headerSize );
+    std::string header;
+    putNumber( header, payload.size(), 4 );
+    putNumber( header, checksum( m_sequence, payload ), 4 );
+    putNumber( header, m_sequence, 8 );
+    record.replace( 0, c_headerSize, header );
+
+    for ( size_t done = 0; done < record.size(); ) {
+        ssize_t const n = ::write( m_logFd, record.data() + done, record.size() - done );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 ) {
+            int const error = errno;
+            // do not leave a partial record for the next one to be appended after
+            if ( ::ftruncate( m_logFd, m_logSize ) != 0 )
+                cwarn << "Cannot truncate " << m_logPath << ": " << strerror( errno );
+            errno = error;
+            throwIOError( "write", m_logPath );
+        }
+        done += n;
+    }
+    m_logSize += record.size();
+    m_appended += record.size();
+    ++m_sequence;
+}
+
+void DeltaLogDB::checkpoint() {
+    std::lock_guard< std::mutex > lock( m_logMutex );
+    {
+        std::unique_lock< std::shared_mutex > pendingLock( m_pendingMutex );
+        m_pendingChanged.wait(
+            pendingLock, [this]() { return m_pending.empty() || m_applyFailed; } );
+        if ( m_applyFailed )
+            BOOST_THROW_EXCEPTION(
+                DatabaseError() << errinfo_comment( "Delta log cannot be applied" ) );
+    }
+    m_backend->sync();
+    if ( m_logSize == 0 )
+        return;
+    if ( ::ftruncate( m_logFd, 0 ) != 0 )
+        throwIOError( "truncate", m_logPath );
+    if ( ::fdatasync( m_logFd ) != 0 )
+        throwIOError( "sync", m_logPath );
+    m_logSize = 0;
+    std::lock_guard< std::mutex > syncLock( m_syncMutex );
+    m_synced = m_appended;
+}
+
+void DeltaLogDB::applyPending() {
+    for ( ;; ) {
+        std::shared_ptr< Batch const > batch;
+        {
+            std::unique_lock< std::shared_mutex > lock( m_pendingMutex );
+            m_pendingChanged.wait( lock, [this]() { return m_stopping || !m_pending.empty(); } );
+            if ( m_pending.empty() )
+                return;
+            batch = m_pending.front();
+        }
+
+        for ( unsigned applyTry = 0;; ++applyTry ) {
+            try {
+                apply( *batch );
+                break;
+            } catch ( ... ) {
+                cwarn << "Error applying delta log to the database: "
+                      << boost::current_exception_diagnostic_information();
+                if ( applyTry == 9 ) {
+                    cerror << "Fail applying delta log to the database. Batches are kept in "
+                           << m_logPath;
+                    {
+                        std::unique_lock< std::shared_mutex > lock( m_pendingMutex );
+                        m_applyFailed = true;
+                    }
+                    m_pendingChanged.notify_all();
+                    return;
+                }
+                cwarn << "Sleeping for " << ( applyTry + 1 ) << " seconds, then retrying.";
+                std::this_thread::sleep_for( std::chrono::seconds( applyTry + 1 ) );
+            }
+        }
+
+        {
+            std::unique_lock< std::shared_mutex > lock( m_pendingMutex );
+            m_pending.pop_front();
+        }
+        m_pendingChanged.notify_all();
+    }
+}
+
+void DeltaLogDB::apply( Batch const& _batch ) {
+    auto batch = m_backend->createWriteBatch();
+    for ( auto const& op : _batch.ops ) {
+        if ( op.second )
+            batch->insert( op.first, *op.second );
+        else
+            batch->kill( op.first );
+    }
+    m_backend->commit( std::move( batch ) );
+}
+
+boost::optional< std::string > const* DeltaLogDB::find( Pending const& _pending, Slice _key ) {
+    if ( _pending.empty() )
+        return nullptr;
+    std::string const key = _key.toString();
+    for ( auto batch = _pending.rbegin(); batch != _pending.rend(); ++batch ) {
+        auto it = ( *batch )->ops.find( key );
+        if ( it != ( *batch )->ops.end() )
+            return &it->second;
+    }
+    return nullptr;
+}
+
+void DeltaLogDB::forEachInRange( Pending const& _pending, DatabaseFace const& _backend,
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) {
+    // last pending operation on each key in range
+    std::map< std::string, boost::optional< std::string > const* > overlay;
+    std::string const begin = _begin.toString();
+    for ( auto const& batch : _pending )
+        for ( auto it = batch->ops.lower_bound( begin );
+              it != batch->ops.end() && ( _end.empty() || compareKeys( it->first, _end ) < 0 );
+              ++it )
+            overlay[it->first] = &it->second;
+
+    auto next = overlay.begin();
+    bool keepIterating = true;
+    _backend.forEachInRange( _begin, _end, [&]( Slice _key, Slice _value ) -> bool {
+        for ( ; next != overlay.end() && compareKeys( next->first, _key ) < 0; ++next )
+            if ( *next->second && !f( next->first, **next->second ) )
+                return keepIterating = false;
+        if ( next != overlay.end() && compareKeys( next->first, _key ) == 0 ) {
+            boost::optional< std::string > const& value = *( next++ )->second;
+            return keepIterating = !value || f( _key, *value );
+        }
+        return keepIterating = f( _key, _value );
+    } );
+    for ( ; keepIterating && next != overlay.end(); ++next )
+        if ( *next->second )
+            keepIterating = f( next->first, **next->second );
+}
+
+std::string DeltaLogDB::lookup( Slice _key ) const {
+    {
+        std::shared_lock< std::shared_mutex > lock( m_pendingMutex );
+        if ( auto value = find( m_pending, _key ) )
+            return value->value_or( std::string() );
+    }
+    // batches applied since are either in the backend or shadowed by newer pending ones
+    return m_backend->lookup( _key );
+}
+
+bool DeltaLogDB::exists( Slice _key ) const {
+    {
+        std::shared_lock< std::shared_mutex > lock( m_pendingMutex );
+        if ( auto value = find( m_pending, _key ) )
+            return value->is_initialized();
+    }
+    return m_backend->exists( _key );
+}
+
+void DeltaLogDB::insert( Slice _key, Slice _value ) {
+    auto batch = createWriteBatch();
+    batch->insert( _key, _value );
+    commit( std::move( batch ) );
+}
+
+void DeltaLogDB::kill( Slice _key ) {
+    auto batch = createWriteBatch();
+    batch->kill( _key );
+    commit( std::move( batch ) );
+}
+
+std::unique_ptr< WriteBatchFace > DeltaLogDB::createWriteBatch() const {
+    return std::unique_ptr< WriteBatchFace >( new Batch() );
+}
+
+void DeltaLogDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
+    if ( !_batch ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "Cannot commit null batch" ) );
+    }
+    auto* batchPtr = dynamic_cast< Batch* >( _batch.get() );
+    if ( !batchPtr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment(
+                                   "Invalid batch type passed to DeltaLogDB::commit" ) );
+    }
+    _batch.release();
+    std::shared_ptr< Batch const > batch( batchPtr );
+
+    bool checkpointNeeded;
+    {
+        std::lock_guard< std::mutex > lock( m_logMutex );
+        {
+            std::shared_lock< std::shared_mutex > pendingLock( m_pendingMutex );
+            if ( m_applyFailed )
+                BOOST_THROW_EXCEPTION(
+                    DatabaseError() << errinfo_comment( "Delta log cannot be applied" ) );
+        }
+        append( *batch );
+        {
+            std::unique_lock< std::shared_mutex > pendingLock( m_pendingMutex );
+            m_pending.push_back( std::move( batch ) );
+        }
+        checkpointNeeded = m_logSize > c_checkpointSize;
+    }
+    m_pendingChanged.notify_all();
+    if ( checkpointNeeded )
+        checkpoint();
+}
+
+void DeltaLogDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
+    forEachInRange( Slice(), Slice(), f );
+}
+
+void DeltaLogDB::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    if ( auto view = snapshot() )
+        return view->forEachInRange( _begin, _end, f );
+    // backend without snapshots shows batches applied during iteration
+    Pending pending;
+    {
+        std::shared_lock< std::shared_mutex > lock( m_pendingMutex );
+        pending = m_pending;
+    }
+    forEachInRange( pending, *m_backend, _begin, _end, f );
+}
+
+h256 DeltaLogDB::hashBase() const {
+    std::unique_ptr< DatabaseFace > view = snapshot();
+    if ( view )
+        return view->hashBase();
+    const_cast< DeltaLogDB* >( this )->checkpoint();
+    return m_backend->hashBase();
+}
+
+std::unique_ptr< DatabaseFace > DeltaLogDB::snapshot() const {
+    // applier does not drop pending batches while the backend snapshot is taken
+    std::shared_lock< std::shared_mutex > lock( m_pendingMutex );
+    std::unique_ptr< DatabaseFace > backend = m_backend->snapshot();
+    if ( !backend )
+        return nullptr;
+    return std::unique_ptr< DatabaseFace >( new Snapshot( std::move( backend ), m_pending ) );
+}
+
+void DeltaLogDB::sync() {
+    uint64_t const committed = m_appended;
+    std::lock_guard< std::mutex > lock( m_syncMutex );
+    if ( m_synced >= committed )
+        return;  // synced by a concurrent caller
+    // covers commits appended by other threads meanwhile, too
+    uint64_t const appended = m_appended;
+    if ( ::fdatasync( m_logFd ) != 0 )
+        throwIOError( "sync", m_logPath );
+    m_synced = std::max( m_synced, appended );
+}
+
+void DeltaLogDB::flush() {
+    checkpoint();
+}
+
+}  // namespace db
+}  // namespace dev
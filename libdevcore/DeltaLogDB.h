@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file DeltaLogDB.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include "db.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace dev {
+namespace db {
+
+/**
+ * Database that commits write batches to an append-only delta log and applies them to the
+ * backend database in a background thread.
+ *
+ * Commit is a single sequential write to the log. Batches that are not applied yet are kept in
+ * memory and take precedence over the backend on reads. `sync` makes all commits made so far
+ * durable with one fsync of the log, so it can be called once per block instead of once per
+ * batch; concurrent callers share one fsync. Batches found in the log on opening are applied
+ * to the backend again, which is harmless for batches that have been applied already.
+ *
+ * Once the backend has been synced the applied part of the log is no longer needed, and the log
+ * is truncated on `flush` and when it outgrows c_checkpointSize.
+ */
+class DeltaLogDB : public DatabaseFace {
+public:
+    static constexpr uint64_t c_checkpointSize = 64 << 20;
+
+    DeltaLogDB(
+        std::unique_ptr< DatabaseFace > _backend, boost::filesystem::path const& _logPath );
+    ~DeltaLogDB() override;
+
+    std::string lookup( Slice _key ) const override;
+    bool exists( Slice _key ) const override;
+    void insert( Slice _key, Slice _value ) override;
+    void kill( Slice _key ) override;
+
+    std::unique_ptr< WriteBatchFace > createWriteBatch() const override;
+    void commit( std::unique_ptr< WriteBatchFace > _batch ) override;
+
+    void forEach( std::function< bool( Slice, Slice ) > f ) const override;
+    void forEachInRange(
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const override;
+
+    h256 hashBase() const override;
+
+    std::unique_ptr< DatabaseFace > snapshot() const override;
+
+    void sync() override;
+    void flush() override;
+
+    // @returns number of batches replayed from the log when the database was opened
+    size_t replayed() const { return m_replayed; }
+
+private:
+    class Batch;
+    class Snapshot;
+    using Pending = std::deque< std::shared_ptr< Batch const > >;
+
+    void replay();
+    void append( Batch const& _batch );
+    void checkpoint();
+    void applyPending();
+    void apply( Batch const& _batch );
+
+    // @returns the last pending operation on the key, boost::none for kill, or nullptr if the
+    // key is not in pending batches
+    static boost::optional< std::string > const* find( Pending const& _pending, Slice _key );
+    static void forEachInRange( Pending const& _pending, DatabaseFace const& _backend,
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f );
+
+    std::unique_ptr< DatabaseFace > m_backend;
+    boost::filesystem::path const m_logPath;
+    int m_logFd = -1;
+    size_t m_replayed = 0;
+
+    std::mutex m_logMutex;  // serializes appends, keeps m_pending in log order
+    uint64_t m_logSize = 0;
+    uint64_t m_sequence = 0;  // of the next record
+    std::atomic< uint64_t > m_appended{0};  // bytes ever appended
+
+    std::mutex m_syncMutex;
+    uint64_t m_synced = 0;  // bytes of m_appended known to be durable
+
+    // committed batches not applied to the backend yet, oldest first
+    mutable std::shared_mutex m_pendingMutex;
+    mutable std::condition_variable_any m_pendingChanged;
+    Pending m_pending;
+    bool m_stopping = false;
+    bool m_applyFailed = false;
+
+    std::thread m_applier;
+};
+
+}  // namespace db
+}  // namespace dev
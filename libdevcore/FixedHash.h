@@ -30,8 +30,13 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <random>
 
+#if defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
 namespace dev {
 
 /// Compile-time calculation of Log2 of constant values.
@@ -46,6 +51,102 @@ struct StaticLog2< 1 > {
 
 extern std::random_device s_fixedHashEngine;
 
+/// Bitwise kernels of FixedHash. 2048-bit blooms are processed in AVX2 or SSE2 registers when
+/// the build targets them, other sizes in 64-bit words or bytes.
+namespace fixedHashKernels {
+
+template < unsigned N >
+inline void orBytes( _byte_* _a, _byte_ const* _b ) {
+#if defined( __AVX2__ )
+    if constexpr ( N % 32 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 32 ) {
+            __m256i a = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _a + i ) );
+            __m256i b = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _b + i ) );
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( _a + i ), _mm256_or_si256( a, b ) );
+        }
+        return;
+    }
+#endif
+#if defined( __SSE2__ )
+    if constexpr ( N % 16 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 16 ) {
+            __m128i a = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _a + i ) );
+            __m128i b = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _b + i ) );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( _a + i ), _mm_or_si128( a, b ) );
+        }
+        return;
+    }
+#endif
+    if constexpr ( N % 8 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 8 ) {
+            uint64_t a, b;
+            std::memcpy( &a, _a + i, 8 );
+            std::memcpy( &b, _b + i, 8 );
+            a |= b;
+            std::memcpy( _a + i, &a, 8 );
+        }
+    } else
+        for ( unsigned i = 0; i < N; ++i )
+            _a[i] |= _b[i];
+}
+
+/// @returns true if all one-bits of @a _b are set in @a _a.
+template < unsigned N >
+inline bool containsBytes( _byte_ const* _a, _byte_ const* _b ) {
+#if defined( __AVX2__ )
+    if constexpr ( N % 32 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 32 ) {
+            __m256i a = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _a + i ) );
+            __m256i b = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( _b + i ) );
+            if ( !_mm256_testc_si256( a, b ) )
+                return false;
+        }
+        return true;
+    }
+#endif
+#if defined( __SSE2__ )
+    if constexpr ( N % 16 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 16 ) {
+            __m128i a = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _a + i ) );
+            __m128i b = _mm_loadu_si128( reinterpret_cast< __m128i const* >( _b + i ) );
+            if ( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( a, b ), b ) ) != 0xffff )
+                return false;
+        }
+        return true;
+    }
+#endif
+    if constexpr ( N % 8 == 0 ) {
+        for ( unsigned i = 0; i < N; i += 8 ) {
+            uint64_t a, b;
+            std::memcpy( &a, _a + i, 8 );
+            std::memcpy( &b, _b + i, 8 );
+            if ( b & ~a )
+                return false;
+        }
+    } else
+        for ( unsigned i = 0; i < N; ++i )
+            if ( _b[i] & ~_a[i] )
+                return false;
+    return true;
+}
+
+template < unsigned N >
+inline unsigned popcountBytes( _byte_ const* _a ) {
+    unsigned ret = 0;
+    if constexpr ( N % 8 == 0 )
+        for ( unsigned i = 0; i < N; i += 8 ) {
+            uint64_t a;
+            std::memcpy( &a, _a + i, 8 );
+            ret += __builtin_popcountll( a );
+        }
+    else
+        for ( unsigned i = 0; i < N; ++i )
+            ret += __builtin_popcount( _a[i] );
+    return ret;
+}
+
+}  // namespace fixedHashKernels
+
 /// Fixed-size raw-byte array container type, with an API optimised for storing hashes.
 /// Transparently converts to/from the corresponding arithmetic type; this will
 /// assume the data contained in the hash is big-endian.
@@ -158,8 +259,7 @@ public:
     }
     FixedHash operator^( FixedHash const& _c ) const { return FixedHash( *this ) ^= _c; }
     FixedHash& operator|=( FixedHash const& _c ) {
-        for ( unsigned i = 0; i < N; ++i )
-            m_data[i] |= _c.m_data[i];
+        fixedHashKernels::orBytes< N >( m_data.data(), _c.m_data.data() );
         return *this;
     }
     FixedHash operator|( FixedHash const& _c ) const { return FixedHash( *this ) |= _c; }
@@ -184,7 +284,12 @@ public:
     }
 
     /// @returns true if all one-bits in @a _c are set in this object.
-    bool contains( FixedHash const& _c ) const { return ( *this & _c ) == _c; }
+    bool contains( FixedHash const& _c ) const {
+        return fixedHashKernels::containsBytes< N >( m_data.data(), _c.m_data.data() );
+    }
+
+    /// @returns number of one-bits in this object.
+    unsigned popcount() const { return fixedHashKernels::popcountBytes< N >( m_data.data() ); }
 
     /// @returns a particular byte from the hash.
     _byte_& operator[]( unsigned _i ) { return m_data[_i]; }
@@ -259,7 +364,7 @@ public:
     }
 
     template < unsigned P, unsigned M >
-    inline bool containsBloom( FixedHash< M > const& _h ) {
+    inline bool containsBloom( FixedHash< M > const& _h ) const {
         return contains( _h.template bloomPart< P, N >() );
     }
 
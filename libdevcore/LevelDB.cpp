@@ -22,6 +22,8 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <skutils/open_metrics.h>
+
 #include <secp256k1_sha256.h>
 
 namespace dev {
@@ -67,18 +69,25 @@ public:
 
     leveldb::WriteBatch const& writeBatch() const { return m_writeBatch; }
     leveldb::WriteBatch& writeBatch() { return m_writeBatch; }
+    size_t operations() const { return m_operations; }
+    size_t bytes() const { return m_bytes; }
 
 private:
     leveldb::WriteBatch m_writeBatch;
+    size_t m_operations = 0;
+    size_t m_bytes = 0;
 };
 
 void LevelDBWriteBatch::insert( Slice _key, Slice _value ) {
     MICROPROFILE_SCOPEI( "LevelDBWriteBatch", "insert", MP_LAVENDERBLUSH );
     m_writeBatch.Put( toLDBSlice( _key ), toLDBSlice( _value ) );
+    ++m_operations;
+    m_bytes += _key.size() + _value.size();
 }
 
 void LevelDBWriteBatch::kill( Slice _key ) {
     m_writeBatch.Delete( toLDBSlice( _key ) );
+    ++m_operations;
 }
 
 }  // namespace
@@ -103,6 +112,15 @@ LevelDB::LevelDB( boost::filesystem::path const& _path, leveldb::ReadOptions _re
     : m_db( nullptr ),
       m_readOptions( std::move( _readOptions ) ),
       m_writeOptions( std::move( _writeOptions ) ) {
+    // parent is kept because rotated pieces are named by numbers
+    std::string const label = skutils::stats::metrics::open_metrics_writer::label(
+        "db", ( _path.parent_path().filename() / _path.filename() ).string() );
+    m_reads = &skutils::stats::metrics::counter( "skaled_db_reads", label );
+    m_readBytes = &skutils::stats::metrics::counter( "skaled_db_read_bytes", label );
+    m_writes = &skutils::stats::metrics::counter( "skaled_db_writes", label );
+    m_writtenBytes = &skutils::stats::metrics::counter( "skaled_db_written_bytes", label );
+    m_commits = &skutils::stats::metrics::counter( "skaled_db_commits", label );
+
     auto db = static_cast< leveldb::DB* >( nullptr );
     auto const status = leveldb::DB::Open( _dbOptions, _path.string(), &db );
     checkStatus( status, _path );
@@ -111,14 +129,53 @@ LevelDB::LevelDB( boost::filesystem::path const& _path, leveldb::ReadOptions _re
     m_db.reset( db );
 }
 
+LevelDB::LevelDB( LevelDB const& _db, std::shared_ptr< leveldb::Snapshot const > _snapshot )
+    : m_db( _db.m_db ),
+      m_snapshot( std::move( _snapshot ) ),
+      m_readOptions( _db.m_readOptions ),
+      m_writeOptions( _db.m_writeOptions ),
+      m_reads( _db.m_reads ),
+      m_readBytes( _db.m_readBytes ),
+      m_writes( _db.m_writes ),
+      m_writtenBytes( _db.m_writtenBytes ),
+      m_commits( _db.m_commits ) {
+    m_readOptions.snapshot = m_snapshot.get();
+}
+
+std::unique_ptr< DatabaseFace > LevelDB::snapshot() const {
+    if ( m_snapshot )
+        return std::unique_ptr< DatabaseFace >( new LevelDB( *this, m_snapshot ) );
+    std::shared_ptr< leveldb::DB > db = m_db;
+    std::shared_ptr< leveldb::Snapshot const > snapshot(
+        db->GetSnapshot(), [db]( leveldb::Snapshot const* _s ) { db->ReleaseSnapshot( _s ); } );
+    return std::unique_ptr< DatabaseFace >( new LevelDB( *this, std::move( snapshot ) ) );
+}
+
+void LevelDB::sync() {
+    checkWritable();
+    // an empty synchronous write syncs the log holding all previous writes
+    leveldb::WriteOptions options = m_writeOptions;
+    options.sync = true;
+    leveldb::WriteBatch batch;
+    checkStatus( m_db->Write( options, &batch ) );
+}
+
+void LevelDB::checkWritable() const {
+    if ( m_snapshot ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "Cannot write to snapshot" ) );
+    }
+}
+
 std::string LevelDB::lookup( Slice _key ) const {
     leveldb::Slice const key( _key.data(), _key.size() );
     std::string value;
     auto const status = m_db->Get( m_readOptions, key, &value );
+    m_reads->add();
     if ( status.IsNotFound() )
         return std::string();
 
     checkStatus( status );
+    m_readBytes->add( value.size() );
     return value;
 }
 
@@ -126,6 +183,7 @@ bool LevelDB::exists( Slice _key ) const {
     std::string value;
     leveldb::Slice const key( _key.data(), _key.size() );
     auto const status = m_db->Get( m_readOptions, key, &value );
+    m_reads->add();
     if ( status.IsNotFound() )
         return false;
 
@@ -134,16 +192,21 @@ bool LevelDB::exists( Slice _key ) const {
 }
 
 void LevelDB::insert( Slice _key, Slice _value ) {
+    checkWritable();
     leveldb::Slice const key( _key.data(), _key.size() );
     leveldb::Slice const value( _value.data(), _value.size() );
     auto const status = m_db->Put( m_writeOptions, key, value );
     checkStatus( status );
+    m_writes->add();
+    m_writtenBytes->add( _key.size() + _value.size() );
 }
 
 void LevelDB::kill( Slice _key ) {
+    checkWritable();
     leveldb::Slice const key( _key.data(), _key.size() );
     auto const status = m_db->Delete( m_writeOptions, key );
     checkStatus( status );
+    m_writes->add();
 }
 
 std::unique_ptr< WriteBatchFace > LevelDB::createWriteBatch() const {
@@ -151,6 +214,7 @@ std::unique_ptr< WriteBatchFace > LevelDB::createWriteBatch() const {
 }
 
 void LevelDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
+    checkWritable();
     if ( !_batch ) {
         BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "Cannot commit null batch" ) );
     }
@@ -161,6 +225,9 @@ void LevelDB::commit( std::unique_ptr< WriteBatchFace > _batch ) {
     }
     auto const status = m_db->Write( m_writeOptions, &batchPtr->writeBatch() );
     checkStatus( status );
+    m_commits->add();
+    m_writes->add( batchPtr->operations() );
+    m_writtenBytes->add( batchPtr->bytes() );
 }
 
 void LevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
@@ -178,6 +245,26 @@ void LevelDB::forEach( std::function< bool( Slice, Slice ) > f ) const {
     }
 }
 
+void LevelDB::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    std::unique_ptr< leveldb::Iterator > itr( m_db->NewIterator( m_readOptions ) );
+    if ( itr == nullptr ) {
+        BOOST_THROW_EXCEPTION( DatabaseError() << errinfo_comment( "null iterator" ) );
+    }
+    leveldb::Slice const begin( _begin.data(), _begin.size() );
+    leveldb::Slice const end( _end.data(), _end.size() );
+    auto keepIterating = true;
+    for ( itr->Seek( begin ); keepIterating && itr->Valid(); itr->Next() ) {
+        auto const dbKey = itr->key();
+        if ( !end.empty() && dbKey.compare( end ) >= 0 )
+            break;
+        auto const dbValue = itr->value();
+        Slice const key( dbKey.data(), dbKey.size() );
+        Slice const value( dbValue.data(), dbValue.size() );
+        keepIterating = f( key, value );
+    }
+}
+
 h256 LevelDB::hashBase() const {
     std::unique_ptr< leveldb::Iterator > it( m_db->NewIterator( m_readOptions ) );
     if ( it == nullptr ) {
@@ -25,6 +25,14 @@
 #include <leveldb/write_batch.h>
 #include <boost/filesystem.hpp>
 
+namespace skutils {
+namespace stats {
+namespace metrics {
+class sharded_counter;
+}
+}  // namespace stats
+}  // namespace skutils
+
 namespace dev {
 namespace db {
 class LevelDB : public DatabaseFace {
@@ -47,14 +55,32 @@ public:
     void commit( std::unique_ptr< WriteBatchFace > _batch ) override;
 
     void forEach( std::function< bool( Slice, Slice ) > f ) const override;
+    void forEachInRange(
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const override;
 
     h256 hashBase() const override;
     h256 hashBaseWithPrefix( char _prefix ) const;
 
+    std::unique_ptr< DatabaseFace > snapshot() const override;
+
+    void sync() override;
+
 private:
-    std::unique_ptr< leveldb::DB > m_db;
-    leveldb::ReadOptions const m_readOptions;
+    LevelDB( LevelDB const& _db, std::shared_ptr< leveldb::Snapshot const > _snapshot );
+
+    void checkWritable() const;
+
+    std::shared_ptr< leveldb::DB > m_db;  // shared with snapshots
+    std::shared_ptr< leveldb::Snapshot const > m_snapshot;
+    leveldb::ReadOptions m_readOptions;
     leveldb::WriteOptions const m_writeOptions;
+
+    // shared by databases opened on the same path, exported as skaled_db_*_total
+    skutils::stats::metrics::sharded_counter* m_reads;
+    skutils::stats::metrics::sharded_counter* m_readBytes;
+    skutils::stats::metrics::sharded_counter* m_writes;
+    skutils::stats::metrics::sharded_counter* m_writtenBytes;
+    skutils::stats::metrics::sharded_counter* m_commits;
 };
 
 }  // namespace db
@@ -27,6 +27,7 @@
 #include <pthread.h>
 #endif
 
+#include <libdevcore/Tracing.h>
 #include <libdevcore/microprofile.h>
 
 #include <boost/core/null_deleter.hpp>
@@ -46,9 +47,10 @@
 #include <thread>
 
 #if defined( NDEBUG )
+#include <libdevcore/LogRingQueue.h>
 #include <boost/log/sinks/async_frontend.hpp>
 template < class T >
-using log_sink = boost::log::sinks::asynchronous_sink< T >;
+using log_sink = boost::log::sinks::asynchronous_sink< T, dev::LogRingQueue >;
 #else
 #include <boost/log/sinks/sync_frontend.hpp>
 template < class T >
@@ -58,17 +60,21 @@ using log_sink = boost::log::sinks::synchronous_sink< T >;
 namespace dev {
 
 #if defined( __GLIBC__ ) || defined( __APPLE__ )
-// nothing)
+// cached to avoid a syscall for every log record; empty until first queried or set
+static thread_local std::string g_logThreadName;
 #else
 static thread_local std::string g_logThreadName( "main" );
 #endif
 
 std::string getThreadName() {
 #if defined( __GLIBC__ ) || defined( __APPLE__ )
-    char buffer[128];
-    pthread_getname_np( pthread_self(), buffer, 127 );
-    buffer[127] = 0;
-    return buffer;
+    if ( g_logThreadName.empty() ) {
+        char buffer[128];
+        pthread_getname_np( pthread_self(), buffer, 127 );
+        buffer[127] = 0;
+        g_logThreadName = buffer;
+    }
+    return g_logThreadName;
 #else
     return g_logThreadName.empty() ? std::string( "<unknown>" ) : g_logThreadName;
 #endif
@@ -77,18 +83,38 @@ std::string getThreadName() {
 void setThreadName( std::string const& _n ) {
 #if defined( __GLIBC__ )
     pthread_setname_np( pthread_self(), _n.c_str() );
+    g_logThreadName.clear();  // kernel may truncate the name, re-read it lazily
 #elif defined( __APPLE__ )
     pthread_setname_np( _n.c_str() );
+    g_logThreadName.clear();
 #else
     g_logThreadName = _n;
 #endif
+    tracing::setThreadName( getThreadName() );
     MicroProfileOnThreadCreate( _n.c_str() );
 }
 
+uint64_t droppedLogRecords() {
+#if defined( NDEBUG )
+    return LogRingQueue::droppedRecords();
+#else
+    return 0;
+#endif
+}
+
 BOOST_LOG_ATTRIBUTE_KEYWORD( channel, "Channel", std::string )
 BOOST_LOG_ATTRIBUTE_KEYWORD( context, "Context", std::string )
 BOOST_LOG_ATTRIBUTE_KEYWORD( threadName, "ThreadName", std::string )
-BOOST_LOG_ATTRIBUTE_KEYWORD( timestamp, "TimeStamp", std::string )
+BOOST_LOG_ATTRIBUTE_KEYWORD( timestamp, "TimeStamp", cc::default_clock_t::time_point )
+
+// formatted in the sink (i.e. in background thread for asynchronous one), only raw time is
+// captured by the thread that logs
+static void formatTimeStamp(
+    boost::log::record_view const& _rec, boost::log::formatting_ostream& _strm ) {
+    auto const tp = _rec[timestamp];
+    if ( tp )
+        _strm << cc::time2string( tp.get(), true );
+}
 
 void setupLogging( LoggingOptions const& _options ) {
     auto sink = boost::make_shared< log_sink< boost::log::sinks::text_ostream_backend > >();
@@ -119,7 +145,8 @@ void setupLogging( LoggingOptions const& _options ) {
         strChannel = ss.str();
     }  // block
     sink->set_formatter( expr::stream
-                         << timestamp << " " << cc::info( strThreadName ) << " "
+                         << expr::wrap_formatter( &formatTimeStamp ) << " "
+                         << cc::info( strThreadName ) << " "
                          << cc::warn( strChannel )
                          << expr::if_( expr::has_attr(
                                 context ) )[expr::stream << " " << cc::warn( strChannel )]
@@ -130,7 +157,7 @@ void setupLogging( LoggingOptions const& _options ) {
         "ThreadName", boost::log::attributes::make_function( &getThreadName ) );
     boost::log::core::get()->add_global_attribute(
         "TimeStamp", boost::log::attributes::make_function(
-                         []() -> std::string { return cc::now2string( true ); } ) );
+                         []() { return cc::default_clock_t::now(); } ) );
 
     boost::log::core::get()->set_exception_handler(
         boost::log::make_exception_handler< std::exception >( []( std::exception const& _ex ) {
@@ -73,41 +73,54 @@ enum Verbosity {
     VerbosityTrace = 4,
 };
 
+// Simple non-thread-safe logger with fixed severity and channel for each message
+using Logger = boost::log::sources::severity_channel_logger<>;
+inline Logger createLogger( int _severity, std::string const& _channel ) {
+    return Logger(
+        boost::log::keywords::severity = _severity, boost::log::keywords::channel = _channel );
+}
+
 // Simple cout-like stream objects for accessing common log channels.
-// Thread-safe
-BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS( g_errorLogger,
-    boost::log::sources::severity_channel_logger_mt<>,
-    ( boost::log::keywords::severity = VerbosityError )( boost::log::keywords::channel = "error" ) )
-#define cerror LOG( dev::g_errorLogger::get() )
-
-BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS( g_warnLogger,
-    boost::log::sources::severity_channel_logger_mt<>,
-    ( boost::log::keywords::severity = VerbosityWarning )(
-        boost::log::keywords::channel = "warn" ) )
-#define cwarn LOG( dev::g_warnLogger::get() )
-
-BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS( g_noteLogger,
-    boost::log::sources::severity_channel_logger_mt<>,
-    ( boost::log::keywords::severity = VerbosityInfo )( boost::log::keywords::channel = "info" ) )
-#define cnote LOG( dev::g_noteLogger::get() )
-
-BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS( g_debugLogger,
-    boost::log::sources::severity_channel_logger_mt<>,
-    ( boost::log::keywords::severity = VerbosityDebug )( boost::log::keywords::channel = "debug" ) )
-#define cdebug LOG( dev::g_debugLogger::get() )
-
-BOOST_LOG_INLINE_GLOBAL_LOGGER_CTOR_ARGS( g_traceLogger,
-    boost::log::sources::severity_channel_logger_mt<>,
-    ( boost::log::keywords::severity = VerbosityTrace )( boost::log::keywords::channel = "trace" ) )
-#define ctrace LOG( dev::g_traceLogger::get() )
+// Thread-safe: every thread has its own logger instance, so no logger lock is taken
+inline Logger& errorLogger() {
+    thread_local Logger s_logger{createLogger( VerbosityError, "error" )};
+    return s_logger;
+}
+#define cerror LOG( dev::errorLogger() )
+
+inline Logger& warnLogger() {
+    thread_local Logger s_logger{createLogger( VerbosityWarning, "warn" )};
+    return s_logger;
+}
+#define cwarn LOG( dev::warnLogger() )
+
+inline Logger& noteLogger() {
+    thread_local Logger s_logger{createLogger( VerbosityInfo, "info" )};
+    return s_logger;
+}
+#define cnote LOG( dev::noteLogger() )
+
+inline Logger& debugLogger() {
+    thread_local Logger s_logger{createLogger( VerbosityDebug, "debug" )};
+    return s_logger;
+}
+#define cdebug LOG( dev::debugLogger() )
+
+inline Logger& traceLogger() {
+    thread_local Logger s_logger{createLogger( VerbosityTrace, "trace" )};
+    return s_logger;
+}
+#define ctrace LOG( dev::traceLogger() )
 
 // Simple macro to log to any channel a message without creating a logger object
 // e.g. clog(VerbosityInfo, "channel") << "message";
 // Thread-safe
-BOOST_LOG_INLINE_GLOBAL_LOGGER_DEFAULT(
-    g_clogLogger, boost::log::sources::severity_channel_logger_mt<> );
-#define clog( SEVERITY, CHANNEL )                           \
-    BOOST_LOG_STREAM_WITH_PARAMS( dev::g_clogLogger::get(), \
+inline Logger& clogLogger() {
+    thread_local Logger s_logger;
+    return s_logger;
+}
+#define clog( SEVERITY, CHANNEL )                    \
+    BOOST_LOG_STREAM_WITH_PARAMS( dev::clogLogger(), \
         ( boost::log::keywords::severity = SEVERITY )( boost::log::keywords::channel = CHANNEL ) )
 
 
@@ -120,12 +133,8 @@ struct LoggingOptions {
 // Should be called in every executable
 void setupLogging( LoggingOptions const& _options );
 
-// Simple non-thread-safe logger with fixed severity and channel for each message
-using Logger = boost::log::sources::severity_channel_logger<>;
-inline Logger createLogger( int _severity, std::string const& _channel ) {
-    return Logger(
-        boost::log::keywords::severity = _severity, boost::log::keywords::channel = _channel );
-}
+/// @returns number of log records dropped because the asynchronous log queue was full
+uint64_t droppedLogRecords();
 
 // Adds the context string to all log messages in the scope
 #define LOG_SCOPED_CONTEXT( context ) \
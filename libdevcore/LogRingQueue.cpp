@@ -0,0 +1,178 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogRingQueue.cpp
+ * @date 2020
+ */
+
+#include "LogRingQueue.h"
+
+#include <algorithm>
+
+namespace dev {
+
+std::atomic_uint64_t LogRingQueue::s_dropped{0};
+std::atomic_uint64_t LogRingQueue::s_lastId{0};
+
+struct LogRingQueue::Ring {
+    static constexpr size_t c_mask = c_ringCapacity - 1;
+    static_assert( ( c_ringCapacity & c_mask ) == 0, "ring capacity must be a power of 2" );
+
+    std::vector< boost::log::record_view > slots{c_ringCapacity};
+    alignas( 64 ) std::atomic_size_t head{0};  // written by consumer
+    alignas( 64 ) std::atomic_size_t tail{0};  // written by producer
+    std::atomic_bool abandoned{false};         // producer thread has exited
+
+    bool push( boost::log::record_view const& _rec ) {
+        size_t t = tail.load( std::memory_order_relaxed );
+        if ( t - head.load( std::memory_order_acquire ) >= c_ringCapacity )
+            return false;
+        slots[t & c_mask] = _rec;
+        tail.store( t + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool pop( boost::log::record_view& o_rec ) {
+        size_t h = head.load( std::memory_order_relaxed );
+        if ( h == tail.load( std::memory_order_acquire ) )
+            return false;
+        o_rec = std::move( slots[h & c_mask] );
+        slots[h & c_mask] = boost::log::record_view();
+        head.store( h + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool empty() const {
+        return head.load( std::memory_order_acquire ) == tail.load( std::memory_order_acquire );
+    }
+};
+
+namespace {
+struct ThreadRing {
+    uint64_t owner = 0;
+    std::shared_ptr< void > ring;
+    std::atomic_bool* abandoned = nullptr;
+    ~ThreadRing() {
+        if ( abandoned )
+            *abandoned = true;
+    }
+};
+thread_local ThreadRing t_threadRing;
+}  // namespace
+
+LogRingQueue::Ring& LogRingQueue::threadRing() {
+    if ( t_threadRing.owner != m_id ) {
+        if ( t_threadRing.abandoned )
+            *t_threadRing.abandoned = true;
+
+        auto ring = std::make_shared< Ring >();
+        {
+            std::lock_guard< std::mutex > lock( m_ringsMutex );
+            m_rings.push_back( ring );
+            ++m_ringsVersion;
+        }
+        t_threadRing.owner = m_id;
+        t_threadRing.abandoned = &ring->abandoned;
+        t_threadRing.ring = ring;
+    }
+    return *static_cast< Ring* >( t_threadRing.ring.get() );
+}
+
+void LogRingQueue::enqueue( boost::log::record_view const& _rec ) {
+    if ( !try_enqueue( _rec ) )
+        ++s_dropped;
+}
+
+bool LogRingQueue::try_enqueue( boost::log::record_view const& _rec ) {
+    if ( !threadRing().push( _rec ) )
+        return false;
+    // pairs with the fence in dequeue_ready(): either the consumer sees the record when it
+    // checks rings after announcing it waits, or the producer sees the announcement
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    if ( m_consumerWaiting.load( std::memory_order_relaxed ) &&
+         m_consumerWaiting.exchange( false ) ) {
+        // consumer holds the mutex from the announcement until it is inside wait()
+        std::lock_guard< std::mutex > lock( m_waitMutex );
+        m_waitCond.notify_one();
+    }
+    return true;
+}
+
+void LogRingQueue::refreshConsumerRings() {
+    bool prune = std::any_of( m_consumerRings.begin(), m_consumerRings.end(),
+        []( std::shared_ptr< Ring > const& _r ) { return _r->abandoned && _r->empty(); } );
+    if ( !prune && m_consumerVersion == m_ringsVersion.load( std::memory_order_acquire ) )
+        return;
+
+    std::lock_guard< std::mutex > lock( m_ringsMutex );
+    if ( prune ) {
+        m_rings.erase( std::remove_if( m_rings.begin(), m_rings.end(),
+                           []( std::shared_ptr< Ring > const& _r ) {
+                               return _r->abandoned && _r->empty();
+                           } ),
+            m_rings.end() );
+        ++m_ringsVersion;
+    }
+    m_consumerRings = m_rings;
+    m_consumerVersion = m_ringsVersion;
+}
+
+bool LogRingQueue::popAny( boost::log::record_view& o_rec ) {
+    refreshConsumerRings();
+    size_t n = m_consumerRings.size();
+    for ( size_t i = 0; i < n; ++i ) {
+        size_t idx = ( m_nextRing + i ) % n;
+        if ( m_consumerRings[idx]->pop( o_rec ) ) {
+            m_nextRing = idx + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogRingQueue::try_dequeue( boost::log::record_view& o_rec ) {
+    return popAny( o_rec );
+}
+
+bool LogRingQueue::dequeue_ready( boost::log::record_view& o_rec ) {
+    while ( true ) {
+        if ( m_interrupted.exchange( false, std::memory_order_acquire ) )
+            return false;
+        if ( popAny( o_rec ) )
+            return true;
+
+        std::unique_lock< std::mutex > lock( m_waitMutex );
+        m_consumerWaiting = true;
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        bool found = popAny( o_rec );
+        if ( !found )
+            m_waitCond.wait( lock, [this]() { return !m_consumerWaiting || m_interrupted; } );
+        m_consumerWaiting = false;
+        if ( found )
+            return true;
+    }
+}
+
+void LogRingQueue::interrupt_dequeue() {
+    m_interrupted = true;
+    std::lock_guard< std::mutex > lock( m_waitMutex );
+    m_waitCond.notify_one();
+}
+
+}  // namespace dev
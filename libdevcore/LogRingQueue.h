@@ -0,0 +1,91 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogRingQueue.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include <boost/log/core/record_view.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dev {
+
+/**
+ * @brief Queueing strategy for boost::log::sinks::asynchronous_sink.
+ * Every producer thread writes into its own bounded single-producer/single-consumer ring, so
+ * emitting a record never takes a lock and never blocks: when the ring is full the record is
+ * dropped and counted. Formatting and output happen in the sink's feeding thread, which polls
+ * all rings.
+ */
+class LogRingQueue {
+public:
+    static constexpr size_t c_ringCapacity = 4096;  // records per producer thread, power of 2
+
+    /// @returns number of records dropped because a producer's ring was full
+    static uint64_t droppedRecords() { return s_dropped; }
+
+protected:
+    LogRingQueue() : m_id( ++s_lastId ) {}
+    template < typename ArgsT >
+    explicit LogRingQueue( ArgsT const& ) : LogRingQueue() {}
+
+    // the logging core retries a failed try_enqueue() with enqueue(), so only the latter drops
+    void enqueue( boost::log::record_view const& _rec );
+    bool try_enqueue( boost::log::record_view const& _rec );
+    bool try_dequeue_ready( boost::log::record_view& o_rec ) { return try_dequeue( o_rec ); }
+    bool try_dequeue( boost::log::record_view& o_rec );
+    bool dequeue_ready( boost::log::record_view& o_rec );
+    void interrupt_dequeue();
+
+private:
+    struct Ring;
+    Ring& threadRing();
+    bool popAny( boost::log::record_view& o_rec );
+    void refreshConsumerRings();
+
+    const uint64_t m_id;  // identifies this queue in producers' thread-local state
+
+    // all rings ever registered; producers touch it only once per thread
+    std::mutex m_ringsMutex;
+    std::vector< std::shared_ptr< Ring > > m_rings;
+    std::atomic_size_t m_ringsVersion{0};
+
+    // consumer-side snapshot of m_rings
+    std::vector< std::shared_ptr< Ring > > m_consumerRings;
+    size_t m_consumerVersion = 0;
+    size_t m_nextRing = 0;
+
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCond;
+    // set by the consumer before it waits, cleared by the producer that wakes it up
+    std::atomic_bool m_consumerWaiting{false};
+    std::atomic_bool m_interrupted{false};
+
+    static std::atomic_uint64_t s_dropped;
+    static std::atomic_uint64_t s_lastId;
+};
+
+}  // namespace dev
@@ -10,6 +10,34 @@ namespace {
 const std::string current_piece_mark_key =
     "ead48ec575aaa7127384dee432fc1c02d9f6a22950234e5ecf59f35ed9f6e78d";
 
+// records read from one piece at a time while merging
+const size_t merge_chunk_size = 256;
+
+// sorted records of one piece, read in chunks
+struct PieceCursor {
+    const DatabaseFace* piece;
+    std::deque< std::pair< std::string, std::string > > chunk;
+    std::string next;
+    bool exhausted = false;
+
+    bool fill( Slice _end ) {
+        if ( chunk.empty() && !exhausted ) {
+            piece->forEachInRange( next, _end, [this]( Slice _key, Slice _value ) -> bool {
+                chunk.emplace_back( std::string( _key.begin(), _key.end() ),
+                    std::string( _value.begin(), _value.end() ) );
+                return chunk.size() < merge_chunk_size;
+            } );
+            exhausted = chunk.size() < merge_chunk_size;
+            if ( !exhausted ) {
+                // smallest key greater than the last one read
+                next = chunk.back().first;
+                next.push_back( '\0' );
+            }
+        }
+        return !chunk.empty();
+    }
+};
+
 }  // namespace
 
 ManuallyRotatingLevelDB::ManuallyRotatingLevelDB(
@@ -131,6 +159,35 @@ void ManuallyRotatingLevelDB::forEach( std::function< bool( Slice, Slice ) > f )
     }
 }
 
+void ManuallyRotatingLevelDB::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    std::shared_lock< std::shared_mutex > lock( m_mutex );
+
+    // pieces are ordered from the newest one
+    std::vector< PieceCursor > cursors;
+    for ( const auto& p : pieces )
+        cursors.push_back( PieceCursor{p.get(), {}, std::string( _begin.begin(), _begin.end() )} );
+
+    for ( ;; ) {
+        PieceCursor* min = nullptr;
+        for ( auto& c : cursors )
+            if ( c.fill( _end ) &&
+                 ( !min || compareKeys( c.chunk.front().first, min->chunk.front().first ) < 0 ) )
+                min = &c;
+        if ( !min )
+            return;
+
+        std::pair< std::string, std::string > record = std::move( min->chunk.front() );
+        min->chunk.pop_front();
+        for ( auto& c : cursors )
+            if ( !c.chunk.empty() && c.chunk.front().first == record.first )
+                c.chunk.pop_front();
+
+        if ( !f( record.first, record.second ) )
+            return;
+    }
+}
+
 h256 ManuallyRotatingLevelDB::hashBase() const {
     std::shared_lock< std::shared_mutex > lock( m_mutex );
     secp256k1_sha256_t ctx;
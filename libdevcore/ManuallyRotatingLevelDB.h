@@ -34,6 +34,9 @@ public:
     virtual void commit( std::unique_ptr< WriteBatchFace > _batch );
 
     virtual void forEach( std::function< bool( Slice, Slice ) > f ) const;
+    // merges pieces; if a key is present in several pieces, record of the newest one is used
+    virtual void forEachInRange(
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const;
     virtual h256 hashBase() const;
 };
 
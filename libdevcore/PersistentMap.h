@@ -0,0 +1,282 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PersistentMap.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace dev {
+
+/**
+ * Hash map with O(1) copy (hash array mapped trie).
+ *
+ * Copies share all nodes and values. A modification copies only the nodes on the path to the
+ * modified entry and the entry itself, and only if they are shared with another copy. Different
+ * copies may be used from different threads; one copy may not.
+ *
+ * Pointers and references to values stay valid until the next modification of the map.
+ */
+template < class K, class V, class H = std::hash< K > >
+class PersistentMap {
+public:
+    using value_type = std::pair< K const, V >;
+
+private:
+    static constexpr unsigned c_bitsPerLevel = 5;
+    static constexpr unsigned c_hashBits = 64;
+
+    struct Node;
+    // exactly one of the pointers is set
+    struct Slot {
+        std::shared_ptr< Node > child;
+        std::shared_ptr< value_type > entry;
+    };
+    // slots of present bits in order; nodes below the last level keep colliding entries unordered
+    struct Node {
+        uint32_t bitmap = 0;
+        std::vector< Slot > slots;
+    };
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PersistentMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        const_iterator() = default;
+
+        reference operator*() const { return *current(); }
+        pointer operator->() const { return current(); }
+        const_iterator& operator++() {
+            ++m_path.back().second;
+            descend();
+            return *this;
+        }
+        const_iterator operator++( int ) {
+            const_iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+        bool operator==( const_iterator const& _other ) const { return m_path == _other.m_path; }
+        bool operator!=( const_iterator const& _other ) const { return !( *this == _other ); }
+
+    private:
+        friend class PersistentMap;
+
+        explicit const_iterator( Node const* _root ) {
+            if ( _root ) {
+                m_path.emplace_back( _root, 0 );
+                descend();
+            }
+        }
+
+        value_type const* current() const {
+            return m_path.back().first->slots[m_path.back().second].entry.get();
+        }
+
+        // moves to the first entry at or after current position
+        void descend() {
+            while ( !m_path.empty() ) {
+                Node const* node = m_path.back().first;
+                size_t index = m_path.back().second;
+                if ( index == node->slots.size() ) {
+                    m_path.pop_back();
+                    if ( !m_path.empty() )
+                        ++m_path.back().second;
+                } else if ( node->slots[index].child )
+                    m_path.emplace_back( node->slots[index].child.get(), 0 );
+                else
+                    return;
+            }
+        }
+
+        std::vector< std::pair< Node const*, size_t > > m_path;
+    };
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    const_iterator begin() const { return const_iterator( m_root.get() ); }
+    const_iterator end() const { return const_iterator(); }
+
+    void clear() {
+        m_root.reset();
+        m_size = 0;
+    }
+
+    /// @returns the value or nullptr if there is no such key.
+    V const* find( K const& _key ) const {
+        size_t hash = hashOf( _key );
+        Node const* node = m_root.get();
+        for ( unsigned shift = 0; node; shift += c_bitsPerLevel ) {
+            if ( shift >= c_hashBits ) {
+                for ( Slot const& slot : node->slots )
+                    if ( slot.entry->first == _key )
+                        return &slot.entry->second;
+                return nullptr;
+            }
+            uint32_t bit = bitOf( hash, shift );
+            if ( !( node->bitmap & bit ) )
+                return nullptr;
+            Slot const& slot = node->slots[indexOf( node->bitmap, bit )];
+            if ( !slot.child )
+                return slot.entry->first == _key ? &slot.entry->second : nullptr;
+            node = slot.child.get();
+        }
+        return nullptr;
+    }
+
+    size_t count( K const& _key ) const { return find( _key ) ? 1 : 0; }
+
+    /// @returns the value, unshared from other copies, or nullptr if there is no such key.
+    V* findMutable( K const& _key ) {
+        if ( !find( _key ) )
+            return nullptr;
+        return &emplace( _key ).first->second;
+    }
+
+    /// Inserts value constructed from @a _args if there is no such key.
+    /// @returns the value, unshared from other copies, and whether it was inserted.
+    template < class... Args >
+    std::pair< value_type*, bool > emplace( K const& _key, Args&&... _args ) {
+        size_t hash = hashOf( _key );
+        Node* node = &unique( m_root );
+        for ( unsigned shift = 0;; shift += c_bitsPerLevel ) {
+            if ( shift >= c_hashBits ) {
+                for ( Slot& slot : node->slots )
+                    if ( slot.entry->first == _key )
+                        return {&unique( slot.entry ), false};
+                node->slots.push_back(
+                    Slot{nullptr, newEntry( _key, std::forward< Args >( _args )... )} );
+                ++m_size;
+                return {node->slots.back().entry.get(), true};
+            }
+            uint32_t bit = bitOf( hash, shift );
+            size_t index = indexOf( node->bitmap, bit );
+            if ( !( node->bitmap & bit ) ) {
+                node->bitmap |= bit;
+                auto it = node->slots.insert( node->slots.begin() + index,
+                    Slot{nullptr, newEntry( _key, std::forward< Args >( _args )... )} );
+                ++m_size;
+                return {it->entry.get(), true};
+            }
+            Slot& slot = node->slots[index];
+            if ( !slot.child ) {
+                if ( slot.entry->first == _key )
+                    return {&unique( slot.entry ), false};
+                // push existing entry one level down and retry there
+                auto child = std::make_shared< Node >();
+                unsigned childShift = shift + c_bitsPerLevel;
+                if ( childShift < c_hashBits )
+                    child->bitmap = bitOf( hashOf( slot.entry->first ), childShift );
+                child->slots.push_back( Slot{nullptr, std::move( slot.entry )} );
+                slot.entry.reset();
+                slot.child = std::move( child );
+            }
+            node = &unique( slot.child );
+        }
+    }
+
+    V& operator[]( K const& _key ) { return emplace( _key ).first->second; }
+
+    /// @returns true if the key was present.
+    bool erase( K const& _key ) {
+        if ( !find( _key ) )
+            return false;
+        eraseFrom( m_root, hashOf( _key ), 0, _key );
+        if ( m_root->slots.empty() )
+            m_root.reset();
+        --m_size;
+        return true;
+    }
+
+private:
+    static size_t hashOf( K const& _key ) {
+        // spreads weak hashes over the bits used at upper levels
+        uint64_t h = H()( _key );
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+    static uint32_t bitOf( size_t _hash, unsigned _shift ) {
+        return uint32_t( 1 ) << ( ( _hash >> _shift ) & 31 );
+    }
+    static size_t indexOf( uint32_t _bitmap, uint32_t _bit ) {
+        return __builtin_popcount( _bitmap & ( _bit - 1 ) );
+    }
+
+    template < class... Args >
+    static std::shared_ptr< value_type > newEntry( K const& _key, Args&&... _args ) {
+        return std::make_shared< value_type >( std::piecewise_construct,
+            std::forward_as_tuple( _key ), std::forward_as_tuple( std::forward< Args >( _args )... ) );
+    }
+
+    template < class T >
+    static T& unique( std::shared_ptr< T >& _ptr ) {
+        if ( !_ptr )
+            _ptr = std::make_shared< T >();
+        else if ( _ptr.use_count() > 1 )
+            _ptr = std::make_shared< T >( *_ptr );
+        else
+            // pairs with release of other copies dropping their references
+            std::atomic_thread_fence( std::memory_order_acquire );
+        return *_ptr;
+    }
+
+    static void eraseFrom(
+        std::shared_ptr< Node >& _node, size_t _hash, unsigned _shift, K const& _key ) {
+        Node& node = unique( _node );
+        if ( _shift >= c_hashBits ) {
+            for ( auto it = node.slots.begin(); it != node.slots.end(); ++it )
+                if ( it->entry->first == _key ) {
+                    node.slots.erase( it );
+                    return;
+                }
+            return;
+        }
+        uint32_t bit = bitOf( _hash, _shift );
+        auto it = node.slots.begin() + indexOf( node.bitmap, bit );
+        if ( it->child ) {
+            eraseFrom( it->child, _hash, _shift + c_bitsPerLevel, _key );
+            if ( !it->child->slots.empty() )
+                return;
+        }
+        node.slots.erase( it );
+        node.bitmap &= ~bit;
+    }
+
+    std::shared_ptr< Node > m_root;
+    size_t m_size = 0;
+};
+
+}  // namespace dev
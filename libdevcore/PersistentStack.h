@@ -0,0 +1,102 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file PersistentStack.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dev {
+
+/**
+ * Stack with O(1) copy. Copies share elements pushed before the copy was made; elements are
+ * immutable once pushed.
+ */
+template < class T >
+class PersistentStack {
+public:
+    bool empty() const { return !m_top; }
+    size_t size() const { return m_top ? m_top->size : 0; }
+
+    T const& back() const { return m_top->value; }
+
+    template < class... Args >
+    void emplace_back( Args&&... _args ) {
+        m_top = std::make_shared< Node >( std::move( m_top ), std::forward< Args >( _args )... );
+    }
+
+    void pop_back() { m_top = m_top->prev; }
+
+    void clear() { release( m_top ); }
+
+    /// @returns elements from bottom to top
+    std::vector< T > toVector() const {
+        std::vector< T > ret;
+        ret.reserve( size() );
+        for ( Node const* node = m_top.get(); node; node = node->prev.get() )
+            ret.push_back( node->value );
+        return std::vector< T >( ret.rbegin(), ret.rend() );
+    }
+
+    PersistentStack() = default;
+    PersistentStack( PersistentStack const& ) = default;
+    PersistentStack( PersistentStack&& ) = default;
+    PersistentStack& operator=( PersistentStack const& _other ) {
+        std::shared_ptr< Node > old = std::move( m_top );
+        m_top = _other.m_top;
+        release( old );
+        return *this;
+    }
+    PersistentStack& operator=( PersistentStack&& _other ) {
+        std::shared_ptr< Node > old = std::move( m_top );
+        m_top = std::move( _other.m_top );
+        release( old );
+        return *this;
+    }
+    ~PersistentStack() { release( m_top ); }
+
+private:
+    struct Node {
+        template < class... Args >
+        Node( std::shared_ptr< Node > _prev, Args&&... _args )
+            : prev( std::move( _prev ) ),
+              size( prev ? prev->size + 1 : 1 ),
+              value( std::forward< Args >( _args )... ) {}
+
+        std::shared_ptr< Node > prev;
+        size_t size;
+        T value;
+    };
+
+    // unlinks nodes one by one, as recursive destruction of a long stack may overflow
+    static void release( std::shared_ptr< Node >& _top ) {
+        while ( _top && _top.use_count() == 1 )
+            _top = std::move( _top->prev );
+        _top.reset();
+    }
+
+    std::shared_ptr< Node > m_top;
+};
+
+}  // namespace dev
@@ -223,33 +223,43 @@ void RLPStream::noteAppended( size_t _itemCount ) {
         return;
     //	cdebug << "noteAppended(" << _itemCount << ")";
     while ( m_listStack.size() ) {
-        if ( m_listStack.back().first < _itemCount )
+        if ( m_listStack.back().items < _itemCount )
             BOOST_THROW_EXCEPTION( RLPException()
                                    << errinfo_comment( "itemCount too large" )
-                                   << RequirementError( ( bigint ) m_listStack.back().first,
+                                   << RequirementError( ( bigint ) m_listStack.back().items,
                                           ( bigint ) _itemCount ) );
-        m_listStack.back().first -= _itemCount;
-        if ( m_listStack.back().first )
+        m_listStack.back().items -= _itemCount;
+        if ( m_listStack.back().items )
             break;
         else {
-            auto p = m_listStack.back().second;
+            ListFrame const list = m_listStack.back();
             m_listStack.pop_back();
-            size_t s = m_out.size() - p;  // list size
-            auto brs = bytesRequired( s );
-            unsigned encodeSize = s < c_rlpListImmLenCount ? 1 : ( 1 + brs );
-            auto os = m_out.size();
-            m_out.resize( os + encodeSize );
-            memmove( m_out.data() + p + encodeSize, m_out.data() + p, os - p );
+            if ( list.payloadSize ) {
+                // header has been written by appendList
+                if ( m_out.size() - list.begin != list.payloadSize )
+                    BOOST_THROW_EXCEPTION( RLPException() << errinfo_comment(
+                                               "list items do not match size of the list" ) );
+                _itemCount = 1;
+                continue;
+            }
+            // one byte was left for the header, which suffices for short lists
+            auto p = list.begin;
+            size_t s = m_out.size() - p - 1;  // list size
             if ( s < c_rlpListImmLenCount )
                 m_out[p] = ( _byte_ )( c_rlpListStart + s );
-            else if ( c_rlpListIndLenZero + brs <= 0xff ) {
+            else {
+                auto brs = bytesRequired( s );
+                if ( c_rlpListIndLenZero + brs > 0xff )
+                    BOOST_THROW_EXCEPTION(
+                        RLPException() << errinfo_comment( "itemCount too large for RLP" ) );
+                auto os = m_out.size();
+                m_out.resize( os + brs );
+                memmove( m_out.data() + p + 1 + brs, m_out.data() + p + 1, s );
                 m_out[p] = ( _byte_ )( c_rlpListIndLenZero + brs );
                 _byte_* b = &( m_out[p + brs] );
                 for ( ; s; s >>= 8 )
                     *( b-- ) = ( _byte_ ) s;
-            } else
-                BOOST_THROW_EXCEPTION(
-                    RLPException() << errinfo_comment( "itemCount too large for RLP" ) );
+            }
         }
         _itemCount = 1;  // for all following iterations, we've effectively appended a single item
                          // only since we completed a list.
@@ -258,13 +268,26 @@ void RLPStream::noteAppended( size_t _itemCount ) {
 
 RLPStream& RLPStream::appendList( size_t _items ) {
     //	cdebug << "appendList(" << _items << ")";
-    if ( _items )
-        m_listStack.push_back( std::make_pair( _items, m_out.size() ) );
-    else
+    if ( _items ) {
+        m_listStack.push_back( {_items, m_out.size(), 0} );
+        m_out.push_back( 0 );  // header, filled when the list is completed
+    } else
         appendList( bytes() );
     return *this;
 }
 
+RLPStream& RLPStream::appendList( size_t _items, size_t _payloadSize ) {
+    if ( !_items || !_payloadSize )
+        return appendList( _items );
+    if ( _payloadSize < c_rlpListImmLenCount )
+        m_out.push_back( ( _byte_ )( _payloadSize + c_rlpListStart ) );
+    else
+        pushCount( _payloadSize, c_rlpListIndLenZero );
+    m_out.reserve( m_out.size() + _payloadSize );
+    m_listStack.push_back( {_items, m_out.size(), _payloadSize} );
+    return *this;
+}
+
 RLPStream& RLPStream::appendList( bytesConstRef _rlp ) {
     if ( _rlp.size() < c_rlpListImmLenCount )
         m_out.push_back( ( _byte_ )( _rlp.size() + c_rlpListStart ) );
@@ -294,6 +317,20 @@ RLPStream& RLPStream::append( bytesConstRef _s, bool _compact ) {
     return *this;
 }
 
+RLPStream& RLPStream::append( unsigned long _i ) {
+    if ( !_i )
+        m_out.push_back( c_rlpDataImmLenStart );
+    else if ( _i < c_rlpDataImmLenStart )
+        m_out.push_back( ( _byte_ ) _i );
+    else {
+        unsigned br = bytesRequired( _i );
+        m_out.push_back( ( _byte_ )( br + c_rlpDataImmLenStart ) );
+        pushInt( _i, br );
+    }
+    noteAppended();
+    return *this;
+}
+
 RLPStream& RLPStream::append( bigint _i ) {
     if ( !_i )
         m_out.push_back( c_rlpDataImmLenStart );
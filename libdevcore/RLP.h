@@ -359,6 +359,9 @@ public:
                 return 0;
         }
 
+        if constexpr ( std::is_same< _T, u256 >::value || std::is_same< _T, u160 >::value )
+            if ( p.size() <= intTraits< _T >::maxSize )
+                return fromBigEndianLimbs< _T >( p );
         return fromBigEndian< _T >( p );
     }
 
@@ -540,12 +543,16 @@ public:
     /// Initializes the RLPStream as a list of @a _listItems items.
     explicit RLPStream( size_t _listItems ) { appendList( _listItems ); }
 
+    /// Initializes empty RLPStream writing into @a _buffer, so that memory already allocated by
+    /// it is reused. Contents of the buffer are discarded; take it back with swapOut.
+    explicit RLPStream( bytes&& _buffer ) : m_out( std::move( _buffer ) ) { m_out.clear(); }
+
     ~RLPStream() {}
 
     /// Append given datum to the byte stream.
-    RLPStream& append( unsigned long _s ) { return append( bigint( _s ) ); }
-    RLPStream& append( u160 _s ) { return append( bigint( _s ) ); }
-    RLPStream& append( u256 _s ) { return append( bigint( _s ) ); }
+    RLPStream& append( unsigned long _s );
+    RLPStream& append( u160 _s ) { return appendFixed( _s ); }
+    RLPStream& append( u256 _s ) { return appendFixed( _s ); }
     RLPStream& append( bigint _s );
     RLPStream& append( bytesConstRef _s, bool _compact = false );
     RLPStream& append( bytes const& _s ) { return append( bytesConstRef( &_s ) ); }
@@ -605,6 +612,9 @@ public:
 
     /// Appends a list.
     RLPStream& appendList( size_t _items );
+    /// Appends a list of @a _items items taking @a _payloadSize bytes when encoded. The header of
+    /// the list is written at once, so the items need not be moved when the list is completed.
+    RLPStream& appendList( size_t _items, size_t _payloadSize );
     RLPStream& appendList( bytesConstRef _rlp );
     RLPStream& appendList( bytes const& _rlp ) { return appendList( &_rlp ); }
     RLPStream& appendList( RLPStream const& _s ) { return appendList( &_s.out() ); }
@@ -621,6 +631,9 @@ public:
         return append( _data );
     }
 
+    /// Preallocate @a _size bytes of output.
+    void reserve( size_t _size ) { m_out.reserve( _size ); }
+
     /// Clear the output stream so far.
     void clear() {
         m_out.clear();
@@ -649,8 +662,22 @@ public:
     }
 
 private:
+    /// List being appended.
+    struct ListFrame {
+        size_t items;        ///< Items still to be appended.
+        size_t begin;        ///< Offset of the header, or of the payload if header is written.
+        size_t payloadSize;  ///< Size given to appendList, or 0 if header is to be written.
+    };
+
     void noteAppended( size_t _itemCount = 1 );
 
+    /// Append fixed-width number without converting it to bigint.
+    template < class _T >
+    RLPStream& appendFixed( _T const& _i ) {
+        _byte_ buffer[std::numeric_limits< _T >::digits / 8];
+        return append( bytesConstRef( buffer, toBigEndianLimbs( _i, buffer ) ) );
+    }
+
     /// Push the node-type byte (using @a _base) along with the item count @a _count.
     /// @arg _count is number of characters for strings, data-bytes for ints, or items for lists.
     void pushCount( size_t _count, _byte_ _offset );
@@ -667,7 +694,7 @@ private:
     /// Our output byte stream.
     bytes m_out;
 
-    std::vector< std::pair< size_t, size_t > > m_listStack;
+    std::vector< ListFrame > m_listStack;
 };
 
 template < class _T >
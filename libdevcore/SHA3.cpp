@@ -24,6 +24,8 @@
 
 #include <libdevcore/microprofile.h>
 
+#include <cstring>
+
 namespace dev {
 h256 const EmptySHA3 = sha3( bytesConstRef() );
 h256 const EmptyListSHA3 = sha3( rlpList() );
@@ -38,4 +40,173 @@ bool sha3( bytesConstRef _input, bytesRef o_output ) noexcept {
     bytesConstRef{h.bytes, 32}.copyTo( o_output );
     return true;
 }
+
+namespace {
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+
+size_t const c_rate = 136;  // bytes absorbed by Keccak-256 per permutation
+
+constexpr uint64_t c_roundConstants[24] = {0x0000000000000001, 0x0000000000008082,
+    0x800000000000808a, 0x8000000080008000, 0x000000000000808b, 0x0000000080000001,
+    0x8000000080008081, 0x8000000000008009, 0x000000000000008a, 0x0000000000000088,
+    0x0000000080008009, 0x000000008000000a, 0x000000008000808b, 0x800000000000008b,
+    0x8000000000008089, 0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+    0x000000000000800a, 0x800000008000000a, 0x8000000080008081, 0x8000000000008080,
+    0x0000000080000001, 0x8000000080008008};
+
+// rotation of state word x + 5 * y in the rho step
+constexpr unsigned c_rotations[25] = {0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41,
+    45, 15, 21, 8, 18, 2, 61, 56, 14};
+
+// Vectors of 64-bit words, one word per independent Keccak state. Functions on them are always
+// inlined, so they are compiled for the instruction set of the kernel using them.
+using Words4 = uint64_t __attribute__( ( vector_size( 32 ) ) );
+using Words8 = uint64_t __attribute__( ( vector_size( 64 ) ) );
+
+template < class V >
+__attribute__( ( always_inline ) ) inline void rotate( V const& _v, unsigned _n, V& o_v ) {
+    o_v = _n ? ( _v << _n ) | ( _v >> ( 64 - _n ) ) : _v;
+}
+
+/// Keccak-f[1600] permutation of L states, word i of state l being _a[i][l]. Loops inside a
+/// round are unrolled, so that the state stays in registers and rotations are by constants.
+template < class V >
+__attribute__( ( always_inline ) ) inline void keccakF1600( V* _a ) {
+    V s[25];
+#pragma GCC unroll 25
+    for ( unsigned i = 0; i < 25; ++i )
+        s[i] = _a[i];
+    for ( unsigned round = 0; round < 24; ++round ) {
+        V c[5], d, b[25];
+#pragma GCC unroll 5
+        for ( unsigned x = 0; x < 5; ++x )
+            c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+#pragma GCC unroll 5
+        for ( unsigned x = 0; x < 5; ++x ) {
+            rotate( c[( x + 1 ) % 5], 1, d );
+            d ^= c[( x + 4 ) % 5];
+#pragma GCC unroll 5
+            for ( unsigned y = 0; y < 25; y += 5 )
+                s[y + x] ^= d;
+        }
+#pragma GCC unroll 5
+        for ( unsigned x = 0; x < 5; ++x )
+#pragma GCC unroll 5
+            for ( unsigned y = 0; y < 5; ++y ) {
+                unsigned const i = x + 5 * y;
+                rotate( s[i], c_rotations[i], b[y + 5 * ( ( 2 * x + 3 * y ) % 5 )] );
+            }
+#pragma GCC unroll 5
+        for ( unsigned y = 0; y < 25; y += 5 )
+#pragma GCC unroll 5
+            for ( unsigned x = 0; x < 5; ++x )
+                s[y + x] = b[y + x] ^ ( ~b[y + ( x + 1 ) % 5] & b[y + ( x + 2 ) % 5] );
+        s[0] ^= c_roundConstants[round];
+    }
+#pragma GCC unroll 25
+    for ( unsigned i = 0; i < 25; ++i )
+        _a[i] = s[i];
+}
+
+/// Hashes inputs in L lanes. A lane takes the next input as soon as it has squeezed the hash of
+/// the previous one, so inputs of different lengths keep all lanes busy.
+template < class V, unsigned L >
+__attribute__( ( always_inline ) ) inline void sha3Lanes(
+    bytesConstRef const* _inputs, size_t _count, h256* o_outputs ) {
+    V a[25] = {};
+    size_t input[L];     // input absorbed by the lane, or _count if lane is idle
+    size_t absorbed[L];  // bytes of the input absorbed so far
+    bool last[L];        // lane absorbs the last block of its input in this permutation
+    size_t next = 0;
+    auto const take = [&]( unsigned _l ) {
+        input[_l] = next < _count ? next++ : _count;
+        absorbed[_l] = 0;
+        for ( unsigned i = 0; i < 25; ++i )
+            a[i][_l] = 0;
+    };
+    for ( unsigned l = 0; l < L; ++l )
+        take( l );
+
+    for ( ;; ) {
+        bool active = false;
+        for ( unsigned l = 0; l < L; ++l ) {
+            if ( input[l] == _count )
+                continue;
+            active = true;
+            bytesConstRef const data = _inputs[input[l]].cropped( absorbed[l] );
+            uint64_t block[c_rate / 8];
+            last[l] = data.size() < c_rate;
+            if ( last[l] ) {
+                _byte_* padded = reinterpret_cast< _byte_* >( block );
+                std::memset( padded, 0, c_rate );
+                if ( !data.empty() )
+                    std::memcpy( padded, data.data(), data.size() );
+                padded[data.size()] ^= 0x01;
+                padded[c_rate - 1] ^= 0x80;
+            } else
+                std::memcpy( block, data.data(), c_rate );
+            for ( unsigned i = 0; i < c_rate / 8; ++i )
+                a[i][l] ^= block[i];
+            absorbed[l] += c_rate;
+        }
+        if ( !active )
+            return;
+
+        keccakF1600( a );
+
+        for ( unsigned l = 0; l < L; ++l )
+            if ( input[l] != _count && last[l] ) {
+                uint64_t hash[4] = {a[0][l], a[1][l], a[2][l], a[3][l]};
+                std::memcpy( o_outputs[input[l]].data(), hash, 32 );
+                take( l );
+            }
+    }
+}
+
+__attribute__( ( target( "avx2" ) ) ) void sha3x4(
+    bytesConstRef const* _inputs, size_t _count, h256* o_outputs ) {
+    sha3Lanes< Words4, 4 >( _inputs, _count, o_outputs );
+}
+
+__attribute__( ( target( "avx512f" ) ) ) void sha3x8(
+    bytesConstRef const* _inputs, size_t _count, h256* o_outputs ) {
+    sha3Lanes< Words8, 8 >( _inputs, _count, o_outputs );
+}
+
+struct CpuFeatures {
+    CpuFeatures() {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports( "avx2" );
+        avx512 = __builtin_cpu_supports( "avx512f" );
+    }
+    bool avx2;
+    bool avx512;
+};
+
+CpuFeatures const& cpuFeatures() {
+    static CpuFeatures const features;
+    return features;
+}
+
+#endif
+
+}  // namespace
+
+void sha3( bytesConstRef const* _inputs, size_t _count, h256* o_outputs ) noexcept {
+    MICROPROFILE_SCOPEI( "sha3", "sha3 batch", MP_MEDIUMBLUE );
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+    CpuFeatures const& cpu = cpuFeatures();
+    if ( cpu.avx512 && _count > 4 )
+        return sha3x8( _inputs, _count, o_outputs );
+    if ( cpu.avx2 && _count > 1 )
+        return sha3x4( _inputs, _count, o_outputs );
+#endif
+
+    for ( size_t i = 0; i < _count; ++i ) {
+        ethash::hash256 h = ethash::keccak256( _inputs[i].data(), _inputs[i].size() );
+        std::memcpy( o_outputs[i].data(), h.bytes, 32 );
+    }
+}
 }  // namespace dev
@@ -47,6 +47,17 @@ inline h256 sha3( bytesConstRef _input ) noexcept {
     return ret;
 }
 
+/// Calculate SHA3-256 hashes of @a _count independent inputs into @a o_outputs.
+/// Inputs are hashed several at a time in AVX2 or AVX-512 lanes when the CPU supports them.
+void sha3( bytesConstRef const* _inputs, size_t _count, h256* o_outputs ) noexcept;
+
+/// Calculate SHA3-256 hashes of the given independent inputs.
+inline h256s sha3( std::vector< bytesConstRef > const& _inputs ) {
+    h256s ret( _inputs.size() );
+    sha3( _inputs.data(), _inputs.size(), ret.data() );
+    return ret;
+}
+
 inline SecureFixedHash< 32 > sha3Secure( bytesConstRef _input ) noexcept {
     SecureFixedHash< 32 > ret;
     sha3( _input, ret.writable().ref() );
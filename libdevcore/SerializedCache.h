@@ -0,0 +1,117 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file SerializedCache.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace dev {
+
+/**
+ * @brief LRU cache of immutable serialized values, bounded by their total size in bytes.
+ * Values are shared, so a reader keeps its copy alive after eviction and can splice it into
+ * output without copying under the lock.
+ * @threadsafe
+ */
+class SerializedCache {
+public:
+    typedef std::shared_ptr< const std::string > value_ptr;
+
+    explicit SerializedCache( size_t _maxBytes ) : m_maxBytes( _maxBytes ) {}
+
+    value_ptr get( std::string const& _key ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        auto it = m_index.find( _key );
+        if ( it == m_index.end() ) {
+            ++m_misses;
+            return value_ptr();
+        }
+        m_data.splice( m_data.begin(), m_data, it->second );
+        ++m_hits;
+        return it->second->second;
+    }
+
+    /// @returns stored value, which is the existing one if _key was inserted concurrently
+    value_ptr insert( std::string const& _key, std::string&& _value ) {
+        value_ptr p = std::make_shared< const std::string >( std::move( _value ) );
+        size_t cost = entryCost( _key, *p );
+        if ( cost > m_maxBytes )
+            return p;  // never cached
+        std::lock_guard< std::mutex > lock( m_mutex );
+        auto it = m_index.find( _key );
+        if ( it != m_index.end() ) {
+            m_data.splice( m_data.begin(), m_data, it->second );
+            return it->second->second;
+        }
+        while ( !m_data.empty() && m_bytes + cost > m_maxBytes ) {
+            m_bytes -= entryCost( m_data.back().first, *m_data.back().second );
+            m_index.erase( m_data.back().first );
+            m_data.pop_back();
+        }
+        m_data.emplace_front( _key, p );
+        m_index[_key] = m_data.begin();
+        m_bytes += cost;
+        return p;
+    }
+
+    void clear() {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_index.clear();
+        m_data.clear();
+        m_bytes = 0;
+    }
+
+    size_t size() const {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_index.size();
+    }
+    size_t bytes() const {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_bytes;
+    }
+    size_t maxBytes() const noexcept { return m_maxBytes; }
+    uint64_t hits() const noexcept { return m_hits; }
+    uint64_t misses() const noexcept { return m_misses; }
+
+private:
+    static size_t entryCost( std::string const& _key, std::string const& _value ) {
+        return _key.size() + _value.size() + 64;  // rough per-entry overhead
+    }
+
+    typedef std::list< std::pair< std::string, value_ptr > > list_type;
+
+    mutable std::mutex m_mutex;
+    list_type m_data;
+    std::unordered_map< std::string, list_type::iterator > m_index;
+    size_t m_bytes = 0;
+    const size_t m_maxBytes;
+    std::atomic_uint64_t m_hits{0};
+    std::atomic_uint64_t m_misses{0};
+};
+
+}  // namespace dev
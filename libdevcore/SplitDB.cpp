@@ -99,6 +99,25 @@ void SplitDB::PrefixedDB::forEach( std::function< bool( Slice, Slice ) > f ) con
     } );
 }
 
+void SplitDB::PrefixedDB::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    std::shared_lock< std::shared_mutex > lock( this->backend_mutex );
+    std::vector< char > begin2 = _begin.toVector();
+    begin2.insert( begin2.begin(), prefix );
+    std::string end2;
+    if ( _end.empty() )
+        end2 = prefixUpperBound( Slice( &prefix, 1 ) );
+    else {
+        end2.assign( 1, prefix );
+        end2.append( _end.begin(), _end.end() );
+    }
+
+    backend->forEachInRange( ref( begin2 ), end2, [&]( Slice _key, Slice _val ) -> bool {
+        Slice key_short = Slice( _key.data() + 1, _key.size() - 1 );
+        return f( key_short, _val );
+    } );
+}
+
 h256 SplitDB::PrefixedDB::hashBase() const {
     // HACK TODO implement that it would work with any DatabaseFace*
     const LevelDB* ldb = dynamic_cast< const LevelDB* >( backend );
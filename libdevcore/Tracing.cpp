@@ -0,0 +1,232 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file Tracing.cpp
+ * @date 2020
+ */
+
+#include "Tracing.h"
+#include "Log.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dev {
+namespace tracing {
+
+namespace detail {
+std::atomic_bool g_enabled{true};
+}  // namespace detail
+
+namespace {
+
+// rings of exited threads are kept for export until this many rings exist
+static constexpr size_t c_maxRings = 256;
+
+struct Slot {
+    std::atomic< const char* > name{nullptr};
+    std::atomic_uint64_t arg{0};
+    std::atomic_uint64_t beginNs{0};
+    std::atomic_uint64_t endNs{0};
+};
+
+struct Span {
+    const char* name;
+    uint64_t arg;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+// single producer; reader copies slots and then discards ones producer might have overwritten
+struct Ring {
+    static constexpr uint64_t c_mask = c_ringCapacity - 1;
+    static_assert( ( c_ringCapacity & c_mask ) == 0, "ring capacity must be a power of 2" );
+
+    std::unique_ptr< Slot[] > slots{new Slot[c_ringCapacity]};
+    alignas( 64 ) std::atomic_uint64_t written{0};
+    std::atomic_bool abandoned{false};
+    uint64_t tid = 0;
+    std::string threadName;  // guarded by registry mutex
+
+    void push( const char* _name, uint64_t _arg, uint64_t _beginNs, uint64_t _endNs ) {
+        uint64_t n = written.load( std::memory_order_relaxed );
+        // orders slot stores after publication of n, so readers seeing them see written >= n
+        std::atomic_thread_fence( std::memory_order_release );
+        Slot& s = slots[n & c_mask];
+        s.name.store( _name, std::memory_order_relaxed );
+        s.arg.store( _arg, std::memory_order_relaxed );
+        s.beginNs.store( _beginNs, std::memory_order_relaxed );
+        s.endNs.store( _endNs, std::memory_order_relaxed );
+        written.store( n + 1, std::memory_order_release );
+    }
+
+    void read( std::vector< Span >& o_spans, uint64_t _sinceNs ) const {
+        uint64_t last = written.load( std::memory_order_acquire );
+        uint64_t first = last > c_ringCapacity ? last - c_ringCapacity : 0;
+        std::vector< Span > copied;
+        copied.reserve( last - first );
+        for ( uint64_t i = first; i < last; ++i ) {
+            Slot const& s = slots[i & c_mask];
+            copied.push_back( {s.name.load( std::memory_order_relaxed ),
+                s.arg.load( std::memory_order_relaxed ),
+                s.beginNs.load( std::memory_order_relaxed ),
+                s.endNs.load( std::memory_order_relaxed )} );
+        }
+        std::atomic_thread_fence( std::memory_order_acquire );
+        uint64_t lastAfter = written.load( std::memory_order_relaxed );
+        // producer may be writing index lastAfter, which overwrites lastAfter - capacity
+        uint64_t firstValid = lastAfter >= c_ringCapacity ? lastAfter - c_ringCapacity + 1 : 0;
+        for ( uint64_t i = std::max( first, firstValid ); i < last; ++i ) {
+            Span const& span = copied[i - first];
+            if ( span.name != nullptr && span.endNs >= _sinceNs )
+                o_spans.push_back( span );
+        }
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector< std::shared_ptr< Ring > > rings;
+    uint64_t lastTid = 0;
+};
+
+Registry& registry() {
+    static Registry* s_registry = new Registry;  // used by exiting threads
+    return *s_registry;
+}
+
+struct ThreadRing {
+    std::shared_ptr< Ring > ring;
+    ~ThreadRing() {
+        if ( ring )
+            ring->abandoned = true;
+    }
+};
+thread_local ThreadRing t_threadRing;
+
+Ring& threadRing() {
+    if ( t_threadRing.ring )
+        return *t_threadRing.ring;
+    auto ring = std::make_shared< Ring >();
+    std::string name = getThreadName();
+    Registry& r = registry();
+    std::lock_guard< std::mutex > lock( r.mutex );
+    if ( r.rings.size() >= c_maxRings ) {
+        for ( auto it = r.rings.begin(); it != r.rings.end(); ++it )
+            if ( ( *it )->abandoned ) {
+                r.rings.erase( it );
+                break;
+            }
+    }
+    ring->tid = ++r.lastTid;
+    ring->threadName = name;
+    r.rings.push_back( ring );
+    t_threadRing.ring = ring;
+    return *ring;
+}
+
+void appendEscaped( std::string& o_json, const char* _str ) {
+    for ( ; *_str != '\0'; ++_str ) {
+        unsigned char c = *_str;
+        if ( c == '"' || c == '\\' ) {
+            o_json += '\\';
+            o_json += char( c );
+        } else if ( c < 0x20 ) {
+            char buf[8];
+            std::snprintf( buf, sizeof( buf ), "\\u%04x", c );
+            o_json += buf;
+        } else
+            o_json += char( c );
+    }
+}
+
+// microseconds with nanosecond fraction, as Chrome trace timestamps are in microseconds
+void appendMicroseconds( std::string& o_json, uint64_t _ns ) {
+    char buf[32];
+    std::snprintf( buf, sizeof( buf ), "%llu.%03llu", ( unsigned long long ) ( _ns / 1000 ),
+        ( unsigned long long ) ( _ns % 1000 ) );
+    o_json += buf;
+}
+
+}  // namespace
+
+void setEnabled( bool _enabled ) {
+    detail::g_enabled = _enabled;
+}
+
+void record( const char* _name, uint64_t _arg, uint64_t _beginNs, uint64_t _endNs ) {
+    threadRing().push( _name, _arg, _beginNs, _endNs );
+}
+
+void setThreadName( std::string const& _name ) {
+    if ( !t_threadRing.ring )
+        return;  // will be read by threadRing()
+    std::lock_guard< std::mutex > lock( registry().mutex );
+    t_threadRing.ring->threadName = _name;
+}
+
+std::string chromeTraceJson( uint64_t _sinceNs ) {
+    std::vector< std::pair< std::shared_ptr< Ring >, std::string > > rings;
+    {
+        Registry& r = registry();
+        std::lock_guard< std::mutex > lock( r.mutex );
+        for ( auto const& ring : r.rings )
+            rings.emplace_back( ring, ring->threadName );
+    }
+
+    std::string pid = std::to_string( ::getpid() );
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    std::vector< Span > spans;
+    for ( auto const& entry : rings ) {
+        std::string tid = std::to_string( entry.first->tid );
+        if ( !first )
+            json += ',';
+        first = false;
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid +
+                ",\"args\":{\"name\":\"";
+        appendEscaped( json, entry.second.c_str() );
+        json += "\"}}";
+
+        spans.clear();
+        entry.first->read( spans, _sinceNs );
+        for ( Span const& span : spans ) {
+            json += ",{\"name\":\"";
+            appendEscaped( json, span.name );
+            json += "\",\"cat\":\"skaled\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds( json, span.beginNs );
+            if ( span.endNs == span.beginNs )
+                json += ",\"ph\":\"i\",\"s\":\"t\"";
+            else {
+                json += ",\"ph\":\"X\",\"dur\":";
+                appendMicroseconds( json, span.endNs - span.beginNs );
+            }
+            json += ",\"args\":{\"arg\":" + std::to_string( span.arg ) + "}}";
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+}  // namespace tracing
+}  // namespace dev
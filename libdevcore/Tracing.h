@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file Tracing.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace dev {
+namespace tracing {
+
+/**
+ * Always-on span recorder.
+ * Every thread writes fixed-size binary spans into its own ring, overwriting the oldest ones, so
+ * recording never locks and never allocates after the first span of a thread. Span names must be
+ * string literals: only the pointer is stored. Rings are read and converted to Chrome trace
+ * format only when requested.
+ */
+
+static constexpr size_t c_ringCapacity = 4096;  // spans per thread, power of 2
+
+namespace detail {
+extern std::atomic_bool g_enabled;
+}  // namespace detail
+
+inline bool enabled() {
+    return detail::g_enabled.load( std::memory_order_relaxed );
+}
+void setEnabled( bool _enabled );
+
+inline uint64_t nowNs() {
+    return std::chrono::duration_cast< std::chrono::nanoseconds >(
+        std::chrono::steady_clock::now().time_since_epoch() )
+        .count();
+}
+
+/// Records span of calling thread; instant event when _endNs == _beginNs
+void record( const char* _name, uint64_t _arg, uint64_t _beginNs, uint64_t _endNs );
+
+inline void mark( const char* _name, uint64_t _arg = 0 ) {
+    if ( enabled() ) {
+        uint64_t t = nowNs();
+        record( _name, _arg, t, t );
+    }
+}
+
+/// Span covering lifetime of the object
+class ScopedSpan {
+public:
+    explicit ScopedSpan( const char* _name, uint64_t _arg = 0 )
+        : m_name( _name ), m_arg( _arg ), m_beginNs( enabled() ? nowNs() : 0 ) {}
+    ScopedSpan( ScopedSpan const& ) = delete;
+    ScopedSpan& operator=( ScopedSpan const& ) = delete;
+    ~ScopedSpan() {
+        if ( m_beginNs != 0 )
+            record( m_name, m_arg, m_beginNs, nowNs() );
+    }
+
+    void setArg( uint64_t _arg ) { m_arg = _arg; }
+
+private:
+    const char* m_name;
+    uint64_t m_arg;
+    uint64_t m_beginNs;
+};
+
+/// Span argument identifying a transaction or block: leading 8 bytes of its hash
+template < class HashT >
+uint64_t hashArg( HashT const& _hash ) {
+    uint64_t ret = 0;
+    for ( size_t i = 0; i < 8 && i < _hash.size; ++i )
+        ret = ( ret << 8 ) | _hash[i];
+    return ret;
+}
+
+/// Updates name shown for calling thread in exported traces
+void setThreadName( std::string const& _name );
+
+/// @returns spans of all threads as Chrome trace event JSON, loadable by Perfetto UI;
+/// spans that ended before _sinceNs are skipped
+std::string chromeTraceJson( uint64_t _sinceNs = 0 );
+
+}  // namespace tracing
+}  // namespace dev
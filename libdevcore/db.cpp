@@ -0,0 +1,61 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file db.cpp
+ * @date 2020
+ */
+
+#include "db.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace dev {
+namespace db {
+
+void DatabaseFace::forEachInRange(
+    Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const {
+    forEach( [&]( Slice _key, Slice _value ) -> bool {
+        if ( compareKeys( _key, _begin ) < 0 )
+            return true;
+        if ( !_end.empty() && compareKeys( _key, _end ) >= 0 )
+            return true;
+        return f( _key, _value );
+    } );
+}
+
+std::string prefixUpperBound( Slice _prefix ) {
+    std::string ret( _prefix.begin(), _prefix.end() );
+    while ( !ret.empty() && static_cast< unsigned char >( ret.back() ) == 0xFF )
+        ret.pop_back();
+    if ( !ret.empty() )
+        ret.back() = static_cast< char >( static_cast< unsigned char >( ret.back() ) + 1 );
+    return ret;
+}
+
+int compareKeys( Slice _a, Slice _b ) {
+    size_t const n = std::min( _a.size(), _b.size() );
+    int const r = n == 0 ? 0 : std::memcmp( _a.data(), _b.data(), n );
+    if ( r != 0 )
+        return r;
+    return _a.size() < _b.size() ? -1 : ( _a.size() > _b.size() ? 1 : 0 );
+}
+
+}  // namespace db
+}  // namespace dev
@@ -66,9 +66,37 @@ public:
     // of each record in the database. If `f` returns false, the `forEach`
     // method must return immediately.
     virtual void forEach( std::function< bool( Slice, Slice ) > f ) const = 0;
+
+    // Same as `forEach`, but visits only records with _begin <= key < _end, in ascending
+    // unsigned bytewise order of keys; an empty _end means no upper bound. Iteration can be
+    // resumed by passing the first key not visited as _begin. The default implementation
+    // filters `forEach`, ordered databases override it with a seek.
+    virtual void forEachInRange(
+        Slice _begin, Slice _end, std::function< bool( Slice, Slice ) > f ) const;
+
     virtual h256 hashBase() const = 0;
+
+    // Returns read-only database that keeps showing current contents regardless of later writes,
+    // or nullptr if the database does not support snapshots. Snapshot may outlive its database.
+    virtual std::unique_ptr< DatabaseFace > snapshot() const { return nullptr; }
+
+    // Blocks until committed writes survive a crash of the machine. Databases that write
+    // through on commit need not override it.
+    virtual void sync() {}
+
+    // Blocks until committed writes reach the database files, so that they can be copied or
+    // opened by another process. Databases that apply writes on commit need not override it.
+    virtual void flush() {}
 };
 
+// @returns the smallest key greater than all keys starting with _prefix, or empty string if
+// there is no such key (the prefix consists of 0xFF bytes only). Used as `_end` of
+// `forEachInRange` to iterate over a prefix.
+std::string prefixUpperBound( Slice _prefix );
+
+// Compares keys the way `forEachInRange` orders them
+int compareKeys( Slice _a, Slice _b );
+
 DEV_SIMPLE_EXCEPTION( DatabaseError );
 
 enum class DatabaseStatus {
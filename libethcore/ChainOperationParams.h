@@ -129,6 +129,13 @@ public:
     bool freeContractDeployment = false;
     int emptyBlockIntervalMs = -1;
     size_t t = 1;
+    // 0 disables batching of broadcast transactions; nodes before batching was introduced drop
+    // batch messages, so it may be enabled only when all nodes of the chain understand them
+    size_t broadcastBatchMaxBytes = 0;
+    uint64_t broadcastBatchMaxDelayUs = 1000;  // max time transaction waits in broadcast batch
+    // format of state DB records; nodes keep snapshot hashes equal only if they use the same
+    // format, so 2 may be enabled only when all nodes of the chain support it
+    unsigned stateFormatVersion = 1;
 
     SChain() {
         name = "TestChain";
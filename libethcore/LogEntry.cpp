@@ -37,10 +37,25 @@ void LogEntry::streamRLP( RLPStream& _s ) const {
 }
 
 LogBloom LogEntry::bloom() const {
+    // address and up to 4 topics of LOG0..LOG4, hashed in batches to avoid heap allocations
+    size_t const c_batch = 5;
+    bytesConstRef inputs[c_batch];
+    h256 hashes[c_batch];
     LogBloom ret;
-    ret.shiftBloom< 3 >( sha3( address.ref() ) );
-    for ( auto t : topics )
-        ret.shiftBloom< 3 >( sha3( t.ref() ) );
+    inputs[0] = address.ref();
+    size_t count = 1;
+    auto flush = [&]() {
+        sha3( inputs, count, hashes );
+        for ( size_t i = 0; i < count; ++i )
+            ret.shiftBloom< 3 >( hashes[i] );
+        count = 0;
+    };
+    for ( auto const& t : topics ) {
+        if ( count == c_batch )
+            flush();
+        inputs[count++] = t.ref();
+    }
+    flush();
     return ret;
 }
 
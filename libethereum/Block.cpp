@@ -111,6 +111,8 @@ Block::Block( Block const& _s )
     : m_state( _s.m_state ),
       m_transactions( _s.m_transactions ),
       m_receipts( _s.m_receipts ),
+      m_transactionRLPs( _s.m_transactionRLPs ),
+      m_receiptRLPs( _s.m_receiptRLPs ),
       m_transactionSet( _s.m_transactionSet ),
       m_precommit( _s.m_state ),
       m_previousBlock( _s.m_previousBlock ),
@@ -128,6 +130,8 @@ Block& Block::operator=( Block const& _s ) {
     m_state = _s.m_state;
     m_transactions = _s.m_transactions;
     m_receipts = _s.m_receipts;
+    m_transactionRLPs = _s.m_transactionRLPs;
+    m_receiptRLPs = _s.m_receiptRLPs;
     m_transactionSet = _s.m_transactionSet;
     m_previousBlock = _s.m_previousBlock;
     m_currentBlock = _s.m_currentBlock;
@@ -143,6 +147,8 @@ Block& Block::operator=( Block const& _s ) {
 void Block::resetCurrent( int64_t _timestamp ) {
     m_transactions.clear();
     m_receipts.clear();
+    m_transactionRLPs.clear();
+    m_receiptRLPs.clear();
     m_transactionSet.clear();
     m_currentBlock = BlockHeader();
     m_currentBlock.setAuthor( m_author );
@@ -462,6 +468,7 @@ tuple< TransactionReceipts, unsigned > Block::syncEveryone( BlockChain const& _b
                         TransactionReceipt( EmptyTrie, info().gasUsed(), LogEntries() );
 
                 m_receipts.push_back( null_receipt );
+                encodeLastTransaction();
                 receipts.push_back( null_receipt );
 
                 ++count_bad;
@@ -802,6 +809,7 @@ ExecutionResult Block::execute( LastBlockHashesFace const& _lh, Transaction cons
         // Add to the user-originated transactions that we've executed.
         m_transactions.push_back( _t );
         m_receipts.push_back( resultReceipt.second );
+        encodeLastTransaction();
         m_transactionSet.insert( _t.sha3() );
     }
     if ( _p == Permanence::Committed || _p == Permanence::Uncommitted ) {
@@ -890,22 +898,21 @@ void Block::commitToSeal(
     BytesMap transactionsMap;
     BytesMap receiptsMap;
 
+    size_t txsSize = 0;
+    for ( unsigned i = 0; i < m_transactions.size(); ++i )
+        txsSize += m_transactionRLPs[i].size();
     RLPStream txs;
-    txs.appendList( m_transactions.size() );
+    txs.appendList( m_transactions.size(), txsSize );
 
+    RLPStream k;
     for ( unsigned i = 0; i < m_transactions.size(); ++i ) {
-        RLPStream k;
+        k.clear();
         k << i;
 
-        RLPStream receiptrlp;
-        receipt( i ).streamRLP( receiptrlp );
-        receiptsMap.insert( std::make_pair( k.out(), receiptrlp.out() ) );
+        receiptsMap.insert( std::make_pair( k.out(), m_receiptRLPs[i] ) );
+        transactionsMap.insert( std::make_pair( k.out(), m_transactionRLPs[i] ) );
 
-        RLPStream txrlp;
-        m_transactions[i].streamRLP( txrlp );
-        transactionsMap.insert( std::make_pair( k.out(), txrlp.out() ) );
-
-        txs.appendRaw( txrlp.out() );
+        txs.appendRaw( m_transactionRLPs[i] );
     }
 
     txs.swapOut( m_currentTxs );
@@ -945,6 +952,18 @@ void Block::commitToSeal(
     m_committedToSeal = true;
 }
 
+void Block::encodeLastTransaction() {
+    assert( m_transactionRLPs.size() + 1 == m_transactions.size() );
+    RLPStream transactionStream;
+    m_transactions.back().streamRLP( transactionStream );
+    m_transactionRLPs.emplace_back();
+    transactionStream.swapOut( m_transactionRLPs.back() );
+    RLPStream receiptStream;
+    m_receipts.back().streamRLP( receiptStream );
+    m_receiptRLPs.emplace_back();
+    receiptStream.swapOut( m_receiptRLPs.back() );
+}
+
 void Block::uncommitToSeal() {
     if ( m_committedToSeal ) {
         m_state = m_precommit;
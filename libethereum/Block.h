@@ -186,6 +186,9 @@ public:
     /// Get the transaction receipt for the transaction of the given index.
     TransactionReceipt const& receipt( unsigned _i ) const { return m_receipts.at( _i ); }
 
+    /// Get RLP of the transaction receipt for the transaction of the given index.
+    bytes const& receiptRLP( unsigned _i ) const { return m_receiptRLPs.at( _i ); }
+
     /// Get the list of pending transactions.
     LogEntries const& log( unsigned _i ) const { return receipt( _i ).log(); }
 
@@ -314,10 +317,15 @@ private:
     /// Creates and updates the special contract for storing block hashes according to EIP96
     void updateBlockhashContract();
 
+    /// Encodes the last added transaction and its receipt for sealing.
+    void encodeLastTransaction();
+
     skale::State m_state;         ///< Our state.
     Transactions m_transactions;  ///< The current list of transactions that we've included in the
                                   ///< state.
     TransactionReceipts m_receipts;  ///< The corresponding list of transaction receipts.
+    std::vector< bytes > m_transactionRLPs;  ///< Encoded m_transactions.
+    std::vector< bytes > m_receiptRLPs;      ///< Encoded m_receipts.
     h256Hash m_transactionSet;  ///< The set of transaction hashes that we've included in the state.
     skale::State m_precommit;   ///< State at the point immediately prior to rewards.
 
@@ -621,15 +621,6 @@ ImportRoute BlockChain::import(
     verifiedBlock.transactions = _block.pending();
     //    verifyBlock( ref( _block.blockData() ), m_onBad, ImportRequirements::OutOfOrderChecks );
 
-    BlockReceipts blockReceipts;
-    if ( partialTransactionReceipts ) {
-        for ( unsigned i = 0; i < partialTransactionReceipts->size(); ++i )
-            blockReceipts.receipts.push_back( ( *partialTransactionReceipts )[i] );
-    }
-    for ( unsigned i = 0; i < _block.pending().size(); ++i )
-        blockReceipts.receipts.push_back( _block.receipt( i ) );
-    bytes const receipts = blockReceipts.rlp();
-
     //
     // l_sergiy:
     //
@@ -639,9 +630,20 @@ ImportRoute BlockChain::import(
     //
     // normally it's performed like: // LogBloom blockBloom = tbi.logBloom();
     //
+    size_t const partialCount =
+        partialTransactionReceipts ? partialTransactionReceipts->size() : 0;
+    RLPStream receiptsStream( partialCount + _block.pending().size() );
     LogBloom blockBloomFull;
-    for ( const TransactionReceipt& trWalk : blockReceipts.receipts )
-        blockBloomFull |= trWalk.bloom();
+    for ( size_t i = 0; i < partialCount; ++i ) {
+        ( *partialTransactionReceipts )[i].streamRLP( receiptsStream );
+        blockBloomFull |= ( *partialTransactionReceipts )[i].bloom();
+    }
+    // receipts of the block are already encoded
+    for ( unsigned i = 0; i < _block.pending().size(); ++i ) {
+        receiptsStream.appendRaw( _block.receiptRLP( i ) );
+        blockBloomFull |= _block.receipt( i ).bloom();
+    }
+    bytes const receipts = receiptsStream.out();
 
     ImportPerformanceLogger performanceLogger;
 
@@ -744,8 +746,9 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
             toSlice( _block.info.hash(), ExtraDetails ), ( db::Slice ) dev::ref( details_rlp ) );
 
         BlockLogBlooms blb;
+        // bloom is the third item of receipt, no need to decode logs
         for ( auto i : RLP( _receipts ) )
-            blb.blooms.push_back( TransactionReceipt( i.data() ).bloom() );
+            blb.blooms.push_back( ( LogBloom ) i[2] );
         extrasWriteBatch->insert(
             toSlice( _block.info.hash(), ExtraLogBlooms ), ( db::Slice ) dev::ref( blb.rlp() ) );
 
@@ -841,12 +844,14 @@ ImportRoute BlockChain::insertBlockAndExtras( VerifiedBlockRef const& _block,
             ta.index = 0;
 
             RLP txns_rlp = blockRLP[1];
+            std::vector< bytesConstRef > txns;
+            for ( auto const& txn : txns_rlp )
+                txns.push_back( txn.data() );
 
-            for ( RLP::iterator it = txns_rlp.begin(); it != txns_rlp.end(); ++it ) {
+            for ( h256 const& txnHash : sha3( txns ) ) {
                 MICROPROFILE_SCOPEI( "insertBlockAndExtras", "for2", MP_HONEYDEW );
 
-                extrasWriteBatch->insert(
-                    toSlice( sha3( ( *it ).data() ), ExtraTransactionAddress ),
+                extrasWriteBatch->insert( toSlice( txnHash, ExtraTransactionAddress ),
                     ( db::Slice ) dev::ref( ta.rlp() ) );
                 ++ta.index;
             }
@@ -1332,7 +1337,14 @@ static inline unsigned ceilDiv( unsigned n, unsigned d ) {
 
 vector< unsigned > BlockChain::withBlockBloom(
     LogBloom const& _b, unsigned _earliest, unsigned _latest ) const {
+    return withBlockBloom( vector< LogBloom >{_b}, _earliest, _latest );
+}
+
+vector< unsigned > BlockChain::withBlockBloom(
+    vector< LogBloom > const& _blooms, unsigned _earliest, unsigned _latest ) const {
     vector< unsigned > ret;
+    if ( _blooms.empty() )
+        return ret;
 
     // start from the top-level
     unsigned u = upow( c_bloomIndexSize, c_bloomIndexLevels );
@@ -1340,13 +1352,13 @@ vector< unsigned > BlockChain::withBlockBloom(
     // run through each of the top-level blockbloom blocks
     // TODO here should be another blockBlooms() filtering!?
     for ( unsigned index = _earliest / u; index <= _latest / u; ++index )  // 0
-        ret += withBlockBloom( _b, _earliest, _latest, c_bloomIndexLevels - 1, index );
+        ret += withBlockBloom( _blooms, _earliest, _latest, c_bloomIndexLevels - 1, index );
 
     return ret;
 }
 
-vector< unsigned > BlockChain::withBlockBloom( LogBloom const& _b, unsigned _earliest,
-    unsigned _latest, unsigned _level, unsigned _index ) const {
+vector< unsigned > BlockChain::withBlockBloom( vector< LogBloom > const& _blooms,
+    unsigned _earliest, unsigned _latest, unsigned _level, unsigned _index ) const {
     // 14, 32, 1, 0
     // 14, 32, 0, 0
     // 14, 32, 0, 1
@@ -1374,15 +1386,23 @@ vector< unsigned > BlockChain::withBlockBloom( LogBloom const& _b, unsigned _ear
     // 1
 
     BlocksBlooms bb = blocksBlooms( _level, _index );
-    for ( unsigned o = obegin; o < oend; ++o )
-        if ( bb.blooms[o].contains( _b ) ) {
-            // This level has something like what we want.
-            if ( _level > 0 )
-                ret += withBlockBloom(
-                    _b, _earliest, _latest, _level - 1, o + _index * c_bloomIndexSize );
-            else
-                ret.push_back( o + _index * c_bloomIndexSize );
-        }
+    vector< LogBloom > matching;
+    for ( unsigned o = obegin; o < oend; ++o ) {
+        // blooms of the finer level are parts of this one, so only blooms matching here are
+        // passed down
+        matching.clear();
+        for ( auto const& b : _blooms )
+            if ( bb.blooms[o].contains( b ) )
+                matching.push_back( b );
+        if ( matching.empty() )
+            continue;
+        // This level has something like what we want.
+        if ( _level > 0 )
+            ret += withBlockBloom(
+                matching, _earliest, _latest, _level - 1, o + _index * c_bloomIndexSize );
+        else
+            ret.push_back( o + _index * c_bloomIndexSize );
+    }
     return ret;
 }
 
@@ -281,8 +281,12 @@ public:
     }
     std::vector< unsigned > withBlockBloom(
         LogBloom const& _b, unsigned _earliest, unsigned _latest ) const;
-    std::vector< unsigned > withBlockBloom( LogBloom const& _b, unsigned _earliest,
-        unsigned _latest, unsigned _topLevel, unsigned _index ) const;
+    /// @returns numbers of blocks whose bloom contains any of @a _blooms, each number once.
+    /// Every bloom chunk is read once and tested against all blooms still possible in it.
+    std::vector< unsigned > withBlockBloom(
+        std::vector< LogBloom > const& _blooms, unsigned _earliest, unsigned _latest ) const;
+    std::vector< unsigned > withBlockBloom( std::vector< LogBloom > const& _blooms,
+        unsigned _earliest, unsigned _latest, unsigned _topLevel, unsigned _index ) const;
 
     /// Returns true if transaction is known. Thread-safe
     bool isKnownTransaction( h256 const& _transactionHash ) const {
@@ -196,6 +196,15 @@ ChainParams ChainParams::loadConfig(
         if ( sChainObj.count( "freeContractDeployment" ) )
             s.freeContractDeployment = sChainObj.at( "freeContractDeployment" ).get_bool();
 
+        if ( sChainObj.count( "broadcastBatchMaxBytes" ) )
+            s.broadcastBatchMaxBytes = sChainObj.at( "broadcastBatchMaxBytes" ).get_uint64();
+
+        if ( sChainObj.count( "broadcastBatchMaxDelayUs" ) )
+            s.broadcastBatchMaxDelayUs = sChainObj.at( "broadcastBatchMaxDelayUs" ).get_uint64();
+
+        if ( sChainObj.count( "stateFormatVersion" ) )
+            s.stateFormatVersion = sChainObj.at( "stateFormatVersion" ).get_uint64();
+
         for ( auto nodeConf : sChainObj.at( "nodes" ).get_array() ) {
             auto nodeConfObj = nodeConf.get_obj();
             sChainNode node{};
@@ -29,6 +29,8 @@
 #include "SnapshotStorage.h"
 #include "TransactionQueue.h"
 #include <libdevcore/Log.h>
+#include <libdevcore/Tracing.h>
+#include <boost/core/demangle.hpp>
 #include <boost/filesystem.hpp>
 #include <chrono>
 #include <memory>
@@ -130,9 +132,33 @@ Client::Client( ChainParams const& _params, int _networkID,
     };
 
     init( _forceAction, _networkID );
+
+    m_metricsCollector = skutils::stats::metrics::add_collector(
+        [this]( skutils::stats::metrics::open_metrics_writer& _w ) {
+            typedef skutils::stats::metrics::open_metrics_writer writer;
+            TransactionQueue::Status const status = m_tq.status();
+            TransactionQueue::Limits const limits = m_tq.limits();
+            _w.family( "skaled_txqueue_transactions", "gauge", "Transactions in queue." );
+            _w.sample( "skaled_txqueue_transactions", writer::label( "state", "current" ),
+                uint64_t( status.current ) );
+            _w.sample( "skaled_txqueue_transactions", writer::label( "state", "future" ),
+                uint64_t( status.future ) );
+            _w.sample( "skaled_txqueue_transactions", writer::label( "state", "unverified" ),
+                uint64_t( status.unverified ) );
+            _w.sample( "skaled_txqueue_transactions", writer::label( "state", "dropped" ),
+                uint64_t( status.dropped ) );
+            _w.family( "skaled_txqueue_limit", "gauge", "Transaction queue limits." );
+            _w.sample( "skaled_txqueue_limit", writer::label( "state", "current" ),
+                uint64_t( limits.current ) );
+            _w.sample( "skaled_txqueue_limit", writer::label( "state", "future" ),
+                uint64_t( limits.future ) );
+            _w.family( "skaled_block_number", "gauge", "Latest imported block." );
+            _w.sample( "skaled_block_number", "", uint64_t( m_bc.number() ) );
+        } );
 }
 
 Client::~Client() {
+    skutils::stats::metrics::remove_collector( m_metricsCollector );
     stopWorking();
 }
 
@@ -205,7 +231,7 @@ void Client::init( WithExisting _forceAction, u256 _networkId ) {
     // blockchain database until after the construction.
     m_state = State( chainParams().accountStartNonce, m_dbPath, bc().genesisHash(),
         BaseState::PreExisting, chainParams().accountInitialFunds,
-        chainParams().sChain.storageLimit );
+        chainParams().sChain.storageLimit, chainParams().sChain.stateFormatVersion );
 
     if ( m_state.empty() ) {
         m_state.startWrite().populateFrom( bc().chainParams().genesisState );
@@ -371,16 +397,15 @@ void Client::appendFromNewPending(
     Guard l( x_filtersWatches );
     io_changed.insert( PendingChangedFilter );
     m_specialFilters.at( PendingChangedFilter ).push_back( _sha3 );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number.
-        auto m = i.second.filter.matches( _receipt );
-        if ( m.size() ) {
-            // filter catches them
-            for ( LogEntry const& l : m )
-                i.second.changes_.push_back( LocalisedLogEntry( l ) );
-            io_changed.insert( i.first );
-        }
-    }
+    // only filters indexed under address or topics of a log can catch it
+    for ( LogEntry const& l : _receipt.log() )
+        m_filterIndex.forEachCandidate( l, [&]( h256 const& _id ) {
+            auto it = m_filters.find( _id );
+            if ( it == m_filters.end() || !it->second.filter.matches( l ) )
+                return;
+            it->second.changes_.push_back( LocalisedLogEntry( l ) );
+            io_changed.insert( _id );
+        } );
 }
 
 void Client::appendFromBlock( h256 const& _block, BlockPolarity _polarity, h256Hash& io_changed ) {
@@ -390,20 +415,23 @@ void Client::appendFromBlock( h256 const& _block, BlockPolarity _polarity, h256H
     Guard l( x_filtersWatches );
     io_changed.insert( ChainChangedFilter );
     m_specialFilters.at( ChainChangedFilter ).push_back( _block );
-    for ( pair< h256 const, InstalledFilter >& i : m_filters ) {
-        // acceptable number & looks like block may contain a matching log entry.
-        for ( size_t j = 0; j < receipts.size(); j++ ) {
-            auto tr = receipts[j];
-            auto m = i.second.filter.matches( tr );
-            if ( m.size() ) {
-                auto transactionHash = transaction( _block, j ).sha3();
-                // filter catches them
-                for ( LogEntry const& l : m )
-                    i.second.changes_.push_back( LocalisedLogEntry( l, _block,
-                        ( BlockNumber ) bc().number( _block ), transactionHash, j, 0, _polarity ) );
-                io_changed.insert( i.first );
-            }
-        }
+    if ( !m_filterIndex.size() )
+        return;
+    BlockNumber number = ( BlockNumber ) bc().number( _block );
+    for ( size_t j = 0; j < receipts.size(); j++ ) {
+        h256 transactionHash;
+        // only filters indexed under address or topics of a log can catch it
+        for ( LogEntry const& l : receipts[j].log() )
+            m_filterIndex.forEachCandidate( l, [&]( h256 const& _id ) {
+                auto it = m_filters.find( _id );
+                if ( it == m_filters.end() || !it->second.filter.matches( l ) )
+                    return;
+                if ( !transactionHash )
+                    transactionHash = transaction( _block, j ).sha3();
+                it->second.changes_.push_back(
+                    LocalisedLogEntry( l, _block, number, transactionHash, j, 0, _polarity ) );
+                io_changed.insert( _id );
+            } );
     }
 }
 
@@ -548,6 +576,8 @@ size_t Client::importTransactionsAsBlock(
             _timestamp, isSaveLastTxHash, &accumulatedTransactionReceipts );
         sealUnconditionally( false );
         importWorkingBlock( &partialTransactionReceipts );
+        // state of the whole block is made durable with one sync
+        m_state.db()->sync();
 
         if ( bIsPartial )
             cntSucceeded += cntPassed;
@@ -576,6 +606,8 @@ size_t Client::importTransactionsAsBlock(
                     LOG( m_logger ) << "DOING SNAPSHOT: " << block_number;
                     m_debugTracer.tracepoint( "doing_snapshot" );
 
+                    // snapshot copies the state DB files, so they must have all commits
+                    m_state.db()->flush();
                     m_snapshotManager->doSnapshot( block_number );
                 } catch ( SnapshotManager::SnapshotPresent& ex ) {
                     cerror << "WARNING " << dev::nested_exception_what( ex );
@@ -640,6 +672,7 @@ size_t Client::syncTransactions( const Transactions& _transactions, u256 _gasPri
     uint64_t _timestamp, bool isSaveLastTxHash,
     TransactionReceipts* accumulatedTransactionReceipts ) {
     assert( m_skaleHost );
+    tracing::ScopedSpan span( "execute_transactions", _transactions.size() );
 
     // HACK remove block verification and put it directly in blockchain!!
     // TODO remove block verification and put it directly in blockchain!!
@@ -869,6 +902,7 @@ void Client::rejigSealing() {
 }
 
 void Client::sealUnconditionally( bool submitToBlockChain ) {
+    tracing::ScopedSpan span( "seal_block" );
     m_wouldButShouldnot = false;
 
     LOG( m_loggerDetail ) << cc::notice( "Rejigging seal engine..." );
@@ -934,6 +968,7 @@ void Client::sealUnconditionally( bool submitToBlockChain ) {
 
 void Client::importWorkingBlock( TransactionReceipts* partialTransactionReceipts ) {
     DEV_READ_GUARDED( x_working );
+    tracing::ScopedSpan span( "commit_block", m_working.info().number() );
     ImportRoute importRoute = bc().import( m_working, partialTransactionReceipts );
     m_new_block_watch.invoke( m_working );
     onChainChanged( importRoute );
@@ -959,9 +994,12 @@ void Client::noteChanged( h256Hash const& _filters ) {
                     w.second.append_changes( LocalisedLogEntry( SpecialLogEntry, hash ) );
                 }
         }
-    // clear the filters now.
-    for ( auto& i : m_filters )
-        i.second.changes_.clear();
+    // clear the filters now, only ones noted as changed may have collected anything
+    for ( h256 const& h : _filters ) {
+        auto it = m_filters.find( h );
+        if ( it != m_filters.end() )
+            it->second.changes_.clear();
+    }
     for ( auto& i : m_specialFilters )
         i.second.clear();
 }
@@ -1121,6 +1159,7 @@ h256 Client::submitTransaction( TransactionSkeleton const& _t, Secret const& _se
 }
 
 h256 Client::importTransaction( Transaction const& _t ) {
+    tracing::ScopedSpan span( "import_transaction", tracing::hashArg( _t.sha3() ) );
     prepareForTransaction();
 
     // Use the Executive to perform basic validation of the transaction
@@ -1164,14 +1203,73 @@ h256 Client::importTransaction( Transaction const& _t ) {
     return _t.sha3();
 }
 
+std::vector< ImportResult > Client::importTransactionsBatch(
+    Transactions const& _txs, std::vector< std::string >* o_errors ) {
+    prepareForTransaction();
+
+    State state;
+    u256 gasBidPrice;
+
+    DEV_GUARDED( m_blockImportMutex ) {
+        state = this->state().startRead();
+        gasBidPrice = this->gasBidPrice();
+    }
+
+    BlockHeader const header =
+        bc().number() ? this->blockInfo( bc().currentHash() ) : bc().genesis();
+
+    std::vector< ImportResult > ret( _txs.size(), ImportResult::Malformed );
+    if ( o_errors )
+        o_errors->assign( _txs.size(), std::string() );
+    Transactions verified;
+    std::vector< size_t > verifiedIndexes;
+    verified.reserve( _txs.size() );
+    verifiedIndexes.reserve( _txs.size() );
+
+    for ( size_t i = 0; i < _txs.size(); ++i ) {
+        try {
+            const_cast< Transaction& >( _txs[i] )
+                .checkOutExternalGas( chainParams().externalGasDifficulty );
+            Executive::verifyTransaction(
+                _txs[i], header, state, *bc().sealEngine(), 0, gasBidPrice );
+        } catch ( Exception const& _e ) {
+            // name of the exception tells which check failed, e.g. InvalidNonce
+            std::string error = boost::core::demangle( typeid( _e ).name() );
+            LOG( m_loggerDetail ) << "Ignoring invalid transaction in batch (" << error
+                                  << "): " << diagnostic_information( _e );
+            if ( o_errors )
+                ( *o_errors )[i] = move( error );
+            continue;
+        } catch ( std::exception const& _e ) {
+            LOG( m_loggerDetail ) << "Ignoring invalid transaction in batch: " << _e.what();
+            if ( o_errors )
+                ( *o_errors )[i] = _e.what();
+            continue;
+        }
+        verified.push_back( _txs[i] );
+        verifiedIndexes.push_back( i );
+    }
+
+    std::vector< ImportResult > imported = m_tq.importBatch( verified );
+    for ( size_t i = 0; i < imported.size(); ++i ) {
+        ret[verifiedIndexes[i]] = imported[i];
+        if ( imported[i] == ImportResult::Success )
+            m_new_pending_transaction_watch.invoke( verified[i] );
+        else if ( o_errors )
+            ( *o_errors )[verifiedIndexes[i]] = "transaction queue import result " +
+                                                std::to_string( int( imported[i] ) );
+    }
+
+    return ret;
+}
+
 // TODO: remove try/catch, allow exceptions
 ExecutionResult Client::call( Address const& _from, u256 _value, Address _dest, bytes const& _data,
     u256 _gas, u256 _gasPrice, FudgeFactor _ff ) {
     ExecutionResult ret;
     try {
         Block temp = latestBlock();
-        // TODO there can be race conditions between prev and next line!
-        State readStateForLock = temp.mutableState().startRead();
+        temp.startReadState();
         u256 nonce = max< u256 >( temp.transactionsFrom( _from ), m_tq.maxNonce( _from ) );
         u256 gas = _gas == Invalid256 ? gasLimitRemaining() : _gas;
         u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
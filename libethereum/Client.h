@@ -56,6 +56,7 @@
 
 #include <skutils/atomic_shared_ptr.h>
 #include <skutils/multithreading.h>
+#include <skutils/open_metrics.h>
 
 class ConsensusHost;
 
@@ -108,6 +109,14 @@ public:
     /// Imports the given transaction into the transaction queue
     h256 importTransaction( Transaction const& _t ) override;
 
+    /// Imports a batch of transactions (e.g. received from a peer) into the transaction queue.
+    /// State is read once and the queue is locked once for the whole batch.
+    /// @returns import result for each transaction; Malformed if verification failed.
+    /// @param o_errors if given, receives for each transaction that was not imported the reason
+    /// (the failed verification check or the queue's import result), empty for imported ones.
+    std::vector< ImportResult > importTransactionsBatch(
+        Transactions const& _txs, std::vector< std::string >* o_errors = nullptr );
+
     /// Makes the given call. Nothing is recorded into the state.
     ExecutionResult call( Address const& _secret, u256 _value, Address _dest, bytes const& _data,
         u256 _gas, u256 _gasPrice, FudgeFactor _ff = FudgeFactor::Strict ) override;
@@ -413,6 +422,7 @@ protected:
                       ///< imported).
     TransactionQueue m_tq;  ///< Maintains a list of incoming transactions not yet in a block on the
                             ///< blockchain.
+    skutils::stats::metrics::collector_id_t m_metricsCollector = 0;  ///< Exports queue depths.
 
     std::shared_ptr< GasPricer > m_gp;  ///< The gas pricer.
 
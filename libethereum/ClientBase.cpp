@@ -221,9 +221,8 @@ LocalisedLogEntries ClientBase::logs( LogFilter const& _f ) const {
     // Handle blocks from main chain
     set< unsigned > matchingBlocks;
     if ( !_f.isRangeFilter() )
-        for ( auto const& i : _f.bloomPossibilities() )
-            for ( auto u : bc().withBlockBloom( i, end, begin ) )
-                matchingBlocks.insert( u );
+        for ( auto u : bc().withBlockBloom( _f.bloomPossibilities(), end, begin ) )
+            matchingBlocks.insert( u );
     else
         // if it is a range filter, we want to get all logs from all blocks in given range
         for ( unsigned i = end; i <= begin; i++ )
@@ -255,10 +254,13 @@ unsigned ClientBase::installWatch(
     h256 h = _f.sha3();
     {
         Guard l( x_filtersWatches );
-        if ( !m_filters.count( h ) ) {
+        auto fit = m_filters.find( h );
+        if ( fit == m_filters.end() ) {
             LOG( m_loggerWatch ) << "FFF" << _f << h;
             m_filters.insert( make_pair( h, _f ) );
-        }
+            m_filterIndex.insert( h, _f );
+        } else
+            ++fit->second.refCount;
     }
     return installWatch( h, _r, fnOnNewChanges, isWS );
 }
@@ -299,6 +301,7 @@ bool ClientBase::uninstallWatch( unsigned _i ) {
     if ( fit != m_filters.end() )
         if ( !--fit->second.refCount ) {
             LOG( m_loggerWatch ) << "*X*" << fit->first << ":" << fit->second.filter;
+            m_filterIndex.erase( fit->first, fit->second.filter );
             m_filters.erase( fit );
         }
     return true;
@@ -25,6 +25,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptors.hpp>
 
+#include <skutils/open_metrics.h>
+
 using namespace dev;
 using namespace eth;
 
@@ -37,6 +39,26 @@ static std::string pairToString( std::pair< std::string const, ValueType > const
 
 }  // namespace
 
+void ImportPerformanceLogger::onStageFinished( std::string const& _name ) {
+    double const elapsed = m_stageTimer.elapsed();
+    m_stages[_name] = elapsed;
+    m_stageTimer.restart();
+    skutils::stats::metrics::histogram( "skaled_block_import_stage_seconds",
+        skutils::stats::metrics::open_metrics_writer::label( "stage", _name ) )
+        .record( uint64_t( elapsed * 1000000.0 ) );
+}
+
+void ImportPerformanceLogger::onFinished(
+    std::unordered_map< std::string, std::string > const& _additionalValues ) {
+    double const totalElapsed = m_totalTimer.elapsed();
+    static skutils::stats::metrics::latency_histogram& s_totalHistogram =
+        skutils::stats::metrics::histogram( "skaled_block_import_seconds" );
+    s_totalHistogram.record( uint64_t( totalElapsed * 1000000.0 ) );
+    if ( totalElapsed > 0.5 ) {
+        cdebug << "SLOW IMPORT: { " << constructReport( totalElapsed, _additionalValues ) << " }";
+    }
+}
+
 std::string ImportPerformanceLogger::constructReport( double _totalElapsed,
     std::unordered_map< std::string, std::string > const& _additionalValues ) {
     static std::string const Separator = ", ";
@@ -34,23 +34,16 @@ namespace eth {
 
 class ImportPerformanceLogger {
 public:
-    void onStageFinished( std::string const& _name ) {
-        m_stages[_name] = m_stageTimer.elapsed();
-        m_stageTimer.restart();
-    }
+    /// Also exported as skaled_block_import_stage_seconds
+    void onStageFinished( std::string const& _name );
 
     double stageDuration( std::string const& _name ) const {
         auto const it = m_stages.find( _name );
         return it != m_stages.end() ? it->second : 0;
     }
 
-    void onFinished( std::unordered_map< std::string, std::string > const& _additionalValues ) {
-        double const totalElapsed = m_totalTimer.elapsed();
-        if ( totalElapsed > 0.5 ) {
-            cdebug << "SLOW IMPORT: { " << constructReport( totalElapsed, _additionalValues )
-                   << " }";
-        }
-    }
+    /// Also exported as skaled_block_import_seconds
+    void onFinished( std::unordered_map< std::string, std::string > const& _additionalValues );
 
 private:
     std::string constructReport( double _totalElapsed,
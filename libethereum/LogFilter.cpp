@@ -57,22 +57,22 @@ bool LogFilter::isRangeFilter() const {
     return true;
 }
 
-bool LogFilter::matches( LogBloom _bloom ) const {
-    if ( m_addresses.size() ) {
-        for ( auto const& i : m_addresses )
-            if ( _bloom.containsBloom< 3 >( dev::sha3( i ) ) )
-                goto OK1;
+LogBloom LogFilter::hashBloom( bytesConstRef _data ) {
+    return LogBloom().shiftBloom< 3 >( dev::sha3( _data ) );
+}
+
+bool LogFilter::matches( LogBloom const& _bloom ) const {
+    auto containsAny = [&]( vector< LogBloom > const& _blooms ) {
+        for ( auto const& b : _blooms )
+            if ( _bloom.contains( b ) )
+                return true;
         return false;
-    }
-OK1:
-    for ( auto const& t : m_topics )
-        if ( t.size() ) {
-            for ( auto const& i : t )
-                if ( _bloom.containsBloom< 3 >( dev::sha3( i ) ) )
-                    goto OK2;
+    };
+    if ( !m_addressBlooms.empty() && !containsAny( m_addressBlooms ) )
+        return false;
+    for ( auto const& t : m_topicBlooms )
+        if ( !t.empty() && !containsAny( t ) )
             return false;
-        OK2:;
-        }
     return true;
 }
 
@@ -84,8 +84,17 @@ vector< LogBloom > LogFilter::bloomPossibilities() const {
     // return combination of each of the addresses/topics
     vector< LogBloom > ret;
 
+    vector< LogBloom > topicBlooms;
+    for ( auto const& t : m_topicBlooms )
+        if ( t.size() ) {
+            LogBloom b;
+            for ( auto const& j : t )
+                b |= j;
+            topicBlooms.push_back( b );
+        }
+
     // | every address with every topic
-    for ( auto const& i : m_addresses ) {
+    for ( auto const& i : m_addressBlooms ) {
         // 1st case, there are addresses and topics
         //
         // m_addresses = [a0, a1];
@@ -96,13 +105,8 @@ vector< LogBloom > LogFilter::bloomPossibilities() const {
         // a1 | t0, a1 | t1a | t1b
         // ]
         //
-        for ( auto const& t : m_topics )
-            if ( t.size() ) {
-                LogBloom b = LogBloom().shiftBloom< 3 >( dev::sha3( i ) );
-                for ( auto const& j : t )
-                    b = b.shiftBloom< 3 >( dev::sha3( j ) );
-                ret.push_back( b );
-            }
+        for ( auto const& t : topicBlooms )
+            ret.push_back( i | t );
     }
 
     // 2nd case, there are no topics
@@ -113,8 +117,7 @@ vector< LogBloom > LogFilter::bloomPossibilities() const {
     // blooms = [a0, a1];
     //
     if ( !ret.size() )
-        for ( auto const& i : m_addresses )
-            ret.push_back( LogBloom().shiftBloom< 3 >( dev::sha3( i ) ) );
+        ret = m_addressBlooms;
 
     // 3rd case, there are no addresses, at least create blooms from topics
     //
@@ -124,13 +127,7 @@ vector< LogBloom > LogFilter::bloomPossibilities() const {
     // blooms = [t0, t1a | t1b];
     //
     if ( !m_addresses.size() )
-        for ( auto const& t : m_topics )
-            if ( t.size() ) {
-                LogBloom b;
-                for ( auto const& j : t )
-                    b = b.shiftBloom< 3 >( dev::sha3( j ) );
-                ret.push_back( b );
-            }
+        ret = topicBlooms;
 
     return ret;
 }
@@ -142,15 +139,18 @@ LogEntries LogFilter::matches( TransactionReceipt const& _m ) const {
 
     LogEntries ret;
     if ( matches( _m.bloom() ) )
-        for ( LogEntry const& e : _m.log() ) {
-            if ( !m_addresses.empty() && !m_addresses.count( e.address ) )
-                goto continue2;
-            for ( unsigned i = 0; i < 4; ++i )
-                if ( !m_topics[i].empty() &&
-                     ( e.topics.size() < i || !m_topics[i].count( e.topics[i] ) ) )
-                    goto continue2;
-            ret.push_back( e );
-        continue2:;
-        }
+        for ( LogEntry const& e : _m.log() )
+            if ( matches( e ) )
+                ret.push_back( e );
     return ret;
 }
+
+bool LogFilter::matches( LogEntry const& _e ) const {
+    if ( !m_addresses.empty() && !m_addresses.count( _e.address ) )
+        return false;
+    for ( unsigned i = 0; i < 4; ++i )
+        if ( !m_topics[i].empty() &&
+             ( _e.topics.size() <= i || !m_topics[i].count( _e.topics[i] ) ) )
+            return false;
+    return true;
+}
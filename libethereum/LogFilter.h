@@ -69,17 +69,23 @@ public:
     /// @returns bloom possibilities for all addresses and topics
     std::vector< LogBloom > bloomPossibilities() const;
 
-    bool matches( LogBloom _bloom ) const;
+    bool matches( LogBloom const& _bloom ) const;
     bool matches( Block const& _b, unsigned _i ) const;
     LogEntries matches( TransactionReceipt const& _r ) const;
+    /// @returns true if addresses and topics of _e satisfy the filter, block range is not checked
+    bool matches( LogEntry const& _e ) const;
+
+    AddressHash const& addresses() const { return m_addresses; }
+    std::array< h256Hash, 4 > const& topics() const { return m_topics; }
 
     LogFilter address( Address _a ) {
-        m_addresses.insert( _a );
+        if ( m_addresses.insert( _a ).second )
+            m_addressBlooms.push_back( hashBloom( _a.ref() ) );
         return *this;
     }
     LogFilter topic( unsigned _index, h256 const& _t ) {
-        if ( _index < 4 )
-            m_topics[_index].insert( _t );
+        if ( _index < 4 && m_topics[_index].insert( _t ).second )
+            m_topicBlooms[_index].push_back( hashBloom( _t.ref() ) );
         return *this;
     }
     LogFilter withEarliest( BlockNumber _e ) {
@@ -94,8 +100,13 @@ public:
     friend std::ostream& dev::eth::operator<<( std::ostream& _out, dev::eth::LogFilter const& _s );
 
 private:
+    static LogBloom hashBloom( bytesConstRef _data );
+
     AddressHash m_addresses;
     std::array< h256Hash, 4 > m_topics;
+    /// Blooms of m_addresses and m_topics, hashed once when they are added
+    std::vector< LogBloom > m_addressBlooms;
+    std::array< std::vector< LogBloom >, 4 > m_topicBlooms;
     BlockNumber m_earliest = 0;
     BlockNumber m_latest = PendingBlock;
 };
@@ -0,0 +1,69 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogFilterIndex.cpp
+ * @date 2020
+ */
+
+#include "LogFilterIndex.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+void LogFilterIndex::insert( h256 const& _id, LogFilter const& _filter ) {
+    ++m_size;
+    if ( !_filter.addresses().empty() ) {
+        for ( Address const& a : _filter.addresses() )
+            m_byAddress[a].insert( _id );
+        return;
+    }
+    for ( size_t i = 0; i < m_byTopic.size(); ++i )
+        if ( !_filter.topics()[i].empty() ) {
+            for ( h256 const& t : _filter.topics()[i] )
+                m_byTopic[i][t].insert( _id );
+            return;
+        }
+    m_any.insert( _id );
+}
+
+void LogFilterIndex::erase( h256 const& _id, LogFilter const& _filter ) {
+    if ( m_size )
+        --m_size;
+    if ( !_filter.addresses().empty() ) {
+        for ( Address const& a : _filter.addresses() )
+            eraseFrom( m_byAddress, a, _id );
+        return;
+    }
+    for ( size_t i = 0; i < m_byTopic.size(); ++i )
+        if ( !_filter.topics()[i].empty() ) {
+            for ( h256 const& t : _filter.topics()[i] )
+                eraseFrom( m_byTopic[i], t, _id );
+            return;
+        }
+    m_any.erase( _id );
+}
+
+void LogFilterIndex::clear() {
+    m_any.clear();
+    m_byAddress.clear();
+    for ( auto& index : m_byTopic )
+        index.clear();
+    m_size = 0;
+}
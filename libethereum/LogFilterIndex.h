@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file LogFilterIndex.h
+ * @date 2020
+ */
+
+#pragma once
+
+#include "LogFilter.h"
+
+#include <array>
+#include <unordered_map>
+
+namespace dev {
+namespace eth {
+
+/**
+ * @brief Inverted index of installed log filters.
+ * Each filter is registered under the values of exactly one of its criteria: its addresses if
+ * any, otherwise its first non-empty topic position; filters without criteria match every log.
+ * Any filter matching a log entry is therefore reachable through the entry's address or one of
+ * its topics, and is returned by forEachCandidate() exactly once. Candidates still have to be
+ * checked with LogFilter::matches().
+ * Not thread-safe, guarded by its owner.
+ */
+class LogFilterIndex {
+public:
+    void insert( h256 const& _id, LogFilter const& _filter );
+    void erase( h256 const& _id, LogFilter const& _filter );
+    void clear();
+
+    template < class F >
+    void forEachCandidate( LogEntry const& _e, F const& _f ) const {
+        for ( h256 const& id : m_any )
+            _f( id );
+        auto itAddress = m_byAddress.find( _e.address );
+        if ( itAddress != m_byAddress.end() )
+            for ( h256 const& id : itAddress->second )
+                _f( id );
+        for ( size_t i = 0; i < _e.topics.size() && i < m_byTopic.size(); ++i ) {
+            auto itTopic = m_byTopic[i].find( _e.topics[i] );
+            if ( itTopic != m_byTopic[i].end() )
+                for ( h256 const& id : itTopic->second )
+                    _f( id );
+        }
+    }
+
+    size_t size() const { return m_size; }
+
+private:
+    template < class Key >
+    static void eraseFrom(
+        std::unordered_map< Key, h256Hash >& _index, Key const& _key, h256 const& _id ) {
+        auto it = _index.find( _key );
+        if ( it == _index.end() )
+            return;
+        it->second.erase( _id );
+        if ( it->second.empty() )
+            _index.erase( it );
+    }
+
+    h256Hash m_any;
+    std::unordered_map< Address, h256Hash > m_byAddress;
+    std::array< std::unordered_map< h256, h256Hash >, 4 > m_byTopic;
+    size_t m_size = 0;
+};
+
+}  // namespace eth
+}  // namespace dev
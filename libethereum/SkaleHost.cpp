@@ -37,6 +37,7 @@ using namespace std;
 #include <libdevcore/FileSystem.h>
 #include <libdevcore/HashingThreadSafeQueue.h>
 #include <libdevcore/RLP.h>
+#include <libdevcore/Tracing.h>
 #include <libethcore/CommonJS.h>
 
 #include <libethereum/ChainParams.h>
@@ -52,6 +53,7 @@ using namespace std;
 #include <libdevcore/microprofile.h>
 
 #include <skutils/console_colors.h>
+#include <skutils/open_metrics.h>
 #include <skutils/task_performance.h>
 #include <skutils/utils.h>
 
@@ -165,6 +167,11 @@ ConsensusExtImpl::ConsensusExtImpl( SkaleHost& _host ) : m_host( _host ) {}
 
 ConsensusExtFace::transactions_vector ConsensusExtImpl::pendingTransactions(
     size_t _limit, u256& _stateRoot ) {
+    static skutils::stats::metrics::latency_histogram& s_histogram =
+        skutils::stats::metrics::histogram( "skaled_consensus_callback_seconds",
+            skutils::stats::metrics::open_metrics_writer::label(
+                "callback", "pendingTransactions" ) );
+    skutils::stats::metrics::scoped_timer timer( s_histogram );
     auto ret = m_host.pendingTransactions( _limit, _stateRoot );
     return ret;
 }
@@ -174,6 +181,10 @@ void ConsensusExtImpl::createBlock(
     uint32_t /*_timeStampMs */, uint64_t _blockID, u256 _gasPrice, u256 _stateRoot,
     uint64_t _winningNodeIndex ) {
     MICROPROFILE_SCOPEI( "ConsensusExtFace", "createBlock", MP_INDIANRED );
+    static skutils::stats::metrics::latency_histogram& s_histogram =
+        skutils::stats::metrics::histogram( "skaled_consensus_callback_seconds",
+            skutils::stats::metrics::open_metrics_writer::label( "callback", "createBlock" ) );
+    skutils::stats::metrics::scoped_timer timer( s_histogram );
     m_host.createBlock(
         _approvedTransactions, _timeStamp, _blockID, _gasPrice, _stateRoot, _winningNodeIndex );
 }
@@ -192,8 +203,10 @@ SkaleHost::SkaleHost( dev::eth::Client& _client, const ConsensusFactory* _consFa
     };
 
     m_debugTracer.call_on_tracepoint( [this]( const std::string& name ) {
-        skutils::task::performance::action action(
-            "trace/" + name, std::to_string( m_debugTracer.get_tracepoint_count( name ) ) );
+        skutils::task::performance::action action;
+        if ( skutils::task::performance::is_tracking() )
+            action.start(
+                "trace/" + name, std::to_string( m_debugTracer.get_tracepoint_count( name ) ) );
 
         // HACK reduce TRACEPOINT log output
         static uint64_t last_block_when_log = -1;
@@ -240,14 +253,15 @@ h256 SkaleHost::receiveTransaction( std::string _rlp ) {
     Transaction transaction( jsToBytes( _rlp, OnFailed::Throw ), CheckTransaction::None );
 
     h256 sha = transaction.sha3();
+    tracing::ScopedSpan span( "receive_transaction", tracing::hashArg( sha ) );
 
     //
-    static std::atomic_size_t g_nReceiveTransactionsTaskNumber = 0;
-    size_t nReceiveTransactionsTaskNumber = g_nReceiveTransactionsTaskNumber++;
-    std::string strPerformanceQueueName = "bc/receive_transaction";
-    std::string strPerformanceActionName =
-        skutils::tools::format( "receive task %zu", nReceiveTransactionsTaskNumber );
-    skutils::task::performance::action a( strPerformanceQueueName, strPerformanceActionName );
+    skutils::task::performance::action a;
+    if ( skutils::task::performance::is_tracking() ) {
+        static std::atomic_size_t g_nReceiveTransactionsTaskNumber = 0;
+        a.start( "bc/receive_transaction",
+            skutils::tools::format( "receive task %zu", g_nReceiveTransactionsTaskNumber++ ) );
+    }
     //
     m_debugTracer.tracepoint( "receive_transaction" );
     {
@@ -270,6 +284,48 @@ h256 SkaleHost::receiveTransaction( std::string _rlp ) {
     return sha;
 }
 
+h256s SkaleHost::receiveTransactionsBatch( const std::vector< bytes >& _rlps ) {
+    Transactions transactions;
+    transactions.reserve( _rlps.size() );
+    for ( const bytes& rlp : _rlps ) {
+        try {
+            transactions.emplace_back( rlp, CheckTransaction::None );
+        } catch ( const std::exception& ex ) {
+            clog( VerbosityInfo, "skale-host" )
+                << "Could not decode transaction received through broadcast: " << ex.what();
+        }
+    }
+
+    tracing::ScopedSpan span( "receive_transactions_batch", transactions.size() );
+    m_debugTracer.tracepoint( "receive_transactions_batch" );
+    {
+        std::lock_guard< std::mutex > localGuard( m_receivedMutex );
+        for ( const Transaction& t : transactions )
+            m_received.insert( t.sha3() );
+        LOG( m_debugLogger ) << "m_received = " << m_received.size() << std::endl;
+    }
+
+    std::vector< std::string > errors;
+    std::vector< ImportResult > results =
+        m_client.importTransactionsBatch( transactions, &errors );
+
+    h256s ret;
+    ret.reserve( transactions.size() );
+    for ( size_t i = 0; i < results.size(); ++i ) {
+        if ( results[i] == ImportResult::Success )
+            ret.push_back( transactions[i].sha3() );
+        else
+            LOG( m_debugLogger ) << "Could not import transaction received through broadcast "
+                                 << transactions[i].sha3() << ": " << errors[i];
+    }
+
+    m_debugTracer.tracepoint( "receive_transactions_batch_success" );
+    LOG( m_debugLogger ) << "Successfully received through broadcast " << ret.size() << " of "
+                         << _rlps.size() << " transactions";
+
+    return ret;
+}
+
 // keeps mutex unlocked when exists
 template < class M >
 class unlock_guard {
@@ -308,6 +364,7 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
     }
 
     MICROPROFILE_SCOPEI( "SkaleHost", "pendingTransactions", MP_LAWNGREEN );
+    tracing::ScopedSpan span( "pending_transactions" );
 
 
     _stateRoot = dev::h256::Arith( this->m_client.latestBlock().info().stateRoot() );
@@ -317,17 +374,15 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
     h256Hash to_delete;
 
     //
-    static std::atomic_size_t g_nFetchTransactionsTaskNumber = 0;
-    size_t nFetchTransactionsTaskNumber = g_nFetchTransactionsTaskNumber++;
-    std::string strPerformanceQueueName_fetch_transactions = "bc/fetch_transactions";
-    std::string strPerformanceActionName_fetch_transactions =
-        skutils::tools::format( "fetch task %zu", nFetchTransactionsTaskNumber );
-    skutils::task::performance::json jsn = skutils::task::performance::json::object();
-    jsn["limit"] = toJS( _limit );
-    jsn["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::action a_fetch_transactions(
-        strPerformanceQueueName_fetch_transactions, strPerformanceActionName_fetch_transactions,
-        jsn );
+    skutils::task::performance::action a_fetch_transactions;
+    if ( skutils::task::performance::is_tracking() ) {
+        static std::atomic_size_t g_nFetchTransactionsTaskNumber = 0;
+        skutils::task::performance::json jsn = skutils::task::performance::json::object();
+        jsn["limit"] = toJS( _limit );
+        jsn["stateRoot"] = toJS( _stateRoot );
+        a_fetch_transactions.start( "bc/fetch_transactions",
+            skutils::tools::format( "fetch task %zu", g_nFetchTransactionsTaskNumber++ ), jsn );
+    }
     //
     m_debugTracer.tracepoint( "fetch_transactions" );
 
@@ -374,21 +429,20 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
     {
         std::lock_guard< std::mutex > localGuard( m_receivedMutex );
         //
-        static std::atomic_size_t g_nDropBadTransactionsTaskNumber = 0;
-        size_t nDropBadTransactionsTaskNumber = g_nDropBadTransactionsTaskNumber++;
-        std::string strPerformanceQueueName_drop_bad_transactions = "bc/fetch_transactions";
-        std::string strPerformanceActionName_drop_bad_transactions =
-            skutils::tools::format( "fetch task %zu", nDropBadTransactionsTaskNumber );
-        skutils::task::performance::json jsn = skutils::task::performance::json::object();
-        skutils::task::performance::json jarrDroppedTransactions =
-            skutils::task::performance::json::array();
-        for ( auto sha : to_delete ) {
-            jarrDroppedTransactions.push_back( toJS( sha ) );
+        skutils::task::performance::action a_drop_bad_transactions;
+        if ( skutils::task::performance::is_tracking() ) {
+            static std::atomic_size_t g_nDropBadTransactionsTaskNumber = 0;
+            skutils::task::performance::json jsn = skutils::task::performance::json::object();
+            skutils::task::performance::json jarrDroppedTransactions =
+                skutils::task::performance::json::array();
+            for ( auto sha : to_delete ) {
+                jarrDroppedTransactions.push_back( toJS( sha ) );
+            }
+            jsn["droppedTransactions"] = jarrDroppedTransactions;
+            a_drop_bad_transactions.start( "bc/fetch_transactions",
+                skutils::tools::format( "fetch task %zu", g_nDropBadTransactionsTaskNumber++ ),
+                jsn );
         }
-        jsn["droppedTransactions"] = jarrDroppedTransactions;
-        skutils::task::performance::action a_drop_bad_transactions(
-            strPerformanceQueueName_drop_bad_transactions,
-            strPerformanceActionName_drop_bad_transactions, jsn );
         //
         for ( auto sha : to_delete ) {
             m_debugTracer.tracepoint( "drop_bad" );
@@ -405,6 +459,8 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
     if ( txns.size() == 0 )
         return out_vector;  // time-out with 0 results
 
+    span.setArg( txns.size() );
+
     try {
         for ( size_t i = 0; i < txns.size(); ++i ) {
             Transaction& txn = txns[i];
@@ -437,6 +493,7 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 #endif
 
             m_debugTracer.tracepoint( "sent_txn" );
+            tracing::mark( "sent_txn", tracing::hashArg( sha ) );
             LOG( m_traceLogger ) << "Sent txn: " << sha << std::endl;
         }
     } catch ( ... ) {
@@ -456,27 +513,34 @@ ConsensusExtFace::transactions_vector SkaleHost::pendingTransactions(
 void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _approvedTransactions,
     uint64_t _timeStamp, uint64_t _blockID, u256 _gasPrice, u256 _stateRoot,
     uint64_t _winningNodeIndex ) try {
+    tracing::ScopedSpan span( "create_block", _blockID );
     //
-    static std::atomic_size_t g_nCreateBlockTaskNumber = 0;
-    size_t nCreateBlockTaskNumber = g_nCreateBlockTaskNumber++;
-    std::string strPerformanceQueueName_create_block = "bc/create_block";
-    std::string strPerformanceActionName_create_block =
-        skutils::tools::format( "b-create %zu", nCreateBlockTaskNumber );
-    skutils::task::performance::json jsn_create_block = skutils::task::performance::json::object();
-    jsn_create_block["blockID"] = toJS( _blockID );
-    jsn_create_block["timeStamp"] = toJS( _timeStamp );
-    jsn_create_block["gasPrice"] = toJS( _gasPrice );
-    jsn_create_block["stateRoot"] = toJS( _stateRoot );
-    skutils::task::performance::json jarrApprovedTransactions =
-        skutils::task::performance::json::array();
-    for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
-        const bytes& data = *it;
-        h256 sha = sha3( data );
-        jarrApprovedTransactions.push_back( toJS( sha ) );
+    // hashes of all arrived transactions are computed in one batch
+    std::vector< bytesConstRef > approvedRefs;
+    approvedRefs.reserve( _approvedTransactions.size() );
+    for ( const bytes& data : _approvedTransactions )
+        approvedRefs.push_back( &data );
+    h256s const approvedHashes = sha3( approvedRefs );
+
+    bool isPerformanceTracking = skutils::task::performance::is_tracking();
+    skutils::task::performance::action a_create_block;
+    if ( isPerformanceTracking ) {
+        static std::atomic_size_t g_nCreateBlockTaskNumber = 0;
+        skutils::task::performance::json jsn_create_block =
+            skutils::task::performance::json::object();
+        jsn_create_block["blockID"] = toJS( _blockID );
+        jsn_create_block["timeStamp"] = toJS( _timeStamp );
+        jsn_create_block["gasPrice"] = toJS( _gasPrice );
+        jsn_create_block["stateRoot"] = toJS( _stateRoot );
+        skutils::task::performance::json jarrApprovedTransactions =
+            skutils::task::performance::json::array();
+        for ( h256 const& sha : approvedHashes )
+            jarrApprovedTransactions.push_back( toJS( sha ) );
+        jsn_create_block["approvedTransactions"] = jarrApprovedTransactions;
+        a_create_block.start( "bc/create_block",
+            skutils::tools::format( "b-create %zu", g_nCreateBlockTaskNumber++ ),
+            jsn_create_block );
     }
-    jsn_create_block["approvedTransactions"] = jarrApprovedTransactions;
-    skutils::task::performance::action a_create_block( strPerformanceQueueName_create_block,
-        strPerformanceActionName_create_block, jsn_create_block );
 
     LOG( m_debugLogger ) << cc::debug( "createBlock " ) << cc::notice( "ID" ) << cc::debug( " = " )
                          << cc::warn( "#" ) << cc::num10( _blockID ) << std::endl;
@@ -539,11 +603,13 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
 
     skutils::task::performance::json jarrProcessedTxns = skutils::task::performance::json::array();
 
-    for ( auto it = _approvedTransactions.begin(); it != _approvedTransactions.end(); ++it ) {
-        const bytes& data = *it;
-        h256 sha = sha3( data );
+    for ( size_t i = 0; i < _approvedTransactions.size(); ++i ) {
+        const bytes& data = _approvedTransactions[i];
+        h256 const& sha = approvedHashes[i];
         LOG( m_traceLogger ) << cc::debug( "Arrived txn: " ) << sha << std::endl;
-        jarrProcessedTxns.push_back( toJS( sha ) );
+        tracing::mark( "arrived_txn", tracing::hashArg( sha ) );
+        if ( isPerformanceTracking )
+            jarrProcessedTxns.push_back( toJS( sha ) );
 #ifdef DEBUG_TX_BALANCE
         if ( sent.count( sha ) != m_transaction_cache.count( sha.asArray() ) ) {
             std::cerr << cc::error( "createBlock assert" ) << std::endl;
@@ -592,15 +658,16 @@ void SkaleHost::createBlock( const ConsensusExtFace::transactions_vector& _appro
     //
     a_create_block.finish();
     //
-    static std::atomic_size_t g_nImportBlockTaskNumber = 0;
-    size_t nImportBlockTaskNumber = g_nImportBlockTaskNumber++;
-    std::string strPerformanceQueueName_import_block = "bc/import_block";
-    std::string strPerformanceActionName_import_block =
-        skutils::tools::format( "b-import %zu", nImportBlockTaskNumber );
-    skutils::task::performance::json jsn_import_block = skutils::task::performance::json::object();
-    jsn_import_block["txns"] = jarrProcessedTxns;
-    skutils::task::performance::action a_import_block( strPerformanceQueueName_import_block,
-        strPerformanceActionName_import_block, jsn_import_block );
+    skutils::task::performance::action a_import_block;
+    if ( isPerformanceTracking ) {
+        static std::atomic_size_t g_nImportBlockTaskNumber = 0;
+        skutils::task::performance::json jsn_import_block =
+            skutils::task::performance::json::object();
+        jsn_import_block["txns"] = jarrProcessedTxns;
+        a_import_block.start( "bc/import_block",
+            skutils::tools::format( "b-import %zu", g_nImportBlockTaskNumber++ ),
+            jsn_import_block );
+    }
     //
     m_debugTracer.tracepoint( "import_block" );
 
@@ -738,11 +805,16 @@ void SkaleHost::broadcastFunc() {
     size_t nBroadcastTaskNumber = 0;
     while ( !m_exitNeeded ) {
         try {
-            m_broadcaster->broadcast( "" );  // HACK this is just to initialize sockets
-
-            dev::eth::Transactions txns = m_tq.topTransactionsSync( 1, 0, 1 );
-            if ( txns.empty() )  // means timeout
+            m_broadcaster->broadcast( bytes() );  // HACK this is just to initialize sockets
+
+            // don't block while a batch is being coalesced - send it as soon as queue is drained
+            dev::eth::Transactions txns = m_broadcaster->pendingCount() > 0 ?
+                                              m_tq.topTransactions( 1, 0, 1 ) :
+                                              m_tq.topTransactionsSync( 1, 0, 1 );
+            if ( txns.empty() ) {  // means timeout or nothing more to coalesce
+                m_broadcaster->flush();
                 continue;
+            }
 
             this->logState();
 
@@ -764,18 +836,18 @@ void SkaleHost::broadcastFunc() {
                     if ( !m_broadcastPauseFlag ) {
                         MICROPROFILE_SCOPEI(
                             "SkaleHost", "broadcastFunc.broadcast", MP_CHARTREUSE1 );
-                        std::string rlp = toJS( txn.rlp() );
-                        std::string h = toJS( txn.sha3() );
+                        bytes rlp = txn.rlp();
                         //
-                        std::string strPerformanceQueueName = "bc/broadcast";
-                        std::string strPerformanceActionName =
-                            skutils::tools::format( "broadcast %zu", nBroadcastTaskNumber++ );
-                        skutils::task::performance::json jsn =
-                            skutils::task::performance::json::object();
-                        jsn["rlp"] = rlp;
-                        jsn["hash"] = h;
-                        skutils::task::performance::action a(
-                            strPerformanceQueueName, strPerformanceActionName, jsn );
+                        skutils::task::performance::action a;
+                        if ( skutils::task::performance::is_tracking() ) {
+                            skutils::task::performance::json jsn =
+                                skutils::task::performance::json::object();
+                            jsn["rlp"] = toJS( rlp );
+                            jsn["hash"] = toJS( txn.sha3() );
+                            a.start( "bc/broadcast",
+                                skutils::tools::format( "broadcast %zu", nBroadcastTaskNumber++ ),
+                                jsn );
+                        }
                         //
                         m_debugTracer.tracepoint( "broadcast" );
                         m_broadcaster->broadcast( rlp );
@@ -818,7 +890,7 @@ void SkaleHost::forceEmptyBlock() {
 }
 
 void SkaleHost::forcedBroadcast( const Transaction& _txn ) {
-    m_broadcaster->broadcast( toJS( _txn.rlp() ) );
+    m_broadcaster->broadcast( _txn.rlp() );
 }
 
 void SkaleHost::noteNewTransactions() {}
@@ -116,6 +116,8 @@ public:
     void onBlockImported( dev::eth::BlockHeader const& _info );
 
     dev::h256 receiveTransaction( std::string );
+    // imports raw RLPs received through broadcast in one go; returns hashes of imported ones
+    dev::h256s receiveTransactionsBatch( const std::vector< dev::bytes >& _rlps );
 
     dev::u256 getGasPrice() const;
 
@@ -137,6 +139,8 @@ public:
 
     SkaleDebugInterface::handler getDebugHandler() const { return m_debugHandler; }
 
+    nlohmann::json getBroadcastStats() const { return m_broadcaster->getStats(); }
+
 private:
     std::atomic_bool working = false;
     std::atomic_bool m_exitedForcefully = false;
@@ -131,6 +131,35 @@ ImportResult TransactionQueue::import( Transaction const& _transaction, IfDroppe
     return ret;
 }
 
+std::vector< ImportResult > TransactionQueue::importBatch(
+    Transactions const& _txs, IfDropped _ik ) {
+    std::vector< ImportResult > ret( _txs.size(), ImportResult::Success );
+    std::vector< h256 > hashes( _txs.size() );
+
+    // Perform EC recovery and hashing outside of the write lock
+    for ( size_t i = 0; i < _txs.size(); ++i ) {
+        Transaction const& t = _txs[i];
+        if ( t.hasZeroSignature() ) {
+            ret[i] = ImportResult::ZeroSignature;
+            continue;
+        }
+        t.safeSender();
+        hashes[i] = t.sha3( WithSignature );
+    }
+
+    MICROPROFILE_SCOPEI( "TransactionQueue", "importBatch", MP_THISTLE );
+    WriteGuard l( m_lock );
+    for ( size_t i = 0; i < _txs.size(); ++i ) {
+        if ( ret[i] != ImportResult::Success )
+            continue;
+        ret[i] = check_WITH_LOCK( hashes[i], _ik );
+        if ( ret[i] != ImportResult::Success )
+            continue;
+        ret[i] = manageImport_WITH_LOCK( hashes[i], _txs[i] );
+    }
+    return ret;
+}
+
 Transactions TransactionQueue::topTransactions( unsigned _limit, h256Hash const& _avoid ) const {
     return topTransactions(
         _limit, [&]( const Transaction& t ) -> bool { return _avoid.count( t.sha3() ) == 0; } );
@@ -144,6 +173,11 @@ Transactions TransactionQueue::topTransactions_WITH_LOCK(
 
 Transactions TransactionQueue::topTransactions(
     unsigned _limit, int _maxCategory, int _setCategory ) {
+    // setting category re-inserts queue nodes so it needs exclusive access
+    if ( _setCategory >= 0 ) {
+        WriteGuard l( m_lock );
+        return topTransactions_WITH_LOCK( _limit, _maxCategory, _setCategory );
+    }
     ReadGuard l( m_lock );
     return topTransactions_WITH_LOCK( _limit, _maxCategory, _setCategory );
 }
@@ -82,6 +82,14 @@ public:
     /// @returns Import result code.
     ImportResult import( Transaction const& _tx, IfDropped _ik = IfDropped::Ignore );
 
+    /// Verify and add a batch of transactions to the queue synchronously. The queue lock is
+    /// acquired once for the whole batch, signatures are recovered before taking it.
+    /// @param _txs Transactions to import, in order.
+    /// @param _ik Set to Retry to force re-addinga transaction that was previously dropped.
+    /// @returns Import result code for each transaction, in the same order as _txs.
+    std::vector< ImportResult > importBatch(
+        Transactions const& _txs, IfDropped _ik = IfDropped::Ignore );
+
     /// Remove transaction from the queue
     /// @param _txHash Trasnaction hash
     void drop( h256 const& _txHash );
@@ -222,7 +222,10 @@ void validateConfigJson( js::mObject const& _obj ) {
             {"maxFileStorageBytes", {{js::int_type}, JsonFieldPresence::Optional}},
             {"maxReservedStorageBytes", {{js::int_type}, JsonFieldPresence::Optional}},
             {"maxSkaledLeveldbStorageBytes", {{js::int_type}, JsonFieldPresence::Optional}},
-            {"freeContractDeployment", {{js::bool_type}, JsonFieldPresence::Optional}}} );
+            {"freeContractDeployment", {{js::bool_type}, JsonFieldPresence::Optional}},
+            {"broadcastBatchMaxBytes", {{js::int_type}, JsonFieldPresence::Optional}},
+            {"broadcastBatchMaxDelayUs", {{js::int_type}, JsonFieldPresence::Optional}},
+            {"stateFormatVersion", {{js::int_type}, JsonFieldPresence::Optional}}} );
 
     js::mArray const& nodes = sChain.at( "nodes" ).get_array();
     for ( auto const& obj : nodes ) {
@@ -24,13 +24,17 @@
 
 #include "OverlayDB.h"
 
+#include <cstring>
 #include <thread>
 
+#include <boost/predef/other/endian.h>
+
 using std::string;
 using std::unordered_map;
 using std::vector;
 
 #include <libdevcore/Common.h>
+#include <libdevcore/RLP.h>
 #include <libdevcore/db.h>
 
 //#include "SHA3.h"
@@ -39,6 +43,7 @@ using dev::bytes;
 using dev::bytesConstRef;
 using dev::h160;
 using dev::h256;
+using dev::s256;
 using dev::u256;
 using dev::db::Slice;
 
@@ -68,13 +73,162 @@ dev::db::Slice toSlice( std::string const& _s ) {
 
 };  // namespace slicing
 
-OverlayDB::OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db )
+namespace {
+
+char const c_formatVersionKey[] = "stateFormatVersion";
+// first key not converted by unfinished migration
+char const c_migrationPositionKey[] = "stateFormatMigrationPosition";
+
+// RLP list of all partial receipts, written by older versions
+char const c_partialReceiptsKey[] = "safeLastTransactionReceipts";
+char const c_partialReceiptCountKey[] = "safeTransactionReceiptsCount";
+
+// prefix followed by 4-byte big-endian index of the receipt
+string partialReceiptKey( size_t _index ) {
+    string key = "safeTransactionReceipt";
+    for ( int shift = 24; shift >= 0; shift -= 8 )
+        key.push_back( static_cast< char >( _index >> shift ) );
+    return key;
+}
+
+size_t const c_wordSize = 32;
+size_t const c_accountRecordSize = 4 * c_wordSize;
+
+bool isAccountKey( Slice _key ) {
+    return _key.size() == h160::size;
+}
+
+bool isStorageKey( Slice _key ) {
+    return _key.size() == h160::size + h256::size;
+}
+
+u256 storageKeyFromSlice( Slice _key ) {
+    return dev::fromBigEndian< u256 >( bytesConstRef(
+        reinterpret_cast< const unsigned char* >( _key.data() ) + h160::size, h256::size ) );
+}
+
+// copies little-endian word straight into limbs of the number
+u256 wordFromLittleEndian( char const* _data ) {
+    u256 ret;
+#if BOOST_ENDIAN_LITTLE_BYTE
+    auto& backend = ret.backend();
+    unsigned const limbs = c_wordSize / sizeof( boost::multiprecision::limb_type );
+    backend.resize( limbs, limbs );
+    std::memcpy( backend.limbs(), _data, c_wordSize );
+    backend.normalize();
+#else
+    for ( size_t i = c_wordSize; i > 0; --i )
+        ret = ( ret << 8 ) | static_cast< unsigned char >( _data[i - 1] );
+#endif
+    return ret;
+}
+
+void wordToLittleEndian( u256 const& _value, char* o_data ) {
+#if BOOST_ENDIAN_LITTLE_BYTE
+    auto const& backend = _value.backend();
+    size_t const size = backend.size() * sizeof( boost::multiprecision::limb_type );
+    std::memcpy( o_data, backend.limbs(), size );
+    std::memset( o_data + size, 0, c_wordSize - size );
+#else
+    u256 value = _value;
+    for ( size_t i = 0; i < c_wordSize; ++i, value >>= 8 )
+        o_data[i] = static_cast< char >( static_cast< unsigned >( value & 0xFF ) );
+#endif
+}
+
+u256 storageValueFromSlice( Slice _value, unsigned _formatVersion ) {
+    if ( _formatVersion == 1 )
+        return dev::fromBigEndian< u256 >( bytesConstRef(
+            reinterpret_cast< const unsigned char* >( _value.data() ), _value.size() ) );
+    if ( _value.empty() )
+        return 0;
+    if ( _value.size() != c_wordSize )
+        BOOST_THROW_EXCEPTION(
+            dev::db::DatabaseError() << dev::errinfo_comment( "Invalid storage value size" ) );
+    return wordFromLittleEndian( _value.data() );
+}
+
+AccountRecord accountFromSlice( Slice _value, unsigned _formatVersion ) {
+    AccountRecord account;
+    if ( _formatVersion == 1 ) {
+        dev::RLP rlp( bytesConstRef(
+            reinterpret_cast< const unsigned char* >( _value.data() ), _value.size() ) );
+        account.nonce = rlp[0].toInt< u256 >();
+        account.balance = rlp[1].toInt< u256 >();
+        account.codeHash = rlp[2].toInt< u256 >();
+        account.storageUsed = rlp[3].toInt< s256 >();
+        return account;
+    }
+    if ( _value.size() != c_accountRecordSize )
+        BOOST_THROW_EXCEPTION(
+            dev::db::DatabaseError() << dev::errinfo_comment( "Invalid account record size" ) );
+    char const* data = _value.data();
+    account.nonce = wordFromLittleEndian( data );
+    account.balance = wordFromLittleEndian( data + c_wordSize );
+    std::memcpy( account.codeHash.data(), data + 2 * c_wordSize, c_wordSize );
+    account.storageUsed = dev::u2s( wordFromLittleEndian( data + 3 * c_wordSize ) );
+    return account;
+}
+
+bytes accountToBytes( AccountRecord const& _account, unsigned _formatVersion ) {
+    if ( _formatVersion == 1 ) {
+        dev::RLPStream rlpStream( 4 );
+        rlpStream << _account.nonce << _account.balance << u256( _account.codeHash )
+                  << _account.storageUsed;
+        return rlpStream.out();
+    }
+    bytes ret( c_accountRecordSize );
+    char* data = reinterpret_cast< char* >( ret.data() );
+    wordToLittleEndian( _account.nonce, data );
+    wordToLittleEndian( _account.balance, data + c_wordSize );
+    std::memcpy( data + 2 * c_wordSize, _account.codeHash.data(), c_wordSize );
+    wordToLittleEndian( dev::s2u( _account.storageUsed ), data + 3 * c_wordSize );
+    return ret;
+}
+
+// @returns 0 if the database is empty
+unsigned readFormatVersion( dev::db::DatabaseFace const& _db ) {
+    std::string const version = _db.lookup( skale::slicing::toSlice( c_formatVersionKey ) );
+    if ( !version.empty() ) {
+        unsigned const ret = std::stoul( version );
+        if ( ret > OverlayDB::c_formatVersion )
+            BOOST_THROW_EXCEPTION( dev::db::DatabaseError() << dev::errinfo_comment(
+                                       "Unsupported state DB format version " + version ) );
+        return ret;
+    }
+    if ( _db.exists( skale::slicing::toSlice( c_migrationPositionKey ) ) )
+        return 1;
+    bool empty = true;
+    _db.forEach( [&empty]( Slice, Slice ) {
+        empty = false;
+        return false;
+    } );
+    return empty ? 0 : 1;
+}
+
+}  // namespace
+
+OverlayDB::OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db, unsigned _formatVersion )
     : m_db( _db.release(), []( dev::db::DatabaseFace* db ) {
           // clog(dev::VerbosityDebug, "overlaydb") << "Closing state DB";
           //        std::cerr << "!!! Closing state DB !!!" << std::endl;
           //        std::cerr.flush();
           delete db;
-      } ) {}
+      } ),
+      m_formatVersion( _formatVersion ) {
+    if ( m_formatVersion == 0 || m_formatVersion > c_formatVersion )
+        BOOST_THROW_EXCEPTION( dev::db::DatabaseError() << dev::errinfo_comment(
+                                   "Unsupported state DB format version " +
+                                   std::to_string( m_formatVersion ) ) );
+    if ( m_db ) {
+        unsigned const version = readFormatVersion( *m_db );
+        if ( version != 0 )
+            m_formatVersion = version;
+        else
+            // absence of the version means format 1
+            m_formatVersionStored = m_formatVersion == 1;
+    }
+}
 
 const OverlayDB::fn_pre_commit_t OverlayDB::g_fn_pre_commit_empty =
     []( std::shared_ptr< dev::db::DatabaseFace > /*db*/,
@@ -98,8 +252,20 @@ dev::h256 OverlayDB::safeLastExecutedTransactionHash() {
 dev::bytes OverlayDB::stat_safePartialTransactionReceipts( dev::db::DatabaseFace* pDB ) {
     dev::bytes partialTransactionReceipts;
     if ( pDB ) {
-        const std::string l =
-            pDB->lookup( skale::slicing::toSlice( "safeLastTransactionReceipts" ) );
+        const std::string count =
+            pDB->lookup( skale::slicing::toSlice( c_partialReceiptCountKey ) );
+        if ( !count.empty() ) {
+            size_t const n = std::stoul( count );
+            dev::RLPStream rlpStream( n );
+            for ( size_t i = 0; i < n; ++i ) {
+                const std::string receipt = pDB->lookup( partialReceiptKey( i ) );
+                rlpStream.appendRaw( bytesConstRef(
+                    reinterpret_cast< unsigned char const* >( receipt.data() ), receipt.size() ) );
+            }
+            return rlpStream.out();
+        }
+
+        const std::string l = pDB->lookup( skale::slicing::toSlice( c_partialReceiptsKey ) );
         if ( !l.empty() )
             partialTransactionReceipts.insert(
                 partialTransactionReceipts.end(), l.begin(), l.end() );
@@ -111,6 +277,26 @@ dev::bytes OverlayDB::safePartialTransactionReceipts() {
     return stat_safePartialTransactionReceipts( m_db.get() );
 }
 
+void OverlayDB::stat_appendPartialTransactionReceipt( dev::db::DatabaseFace const& _db,
+    dev::db::WriteBatchFace& _writeBatch, size_t _count,
+    std::function< dev::bytes( size_t ) > const& _receipt ) {
+    assert( _count > 0 );
+    const std::string count = _db.lookup( skale::slicing::toSlice( c_partialReceiptCountKey ) );
+    size_t const stored = count.empty() ? 0 : std::stoul( count );
+    // journal holds the previous receipts unless this is the first receipt of the block, or the
+    // block is recovered from the old format
+    size_t const first = stored == _count - 1 ? stored : 0;
+    for ( size_t i = first; i < _count; ++i )
+        _writeBatch.insert( partialReceiptKey( i ), skale::slicing::toSlice( _receipt( i ) ) );
+    // left from a longer block
+    for ( size_t i = _count; i < stored; ++i )
+        _writeBatch.kill( partialReceiptKey( i ) );
+    if ( first == 0 && _db.exists( skale::slicing::toSlice( c_partialReceiptsKey ) ) )
+        _writeBatch.kill( skale::slicing::toSlice( c_partialReceiptsKey ) );
+    _writeBatch.insert(
+        skale::slicing::toSlice( c_partialReceiptCountKey ), std::to_string( _count ) );
+}
+
 void OverlayDB::commit() {
     commit( g_fn_pre_commit_empty );
 }
@@ -147,12 +333,24 @@ void OverlayDB::commit( OverlayDB::fn_pre_commit_t fn_pre_commit ) {
                     for ( auto const& stateAddressValuePair : storage ) {
                         h256 const& storageAddress = stateAddressValuePair.first;
                         h256 const& value = stateAddressValuePair.second;
-
-                        writeBatch->insert(
-                            skale::slicing::toSlice( getStorageKey( address, storageAddress ) ),
-                            skale::slicing::toSlice( value ) );
+                        bytes const key = getStorageKey( address, storageAddress );
+
+                        if ( m_formatVersion == 1 )
+                            writeBatch->insert( skale::slicing::toSlice( key ),
+                                skale::slicing::toSlice( value ) );
+                        else if ( !value )
+                            writeBatch->kill( skale::slicing::toSlice( key ) );
+                        else {
+                            char word[c_wordSize];
+                            wordToLittleEndian( u256( value ), word );
+                            writeBatch->insert(
+                                skale::slicing::toSlice( key ), Slice( word, c_wordSize ) );
+                        }
                     }
                 }
+                if ( !m_formatVersionStored )
+                    writeBatch->insert( skale::slicing::toSlice( c_formatVersionKey ),
+                        skale::slicing::toSlice( std::to_string( m_formatVersion ) ) );
                 writeBatch->insert( skale::slicing::toSlice( "storageUsed" ),
                     skale::slicing::toSlice( storageUsed_.str() ) );
             }
@@ -162,6 +360,7 @@ void OverlayDB::commit( OverlayDB::fn_pre_commit_t fn_pre_commit ) {
                     fn_pre_commit( m_db, writeBatch );
                 bIsPreCommitCallbackPassed = true;
                 m_db->commit( std::move( writeBatch ) );
+                m_formatVersionStored = true;
                 break;
             } catch ( boost::exception const& ex ) {
                 if ( commitTry == 9 ) {
@@ -262,49 +461,122 @@ void OverlayDB::insertAuxiliary(
     }
 }
 
-std::unordered_map< h160, string > OverlayDB::accounts() const {
-    unordered_map< h160, string > accounts;
+std::unordered_map< h160, AccountRecord > OverlayDB::accounts() const {
+    unordered_map< h160, AccountRecord > accounts;
     if ( m_db ) {
-        m_db->forEach( [&accounts]( Slice key, Slice value ) {
-            if ( key.size() == h160::size ) {
-                // key is account address
-                string keyString( key.begin(), key.end() );
-                h160 address = h160( keyString, h160::ConstructFromStringType::FromBinary );
-                accounts[address] = string( value.begin(), value.end() );
-            }
-            return true;
-        } );
+        // account record precedes records of its storage and auxiliary data, which share its key
+        // as prefix and are skipped with a seek
+        string begin;
+        for ( bool found = true; found; ) {
+            found = false;
+            m_db->forEachInRange( begin, Slice(), [&]( Slice key, Slice value ) {
+                if ( key.size() < h160::size ) {
+                    // not address-based key
+                    begin.assign( key.begin(), key.end() );
+                    begin.push_back( '\0' );
+                    found = true;
+                    return false;
+                }
+                Slice const prefix( key.data(), h160::size );
+                if ( key.size() == h160::size ) {
+                    // key is account address
+                    h160 address = h160( string( key.begin(), key.end() ),
+                        h160::ConstructFromStringType::FromBinary );
+                    accounts[address] = accountFromSlice( value, m_formatVersion );
+                }
+                begin = dev::db::prefixUpperBound( prefix );
+                found = !begin.empty();
+                return false;
+            } );
+        }
     } else {
         cerror << "Try to load account but connection to database is not established";
     }
     return accounts;
 }
 
+std::pair< std::map< h160, AccountRecord >, boost::optional< h160 > > OverlayDB::accounts(
+    const dev::h160& _begin, size_t _maxResults ) const {
+    std::map< h160, AccountRecord > accounts;
+    boost::optional< h160 > next;
+    if ( m_db ) {
+        // same walk as accounts(), started at _begin and stopped after _maxResults accounts
+        Slice const beginSlice = skale::slicing::toSlice( _begin );
+        string begin( beginSlice.begin(), beginSlice.end() );
+        for ( bool found = true; found; ) {
+            found = false;
+            m_db->forEachInRange( begin, Slice(), [&]( Slice key, Slice value ) {
+                if ( key.size() < h160::size ) {
+                    // not address-based key
+                    begin.assign( key.begin(), key.end() );
+                    begin.push_back( '\0' );
+                    found = true;
+                    return false;
+                }
+                Slice const prefix( key.data(), h160::size );
+                if ( key.size() == h160::size ) {
+                    h160 address = h160( string( key.begin(), key.end() ),
+                        h160::ConstructFromStringType::FromBinary );
+                    if ( accounts.size() == _maxResults ) {
+                        next = address;
+                        return false;
+                    }
+                    accounts[address] = accountFromSlice( value, m_formatVersion );
+                }
+                begin = dev::db::prefixUpperBound( prefix );
+                found = !begin.empty();
+                return false;
+            } );
+        }
+    } else {
+        cerror << "Try to load accounts but connection to database is not established";
+    }
+    return {accounts, next};
+}
+
 std::unordered_map< u256, u256 > OverlayDB::storage( const dev::h160& _address ) const {
     unordered_map< u256, u256 > storage;
     if ( m_db ) {
-        m_db->forEach( [&storage, &_address]( Slice key, Slice value ) {
-            if ( key.size() == h160::size + h256::size ) {
-                // key is storage address
-                string keyString( key.begin(), key.end() );
-                h160 address = h160(
-                    keyString.substr( 0, h160::size ), h160::ConstructFromStringType::FromBinary );
-                if ( address == _address ) {
-                    h256 memoryAddress = h256(
-                        keyString.substr( h160::size ), h256::ConstructFromStringType::FromBinary );
-                    u256 memoryValue = h256( string( value.begin(), value.end() ),
-                        h256::ConstructFromStringType::FromBinary );
-                    storage[memoryAddress] = memoryValue;
+        m_db->forEachInRange( skale::slicing::toSlice( _address ),
+            dev::db::prefixUpperBound( skale::slicing::toSlice( _address ) ),
+            [this, &storage]( Slice key, Slice value ) {
+                if ( isStorageKey( key ) ) {
+                    storage[storageKeyFromSlice( key )] =
+                        storageValueFromSlice( value, m_formatVersion );
                 }
-            }
-            return true;
-        } );
+                return true;
+            } );
     } else {
         cerror << "Try to load account's storage but connection to database is not established";
     }
     return storage;
 }
 
+std::pair< std::map< u256, u256 >, boost::optional< u256 > > OverlayDB::storage(
+    const dev::h160& _address, const u256& _begin, size_t _maxResults ) const {
+    std::map< u256, u256 > storage;
+    boost::optional< u256 > next;
+    if ( m_db ) {
+        bytes const begin = getStorageKey( _address, h256( _begin ) );
+        m_db->forEachInRange( skale::slicing::toSlice( begin ),
+            dev::db::prefixUpperBound( skale::slicing::toSlice( _address ) ),
+            [&]( Slice key, Slice value ) {
+                if ( !isStorageKey( key ) )
+                    return true;
+                u256 const memoryAddress = storageKeyFromSlice( key );
+                if ( storage.size() == _maxResults ) {
+                    next = memoryAddress;
+                    return false;
+                }
+                storage[memoryAddress] = storageValueFromSlice( value, m_formatVersion );
+                return true;
+            } );
+    } else {
+        cerror << "Try to load account's storage but connection to database is not established";
+    }
+    return {storage, next};
+}
+
 void OverlayDB::rollback() {
 #if DEV_GUARDED_DB
     WriteGuard l( x_this );
@@ -324,6 +596,7 @@ void OverlayDB::clearDB() {
         for ( const auto& key : keys ) {
             m_db->kill( key );
         }
+        m_formatVersionStored = m_formatVersion == 1;
     }
 }
 
@@ -358,16 +631,17 @@ dev::bytes OverlayDB::getStorageKey(
     return key;
 }
 
-string OverlayDB::lookup( h160 const& _h ) const {
-    string ret;
-    auto p = m_cache.find( _h );
-    if ( p != m_cache.end() ) {
-        ret = string( p->second.begin(), p->second.end() );
-    }
-    if ( !ret.empty() || !m_db )
-        return ret;
-
-    return m_db->lookup( skale::slicing::toSlice( _h ) );
+boost::optional< AccountRecord > OverlayDB::lookupAccount( h160 const& _address ) const {
+    auto p = m_cache.find( _address );
+    if ( p != m_cache.end() )
+        return accountFromSlice( skale::slicing::toSlice( p->second ), m_formatVersion );
+    if ( !m_db )
+        return boost::none;
+
+    std::string const value = m_db->lookup( skale::slicing::toSlice( _address ) );
+    if ( value.empty() )
+        return boost::none;
+    return accountFromSlice( skale::slicing::toSlice( value ), m_formatVersion );
 }
 
 bool OverlayDB::exists( h160 const& _h ) const {
@@ -391,29 +665,25 @@ void OverlayDB::kill( h160 const& _h ) {
     }
 }
 
-void OverlayDB::insert( const dev::h160& _address, dev::bytesConstRef _value ) {
-    auto it = m_cache.find( _address );
-    if ( it != m_cache.end() ) {
-        it->second = _value.toBytes();
-    } else
-        m_cache[_address] = _value.toBytes();
+void OverlayDB::insertAccount( const dev::h160& _address, AccountRecord const& _account ) {
+    m_cache[_address] = accountToBytes( _account, m_formatVersion );
 }
 
-h256 OverlayDB::lookup( const dev::h160& _address, const dev::h256& _storageAddress ) const {
+u256 OverlayDB::lookup( const dev::h160& _address, const dev::h256& _storageAddress ) const {
     auto address_ptr = m_storageCache.find( _address );
     if ( address_ptr != m_storageCache.end() ) {
         auto storage_ptr = address_ptr->second.find( _storageAddress );
         if ( storage_ptr != address_ptr->second.end() ) {
-            return storage_ptr->second;
+            return u256( storage_ptr->second );
         }
     }
 
     if ( m_db ) {
         string value =
             m_db->lookup( skale::slicing::toSlice( getStorageKey( _address, _storageAddress ) ) );
-        return h256( value, h256::ConstructFromStringType::FromBinary );
+        return storageValueFromSlice( skale::slicing::toSlice( value ), m_formatVersion );
     } else {
-        return h256( 0 );
+        return 0;
     }
 }
 
@@ -443,4 +713,58 @@ void OverlayDB::updateStorageUsage( dev::s256 const& _storageUsed ) {
     storageUsed_ = _storageUsed;
 }
 
+size_t OverlayDB::migrate( size_t _batchSize ) {
+    if ( !m_db || m_formatVersion >= c_formatVersion )
+        return 0;
+    assert( m_cache.empty() && m_storageCache.empty() );
+
+    size_t converted = 0;
+    string begin = m_db->lookup( skale::slicing::toSlice( c_migrationPositionKey ) );
+    for ( bool done = false; !done; ) {
+        auto writeBatch = m_db->createWriteBatch();
+        size_t count = 0;
+        string next;
+        done = true;
+        m_db->forEachInRange( begin, Slice(), [&]( Slice _key, Slice _value ) {
+            if ( count == _batchSize ) {
+                done = false;
+                return false;
+            }
+            ++count;
+            next.assign( _key.begin(), _key.end() );
+            next.push_back( '\0' );
+
+            if ( isAccountKey( _key ) ) {
+                bytes const record =
+                    accountToBytes( accountFromSlice( _value, 1 ), c_formatVersion );
+                writeBatch->insert( _key, skale::slicing::toSlice( record ) );
+            } else if ( isStorageKey( _key ) ) {
+                u256 const value = storageValueFromSlice( _value, 1 );
+                if ( value == 0 )
+                    writeBatch->kill( _key );
+                else {
+                    char word[c_wordSize];
+                    wordToLittleEndian( value, word );
+                    writeBatch->insert( _key, Slice( word, c_wordSize ) );
+                }
+            } else
+                return true;
+            ++converted;
+            return true;
+        } );
+        if ( done ) {
+            writeBatch->insert( skale::slicing::toSlice( c_formatVersionKey ),
+                skale::slicing::toSlice( std::to_string( c_formatVersion ) ) );
+            writeBatch->kill( skale::slicing::toSlice( c_migrationPositionKey ) );
+        } else
+            writeBatch->insert( skale::slicing::toSlice( c_migrationPositionKey ),
+                skale::slicing::toSlice( next ) );
+        m_db->commit( std::move( writeBatch ) );
+        begin = next;
+    }
+    m_formatVersion = c_formatVersion;
+    m_formatVersionStored = true;
+    return converted;
+}
+
 }  // namespace skale
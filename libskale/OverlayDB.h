@@ -25,8 +25,11 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
 #include <libdevcore/db.h>
@@ -43,9 +46,30 @@ dev::db::Slice toSlice( std::string const& _s );
 
 };  // namespace slicing
 
+/// Account fields stored in the state database.
+struct AccountRecord {
+    dev::u256 nonce;
+    dev::u256 balance;
+    dev::h256 codeHash;
+    dev::s256 storageUsed;
+};
+
+/**
+ * State database with write cache.
+ *
+ * Records are keyed by address, address||storage key and address||auxiliary space. Database
+ * format version 1 keeps accounts as RLP and storage values as big-endian words, zeros included.
+ * Version 2 keeps accounts as fixed-width little-endian records, storage values as little-endian
+ * words and does not store zero storage values. New databases use the version given to the
+ * constructor, existing ones keep theirs until converted by migrate().
+ */
 class OverlayDB {
 public:
-    explicit OverlayDB( std::unique_ptr< dev::db::DatabaseFace > _db = nullptr );
+    static constexpr unsigned c_formatVersion = 2;
+
+    /// _formatVersion is used only if the database is empty.
+    explicit OverlayDB(
+        std::unique_ptr< dev::db::DatabaseFace > _db = nullptr, unsigned _formatVersion = 1 );
 
     virtual ~OverlayDB() = default;
 
@@ -58,8 +82,15 @@ public:
 
     static dev::h256 stat_safeLastExecutedTransactionHash( dev::db::DatabaseFace* pDB );
     dev::h256 safeLastExecutedTransactionHash();
+    // @returns RLP list of receipts saved for the partially executed block
     static dev::bytes stat_safePartialTransactionReceipts( dev::db::DatabaseFace* pDB );
     dev::bytes safePartialTransactionReceipts();
+    // Saves receipts of the partially executed block, _count in total, into _writeBatch.
+    // Receipts are journaled one record each, so normally only the last one is written;
+    // _receipt( i ) returns RLP of i-th receipt.
+    static void stat_appendPartialTransactionReceipt( dev::db::DatabaseFace const& _db,
+        dev::db::WriteBatchFace& _writeBatch, size_t _count,
+        std::function< dev::bytes( size_t ) > const& _receipt );
 
     typedef std::function< void( std::shared_ptr< dev::db::DatabaseFace > db,
         std::unique_ptr< dev::db::WriteBatchFace >& writeBatch ) >
@@ -74,12 +105,12 @@ public:
     bool connected() const;
     bool empty() const;
 
-    std::string lookup( dev::h160 const& _address ) const;
+    boost::optional< AccountRecord > lookupAccount( dev::h160 const& _address ) const;
     bool exists( dev::h160 const& _address ) const;
     void kill( dev::h160 const& _address );
-    void insert( dev::h160 const& _address, dev::bytesConstRef _value );
+    void insertAccount( dev::h160 const& _address, AccountRecord const& _account );
 
-    dev::h256 lookup( dev::h160 const& _address, dev::h256 const& _storageAddress ) const;
+    dev::u256 lookup( dev::h160 const& _address, dev::h256 const& _storageAddress ) const;
     bool exists( dev::h160 const& _address, dev::h256 const& _storageAddress ) const;
     void kill( dev::h160 const& _address, dev::h256 const& _storageAddress );
     void insert(
@@ -97,17 +128,38 @@ public:
     /// @returns the set containing all accounts currently in use in Ethereum.
     /// @warning This is slowslowslow. Don't use it unless you want to lock the object for seconds
     /// or minutes at a time.
-    std::unordered_map< dev::h160, std::string > accounts() const;
+    std::unordered_map< dev::h160, AccountRecord > accounts() const;
+
+    /// @returns at most _maxResults accounts with addresses not less than _begin, ordered by
+    /// address, and the address to continue from if there are more accounts.
+    std::pair< std::map< dev::h160, AccountRecord >, boost::optional< dev::h160 > > accounts(
+        dev::h160 const& _begin, size_t _maxResults ) const;
 
     std::unordered_map< dev::u256, dev::u256 > storage( dev::h160 const& address ) const;
 
+    /// @returns at most _maxResults storage records of the account with keys not less than
+    /// _begin, ordered by key, and the key to continue from if there are more records.
+    std::pair< std::map< dev::u256, dev::u256 >, boost::optional< dev::u256 > > storage(
+        dev::h160 const& _address, dev::u256 const& _begin, size_t _maxResults ) const;
+
+    /// @returns format version of records in the database.
+    unsigned formatVersion() const { return m_formatVersion; }
+
+    /// Converts database records to format version c_formatVersion, committing every _batchSize
+    /// records. Can be interrupted and continued later. Must not be called while cache is not
+    /// empty or other OverlayDB objects use the database.
+    /// @returns number of converted records.
+    size_t migrate( size_t _batchSize = 10000 );
+
 private:
-    std::unordered_map< dev::h160, dev::bytes > m_cache;
+    std::unordered_map< dev::h160, dev::bytes > m_cache;  ///< Encoded account records.
     std::unordered_map< dev::h160, std::unordered_map< _byte_, dev::bytes > > m_auxiliaryCache;
     std::unordered_map< dev::h160, std::unordered_map< dev::h256, dev::h256 > > m_storageCache;
     dev::s256 storageUsed_ = 0;
 
     std::shared_ptr< dev::db::DatabaseFace > m_db;
+    unsigned m_formatVersion = 1;
+    bool m_formatVersionStored = true;  ///< false until the version of a new database is committed
 
     dev::bytes getAuxiliaryKey( dev::h160 const& _address, _byte_ space ) const;
     dev::bytes getStorageKey( dev::h160 const& _address, dev::h256 const& _storageAddress ) const;
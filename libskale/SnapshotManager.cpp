@@ -27,6 +27,7 @@
 #include <libdevcore/LevelDB.h>
 #include <libdevcrypto/Hash.h>
 #include <skutils/btrfs.h>
+#include <skutils/open_metrics.h>
 
 #include <boost/interprocess/sync/named_mutex.hpp>
 
@@ -44,6 +45,11 @@ namespace fs = boost::filesystem;
 
 const std::string SnapshotManager::snapshot_hash_file_name = "snapshot_hash.txt";
 
+static skutils::stats::metrics::latency_histogram& snapshotHistogram( const char* _operation ) {
+    return skutils::stats::metrics::histogram( "skaled_snapshot_seconds",
+        skutils::stats::metrics::open_metrics_writer::label( "operation", _operation ) );
+}
+
 // exceptions:
 // - bad data dir
 // - not btrfs
@@ -96,6 +102,7 @@ SnapshotManager::SnapshotManager(
 // - cannot read
 // - cannot write
 void SnapshotManager::doSnapshot( unsigned _blockNumber ) {
+    skutils::stats::metrics::scoped_timer timer( snapshotHistogram( "create" ) );
     fs::path snapshot_dir = snapshots_dir / to_string( _blockNumber );
 
     try {
@@ -158,6 +165,7 @@ boost::filesystem::path SnapshotManager::makeOrGetDiff( unsigned _toBlock ) {
         std::throw_with_nested( CannotRead( ex.path1() ) );
     }
 
+    skutils::stats::metrics::scoped_timer timer( snapshotHistogram( "makeDiff" ) );
     stringstream cat_cmd;
     cat_cmd << "cat ";
     vector< string > created;
@@ -203,6 +211,7 @@ boost::filesystem::path SnapshotManager::makeOrGetDiff( unsigned _toBlock ) {
 // - no such file/cannot read
 // - cannot input as diff (no base state?)
 void SnapshotManager::importDiff( unsigned _toBlock ) {
+    skutils::stats::metrics::scoped_timer timer( snapshotHistogram( "importDiff" ) );
     fs::path diffPath = getDiffPath( _toBlock );
     fs::path snapshot_dir = snapshots_dir / to_string( _toBlock );
 
@@ -550,6 +559,7 @@ void SnapshotManager::computeSnapshotHash( unsigned _blockNumber, bool is_checki
     if ( this->isSnapshotHashPresent( _blockNumber ) ) {
         return;
     }
+    skutils::stats::metrics::scoped_timer timer( snapshotHistogram( "hash" ) );
 
     secp256k1_sha256_t ctx;
     secp256k1_sha256_initialize( &ctx );
@@ -24,13 +24,16 @@
 
 #include "State.h"
 
+#include <chrono>
 #include <mutex>
+#include <set>
 
 #include <boost/filesystem.hpp>
 #include <boost/timer.hpp>
 #include <boost/utility/in_place_factory.hpp>
 
 #include <libdevcore/DBImpl.h>
+#include <libdevcore/DeltaLogDB.h>
 #include <libethcore/SealEngine.h>
 #include <libethereum/CodeSizeCache.h>
 #include <libethereum/Defaults.h>
@@ -40,6 +43,7 @@
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
+#include <skutils/open_metrics.h>
 
 #include <libethereum/BlockDetails.h>
 
@@ -62,12 +66,72 @@ using dev::eth::TransactionReceipt;
 #define ETH_VMTRACE 0
 #endif
 
+struct State::SnapshotCache {
+    std::mutex mutex;
+    std::weak_ptr< skale::OverlayDB > db;
+    size_t version = 0;
+};
+
+namespace {
+
+// snapshots keep old versions of data on disk, so their number is limited; readers started
+// above the limit lock the database instead
+const size_t c_maxLiveSnapshots = 64;
+
+std::mutex x_liveSnapshots;
+std::multiset< std::chrono::steady_clock::time_point > g_liveSnapshotTimes;
+
+void addSnapshotMetrics() {
+    static skutils::stats::metrics::collector_id_t const s_collector =
+        skutils::stats::metrics::add_collector(
+            []( skutils::stats::metrics::open_metrics_writer& _w ) {
+                size_t count;
+                double oldestAge = 0;
+                {
+                    std::lock_guard< std::mutex > lock( x_liveSnapshots );
+                    count = g_liveSnapshotTimes.size();
+                    if ( count > 0 )
+                        oldestAge = std::chrono::duration< double >(
+                            std::chrono::steady_clock::now() - *g_liveSnapshotTimes.begin() )
+                                        .count();
+                }
+                _w.family( "skaled_state_snapshots", "gauge", "Live state read snapshots." );
+                _w.sample( "skaled_state_snapshots", "", uint64_t( count ) );
+                _w.family( "skaled_state_snapshot_oldest_age_seconds", "gauge",
+                    "Age of the oldest live state read snapshot." );
+                _w.sample( "skaled_state_snapshot_oldest_age_seconds", "", oldestAge );
+            } );
+    ( void ) s_collector;
+}
+
+std::shared_ptr< skale::OverlayDB > newSnapshot( db::DatabaseFace const& _db ) {
+    addSnapshotMetrics();
+    std::lock_guard< std::mutex > lock( x_liveSnapshots );
+    if ( g_liveSnapshotTimes.size() >= c_maxLiveSnapshots ) {
+        skutils::stats::metrics::counter( "skaled_state_snapshot_limit_hits" ).add();
+        return nullptr;
+    }
+    std::unique_ptr< db::DatabaseFace > snapshot = _db.snapshot();
+    if ( !snapshot )
+        return nullptr;
+    auto time = g_liveSnapshotTimes.insert( std::chrono::steady_clock::now() );
+    return std::shared_ptr< skale::OverlayDB >(
+        new skale::OverlayDB( std::move( snapshot ) ), [time]( skale::OverlayDB* _db ) {
+            delete _db;
+            std::lock_guard< std::mutex > lock( x_liveSnapshots );
+            g_liveSnapshotTimes.erase( time );
+        } );
+}
+
+}  // namespace
+
 State::State( u256 const& _accountStartNonce, OverlayDB const& _db, BaseState _bs,
     u256 _initialFunds, s256 _storageLimit )
     : x_db_ptr( make_shared< boost::shared_mutex >() ),
       m_db_ptr( make_shared< OverlayDB >( _db ) ),
       m_storedVersion( make_shared< size_t >( 0 ) ),
       m_currentVersion( *m_storedVersion ),
+      m_snapshotCache( make_shared< SnapshotCache >() ),
       m_accountStartNonce( _accountStartNonce ),
       m_initial_funds( _initialFunds ),
       storageLimit_( _storageLimit ) {
@@ -84,8 +148,8 @@ State::State( u256 const& _accountStartNonce, OverlayDB const& _db, BaseState _b
     }
 }
 
-skale::OverlayDB State::openDB(
-    fs::path const& _basePath, h256 const& _genesisHash, WithExisting _we ) {
+skale::OverlayDB State::openDB( fs::path const& _basePath, h256 const& _genesisHash,
+    WithExisting _we, unsigned _formatVersion ) {
     fs::path path = _basePath.empty() ? eth::Defaults::dbPath() : _basePath;
 
     if ( _we == WithExisting::Kill ) {
@@ -99,10 +163,12 @@ skale::OverlayDB State::openDB(
     DEV_IGNORE_EXCEPTIONS( fs::permissions( path, fs::owner_all ) );
 
     fs::path state_path = path / fs::path( "state" );
+    std::unique_ptr< db::DatabaseFace > db;
     try {
-        std::unique_ptr< db::DatabaseFace > db( new db::DBImpl( state_path ) );
+        std::unique_ptr< db::DatabaseFace > stateDB( new db::DBImpl( state_path ) );
+        // state commits go to the delta log next to the state DB, in the same volume
+        db.reset( new db::DeltaLogDB( std::move( stateDB ), path / fs::path( "state.log" ) ) );
         clog( VerbosityDebug, "statedb" ) << cc::success( "Opened state DB." );
-        return OverlayDB( std::move( db ) );
     } catch ( boost::exception const& ex ) {
         cwarn << boost::diagnostic_information( ex ) << '\n';
         if ( fs::space( path / fs::path( "state" ) ).available < 1024 ) {
@@ -117,6 +183,18 @@ skale::OverlayDB State::openDB(
             BOOST_THROW_EXCEPTION( eth::DatabaseAlreadyOpen() );
         }
     }
+
+    skale::OverlayDB overlayDB( std::move( db ), _formatVersion );
+    if ( overlayDB.formatVersion() < _formatVersion ) {
+        clog( VerbosityInfo, "statedb" )
+            << "Converting state DB from format version " << overlayDB.formatVersion();
+        size_t converted = overlayDB.migrate();
+        clog( VerbosityInfo, "statedb" ) << "Converted " << converted << " state DB records";
+    } else if ( overlayDB.formatVersion() > _formatVersion ) {
+        cwarn << "State DB has format version " << overlayDB.formatVersion()
+              << ", newer than configured " << _formatVersion;
+    }
+    return overlayDB;
 }
 
 State::State( const State& _s ) {
@@ -134,6 +212,10 @@ State& State::operator=( const State& _s ) {
     m_db_ptr = _s.m_db_ptr;
     m_storedVersion = _s.m_storedVersion;
     m_currentVersion = _s.m_currentVersion;
+    x_live_db_ptr = _s.x_live_db_ptr;
+    m_live_db_ptr = _s.m_live_db_ptr;
+    m_liveStoredVersion = _s.m_liveStoredVersion;
+    m_snapshotCache = _s.m_snapshotCache;
     m_cache = _s.m_cache;
     m_unchangedCacheEntries = _s.m_unchangedCacheEntries;
     m_nonExistingAccountsCache = _s.m_nonExistingAccountsCache;
@@ -202,12 +284,8 @@ std::unordered_map< Address, u256 > State::addresses() const {
     }
 
     std::unordered_map< Address, u256 > addresses;
-    for ( auto const& h160StringPair : m_db_ptr->accounts() ) {
-        Address const& address = h160StringPair.first;
-        string const& rlpString = h160StringPair.second;
-        RLP account( rlpString );
-        u256 balance = account[1].toInt< u256 >();
-        addresses[address] = balance;
+    for ( auto const& addressAccountPair : m_db_ptr->accounts() ) {
+        addresses[addressAccountPair.first] = addressAccountPair.second.balance;
     }
     for ( auto const& addressAccountPair : m_cache ) {
         addresses[addressAccountPair.first] = addressAccountPair.second.balance();
@@ -223,9 +301,8 @@ std::pair< State::AddressMap, h256 > State::addresses(
     h256 next;
     for ( auto const& pair : balances ) {
         Address const& address = pair.first;
-        auto cache_ptr = m_cache.find( address );
-        if ( cache_ptr != m_cache.end() ) {
-            if ( !cache_ptr->second.isAlive() ) {
+        if ( eth::Account const* cached = m_cache.find( address ) ) {
+            if ( !cached->isAlive() ) {
                 continue;
             }
         }
@@ -241,6 +318,40 @@ std::pair< State::AddressMap, h256 > State::addresses(
     return {addresses, next};
 }
 
+std::pair< std::map< Address, u256 >, boost::optional< Address > > State::addresses(
+    const Address& _begin, size_t _maxResults ) const {
+    boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
+    if ( !checkVersion() ) {
+        cerr << "Current state version is " << m_currentVersion << " but stored version is "
+             << *m_storedVersion << endl;
+        BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
+    }
+
+    std::pair< std::map< Address, AccountRecord >, boost::optional< Address > > accounts =
+        m_db_ptr->accounts( _begin, _maxResults );
+    std::map< Address, u256 > balances;
+    for ( auto const& addressAccountPair : accounts.first )
+        balances[addressAccountPair.first] = addressAccountPair.second.balance;
+    boost::optional< Address >& next = accounts.second;
+    // accounts after the fetched range will be returned with the next part
+    for ( auto const& addressAccountPair : m_cache ) {
+        Address const& address = addressAccountPair.first;
+        if ( address < _begin || ( next && !( address < *next ) ) )
+            continue;
+        if ( addressAccountPair.second.isAlive() )
+            balances[address] = addressAccountPair.second.balance();
+        else
+            balances.erase( address );
+    }
+    if ( balances.size() > _maxResults ) {
+        assert( numeric_limits< long >::max() >= _maxResults );
+        auto next_ptr = std::next( balances.begin(), static_cast< long >( _maxResults ) );
+        next = next_ptr->first;
+        balances.erase( next_ptr, balances.end() );
+    }
+    return {balances, next};
+}
+
 u256 const& State::requireAccountStartNonce() const {
     if ( m_accountStartNonce == Invalid256 )
         BOOST_THROW_EXCEPTION( InvalidAccountStartNonceInState() );
@@ -255,25 +366,29 @@ void State::noteAccountStartNonce( u256 const& _actual ) {
 }
 
 void State::removeEmptyAccounts() {
-    for ( auto& i : m_cache )
+    std::vector< Address > emptyAccounts;
+    for ( auto const& i : m_cache )
         if ( i.second.isDirty() && i.second.isEmpty() )
-            i.second.kill();
+            emptyAccounts.push_back( i.first );
+    for ( Address const& address : emptyAccounts )
+        m_cache.findMutable( address )->kill();
 }
 
-eth::Account const* State::account( Address const& _a ) const {
-    return const_cast< State* >( this )->account( _a );
+eth::Account* State::account( Address const& _a ) {
+    if ( !static_cast< State const* >( this )->account( _a ) )
+        return nullptr;
+    return m_cache.findMutable( _a );
 }
 
-eth::Account* State::account( Address const& _address ) {
-    auto it = m_cache.find( _address );
-    if ( it != m_cache.end() )
-        return &it->second;
+eth::Account const* State::account( Address const& _address ) const {
+    if ( eth::Account const* cached = m_cache.find( _address ) )
+        return cached;
 
     if ( m_nonExistingAccountsCache.count( _address ) )
         return nullptr;
 
     // Populate basic info.
-    bytes stateBack;
+    boost::optional< AccountRecord > stateBack;
     {
         boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
 
@@ -283,26 +398,19 @@ eth::Account* State::account( Address const& _address ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
 
-        stateBack = asBytes( m_db_ptr->lookup( _address ) );
+        stateBack = m_db_ptr->lookupAccount( _address );
     }
-    if ( stateBack.empty() ) {
-        m_nonExistingAccountsCache.insert( _address );
+    if ( !stateBack ) {
+        m_nonExistingAccountsCache.emplace( _address, true );
         return nullptr;
     }
 
     clearCacheIfTooLarge();
 
-    RLP state( stateBack );
-    u256 nonce = state[0].toInt< u256 >();
-    u256 balance = state[1].toInt< u256 >();
-    h256 codeHash = state[2].toInt< u256 >();
-    s256 storageUsed = state[3].toInt< s256 >();
-    // version is 0 if absent from RLP
-    auto const version = state[4] ? state[4].toInt< u256 >() : 0;
-
-    auto i = m_cache.emplace( std::piecewise_construct, std::forward_as_tuple( _address ),
-        std::forward_as_tuple( nonce, balance, EmptyTrie, codeHash, version,
-            dev::eth::Account::Changedness::Unchanged, storageUsed ) );
+    // version is not stored
+    auto i = m_cache.emplace( _address, stateBack->nonce, stateBack->balance, EmptyTrie,
+        stateBack->codeHash, u256( 0 ), dev::eth::Account::Changedness::Unchanged,
+        stateBack->storageUsed );
     m_unchangedCacheEntries.push_back( _address );
     return &i.first->second;
 }
@@ -320,9 +428,9 @@ void State::clearCacheIfTooLarge() const {
         swap( m_unchangedCacheEntries[randomIndex], m_unchangedCacheEntries.back() );
         m_unchangedCacheEntries.pop_back();
 
-        auto cacheEntry = m_cache.find( addr );
-        if ( cacheEntry != m_cache.end() && !cacheEntry->second.isDirty() )
-            m_cache.erase( cacheEntry );
+        eth::Account const* cacheEntry = m_cache.find( addr );
+        if ( cacheEntry && !cacheEntry->isDirty() )
+            m_cache.erase( addr );
     }
 }
 
@@ -349,12 +457,9 @@ void State::commit( CommitBehaviour _commitBehaviour, OverlayDB::fn_pre_commit_t
                     m_db_ptr->killAuxiliary( address, Auxiliary::CODE );
                     // TODO: remove account storage
                 } else {
-                    RLPStream rlpStream( 4 );
-                    rlpStream << account.nonce() << account.balance() << u256( account.codeHash() )
-                              << account.storageUsed();
-                    auto rawValue = rlpStream.out();
-
-                    m_db_ptr->insert( address, ref( rawValue ) );
+                    m_db_ptr->insertAccount( address, {account.nonce(), account.balance(),
+                                                          account.codeHash(),
+                                                          account.storageUsed()} );
 
                     for ( auto const& storageAddressValuePair : account.storageOverlay() ) {
                         const u256& storageAddress = storageAddressValuePair.first;
@@ -512,6 +617,37 @@ std::map< h256, std::pair< u256, u256 > > State::storage( const Address& _contra
     return storage;
 }
 
+std::pair< std::map< u256, u256 >, boost::optional< u256 > > State::storage(
+    const Address& _contract, const u256& _begin, size_t _maxResults ) const {
+    boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
+    if ( !checkVersion() ) {
+        cerr << "Current state version is " << m_currentVersion << " but stored version is "
+             << *m_storedVersion << endl;
+        BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
+    }
+
+    std::pair< std::map< u256, u256 >, boost::optional< u256 > > ret =
+        m_db_ptr->storage( _contract, _begin, _maxResults );
+    std::map< u256, u256 >& storage = ret.first;
+    boost::optional< u256 >& next = ret.second;
+    eth::Account const* cached = m_cache.find( _contract );
+    if ( cached && cached->isDirty() ) {
+        // keys after the fetched range will be returned with the next part
+        for ( auto const& addressValuePair : cached->storageOverlay() ) {
+            u256 const& address = addressValuePair.first;
+            if ( address >= _begin && ( !next || address < *next ) )
+                storage[address] = addressValuePair.second;
+        }
+    }
+    if ( storage.size() > _maxResults ) {
+        assert( numeric_limits< long >::max() >= _maxResults );
+        auto next_ptr = std::next( storage.begin(), static_cast< long >( _maxResults ) );
+        next = next_ptr->first;
+        storage.erase( next_ptr, storage.end() );
+    }
+    return ret;
+}
+
 u256 State::getNonce( Address const& _addr ) const {
     if ( auto a = account( _addr ) )
         return a->nonce();
@@ -535,7 +671,7 @@ u256 State::storage( Address const& _id, u256 const& _key ) const {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
         u256 value = m_db_ptr->lookup( _id, _key );
-        acc->setStorageCache( _key, value );
+        m_cache.findMutable( _id )->setStorageCache( _key, value );
         return value;
     } else
         return 0;
@@ -583,7 +719,7 @@ u256 State::originalStorageValue( Address const& _contract, u256 const& _key ) c
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
         u256 value = m_db_ptr->lookup( _contract, _key );
-        acc->setStorageCache( _key, value );
+        m_cache.findMutable( _contract )->setStorageCache( _key, value );
         return value;
     } else {
         return 0;
@@ -610,12 +746,13 @@ bytes const& State::code( Address const& _addr ) const {
 
     if ( a->code().empty() ) {
         // Load the code from the backend.
-        eth::Account* mutableAccount = const_cast< eth::Account* >( a );
+        eth::Account* mutableAccount = m_cache.findMutable( _addr );
         boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
         if ( !checkVersion() ) {
             BOOST_THROW_EXCEPTION( AttemptToReadFromStateInThePast() );
         }
         mutableAccount->noteCode( m_db_ptr->lookupAuxiliary( _addr, Auxiliary::CODE ) );
+        a = mutableAccount;
         eth::CodeSizeCache::instance().store( a->codeHash(), a->code().size() );
     }
 
@@ -718,15 +855,59 @@ void State::updateToLatestVersion() {
     }
 }
 
-State State::startRead() const {
+State State::liveCopy() const {
     State stateCopy = State( *this );
-    stateCopy.m_db_read_lock.emplace( *stateCopy.x_db_ptr );
+    if ( stateCopy.m_live_db_ptr ) {
+        stateCopy.x_db_ptr = std::move( stateCopy.x_live_db_ptr );
+        stateCopy.m_db_ptr = std::move( stateCopy.m_live_db_ptr );
+        stateCopy.m_storedVersion = std::move( stateCopy.m_liveStoredVersion );
+    }
+    return stateCopy;
+}
+
+bool State::pinSnapshot() {
+    m_db_read_lock = boost::none;
+    std::shared_ptr< db::DatabaseFace > liveDB = m_db_ptr ? m_db_ptr->db() : nullptr;
+    if ( !liveDB || !m_snapshotCache )
+        return false;
+
+    std::shared_ptr< skale::OverlayDB > snapshot;
+    size_t version;
+    {
+        boost::shared_lock< boost::shared_mutex > lock( *x_db_ptr );
+        version = *m_storedVersion;
+        std::lock_guard< std::mutex > cacheLock( m_snapshotCache->mutex );
+        snapshot = m_snapshotCache->db.lock();
+        if ( !snapshot || m_snapshotCache->version != version ) {
+            snapshot = newSnapshot( *liveDB );
+            if ( !snapshot )
+                return false;
+            m_snapshotCache->db = snapshot;
+            m_snapshotCache->version = version;
+        }
+    }
+
+    x_live_db_ptr = std::move( x_db_ptr );
+    m_live_db_ptr = std::move( m_db_ptr );
+    m_liveStoredVersion = std::move( m_storedVersion );
+    // nobody writes to the snapshot, so its lock is never contended
+    x_db_ptr = make_shared< boost::shared_mutex >();
+    m_db_ptr = std::move( snapshot );
+    m_storedVersion = make_shared< size_t >( version );
+    m_currentVersion = version;
+    return true;
+}
+
+State State::startRead() const {
+    State stateCopy = liveCopy();
+    if ( !stateCopy.pinSnapshot() )
+        stateCopy.m_db_read_lock.emplace( *stateCopy.x_db_ptr );
     stateCopy.updateToLatestVersion();
     return stateCopy;
 }
 
 State State::startWrite() const {
-    State stateCopy = State( *this );
+    State stateCopy = liveCopy();
     stateCopy.m_db_write_lock.emplace( *stateCopy.x_db_ptr );
     stateCopy.updateToLatestVersion();
     return stateCopy;
@@ -754,6 +935,8 @@ State State::startNew() {
     State copy;
     if ( m_db_write_lock )
         copy = delegateWrite();
+    else if ( m_live_db_ptr || m_db_read_lock )
+        return startRead();
     else
         copy = State( *this );
     if ( m_db_read_lock )
@@ -841,7 +1024,7 @@ std::pair< ExecutionResult, TransactionReceipt > State::execute( EnvInfo const&
         removeEmptyAccounts = _envInfo.number() >= _sealEngine.chainParams().EIP158ForkBlock;
         commit( removeEmptyAccounts ? State::CommitBehaviour::RemoveEmptyAccounts :
                                       State::CommitBehaviour::KeepEmptyAccounts,
-            [&]( std::shared_ptr< dev::db::DatabaseFace > /*db*/,
+            [&]( std::shared_ptr< dev::db::DatabaseFace > db,
                 std::unique_ptr< dev::db::WriteBatchFace >& writeBatch ) {
                 if ( isSaveLastTxHash ) {
                     h256 shaLastTx = _t.sha3();  // _t.hasSignature() ? _t.sha3() : _t.sha3(
@@ -860,14 +1043,10 @@ std::pair< ExecutionResult, TransactionReceipt > State::execute( EnvInfo const&
                                     EmptyTrie, startGasUsed + e.gasUsed(), e.logs() );
                         receipt.setRevertReason( strRevertReason );
                         accumulatedTransactionReceipts->push_back( receipt );
-                        dev::eth::BlockReceipts blockReceipts;
-                        for ( unsigned i = 0; i < accumulatedTransactionReceipts->size(); ++i )
-                            blockReceipts.receipts.push_back(
-                                ( *accumulatedTransactionReceipts )[i] );
-                        bytes const receipts = blockReceipts.rlp();
-                        writeBatch->insert(
-                            skale::slicing::toSlice( "safeLastTransactionReceipts" ),
-                            skale::slicing::toSlice( receipts ) );
+                        skale::OverlayDB::stat_appendPartialTransactionReceipt( *db, *writeBatch,
+                            accumulatedTransactionReceipts->size(), [&]( size_t _index ) {
+                                return ( *accumulatedTransactionReceipts )[_index].rlp();
+                            } );
                     }
                 }
             } );
@@ -932,8 +1111,7 @@ std::ostream& skale::operator<<( std::ostream& _out, State const& _s ) {
         d.insert( i.first );
 
     for ( auto i : d ) {
-        auto it = _s.m_cache.find( i );
-        eth::Account* cache = it != _s.m_cache.end() ? &it->second : nullptr;
+        eth::Account const* cache = _s.m_cache.find( i );
         assert( cache );
 
         if ( cache && !cache->isAlive() )
@@ -31,6 +31,8 @@
 #include <boost/optional.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include <libdevcore/PersistentMap.h>
+#include <libdevcore/PersistentStack.h>
 #include <libethcore/Exceptions.h>
 #include <libethereum/Account.h>
 #include <libethereum/Executive.h>
@@ -178,11 +180,13 @@ public:
     /// than BaseState::PreExisting in order to prepopulate the state.
     explicit State( dev::u256 const& _accountStartNonce, boost::filesystem::path const& _dbPath,
         dev::h256 const& _genesis, BaseState _bs = BaseState::PreExisting,
-        dev::u256 _initialFunds = 0, dev::s256 _storageLimit = 32 )
+        dev::u256 _initialFunds = 0, dev::s256 _storageLimit = 32,
+        unsigned _stateFormatVersion = 1 )
         : State( _accountStartNonce,
               openDB( _dbPath, _genesis,
                   _bs == BaseState::PreExisting ? dev::WithExisting::Trust :
-                                                  dev::WithExisting::Kill ),
+                                                  dev::WithExisting::Kill,
+                  _stateFormatVersion ),
               _bs, _initialFunds, _storageLimit ) {}
 
     State() : State( dev::Invalid256, OverlayDB(), BaseState::Empty ) {}
@@ -213,6 +217,12 @@ public:
     std::pair< AddressMap, dev::h256 > addresses(
         dev::h256 const& _begin, size_t _maxResults ) const;
 
+    /// Get a part of addresses in use and their balances ordered by unhashed addresses.
+    /// @returns map with maximum _maxResults addresses not less than _begin, and the address to
+    /// continue from if there are more.
+    std::pair< std::map< dev::Address, dev::u256 >, boost::optional< dev::Address > > addresses(
+        dev::Address const& _begin, size_t _maxResults ) const;
+
     /// Check if the address is in use.
     bool addressInUse( dev::Address const& _address ) const;
 
@@ -288,6 +298,12 @@ public:
     std::map< dev::h256, std::pair< dev::u256, dev::u256 > > storage(
         dev::Address const& _contract ) const;
 
+    /// Get a part of the storage of an account ordered by unhashed keys.
+    /// @returns map with maximum _maxResults keys not less than _begin and their values, and the
+    /// key to continue from if there are more.
+    std::pair< std::map< dev::u256, dev::u256 >, boost::optional< dev::u256 > > storage(
+        dev::Address const& _contract, dev::u256 const& _begin, size_t _maxResults ) const;
+
     /// Get the code of an account.
     /// @returns bytes() if no account exists at that address.
     /// @warning The reference to the code is only valid until the access to
@@ -342,12 +358,14 @@ public:
     /// Revert all recent changes up to the given @p _savepoint savepoint.
     void rollback( size_t _savepoint );
 
-    ChangeLog const& changeLog() const { return m_changeLog; }
+    ChangeLog changeLog() const { return m_changeLog.toVector(); }
 
     /// Create State copy to get access to data.
     /// Different copies can be safely used in different threads
     /// but single object is not thread safe.
-    /// No one can change state while returned object exists.
+    /// Returned object reads from a snapshot of the latest committed state, so it sees no later
+    /// commits and does not delay them. If the database does not support snapshots or too many
+    /// of them are alive, no one can change state while returned object exists.
     State startRead() const;
 
     /// Create State copy to modify data.
@@ -394,9 +412,10 @@ private:
         dev::s256 _storageLimit = 32 );
 
     /// Open a DB - useful for passing into the constructor & keeping for other states that are
-    /// necessary.
+    /// necessary. A new DB gets records of _formatVersion; an existing one is converted to it
+    /// if it has an older format.
     static OverlayDB openDB( boost::filesystem::path const& _path, dev::h256 const& _genesisHash,
-        dev::WithExisting _we = dev::WithExisting::Trust );
+        dev::WithExisting _we = dev::WithExisting::Trust, unsigned _formatVersion = 1 );
 
     /// Turns all "touched" empty accounts into non-alive accounts.
     void removeEmptyAccounts();
@@ -421,6 +440,13 @@ private:
 
     void updateStorageUsage();
 
+    /// @returns copy of this state that reads from the database its snapshot was taken from
+    State liveCopy() const;
+
+    /// Switches this state to a snapshot of its database at the latest version.
+    /// @returns false if snapshots are not supported or too many of them are alive.
+    bool pinSnapshot();
+
 public:
     bool checkVersion() const;
 
@@ -434,21 +460,28 @@ private:
     std::shared_ptr< OverlayDB > m_db_ptr;  ///< Our overlay for the state.
     std::shared_ptr< size_t > m_storedVersion;
     size_t m_currentVersion;
-    mutable std::unordered_map< dev::Address, dev::eth::Account > m_cache;  ///< Our address cache.
-                                                                            ///< This stores the
-                                                                            ///< states of each
-                                                                            ///< address that has
-                                                                            ///< (or at least might
-                                                                            ///< have) been changed.
+
+    /// Database this state reads a snapshot of, if any.
+    std::shared_ptr< boost::shared_mutex > x_live_db_ptr;
+    std::shared_ptr< OverlayDB > m_live_db_ptr;
+    std::shared_ptr< size_t > m_liveStoredVersion;
+
+    /// Latest snapshot, shared by states that use the same database and version.
+    struct SnapshotCache;
+    std::shared_ptr< SnapshotCache > m_snapshotCache;
+
+    /// Our address cache. This stores the states of each address that has (or at least might
+    /// have) been changed.
+    mutable dev::PersistentMap< dev::Address, dev::eth::Account > m_cache;
     mutable std::vector< dev::Address > m_unchangedCacheEntries;  ///< Tracks entries in m_cache
                                                                   ///< that can potentially be
                                                                   ///< purged if it grows too large.
-    mutable std::set< dev::Address > m_nonExistingAccountsCache;  ///< Tracks addresses that are
-                                                                  ///< known to not exist.
+    /// Tracks addresses that are known to not exist.
+    mutable dev::PersistentMap< dev::Address, bool > m_nonExistingAccountsCache;
     dev::u256 m_accountStartNonce;
 
     friend std::ostream& operator<<( std::ostream& _out, State const& _s );
-    ChangeLog m_changeLog;
+    dev::PersistentStack< Change > m_changeLog;
 
     dev::u256 m_initial_funds = 0;
 
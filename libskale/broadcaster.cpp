@@ -24,6 +24,8 @@
 
 #include "broadcaster.h"
 
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/SHA3.h>
 #include <libethereum/Client.h>
 #include <libethereum/SkaleHost.h>
 #include <libskale/SkaleClient.h>
@@ -32,6 +34,8 @@
 
 #include <zmq.h>
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
 Broadcaster::~Broadcaster() {}
@@ -60,26 +64,81 @@ std::string HttpBroadcaster::getHttpUrl( const dev::eth::sChainNode& node ) {
     return url;
 }
 
-void HttpBroadcaster::broadcast( const std::string& _rlp ) {
+void HttpBroadcaster::broadcast( const dev::bytes& _rlp ) {
     if ( _rlp.empty() )
         return;
 
+    std::string rlp = dev::toJS( _rlp );
     for ( const auto& node : m_nodeClients ) {
-        node->skale_receiveTransaction( _rlp );
+        node->skale_receiveTransaction( rlp );
     }
 }
 
 /////////////////////////////////////////////////////////////////////////
 
+const char ZmqBroadcaster::c_batchMagic[4] = {'S', 'K', 'T', 'B'};
+
+namespace {
+// how many recent transaction hashes are remembered for de-duplication
+constexpr size_t c_seenTransactionsCapacity = 64 * 1024;
+}  // namespace
+
 ZmqBroadcaster::ZmqBroadcaster( dev::eth::Client& _client, SkaleHost& _skaleHost )
     : m_client( _client ),
       m_skaleHost( _skaleHost ),
+      m_batchMaxBytes( _client.chainParams().sChain.broadcastBatchMaxBytes ),
+      m_batchMaxDelay( _client.chainParams().sChain.broadcastBatchMaxDelayUs ),
+      m_seen( c_seenTransactionsCapacity ),
       m_zmq_server_socket( nullptr ),
       m_zmq_client_socket( nullptr ),
       m_need_exit( false ) {
     m_zmq_context = zmq_ctx_new();
 }
 
+dev::bytes ZmqBroadcaster::encodeBatch( const std::vector< dev::bytes >& _rlps ) {
+    size_t size = sizeof( c_batchMagic );
+    for ( const auto& rlp : _rlps )
+        size += 4 + rlp.size();
+
+    dev::bytes ret;
+    ret.reserve( size );
+    ret.assign( c_batchMagic, c_batchMagic + sizeof( c_batchMagic ) );
+    for ( const auto& rlp : _rlps )
+        appendToBatch( ret, dev::bytesConstRef( &rlp ) );
+    return ret;
+}
+
+void ZmqBroadcaster::appendToBatch( dev::bytes& io_batch, dev::bytesConstRef _rlp ) {
+    if ( io_batch.empty() )
+        io_batch.assign( c_batchMagic, c_batchMagic + sizeof( c_batchMagic ) );
+    uint32_t len = _rlp.size();
+    for ( size_t i = 0; i < 4; ++i )
+        io_batch.push_back( ( len >> ( 8 * i ) ) & 0xff );
+    io_batch.insert( io_batch.end(), _rlp.begin(), _rlp.end() );
+}
+
+bool ZmqBroadcaster::decodeBatch(
+    const char* _data, size_t _size, std::vector< dev::bytes >& o_rlps ) {
+    if ( _size < sizeof( c_batchMagic ) ||
+         memcmp( _data, c_batchMagic, sizeof( c_batchMagic ) ) != 0 )
+        return false;
+
+    const uint8_t* p = reinterpret_cast< const uint8_t* >( _data ) + sizeof( c_batchMagic );
+    const uint8_t* end = reinterpret_cast< const uint8_t* >( _data ) + _size;
+    while ( p != end ) {
+        if ( end - p < 4 )
+            throw std::runtime_error( "Truncated broadcast batch header" );
+        uint32_t len = uint32_t( p[0] ) | ( uint32_t( p[1] ) << 8 ) | ( uint32_t( p[2] ) << 16 ) |
+                       ( uint32_t( p[3] ) << 24 );
+        p += 4;
+        if ( size_t( end - p ) < len )
+            throw std::runtime_error( "Truncated broadcast batch payload" );
+        o_rlps.emplace_back( p, p + len );
+        p += len;
+    }
+    return true;
+}
+
 std::string ZmqBroadcaster::getZmqUrl( const dev::eth::sChainNode& node ) const {
     std::string url = "tcp://" + node.ip + ":" + ( node.port + 5 ).str();  // HACK +5
     std::cout << url << std::endl;                                         // todo
@@ -174,15 +233,13 @@ void ZmqBroadcaster::startService() {
                 }
 
                 size_t size = zmq_msg_size( &msg );
-                void* data = zmq_msg_data( &msg );
+                const char* data = static_cast< const char* >( zmq_msg_data( &msg ) );
 
-                std::string str( static_cast< char* >( data ), size );
-
-                try {
-                    m_skaleHost.receiveTransaction( str );
-                } catch ( const std::exception& ex ) {
-                    clog( dev::VerbosityInfo, "skale-host" )
-                        << "Received bad transaction through broadcast: " << ex.what();
+                if ( size >= sizeof( c_batchMagic ) &&
+                     memcmp( data, c_batchMagic, sizeof( c_batchMagic ) ) == 0 ) {
+                    onBatchReceived( data, size );
+                } else {
+                    onTransactionReceived( data, size );
                 }
 
             } catch ( const std::exception& ex ) {
@@ -202,11 +259,70 @@ void ZmqBroadcaster::startService() {
     m_thread = std::thread( func );
 }
 
+void ZmqBroadcaster::onTransactionReceived( const char* _data, size_t _size ) {
+    std::string str( _data, _size );
+
+    try {
+        // transaction hash is hash of its RLP - so check it before decoding
+        dev::h256 hash = dev::sha3( dev::jsToBytes( str, dev::OnFailed::Throw ) );
+        if ( m_seen.contains( hash ) ) {
+            ++m_stats.duplicatesReceived;
+            return;
+        }
+        m_skaleHost.receiveTransaction( str );
+        // only imported ones, so that a later copy of a rejected transaction is tried again
+        m_seen.insert( hash, true );
+    } catch ( const std::exception& ex ) {
+        clog( dev::VerbosityInfo, "skale-host" )
+            << "Received bad transaction through broadcast: " << ex.what();
+    }
+}
+
+void ZmqBroadcaster::onBatchReceived( const char* _data, size_t _size ) {
+    std::vector< dev::bytes > rlps;
+    try {
+        decodeBatch( _data, _size, rlps );
+    } catch ( const std::exception& ex ) {
+        clog( dev::VerbosityInfo, "skale-host" )
+            << "Could not decode transaction batch received through broadcast: " << ex.what();
+        return;
+    }
+
+    size_t received = rlps.size();
+    rlps.erase( std::remove_if( rlps.begin(), rlps.end(),
+                    [this]( const dev::bytes& _rlp ) {
+                        return m_seen.contains( dev::sha3( _rlp ) );
+                    } ),
+        rlps.end() );
+    m_stats.duplicatesReceived += received - rlps.size();
+    if ( rlps.empty() )
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    try {
+        // only imported ones, so that a later copy of a rejected transaction is tried again
+        for ( const dev::h256& hash : m_skaleHost.receiveTransactionsBatch( rlps ) )
+            m_seen.insert( hash, true );
+    } catch ( const std::exception& ex ) {
+        clog( dev::VerbosityInfo, "skale-host" )
+            << "Could not import transaction batch received through broadcast: " << ex.what();
+    }
+    auto us = std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now() - start )
+                  .count();
+
+    ++m_stats.batchesReceived;
+    m_stats.transactionsReceived += rlps.size();
+    m_stats.totalImportUs += us;
+}
+
 // HACK this should be called strictly from thread that calls broadcast()
 void ZmqBroadcaster::stopService() {
     assert( !m_need_exit );
     assert( m_thread.joinable() );
 
+    flush();
+
     int linger = 1;
     zmq_setsockopt( server_socket(), ZMQ_LINGER, &linger, sizeof( linger ) );
     zmq_close( server_socket() );
@@ -216,14 +332,96 @@ void ZmqBroadcaster::stopService() {
     m_thread.join();
 }
 
-void ZmqBroadcaster::broadcast( const std::string& _rlp ) {
+void ZmqBroadcaster::sendMessage( const void* _data, size_t _size ) {
+    int res = zmq_send( server_socket(), const_cast< void* >( _data ), _size, 0 );
+    if ( res <= 0 ) {
+        throw std::runtime_error( "Zmq can't send data" );
+    }
+}
+
+void ZmqBroadcaster::broadcast( const dev::bytes& _rlp ) {
     if ( _rlp.empty() ) {
         server_socket();
+        if ( m_batchCount > 0 &&
+             std::chrono::steady_clock::now() - m_batchStart >= m_batchMaxDelay )
+            flush();
         return;
     }
 
-    int res = zmq_send( server_socket(), const_cast< char* >( _rlp.c_str() ), _rlp.size(), 0 );
-    if ( res <= 0 ) {
-        throw std::runtime_error( "Zmq can't send data" );
+    if ( m_batchMaxBytes == 0 ) {
+        // legacy format is hex
+        std::string rlp = dev::toJS( _rlp );
+        sendMessage( rlp.c_str(), rlp.size() );
+        return;
+    }
+
+    if ( m_batchCount == 0 ) {
+        m_batch.clear();
+        m_batchStart = std::chrono::steady_clock::now();
     }
+    appendToBatch( m_batch, dev::bytesConstRef( &_rlp ) );
+    ++m_batchCount;
+
+    if ( m_batch.size() >= m_batchMaxBytes ||
+         std::chrono::steady_clock::now() - m_batchStart >= m_batchMaxDelay )
+        flush();
+}
+
+void ZmqBroadcaster::flush() {
+    if ( m_batchCount == 0 )
+        return;
+
+    uint64_t latencyUs = std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::steady_clock::now() - m_batchStart )
+                             .count();
+    uint64_t count = m_batchCount;
+    uint64_t size = m_batch.size();
+
+    m_batchCount = 0;
+    sendMessage( m_batch.data(), m_batch.size() );
+    m_batch.clear();
+
+    ++m_stats.batchesSent;
+    m_stats.transactionsSent += count;
+    m_stats.bytesSent += size;
+    m_stats.totalLatencyUs += latencyUs;
+    if ( count > m_stats.maxBatchTransactions )
+        m_stats.maxBatchTransactions = count;
+    if ( size > m_stats.maxBatchBytes )
+        m_stats.maxBatchBytes = size;
+    if ( latencyUs > m_stats.maxLatencyUs )
+        m_stats.maxLatencyUs = latencyUs;
+}
+
+nlohmann::json ZmqBroadcaster::getStats() const {
+    uint64_t batchesSent = m_stats.batchesSent;
+    uint64_t batchesReceived = m_stats.batchesReceived;
+
+    nlohmann::json joSent = nlohmann::json::object();
+    joSent["batches"] = batchesSent;
+    joSent["transactions"] = uint64_t( m_stats.transactionsSent );
+    joSent["bytes"] = uint64_t( m_stats.bytesSent );
+    joSent["avgBatchTransactions"] =
+        batchesSent ? double( m_stats.transactionsSent ) / batchesSent : 0.0;
+    joSent["avgBatchBytes"] = batchesSent ? double( m_stats.bytesSent ) / batchesSent : 0.0;
+    joSent["maxBatchTransactions"] = uint64_t( m_stats.maxBatchTransactions );
+    joSent["maxBatchBytes"] = uint64_t( m_stats.maxBatchBytes );
+    joSent["avgLatencyUs"] = batchesSent ? double( m_stats.totalLatencyUs ) / batchesSent : 0.0;
+    joSent["maxLatencyUs"] = uint64_t( m_stats.maxLatencyUs );
+
+    nlohmann::json joReceived = nlohmann::json::object();
+    joReceived["batches"] = batchesReceived;
+    joReceived["transactions"] = uint64_t( m_stats.transactionsReceived );
+    joReceived["avgBatchTransactions"] =
+        batchesReceived ? double( m_stats.transactionsReceived ) / batchesReceived : 0.0;
+    joReceived["avgImportUs"] =
+        batchesReceived ? double( m_stats.totalImportUs ) / batchesReceived : 0.0;
+    joReceived["duplicatesSuppressed"] = uint64_t( m_stats.duplicatesReceived );
+
+    nlohmann::json jo = nlohmann::json::object();
+    jo["batchMaxBytes"] = m_batchMaxBytes;
+    jo["batchMaxDelayUs"] = uint64_t( m_batchMaxDelay.count() );
+    jo["sent"] = joSent;
+    jo["received"] = joReceived;
+    return jo;
 }
@@ -26,8 +26,14 @@
 #define BROADCASTER_H
 
 
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/LruCache.h>
 #include <libethereum/ChainParams.h>
 
+#include <json.hpp>
+
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
@@ -52,10 +58,17 @@ public:
     Broadcaster() {}
     virtual ~Broadcaster();
 
-    virtual void broadcast( const std::string& _rlp ) = 0;
+    // empty _rlp only initializes sockets and sends what is due
+    virtual void broadcast( const dev::bytes& _rlp ) = 0;
+
+    // sends transactions coalesced by previous broadcast() calls, if any
+    virtual void flush() {}
+    virtual size_t pendingCount() const { return 0; }
 
     virtual void startService() = 0;
     virtual void stopService() = 0;
+
+    virtual nlohmann::json getStats() const { return nlohmann::json::object(); }
 };
 
 class HttpBroadcaster : public Broadcaster {
@@ -63,7 +76,7 @@ public:
     HttpBroadcaster( dev::eth::Client& _client );
     virtual ~HttpBroadcaster() {}
 
-    virtual void broadcast( const std::string& _rlp );
+    virtual void broadcast( const dev::bytes& _rlp );
     virtual void startService() {}
     virtual void stopService() {}
 
@@ -80,15 +93,57 @@ public:
     ZmqBroadcaster( dev::eth::Client& _client, SkaleHost& _skaleHost );
     virtual ~ZmqBroadcaster();
 
-    virtual void broadcast( const std::string& _rlp );
+    virtual void broadcast( const dev::bytes& _rlp );
+    virtual void flush();
+    virtual size_t pendingCount() const { return m_batchCount; }
 
     virtual void startService();
     virtual void stopService();
 
+    virtual nlohmann::json getStats() const;
+
+    // Batched wire format: magic, then for each transaction 4-byte LE length and raw RLP.
+    // Messages without the magic are legacy single hex-encoded transactions.
+    static const char c_batchMagic[4];
+    static dev::bytes encodeBatch( const std::vector< dev::bytes >& _rlps );
+    // appends one transaction to batch, starting it with the magic if it is empty
+    static void appendToBatch( dev::bytes& io_batch, dev::bytesConstRef _rlp );
+    static bool decodeBatch(
+        const char* _data, size_t _size, std::vector< dev::bytes >& o_rlps );  // throws
+
 private:
     dev::eth::Client& m_client;
     SkaleHost& m_skaleHost;
 
+    // batching (touched only from the thread that calls broadcast())
+    size_t m_batchMaxBytes;
+    std::chrono::microseconds m_batchMaxDelay;
+    dev::bytes m_batch;
+    size_t m_batchCount = 0;
+    std::chrono::steady_clock::time_point m_batchStart;
+
+    // hashes of transactions recently received and imported; used to drop duplicates before
+    // they are decoded and imported again (touched only from the receiving thread)
+    dev::LruCache< dev::h256, bool > m_seen;
+
+    void sendMessage( const void* _data, size_t _size );
+    void onBatchReceived( const char* _data, size_t _size );
+    void onTransactionReceived( const char* _data, size_t _size );
+
+    struct BatchStats {
+        std::atomic_uint64_t batchesSent{0};
+        std::atomic_uint64_t transactionsSent{0};
+        std::atomic_uint64_t bytesSent{0};
+        std::atomic_uint64_t maxBatchTransactions{0};
+        std::atomic_uint64_t maxBatchBytes{0};
+        std::atomic_uint64_t totalLatencyUs{0};
+        std::atomic_uint64_t maxLatencyUs{0};
+        std::atomic_uint64_t batchesReceived{0};
+        std::atomic_uint64_t transactionsReceived{0};
+        std::atomic_uint64_t totalImportUs{0};
+        std::atomic_uint64_t duplicatesReceived{0};
+    } m_stats;
+
     void* m_zmq_context;
     mutable void* m_zmq_server_socket;
     mutable void* m_zmq_client_socket;
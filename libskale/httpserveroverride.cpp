@@ -33,6 +33,7 @@
 #include <jsonrpccpp/common/specificationparser.h>
 
 #include <cassert>
+#include <condition_variable>
 #include <cstdlib>
 #include <exception>
 #include <iostream>
@@ -263,152 +264,27 @@ bool checkParamsIsObject(
 
 namespace stats {
 
-typedef skutils::multithreading::recursive_mutex_type mutex_type_stats;
-typedef std::lock_guard< mutex_type_stats > lock_type_stats;
-static skutils::multithreading::recursive_mutex_type g_mtx_stats( "RMTX-NMA-PEER-ALL" );
-
-struct map_method_call_stats_t
-    : public std::map< std::string, skutils::stats::named_event_stats* > {
-    typedef std::map< std::string, skutils::stats::named_event_stats* > my_base_t;
-    void clear() {
-        iterator itWalk = begin(), itEnd = end();
-        for ( ; itWalk != itEnd; ++itWalk ) {
-            skutils::stats::named_event_stats* x = itWalk->second;
-            if ( x )
-                delete x;
-        }
-        my_base_t::clear();
-    }
-    map_method_call_stats_t() = default;
-    ~map_method_call_stats_t() { clear(); }
-    map_method_call_stats_t( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t( map_method_call_stats_t&& ) = delete;
-    map_method_call_stats_t& operator=( const map_method_call_stats_t& ) = delete;
-    map_method_call_stats_t& operator=( map_method_call_stats_t&& ) = delete;
-};
-
-map_method_call_stats_t g_map_method_call_stats;
-map_method_call_stats_t g_map_method_answer_stats;
-map_method_call_stats_t g_map_method_error_stats;
-map_method_call_stats_t g_map_method_exception_stats;
-map_method_call_stats_t g_map_method_traffic_stats_in;
-map_method_call_stats_t g_map_method_traffic_stats_out;
-static size_t g_nSizeDefaultOnQueueAdd = 10;
-
-static skutils::stats::named_event_stats& stat_subsystem_call_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_call_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_call_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_call_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_answer_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_answer_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_answer_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_answer_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_error_queue( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_error_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_error_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_error_stats[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_exception_queue(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    map_method_call_stats_t::iterator itFind = g_map_method_exception_stats.find( strSubSystem ),
-                                      itEnd = g_map_method_exception_stats.end();
-    if ( itFind != itEnd ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_exception_stats[strSubSystem] = x;
-    return ( *x );
-}
-
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_in(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_in.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_in ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_in[strSubSystem] = x;
-    return ( *x );
-}
-static skutils::stats::named_event_stats& stat_subsystem_traffic_queue_out(
-    const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    const auto itFind = g_map_method_traffic_stats_out.find( strSubSystem );
-    if ( itFind != std::end( g_map_method_traffic_stats_out ) ) {
-        skutils::stats::named_event_stats* x = itFind->second;
-        if ( x )
-            return ( *x );
-    }
-    skutils::stats::named_event_stats* x = new skutils::stats::named_event_stats;
-    g_map_method_traffic_stats_out[strSubSystem] = x;
-    return ( *x );
-}
-
+// all counters are sharded per thread, see skutils::stats::metrics
 
 void register_stats_message(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    cq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    cq.event_add( strMethodName );
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_in( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    tq.event_add( strMethodName, nJsonSize );
+    skutils::stats::metrics::method_metrics& mm =
+        skutils::stats::metrics::get( strSubSystem, strMethodName );
+    mm.calls_.add();
+    mm.bytes_recv_.add( nJsonSize );
 }
 void register_stats_answer(
     const char* strSubSystem, const char* strMethodName, const size_t nJsonSize ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    aq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    aq.event_add( strMethodName );
-
-    skutils::stats::named_event_stats& tq = stat_subsystem_traffic_queue_out( strSubSystem );
-    tq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    tq.event_add( strMethodName, nJsonSize );
+    skutils::stats::metrics::method_metrics& mm =
+        skutils::stats::metrics::get( strSubSystem, strMethodName );
+    mm.answers_.add();
+    mm.bytes_sent_.add( nJsonSize );
 }
 void register_stats_error( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_error_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    eq.event_add( strMethodName );
+    skutils::stats::metrics::get( strSubSystem, strMethodName ).errors_.add();
 }
 void register_stats_exception( const char* strSubSystem, const char* strMethodName ) {
-    lock_type_stats lock( g_mtx_stats );
-    skutils::stats::named_event_stats& eq = stat_subsystem_exception_queue( strSubSystem );
-    eq.event_queue_add( strMethodName, g_nSizeDefaultOnQueueAdd );
-    eq.event_add( strMethodName );
+    skutils::stats::metrics::get( strSubSystem, strMethodName ).exceptions_.add();
 }
 
 void register_stats_message( const char* strSubSystem, const nlohmann::json& joMessage ) {
@@ -434,67 +310,7 @@ void register_stats_exception( const char* strSubSystem, const nlohmann::json& j
 }
 
 static nlohmann::json generate_subsystem_stats( const char* strSubSystem ) {
-    lock_type_stats lock( g_mtx_stats );
-    nlohmann::json jo = nlohmann::json::object();
-    skutils::stats::named_event_stats& cq = stat_subsystem_call_queue( strSubSystem );
-    skutils::stats::named_event_stats& aq = stat_subsystem_answer_queue( strSubSystem );
-    skutils::stats::named_event_stats& erq = stat_subsystem_error_queue( strSubSystem );
-    skutils::stats::named_event_stats& exq = stat_subsystem_exception_queue( strSubSystem );
-    skutils::stats::named_event_stats& tq_in = stat_subsystem_traffic_queue_in( strSubSystem );
-    skutils::stats::named_event_stats& tq_out = stat_subsystem_traffic_queue_out( strSubSystem );
-    std::set< std::string > setNames = cq.all_queue_names(), setNames_aq = aq.all_queue_names(),
-                            setNames_erq = erq.all_queue_names(),
-                            setNames_exq = exq.all_queue_names(),
-                            setNames_tq_in = tq_in.all_queue_names(),
-                            setNames_tq_out = tq_out.all_queue_names();
-    std::set< std::string >::const_iterator itNameWalk, itNameEnd;
-    for ( itNameWalk = setNames_aq.cbegin(), itNameEnd = setNames_aq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_erq.cbegin(), itNameEnd = setNames_erq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_exq.cbegin(), itNameEnd = setNames_exq.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_in.cbegin(), itNameEnd = setNames_tq_in.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames_tq_out.cbegin(), itNameEnd = setNames_tq_out.cend();
-          itNameWalk != itNameEnd; ++itNameWalk )
-        setNames.insert( *itNameWalk );
-    for ( itNameWalk = setNames.cbegin(), itNameEnd = setNames.cend(); itNameWalk != itNameEnd;
-          ++itNameWalk ) {
-        const std::string& strMethodName = ( *itNameWalk );
-        size_t nCalls = 0, nAnswers = 0, nErrors = 0, nExceptions = 0;
-        skutils::stats::bytes_count_t nBytesRecv = 0, nBytesSent = 0;
-        skutils::stats::time_point tpNow = skutils::stats::clock::now();
-        double lfCallsPerSecond = cq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nCalls );
-        double lfAnswersPerSecond =
-            aq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nAnswers );
-        double lfErrorsPerSecond =
-            erq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nErrors );
-        double lfExceptionsPerSecond =
-            exq.compute_eps_smooth( strMethodName, tpNow, nullptr, &nExceptions );
-        double lfBytesPerSecondRecv = tq_in.compute_eps_smooth( strMethodName, tpNow, &nBytesRecv );
-        double lfBytesPerSecondSent =
-            tq_out.compute_eps_smooth( strMethodName, tpNow, &nBytesSent );
-        nlohmann::json joMethod = nlohmann::json::object();
-        joMethod["cps"] = lfCallsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["aps"] = lfAnswersPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["erps"] = lfErrorsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["exps"] = lfExceptionsPerSecond / g_nSizeDefaultOnQueueAdd;
-        joMethod["bps_recv"] = lfBytesPerSecondRecv;
-        joMethod["bps_sent"] = lfBytesPerSecondSent;
-        joMethod["calls"] = nCalls;
-        joMethod["answers"] = nAnswers;
-        joMethod["errors"] = nErrors;
-        joMethod["exceptions"] = nExceptions;
-        joMethod["bytes_recv"] = nBytesRecv;
-        joMethod["bytes_sent"] = nBytesSent;
-        jo[strMethodName] = joMethod;
-    }
-    return jo;
+    return skutils::stats::metrics::subsystem_stats( strSubSystem );
 }
 
 };  // namespace stats
@@ -661,6 +477,335 @@ void SkaleStatsSubscriptionManager::unsubscribeAll() {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+SkaleWsSubscriptionFanOut::SkaleWsSubscriptionFanOut()
+    : pSubscriptions_( std::make_shared< subscriptions_t >() ),
+      next_subscription_( 1 ),
+      pLifetime_( std::make_shared< lifetime_t >() ) {}
+SkaleWsSubscriptionFanOut::~SkaleWsSubscriptionFanOut() {
+    stopAsync();
+}
+
+SkaleWsSubscriptionFanOut::subscriptions_ptr_t SkaleWsSubscriptionFanOut::subscriptions() const {
+    lock_type lock( mtx_ );
+    return pSubscriptions_;
+}
+
+void SkaleWsSubscriptionFanOut::publish( const subscriptions_t& subscriptions ) {
+    subscriptions_ptr_t p = std::make_shared< subscriptions_t >( subscriptions );
+    lock_type lock( mtx_ );
+    pSubscriptions_ = p;
+}
+
+void SkaleWsSubscriptionFanOut::async( const std::string& strQueueID, std::function< void() > fn ) {
+    std::shared_ptr< lifetime_t > pLifetime = pLifetime_;
+    skutils::dispatch::async( strQueueID, [pLifetime, fn]() -> void {
+        std::shared_lock< std::shared_mutex > lock( pLifetime->mtx_ );
+        if ( pLifetime->isAlive_ )
+            fn();
+    } );
+}
+
+void SkaleWsSubscriptionFanOut::stopAsync() {
+    std::unique_lock< std::shared_mutex > lock( pLifetime_->mtx_ );
+    pLifetime_->isAlive_ = false;
+}
+
+SkaleWsSubscriptionFanOut::subscription_id_t SkaleWsSubscriptionFanOut::subscribeLogs(
+    SkaleWsSubscriber* pPeer, const dev::eth::LogFilter& logFilter, subscription_id_t idTypeBits ) {
+    lock_type lock( mtx_ );
+    subscriber_t subscriber;
+    subscriber.idSubscription_ = next_subscription_++;
+    subscriber.idSubscriptionPublic_ = subscriber.idSubscription_ | idTypeBits;
+    subscriber.pPeer_ = pPeer;
+    subscriptions_t subscriptions = *pSubscriptions_;
+    log_filter_group_t& group = subscriptions.mapLogFilterGroups_[logFilter.sha3()];
+    group.logFilter_ = logFilter;
+    group.subscribers_.push_back( subscriber );
+    publish( subscriptions );
+    return subscriber.idSubscription_;
+}
+
+SkaleWsSubscriptionFanOut::subscription_id_t SkaleWsSubscriptionFanOut::subscribeNewHeads(
+    SkaleWsSubscriber* pPeer, bool bIncludeTransactions, subscription_id_t idTypeBits ) {
+    lock_type lock( mtx_ );
+    subscriber_t subscriber;
+    subscriber.idSubscription_ = next_subscription_++;
+    subscriber.idSubscriptionPublic_ = subscriber.idSubscription_ | idTypeBits;
+    subscriber.pPeer_ = pPeer;
+    subscriptions_t subscriptions = *pSubscriptions_;
+    ( bIncludeTransactions ? subscriptions.vecNewHeadsWithTransactions_ :
+                             subscriptions.vecNewHeads_ )
+        .push_back( subscriber );
+    publish( subscriptions );
+    return subscriber.idSubscription_;
+}
+
+SkaleWsSubscriptionFanOut::subscription_id_t
+SkaleWsSubscriptionFanOut::subscribeNewPendingTransactions(
+    SkaleWsSubscriber* pPeer, subscription_id_t idTypeBits ) {
+    lock_type lock( mtx_ );
+    subscriber_t subscriber;
+    subscriber.idSubscription_ = next_subscription_++;
+    subscriber.idSubscriptionPublic_ = subscriber.idSubscription_ | idTypeBits;
+    subscriber.pPeer_ = pPeer;
+    subscriptions_t subscriptions = *pSubscriptions_;
+    subscriptions.vecNewPendingTransactions_.push_back( subscriber );
+    publish( subscriptions );
+    return subscriber.idSubscription_;
+}
+
+bool SkaleWsSubscriptionFanOut::unsubscribe( const subscription_id_t& idSubscription ) {
+    lock_type lock( mtx_ );
+    subscriptions_t subscriptions = *pSubscriptions_;
+    auto fnErase = [&]( vec_subscribers_t& vec ) -> bool {
+        for ( auto it = vec.begin(); it != vec.end(); ++it ) {
+            if ( it->idSubscription_ == idSubscription ) {
+                vec.erase( it );
+                return true;
+            }
+        }
+        return false;
+    };
+    bool bFound = fnErase( subscriptions.vecNewHeads_ ) ||
+                  fnErase( subscriptions.vecNewHeadsWithTransactions_ ) ||
+                  fnErase( subscriptions.vecNewPendingTransactions_ );
+    if ( !bFound ) {
+        for ( auto it = subscriptions.mapLogFilterGroups_.begin();
+              it != subscriptions.mapLogFilterGroups_.end(); ++it ) {
+            if ( fnErase( it->second.subscribers_ ) ) {
+                if ( it->second.subscribers_.empty() )
+                    subscriptions.mapLogFilterGroups_.erase( it );
+                bFound = true;
+                break;
+            }
+        }
+    }
+    if ( bFound )
+        publish( subscriptions );
+    return bFound;
+}
+
+void SkaleWsSubscriptionFanOut::fanOut( const char* strSubscriptionType,
+    const vec_subscribers_t& subscribers, const shared_text_t& pResult ) {
+    if ( !pResult )
+        return;
+    ++cntNotificationsSerialized_;
+    std::string strSubscriptionType_( strSubscriptionType );
+    for ( const subscriber_t& subscriber : subscribers ) {
+        skutils::retain_release_ptr< SkaleWsSubscriber > pPeer = subscriber.pPeer_;
+        if ( !pPeer || !pPeer->isConnected() )
+            continue;
+        // slow peer must not grow memory without bounds nor delay others
+        if ( pPeer->nPendingNotifications_ >= g_nMaxPendingNotificationsPerPeer ) {
+            ++cntNotificationsDropped_;
+            closeSlowSubscription( subscriber );
+            continue;
+        }
+        ++pPeer.get_unconst()->nPendingNotifications_;
+        subscription_id_t idSubscription = subscriber.idSubscription_;
+        std::string strSubscription = dev::toJS( subscriber.idSubscriptionPublic_ );
+        async( pPeer->notificationQueueID(), [this, pPeer, idSubscription, strSubscription,
+                                                 pResult, strSubscriptionType_]() -> void {
+            --pPeer.get_unconst()->nPendingNotifications_;
+            // only the envelope is built per peer, the result text is shared
+            std::string strNotification;
+            strNotification.reserve( pResult->size() + 100 );
+            strNotification +=
+                "{\"jsonrpc\":\"2.0\",\"method\":\"eth_subscription\",\"params\":{"
+                "\"subscription\":\"";
+            strNotification += strSubscription;
+            strNotification += "\",\"result\":";
+            strNotification += *pResult;
+            strNotification += "}}";
+            if ( pPeer.get_unconst()->sendNotification( strSubscriptionType_, strNotification ) )
+                ++cntNotificationsSent_;
+            else if ( unsubscribe( idSubscription ) )
+                pPeer.get_unconst()->onSubscriptionClosed( idSubscription );
+        } );
+    }
+}
+
+void SkaleWsSubscriptionFanOut::closeSlowSubscription( const subscriber_t& subscriber ) {
+    // several notifications of one event may see subscription which is already closed
+    if ( !unsubscribe( subscriber.idSubscription_ ) )
+        return;
+    ++cntSubscriptionsClosed_;
+    skutils::retain_release_ptr< SkaleWsSubscriber > pPeer = subscriber.pPeer_;
+    nlohmann::json joError = nlohmann::json::object();
+    joError["code"] = -32000;
+    joError["message"] = "subscription is closed because peer does not read notifications";
+    nlohmann::json joParams = nlohmann::json::object();
+    joParams["subscription"] = dev::toJS( subscriber.idSubscriptionPublic_ );
+    joParams["error"] = joError;
+    nlohmann::json joNotification = nlohmann::json::object();
+    joNotification["jsonrpc"] = "2.0";
+    joNotification["method"] = "eth_subscription";
+    joNotification["params"] = joParams;
+    std::string strNotification = joNotification.dump();
+    subscription_id_t idSubscription = subscriber.idSubscription_;
+    // queued after notifications which were accepted, so peer receives it last
+    async( pPeer->notificationQueueID(), [pPeer, idSubscription, strNotification]() -> void {
+        pPeer.get_unconst()->onSubscriptionClosed( idSubscription );
+        pPeer.get_unconst()->sendNotification( "eth_subscription/error", strNotification );
+    } );
+}
+
+nlohmann::json SkaleWsSubscriptionFanOut::stats() const {
+    subscriptions_ptr_t pSubscriptions = subscriptions();
+    size_t cntLogSubscriptions = 0;
+    for ( const auto& group : pSubscriptions->mapLogFilterGroups_ )
+        cntLogSubscriptions += group.second.subscribers_.size();
+    nlohmann::json joStats = nlohmann::json::object();
+    joStats["logs"] = cntLogSubscriptions;
+    joStats["logFilters"] = pSubscriptions->mapLogFilterGroups_.size();
+    joStats["newHeads"] =
+        pSubscriptions->vecNewHeads_.size() + pSubscriptions->vecNewHeadsWithTransactions_.size();
+    joStats["newPendingTransactions"] = pSubscriptions->vecNewPendingTransactions_.size();
+    joStats["serialized"] = size_t( cntNotificationsSerialized_ );
+    joStats["sent"] = size_t( cntNotificationsSent_ );
+    joStats["dropped"] = size_t( cntNotificationsDropped_ );
+    joStats["closed"] = size_t( cntSubscriptionsClosed_ );
+    return joStats;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkaleWsSubscriptionHub::SkaleWsSubscriptionHub( SkaleServerOverride& sso ) : sso_( sso ) {}
+SkaleWsSubscriptionHub::~SkaleWsSubscriptionHub() {
+    uninstallClientWatches();
+    stopAsync();  // before members used by queued jobs are gone
+}
+
+void SkaleWsSubscriptionHub::installClientWatches() {
+    lock_type lock( mtx_ );
+    auto pEthereum = sso_.ethereum();
+    if ( !pEthereum )
+        return;
+    if ( iwNewBlock_ == unsigned( -1 ) ) {
+        std::function< void( const unsigned& iw, const dev::eth::Block& block ) > fnOnNewBlock =
+            [this]( const unsigned& /*iw*/, const dev::eth::Block& block ) -> void {
+            // called from block import, so only receipts needed by log filters are taken here
+            subscriptions_ptr_t pSubscriptions = subscriptions();
+            if ( pSubscriptions->mapLogFilterGroups_.empty() &&
+                 pSubscriptions->vecNewHeads_.empty() &&
+                 pSubscriptions->vecNewHeadsWithTransactions_.empty() )
+                return;
+            dev::h256 hBlock = block.info().hash();
+            dev::eth::TransactionReceipts receipts;
+            if ( !pSubscriptions->mapLogFilterGroups_.empty() ) {
+                size_t cntTXs = block.pending().size();
+                receipts.reserve( cntTXs );
+                for ( size_t i = 0; i < cntTXs; ++i )
+                    receipts.push_back( block.receipt( unsigned( i ) ) );
+            }
+            async( "ws-subscription-hub",
+                [this, hBlock, receipts]() -> void { onNewBlock( hBlock, receipts ); } );
+        };
+        iwNewBlock_ = pEthereum->installNewBlockWatch( fnOnNewBlock );
+    }
+    if ( iwNewPendingTransaction_ == unsigned( -1 ) ) {
+        std::function< void( const unsigned& iw, const dev::eth::Transaction& t ) >
+            fnOnNewPendingTransaction =
+                [this]( const unsigned& /*iw*/, const dev::eth::Transaction& t ) -> void {
+            if ( subscriptions()->vecNewPendingTransactions_.empty() )
+                return;
+            dev::h256 hTransaction = t.sha3();
+            async( "ws-subscription-hub",
+                [this, hTransaction]() -> void { onNewPendingTransaction( hTransaction ); } );
+        };
+        iwNewPendingTransaction_ =
+            pEthereum->installNewPendingTransactionWatch( fnOnNewPendingTransaction );
+    }
+}
+
+void SkaleWsSubscriptionHub::uninstallClientWatches() {
+    lock_type lock( mtx_ );
+    auto pEthereum = sso_.ethereum();
+    if ( iwNewBlock_ != unsigned( -1 ) ) {
+        if ( pEthereum )
+            pEthereum->uninstallNewBlockWatch( iwNewBlock_ );
+        iwNewBlock_ = unsigned( -1 );
+    }
+    if ( iwNewPendingTransaction_ != unsigned( -1 ) ) {
+        if ( pEthereum )
+            pEthereum->uninstallNewPendingTransactionWatch( iwNewPendingTransaction_ );
+        iwNewPendingTransaction_ = unsigned( -1 );
+    }
+    publish( subscriptions_t() );  // drop peer references
+}
+
+void SkaleWsSubscriptionHub::onNewBlock(
+    const dev::h256& hBlock, const dev::eth::TransactionReceipts& receipts ) {
+    ++cntBlocks_;
+    subscriptions_ptr_t pSubscriptions = subscriptions();
+    try {
+        if ( !pSubscriptions->vecNewHeads_.empty() )
+            fanOut( "eth_subscription/newHeads", pSubscriptions->vecNewHeads_,
+                sso_.serializedBlockJson( hBlock, false ) );
+        if ( !pSubscriptions->vecNewHeadsWithTransactions_.empty() )
+            fanOut( "eth_subscription/newHeads", pSubscriptions->vecNewHeadsWithTransactions_,
+                sso_.serializedBlockJson( hBlock, true ) );
+        if ( pSubscriptions->mapLogFilterGroups_.empty() )
+            return;
+        auto pEthereum = sso_.ethereum();
+        dev::eth::BlockNumber nBlockNumber = pEthereum->numberFromHash( hBlock );
+        dev::eth::TransactionHashes arrTxHashes = pEthereum->transactionHashes( hBlock );
+        dev::eth::LogBloom bloomBlock = pEthereum->blockInfo( hBlock ).logBloom();
+        std::string strBlockHash = dev::toJS( hBlock );
+        // each distinct filter is matched against block once, whatever number of peers use it
+        for ( const auto& group : pSubscriptions->mapLogFilterGroups_ ) {
+            const dev::eth::LogFilter& logFilter = group.second.logFilter_;
+            if ( !logFilter.isRangeFilter() && !logFilter.matches( bloomBlock ) )
+                continue;
+            dev::eth::LocalisedLogEntries le;
+            for ( size_t j = 0; j < receipts.size() && j < arrTxHashes.size(); ++j ) {
+                dev::eth::LogEntries m = logFilter.matches( receipts[j] );
+                for ( const dev::eth::LogEntry& l : m )
+                    le.push_back( dev::eth::LocalisedLogEntry( l, hBlock, nBlockNumber,
+                        arrTxHashes[j], unsigned( j ), 0, dev::eth::BlockPolarity::Live ) );
+            }
+            if ( le.empty() )
+                continue;
+            nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
+            for ( const auto& joRW : joResult ) {
+                for ( const auto& joWalk : joRW["logs"] ) {
+                    nlohmann::json joLog = joWalk;  // copy
+                    joLog["blockHash"] = strBlockHash;
+                    joLog["blockNumber"] = unsigned( nBlockNumber );
+                    fanOut( "eth_subscription/logs", group.second.subscribers_,
+                        std::make_shared< const std::string >( joLog.dump() ) );
+                }
+            }
+        }
+    } catch ( std::exception& ex ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( "WS" ) )
+            << ( cc::error( "error in " ) + cc::warn( "subscription hub" ) +
+                   cc::error( " while handling new block, exception: " ) + cc::warn( ex.what() ) );
+    } catch ( ... ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( "WS" ) )
+            << ( cc::error( "error in " ) + cc::warn( "subscription hub" ) +
+                   cc::error( " while handling new block, unknown exception" ) );
+    }
+}
+
+void SkaleWsSubscriptionHub::onNewPendingTransaction( const dev::h256& hTransaction ) {
+    subscriptions_ptr_t pSubscriptions = subscriptions();
+    if ( pSubscriptions->vecNewPendingTransactions_.empty() )
+        return;
+    fanOut( "eth_subscription/newPendingTransactions", pSubscriptions->vecNewPendingTransactions_,
+        std::make_shared< const std::string >( "\"" + dev::toJS( hTransaction ) + "\"" ) );
+}
+
+nlohmann::json SkaleWsSubscriptionHub::stats() const {
+    nlohmann::json joStats = SkaleWsSubscriptionFanOut::stats();
+    joStats["blocks"] = size_t( cntBlocks_ );
+    return joStats;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 SkaleServerConnectionsTrackHelper::SkaleServerConnectionsTrackHelper( SkaleServerOverride& sso )
     : m_sso( sso ) {
     m_sso.connection_counter_inc();
@@ -766,6 +911,10 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
         skutils::dispatch::remove( m_strPeerQueueID );  // remove queue earlier
         return;
     }
+    if ( eOpCode == skutils::ws::opcv::binary && isBinaryRawTransactionsFrame( msg ) ) {
+        handleBinaryRawTransactions( msg );
+        return;
+    }
     if ( eOpCode != skutils::ws::opcv::text ) {
         // throw std::runtime_error( "only ws text messages are supported" );
         clog( dev::VerbosityWarning, cc::info( getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
@@ -825,8 +974,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
         joErrorResponce["result"] = "error";
         joErrorResponce["error"] = std::string( e );
         std::string strResponse = joErrorResponce.dump();
-        stats::register_stats_exception(
-            ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(), "messages" );
+        stats::register_stats_exception( pThis->getRelay().statsSubSystem().c_str(), "messages" );
         stats::register_stats_exception( pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
         // stats::register_stats_exception( "RPC", strMethod.c_str() );
         pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
@@ -864,8 +1012,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
         joErrorResponce["result"] = "error";
         joErrorResponce["error"] = std::string( e );
         std::string strResponse = joErrorResponce.dump();
-        stats::register_stats_exception(
-            ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(), "messages" );
+        stats::register_stats_exception( pThis->getRelay().statsSubSystem().c_str(), "messages" );
         stats::register_stats_exception( pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
         // stats::register_stats_exception( "RPC", strMethod.c_str() );
         pThis.get_unconst()->sendMessage( skutils::tools::trim_copy( strResponse ) );
@@ -880,31 +1027,31 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
     }  // switch( ehldr )
     //
     // WS-processing-lambda
-    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO,
-                                     isBatch]() -> void {  // WS-processing-lambda
+    size_t nMessageSize = msg.size();
+    auto fnAsyncMessageHandler = [pThis, jarrRequest, pSO, isBatch,
+                                     nMessageSize]() -> void {  // WS-processing-lambda
         nlohmann::json jarrBatchAnswer;
         if ( isBatch )
             jarrBatchAnswer = nlohmann::json::array();
         for ( const nlohmann::json& joRequest : jarrRequest ) {
-            std::string strRequest = joRequest.dump();
             std::string strMethod =
                 skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
             nlohmann::json joID = joRequest["id"];
             //
-            std::string strPerformanceQueueName =
-                skutils::tools::format( "rpc/%s/%zu/%s", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis->getRelay().serverIndex(), pThis->desc( false ).c_str() );
-            std::string strPerformanceActionName =
-                skutils::tools::format( "%s task %zu", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                    pThis.get_unconst()->nTaskNumberInPeer_++ );
-            //
-            skutils::stats::time_tracker::element_ptr_t rttElement;
-            rttElement.emplace( "RPC", pThis->getRelay().nfoGetSchemeUC().c_str(),
-                strMethod.c_str(), pThis->getRelay().serverIndex(), -1 );
-            size_t nRequestSize = strRequest.size();
+            skutils::stats::metrics::call_timer timer(
+                "RPC", pThis->getRelay().statsSubSystem().c_str(), strMethod.c_str() );
+            // batch element is accounted with its share of the message
+            size_t nRequestSize = nMessageSize / jarrRequest.size();
             //
-            skutils::task::performance::action a(
-                strPerformanceQueueName, strPerformanceActionName, joRequest );
+            skutils::task::performance::action a;
+            if ( skutils::task::performance::is_tracking() )
+                a.start( skutils::tools::format( "rpc/%s/%zu/%s",
+                             pThis->getRelay().nfoGetSchemeUC().c_str(),
+                             pThis->getRelay().serverIndex(), pThis->desc( false ).c_str() ),
+                    skutils::tools::format( "%s task %zu",
+                        pThis->getRelay().nfoGetSchemeUC().c_str(),
+                        pThis.get_unconst()->nTaskNumberInPeer_++ ),
+                    joRequest );
             if ( pSO->methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
                 clog( pSO->methodTraceVerbosity( strMethod ),
                     cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
@@ -919,27 +1066,24 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 stats::register_stats_message(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", nRequestSize );
                 stats::register_stats_message(
-                    ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest );
+                    pThis->getRelay().statsSubSystem().c_str(), joRequest );
                 stats::register_stats_message( "RPC", joRequest );
                 if ( !pThis.get_unconst()->handleWebSocketSpecificRequest(
                          pThis->getRelay().esm_, joRequest, strResponse ) ) {
                     jsonrpc::IClientConnectionHandler* handler = pSO->GetHandler( "/" );
                     if ( handler == nullptr )
                         throw std::runtime_error( "No client connection handler found" );
-                    handler->HandleRequest( strRequest, strResponse );
+                    handler->HandleRequest( joRequest.dump(), strResponse );
                 }
                 nlohmann::json joResponse = nlohmann::json::parse( strResponse );
                 stats::register_stats_answer(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
                 stats::register_stats_answer(
-                    ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    joRequest, joResponse );
+                    pThis->getRelay().statsSubSystem().c_str(), joRequest, joResponse );
                 stats::register_stats_answer( "RPC", joRequest, joResponse );
                 a.set_json_out( joResponse );
                 bPassed = true;
             } catch ( const std::exception& ex ) {
-                rttElement->setError();
                 clog( dev::VerbosityError, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
                                                cc::debug( "/" ) +
                                                cc::num10( pThis->getRelay().serverIndex() ) )
@@ -952,8 +1096,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 joErrorResponce["result"] = "error";
                 joErrorResponce["error"] = std::string( ex.what() );
                 strResponse = joErrorResponce.dump();
-                stats::register_stats_exception(
-                    ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(), "" );
+                stats::register_stats_exception( pThis->getRelay().statsSubSystem().c_str(), "" );
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
@@ -961,7 +1104,6 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 }
                 a.set_json_err( joErrorResponce );
             } catch ( ... ) {
-                rttElement->setError();
                 const char* e = "unknown exception in SkaleServerOverride";
                 clog( dev::VerbosityError, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
                                                cc::debug( "/" ) +
@@ -976,8 +1118,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
                 joErrorResponce["error"] = std::string( e );
                 strResponse = joErrorResponce.dump();
                 stats::register_stats_exception(
-                    ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                    "messages" );
+                    pThis->getRelay().statsSubSystem().c_str(), "messages" );
                 if ( !strMethod.empty() ) {
                     stats::register_stats_exception(
                         pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
@@ -1001,8 +1142,7 @@ void SkaleWsPeer::onMessage( const std::string& msg, skutils::ws::opcv eOpCode )
             if ( !bPassed )
                 stats::register_stats_answer(
                     pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
-            rttElement->stop();
-            double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+            double lfExecutionDuration = timer.stop();  // in seconds
             if ( lfExecutionDuration >= pSO->opts_.lfExecutionDurationMaxForPerformanceWarning_ )
                 pSO->logPerformanceWarning( lfExecutionDuration, -1,
                     pThis->getRelay().nfoGetSchemeUC().c_str(), pThis->getRelay().serverIndex(),
@@ -1065,33 +1205,64 @@ dev::eth::Interface* SkaleWsPeer::ethereum() const {
     return pSO->ethereum();
 }
 
+bool SkaleWsPeer::sendNotification(
+    const std::string& strSubscriptionType, const std::string& strNotification ) {
+    if ( pso()->opts_.isTraceCalls_ )
+        clog( dev::VerbosityDebug, cc::info( getRelay().nfoGetSchemeUC() ) )
+            << ( cc::ws_tx_inv( " <<< " + getRelay().nfoGetSchemeUC() + "/TX <<< " ) + desc() +
+                   cc::ws_tx( " <<< " ) + cc::j( strNotification ) );
+    bool bMessageSentOK = false;
+    try {
+        bMessageSentOK = sendMessage( strNotification );
+        if ( !bMessageSentOK )
+            throw std::runtime_error( strSubscriptionType + " failed to sent message" );
+        stats::register_stats_answer(
+            getRelay().statsSubSystem().c_str(), strSubscriptionType.c_str(),
+            strNotification.size() );
+        stats::register_stats_answer(
+            "RPC", strSubscriptionType.c_str(), strNotification.size() );
+    } catch ( std::exception& ex ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( getRelay().nfoGetSchemeUC() ) +
+                                                  cc::debug( "/" ) +
+                                                  cc::num10( getRelay().serverIndex() ) )
+            << ( desc() + " " + cc::error( "error in " ) + cc::warn( strSubscriptionType ) +
+                   cc::error( " will unsubscribe because of exception: " ) +
+                   cc::warn( ex.what() ) );
+    } catch ( ... ) {
+        clog( dev::Verbosity::VerbosityError, cc::info( getRelay().nfoGetSchemeUC() ) +
+                                                  cc::debug( "/" ) +
+                                                  cc::num10( getRelay().serverIndex() ) )
+            << ( desc() + " " + cc::error( "error in " ) + cc::warn( strSubscriptionType ) +
+                   cc::error( " will unsubscribe because of unknown exception" ) );
+    }
+    if ( !bMessageSentOK ) {
+        stats::register_stats_error(
+            getRelay().statsSubSystem().c_str(), strSubscriptionType.c_str() );
+        stats::register_stats_error( "RPC", strSubscriptionType.c_str() );
+    }
+    return bMessageSentOK;
+}
+
+void SkaleWsPeer::onSubscriptionClosed( unsigned idSubscription ) {
+    // runs in peer queue like eth_unsubscribe, so sets are not changed concurrently
+    setInstalledWatchesLogs_.erase( idSubscription );
+    setInstalledWatchesNewPendingTransactions_.erase( idSubscription );
+    setInstalledWatchesNewBlocks_.erase( idSubscription );
+}
+
 void SkaleWsPeer::uninstallAllWatches() {
     set_watche_ids_t sw;
-    //
-    sw = setInstalledWatchesLogs_;
+    sw.insert( setInstalledWatchesLogs_.begin(), setInstalledWatchesLogs_.end() );
+    sw.insert( setInstalledWatchesNewPendingTransactions_.begin(),
+        setInstalledWatchesNewPendingTransactions_.end() );
+    sw.insert( setInstalledWatchesNewBlocks_.begin(), setInstalledWatchesNewBlocks_.end() );
     setInstalledWatchesLogs_.clear();
-    auto pEthereum = ethereum();
-    for ( auto iw : sw ) {
-        try {
-            pEthereum->uninstallWatch( iw );
-        } catch ( ... ) {
-        }
-    }
-    //
-    sw = setInstalledWatchesNewPendingTransactions_;
     setInstalledWatchesNewPendingTransactions_.clear();
-    for ( auto iw : sw ) {
-        try {
-            pEthereum->uninstallNewPendingTransactionWatch( iw );
-        } catch ( ... ) {
-        }
-    }
-    //
-    sw = setInstalledWatchesNewBlocks_;
     setInstalledWatchesNewBlocks_.clear();
+    SkaleServerOverride* pSO = pso();
     for ( auto iw : sw ) {
         try {
-            pEthereum->uninstallNewBlockWatch( iw );
+            pSO->wsSubscriptionHub_.unsubscribe( iw );
         } catch ( ... ) {
         }
     }
@@ -1112,9 +1283,167 @@ bool SkaleWsPeer::handleRequestWithBinaryAnswer(
     return false;
 }
 
+const char SkaleWsPeer::g_binaryRawTransactionsMagic[4] = {'S', 'K', 'R', 'T'};
+const char SkaleWsPeer::g_binaryRawTransactionsAnswerMagic[4] = {'S', 'K', 'R', 'A'};
+const char SkaleWsPeer::g_binaryRawTransactionsErrorMagic[4] = {'S', 'K', 'R', 'E'};
+
+bool SkaleWsPeer::isBinaryRawTransactionsFrame( const std::string& msg ) {
+    return msg.size() >= sizeof( g_binaryRawTransactionsMagic ) &&
+           memcmp( msg.data(), g_binaryRawTransactionsMagic,
+               sizeof( g_binaryRawTransactionsMagic ) ) == 0;
+}
+
+std::vector< dev::bytesConstRef > SkaleWsPeer::decodeBinaryRawTransactions(
+    const std::string& msg, size_t nMaxCount ) {
+    if ( !isBinaryRawTransactionsFrame( msg ) )
+        throw std::runtime_error( "Bad binary transactions frame, no magic" );
+    std::vector< dev::bytesConstRef > vecRLPs;
+    const uint8_t* p =
+        reinterpret_cast< const uint8_t* >( msg.data() ) + sizeof( g_binaryRawTransactionsMagic );
+    const uint8_t* end = reinterpret_cast< const uint8_t* >( msg.data() ) + msg.size();
+    while ( p != end ) {
+        if ( vecRLPs.size() >= nMaxCount )
+            throw std::runtime_error(
+                "Bad binary transactions frame, too much transactions in frame" );
+        if ( end - p < 4 )
+            throw std::runtime_error( "Bad binary transactions frame, truncated length" );
+        uint32_t len = uint32_t( p[0] ) | ( uint32_t( p[1] ) << 8 ) | ( uint32_t( p[2] ) << 16 ) |
+                       ( uint32_t( p[3] ) << 24 );
+        p += 4;
+        if ( size_t( end - p ) < len )
+            throw std::runtime_error( "Bad binary transactions frame, truncated transaction" );
+        vecRLPs.emplace_back( p, len );
+        p += len;
+    }
+    return vecRLPs;
+}
+
+std::string SkaleWsPeer::encodeBinaryRawTransactionsAnswer(
+    const std::vector< binary_raw_transaction_result_t >& vecResults ) {
+    auto fnAppendU32 = []( std::string& s, uint32_t n ) {
+        for ( size_t i = 0; i < 4; ++i )
+            s.push_back( char( ( n >> ( 8 * i ) ) & 0xff ) );
+    };
+    std::string s;
+    s.reserve( sizeof( g_binaryRawTransactionsAnswerMagic ) + 4 +
+               vecResults.size() * ( 1 + dev::h256::size ) );
+    s.append( g_binaryRawTransactionsAnswerMagic, sizeof( g_binaryRawTransactionsAnswerMagic ) );
+    fnAppendU32( s, uint32_t( vecResults.size() ) );
+    for ( const auto& r : vecResults ) {
+        if ( !r.strError_.empty() ) {
+            s.push_back( char( g_binaryRawTransactionUndecodable ) );
+            fnAppendU32( s, uint32_t( r.strError_.size() ) );
+            s.append( r.strError_ );
+            continue;
+        }
+        s.push_back( char( r.result_ ) );
+        s.append( reinterpret_cast< const char* >( r.hash_.data() ), dev::h256::size );
+    }
+    return s;
+}
+
+std::string SkaleWsPeer::encodeBinaryRawTransactionsError( const std::string& strError ) {
+    std::string s;
+    s.reserve( sizeof( g_binaryRawTransactionsErrorMagic ) + strError.size() );
+    s.append( g_binaryRawTransactionsErrorMagic, sizeof( g_binaryRawTransactionsErrorMagic ) );
+    s.append( strError );
+    return s;
+}
+
+void SkaleWsPeer::handleBinaryRawTransactions( const std::string& msg ) {
+    static const char g_strMethod[] = "eth_sendRawTransaction";
+    SkaleServerOverride* pSO = pso();
+    skutils::retain_release_ptr< SkaleWsPeer > pThis = this;
+    auto fnSendError = [pThis]( const std::string& e ) -> void {
+        clog( dev::VerbosityError, cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
+                                       cc::debug( "/" ) +
+                                       cc::num10( pThis->getRelay().serverIndex() ) )
+            << ( cc::ws_tx_inv( " !!! " + pThis->getRelay().nfoGetSchemeUC() + "/" +
+                                std::to_string( pThis->getRelay().serverIndex() ) + "/ERR !!! " ) +
+                   pThis->desc() + cc::ws_tx( " !!! " ) + cc::warn( e ) );
+        std::string strResponse = encodeBinaryRawTransactionsError( e );
+        stats::register_stats_exception( pThis->getRelay().nfoGetSchemeUC().c_str(), "messages" );
+        stats::register_stats_exception( "RPC", g_strMethod );
+        pThis.get_unconst()->sendMessage( strResponse, skutils::ws::opcv::binary );
+        stats::register_stats_answer(
+            pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strResponse.size() );
+    };
+    //
+    // transactions refer to the frame, so it is shared with the async handler
+    auto pMsg = std::make_shared< std::string >( msg );
+    std::vector< dev::bytesConstRef > vecRLPs;
+    try {
+        vecRLPs = decodeBinaryRawTransactions( *pMsg, pSO->maxCountInBatchJsonRpcRequest_ );
+    } catch ( const std::exception& ex ) {
+        fnSendError( ex.what() );
+        return;
+    }
+    //
+    // unddos, every transaction of frame is counted as a call
+    for ( size_t i = 0; i < vecRLPs.size(); ++i ) {
+        skutils::unddos::e_high_load_detection_result_t ehldr =
+            pSO->unddos_.register_call_from_origin( m_strUnDdosOrigin, g_strMethod );
+        if ( ehldr != skutils::unddos::e_high_load_detection_result_t::ehldr_no_error ) {
+            fnSendError( "Banned due to high load binary transactions frame" );
+            return;
+        }
+    }
+    //
+    auto fnAsyncBinaryHandler = [pThis, pMsg, vecRLPs, fnSendError]() -> void {
+        skutils::stats::metrics::call_timer timer(
+            "RPC", pThis->getRelay().statsSubSystem().c_str(), g_strMethod );
+        stats::register_stats_message(
+            pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", pMsg->size() );
+        stats::register_stats_message( "RPC", g_strMethod, pMsg->size() );
+        std::string strAnswer;
+        try {
+            dev::eth::Client* pClient = dynamic_cast< dev::eth::Client* >( pThis->ethereum() );
+            if ( !pClient )
+                throw std::runtime_error( "internal error, no client interface found" );
+            std::vector< binary_raw_transaction_result_t > vecResults( vecRLPs.size() );
+            dev::eth::Transactions txs;
+            std::vector< size_t > vecIndexes;
+            txs.reserve( vecRLPs.size() );
+            vecIndexes.reserve( vecRLPs.size() );
+            for ( size_t i = 0; i < vecRLPs.size(); ++i ) {
+                try {
+                    // signature is checked as a part of transaction import
+                    txs.emplace_back( vecRLPs[i], dev::eth::CheckTransaction::None );
+                } catch ( const std::exception& ex ) {
+                    vecResults[i].strError_ = ex.what();
+                    continue;
+                } catch ( ... ) {
+                    vecResults[i].strError_ = "unknown exception while decoding transaction";
+                    continue;
+                }
+                vecResults[i].hash_ = txs.back().sha3();
+                vecIndexes.push_back( i );
+            }
+            std::vector< dev::eth::ImportResult > vecImported =
+                pClient->importTransactionsBatch( txs );
+            for ( size_t i = 0; i < vecImported.size(); ++i )
+                vecResults[vecIndexes[i]].result_ = vecImported[i];
+            strAnswer = encodeBinaryRawTransactionsAnswer( vecResults );
+        } catch ( const std::exception& ex ) {
+            fnSendError( ex.what() );
+            return;
+        } catch ( ... ) {
+            fnSendError( "unknown exception in binary transactions frame handler" );
+            return;
+        }
+        pThis.get_unconst()->sendMessage( strAnswer, skutils::ws::opcv::binary );
+        stats::register_stats_answer(
+            pThis->getRelay().nfoGetSchemeUC().c_str(), "messages", strAnswer.size() );
+        stats::register_stats_answer( "RPC", g_strMethod, strAnswer.size() );
+    };
+    skutils::dispatch::async( pThis->m_strPeerQueueID, fnAsyncBinaryHandler );
+}
+
 bool SkaleWsPeer::handleWebSocketSpecificRequest(
     e_server_mode_t esm, const nlohmann::json& joRequest, std::string& strResponse ) {
     strResponse.clear();
+    if ( pso()->handleSerializedRpcRequest( joRequest, strResponse ) )
+        return true;
     nlohmann::json joResponse = nlohmann::json::object();
     joResponse["jsonrpc"] = "2.0";
     if ( joRequest.count( "id" ) > 0 )
@@ -1122,8 +1451,10 @@ bool SkaleWsPeer::handleWebSocketSpecificRequest(
     joResponse["result"] = nullptr;
     if ( !pso()->handleProtocolSpecificRequest(
              getRelay(), getRemoteIp(), joRequest, joResponse ) ) {
-        if ( !handleWebSocketSpecificRequest( esm, joRequest, joResponse ) )
-            return false;
+        if ( !handleWebSocketSpecificRequest( esm, joRequest, joResponse ) ) {
+            if ( !pso()->handleNativeRpcRequest( joRequest, joResponse ) )
+                return false;
+        }
     }
     strResponse = joResponse.dump();
     return true;
@@ -1217,110 +1548,8 @@ void SkaleWsPeer::eth_subscribe_logs(
                 }
             }
         }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        dev::eth::fnClientWatchHandlerMulti_t fnOnSunscriptionEvent;
-        fnOnSunscriptionEvent += [pThis]( unsigned iw ) -> void {
-            skutils::dispatch::async( "logs-rethread", [=]() -> void {
-                skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw]() -> void {
-                    dev::eth::LocalisedLogEntries le = pThis->ethereum()->checkWatch( iw );
-                    nlohmann::json joResult = skale::server::helper::toJsonByBlock( le );
-                    if ( joResult.is_array() ) {
-                        for ( const auto& joRW : joResult ) {
-                            if ( joRW.is_object() && joRW.count( "logs" ) > 0 &&
-                                 joRW.count( "blockHash" ) > 0 &&
-                                 joRW.count( "blockNumber" ) > 0 ) {
-                                std::string strBlockHash = joRW["blockHash"].get< std::string >();
-                                unsigned nBlockNumber = joRW["blockNumber"].get< unsigned >();
-                                const nlohmann::json& joResultLogs = joRW["logs"];
-                                if ( joResultLogs.is_array() ) {
-                                    for ( const auto& joWalk : joResultLogs ) {
-                                        if ( !joWalk.is_object() )
-                                            continue;
-                                        nlohmann::json joLog = joWalk;  // copy
-                                        joLog["blockHash"] = strBlockHash;
-                                        joLog["blockNumber"] = nBlockNumber;
-                                        nlohmann::json joParams = nlohmann::json::object();
-                                        joParams["subscription"] = dev::toJS( iw );
-                                        joParams["result"] = joLog;
-                                        nlohmann::json joNotification = nlohmann::json::object();
-                                        joNotification["jsonrpc"] = "2.0";
-                                        joNotification["method"] = "eth_subscription";
-                                        joNotification["params"] = joParams;
-                                        std::string strNotification = joNotification.dump();
-                                        const SkaleServerOverride* pSO = pThis->pso();
-                                        if ( pSO->opts_.isTraceCalls_ )
-                                            clog( dev::VerbosityDebug,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::ws_tx_inv(
-                                                        " <<< " +
-                                                        pThis->getRelay().nfoGetSchemeUC() +
-                                                        "/TX <<< " ) )
-                                                << ( pThis->desc() + cc::ws_tx( " <<< " ) +
-                                                       cc::j( strNotification ) );
-                                        // skutils::dispatch::async( pThis->m_strPeerQueueID,
-                                        // [pThis, strNotification]() -> void {
-                                        bool bMessageSentOK = false;
-                                        try {
-                                            bMessageSentOK =
-                                                const_cast< SkaleWsPeer* >( pThis.get() )
-                                                    ->sendMessage( skutils::tools::trim_copy(
-                                                        strNotification ) );
-                                            if ( !bMessageSentOK )
-                                                throw std::runtime_error(
-                                                    "eth_subscription/logs failed to sent "
-                                                    "message" );
-                                            stats::register_stats_answer(
-                                                ( std::string( "RPC/" ) +
-                                                    pThis->getRelay().nfoGetSchemeUC() )
-                                                    .c_str(),
-                                                "eth_subscription/logs", strNotification.size() );
-                                            stats::register_stats_answer( "RPC",
-                                                "eth_subscription/logs", strNotification.size() );
-                                        } catch ( std::exception& ex ) {
-                                            clog( dev::Verbosity::VerbosityError,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::debug( "/" ) +
-                                                    cc::num10( pThis->getRelay().serverIndex() ) )
-                                                << ( pThis->desc() + " " +
-                                                       cc::error( "error in " ) +
-                                                       cc::warn( "eth_subscription/logs" ) +
-                                                       cc::error(
-                                                           " will uninstall watcher callback "
-                                                           "because of exception: " ) +
-                                                       cc::warn( ex.what() ) );
-                                        } catch ( ... ) {
-                                            clog( dev::Verbosity::VerbosityError,
-                                                cc::info( pThis->getRelay().nfoGetSchemeUC() ) +
-                                                    cc::debug( "/" ) +
-                                                    cc::num10( pThis->getRelay().serverIndex() ) )
-                                                << ( pThis->desc() + " " +
-                                                       cc::error( "error in " ) +
-                                                       cc::warn( "eth_subscription/logs" ) +
-                                                       cc::error(
-                                                           " will uninstall watcher callback "
-                                                           "because of unknown exception" ) );
-                                        }
-                                        if ( !bMessageSentOK ) {
-                                            stats::register_stats_error(
-                                                ( std::string( "RPC/" ) +
-                                                    pThis->getRelay().nfoGetSchemeUC() )
-                                                    .c_str(),
-                                                "eth_subscription/logs" );
-                                            stats::register_stats_error(
-                                                "RPC", "eth_subscription/logs" );
-                                            pThis->ethereum()->uninstallWatch( iw );
-                                        }
-                                        //    } );
-                                    }  // for ( const auto& joWalk : joResultLogs )
-                                }      // if ( joResultLogs.is_array() )
-                            }
-                        }  // for ( const auto& joRW : joResult )
-                    }      // if ( joResult.is_array() )
-                } );
-            } );
-        };
-        unsigned iw = ethereum()->installWatch(
-            logFilter, dev::eth::Reaping::Automatic, fnOnSunscriptionEvent, true );  // isWS = true
+        // matched once per distinct filter and block by hub, not by Client watch per peer
+        unsigned iw = pSO->wsSubscriptionHub_.subscribeLogs( this, logFilter, 0 );
         setInstalledWatchesLogs_.insert( iw );
         std::string strIW = dev::toJS( iw );
         if ( pSO->opts_.isTraceCalls_ )
@@ -1362,72 +1591,8 @@ void SkaleWsPeer::eth_subscribe_newPendingTransactions(
     e_server_mode_t /*esm*/, const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) {
     SkaleServerOverride* pSO = pso();
     try {
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        std::function< void( const unsigned& iw, const dev::eth::Transaction& t ) >
-            fnOnSunscriptionEvent =
-                [pThis]( const unsigned& iw, const dev::eth::Transaction& t ) -> void {
-            skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, iw, t]() -> void {
-                const SkaleServerOverride* pSO = pThis->pso();
-                dev::h256 h = t.sha3();
-                //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] =
-                    dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION );
-                joParams["result"] = dev::toJS( h );  // h.hex()
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
-                if ( pSO->opts_.isTraceCalls_ )
-                    clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
-                        << ( cc::ws_tx_inv(
-                                 " <<< " + pThis->getRelay().nfoGetSchemeUC() + "/TX <<< " ) +
-                               pThis->desc() + cc::ws_tx( " <<< " ) + cc::j( strNotification ) );
-                // skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, strNotification]() ->
-                // void {
-                bool bMessageSentOK = false;
-                try {
-                    bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
-                    if ( !bMessageSentOK )
-                        throw std::runtime_error(
-                            "eth_subscription/newPendingTransactions failed to sent message" );
-                    stats::register_stats_answer(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newPendingTransactions", strNotification.size() );
-                    stats::register_stats_answer(
-                        "RPC", "eth_subscription/newPendingTransactions", strNotification.size() );
-                } catch ( std::exception& ex ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newPendingTransactions" ) +
-                               cc::error(
-                                   " will uninstall watcher callback because of exception: " ) +
-                               cc::warn( ex.what() ) );
-                } catch ( ... ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newPendingTransactions" ) +
-                               cc::error( " will uninstall watcher callback because of unknown "
-                                          "exception" ) );
-                }
-                if ( !bMessageSentOK ) {
-                    stats::register_stats_error(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newPendingTransactions" );
-                    stats::register_stats_error( "RPC", "eth_subscription/newPendingTransactions" );
-                    pThis->ethereum()->uninstallNewPendingTransactionWatch( iw );
-                }
-                //} );
-            } );
-        };
-        unsigned iw = ethereum()->installNewPendingTransactionWatch( fnOnSunscriptionEvent );
+        unsigned iw = pSO->wsSubscriptionHub_.subscribeNewPendingTransactions(
+            this, SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION );
         setInstalledWatchesNewPendingTransactions_.insert( iw );
         iw |= SKALED_WS_SUBSCRIPTION_TYPE_NEW_PENDING_TRANSACTION;
         std::string strIW = dev::toJS( iw );
@@ -1475,84 +1640,8 @@ void SkaleWsPeer::eth_subscribe_newHeads( e_server_mode_t /*esm*/,
     const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse, bool bIncludeTransactions ) {
     SkaleServerOverride* pSO = pso();
     try {
-        skutils::retain_release_ptr< SkaleWsPeer > pThis( this );
-        std::function< void( const unsigned& iw, const dev::eth::Block& block ) >
-            fnOnSunscriptionEvent = [pThis, bIncludeTransactions](
-                                        const unsigned& iw, const dev::eth::Block& block ) -> void {
-            skutils::dispatch::async( [pThis, iw, block, bIncludeTransactions]() -> void {
-                const SkaleServerOverride* pSO = pThis->pso();
-                dev::h256 h = block.info().hash();
-                Json::Value jv;
-                if ( bIncludeTransactions )
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactions( h ), pThis->ethereum()->sealEngine() );
-                else
-                    jv = dev::eth::toJson( pThis->ethereum()->blockInfo( h ),
-                        pThis->ethereum()->blockDetails( h ), pThis->ethereum()->uncleHashes( h ),
-                        pThis->ethereum()->transactionHashes( h ),
-                        pThis->ethereum()->sealEngine() );
-                Json::FastWriter fastWriter;
-                std::string s = fastWriter.write( jv );
-                nlohmann::json joBlockDescription = nlohmann::json::parse( s );
-                //
-                nlohmann::json joParams = nlohmann::json::object();
-                joParams["subscription"] = dev::toJS( iw | SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK );
-                joParams["result"] = joBlockDescription;
-                nlohmann::json joNotification = nlohmann::json::object();
-                joNotification["jsonrpc"] = "2.0";
-                joNotification["method"] = "eth_subscription";
-                joNotification["params"] = joParams;
-                std::string strNotification = joNotification.dump();
-                if ( pSO->opts_.isTraceCalls_ )
-                    clog( dev::VerbosityDebug, cc::info( pThis->getRelay().nfoGetSchemeUC() ) )
-                        << ( cc::ws_tx_inv(
-                                 " <<< " + pThis->getRelay().nfoGetSchemeUC() + "/TX <<< " ) +
-                               pThis->desc() + cc::ws_tx( " <<< " ) + cc::j( strNotification ) );
-                // skutils::dispatch::async( pThis->m_strPeerQueueID, [pThis, strNotification]() ->
-                // void {
-                bool bMessageSentOK = false;
-                try {
-                    bMessageSentOK =
-                        const_cast< SkaleWsPeer* >( pThis.get() )
-                            ->sendMessage( skutils::tools::trim_copy( strNotification ) );
-                    if ( !bMessageSentOK )
-                        throw std::runtime_error(
-                            "eth_subscription/newHeads failed to sent message" );
-                    stats::register_stats_answer(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newHeads", strNotification.size() );
-                    stats::register_stats_answer(
-                        "RPC", "eth_subscription/newHeads", strNotification.size() );
-                } catch ( std::exception& ex ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newHeads" ) +
-                               cc::error(
-                                   " will uninstall watcher callback because of exception: " ) +
-                               cc::warn( ex.what() ) );
-                } catch ( ... ) {
-                    clog( dev::Verbosity::VerbosityError,
-                        cc::info( pThis->getRelay().nfoGetSchemeUC() ) + cc::debug( "/" ) +
-                            cc::num10( pThis->getRelay().serverIndex() ) )
-                        << ( pThis->desc() + " " + cc::error( "error in " ) +
-                               cc::warn( "eth_subscription/newHeads" ) +
-                               cc::error( " will uninstall watcher callback because of unknown "
-                                          "exception" ) );
-                }
-                if ( !bMessageSentOK ) {
-                    stats::register_stats_error(
-                        ( std::string( "RPC/" ) + pThis->getRelay().nfoGetSchemeUC() ).c_str(),
-                        "eth_subscription/newHeads" );
-                    stats::register_stats_error( "RPC", "eth_subscription/newHeads" );
-                    pThis->ethereum()->uninstallNewBlockWatch( iw );
-                }
-                //} );
-            } );
-        };
-        unsigned iw = ethereum()->installNewBlockWatch( fnOnSunscriptionEvent );
+        unsigned iw = pSO->wsSubscriptionHub_.subscribeNewHeads(
+            this, bIncludeTransactions, SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK );
         setInstalledWatchesNewBlocks_.insert( iw );
         iw |= SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK;
         std::string strIW = dev::toJS( iw );
@@ -1701,7 +1790,7 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallNewPendingTransactionWatch( iw );
+            pSO->wsSubscriptionHub_.unsubscribe( iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
             setInstalledWatchesNewPendingTransactions_.erase(
                 iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
         } else if ( x == SKALED_WS_SUBSCRIPTION_TYPE_NEW_BLOCK ) {
@@ -1724,7 +1813,7 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallNewBlockWatch( iw );
+            pSO->wsSubscriptionHub_.unsubscribe( iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
             setInstalledWatchesNewBlocks_.erase( iw & ( ~( SKALED_WS_SUBSCRIPTION_TYPE_MASK ) ) );
         } else if ( x == SKALED_WS_SUBSCRIPTION_TYPE_SKALE_STATS ) {
             SkaleStatsSubscriptionManager::subscription_id_t idSubscription =
@@ -1767,7 +1856,7 @@ void SkaleWsPeer::eth_unsubscribe(
                 joResponse["error"] = joError;
                 return;
             }
-            ethereum()->uninstallWatch( iw );
+            pSO->wsSubscriptionHub_.unsubscribe( iw );
             setInstalledWatchesLogs_.erase( iw );
         }
     }  // for ( idxParam = 0; idxParam < cntParams; ++idxParam )
@@ -1784,6 +1873,7 @@ SkaleRelayWS::SkaleRelayWS( int ipVer, const char* strBindAddr,
       strBindAddr_( strBindAddr ),
       m_strScheme_( skutils::tools::to_lower( strScheme ) ),
       m_strSchemeUC( skutils::tools::to_upper( strScheme ) ),
+      m_strStatsSubSystem( "RPC/" + m_strSchemeUC ),
       m_nPort( nPort ),
       esm_( esm ) {
     //
@@ -1964,17 +2054,25 @@ bool SkaleRelayHTTP::handleHttpSpecificRequest( const std::string& strOrigin, e_
     } catch ( ... ) {
         return false;
     }
-    nlohmann::json joResponse = nlohmann::json::object();
+    nlohmann::json joResponse;
+    if ( !handleParsedRequest( strOrigin, esm, joRequest, joResponse ) )
+        return false;
+    strResponse = joResponse.dump();
+    return true;
+}
+
+bool SkaleRelayHTTP::handleParsedRequest( const std::string& strOrigin, e_server_mode_t esm,
+    const nlohmann::json& joRequest, nlohmann::json& joResponse ) {
+    joResponse = nlohmann::json::object();
     joResponse["jsonrpc"] = "2.0";
     if ( joRequest.count( "id" ) > 0 )
         joResponse["id"] = joRequest["id"];
     joResponse["result"] = nullptr;
-    if ( !pso()->handleProtocolSpecificRequest( *this, strOrigin, joRequest, joResponse ) ) {
-        if ( !handleHttpSpecificRequest( strOrigin, esm, joRequest, joResponse ) )
-            return false;
-    }
-    strResponse = joResponse.dump();
-    return true;
+    if ( pso()->handleProtocolSpecificRequest( *this, strOrigin, joRequest, joResponse ) )
+        return true;
+    if ( handleHttpSpecificRequest( strOrigin, esm, joRequest, joResponse ) )
+        return true;
+    return pso()->handleNativeRpcRequest( joRequest, joResponse );
 }
 
 bool SkaleRelayHTTP::handleHttpSpecificRequest( const std::string& strOrigin, e_server_mode_t esm,
@@ -2000,7 +2098,11 @@ const double SkaleServerOverride::g_lfDefaultExecutionDurationMaxForPerformanceW
 
 SkaleServerOverride::SkaleServerOverride(
     dev::eth::ChainParams& chainParams, dev::eth::Interface* pEth, const opts_t& opts )
-    : AbstractServerConnector(), chainParams_( chainParams ), pEth_( pEth ), opts_( opts ) {
+    : AbstractServerConnector(),
+      chainParams_( chainParams ),
+      pEth_( pEth ),
+      opts_( opts ),
+      wsSubscriptionHub_( *this ) {
     {  // block
         std::function< void( const unsigned& iw, const dev::eth::Block& block ) >
             fnOnSunscriptionEvent =
@@ -2031,10 +2133,16 @@ SkaleServerOverride::SkaleServerOverride(
         iwPendingTransactionStats_ =
             ethereum()->installNewPendingTransactionWatch( fnOnSunscriptionEvent );
     }  // block
+    installDefaultNativeRpcHandlers();
+    installDefaultSerializedRpcHandlers();
+    wsSubscriptionHub_.installClientWatches();
+    idMetricsCollector_ = skutils::stats::metrics::add_collector(
+        [this]( skutils::stats::metrics::open_metrics_writer& w ) { writeOpenMetrics( w ); } );
 }
 
 
 SkaleServerOverride::~SkaleServerOverride() {
+    skutils::stats::metrics::remove_collector( idMetricsCollector_ );
     if ( iwBlockStats_ != unsigned( -1 ) ) {
         ethereum()->uninstallNewBlockWatch( iwBlockStats_ );
         iwBlockStats_ = unsigned( -1 );
@@ -2043,6 +2151,7 @@ SkaleServerOverride::~SkaleServerOverride() {
         ethereum()->uninstallNewPendingTransactionWatch( iwPendingTransactionStats_ );
         iwPendingTransactionStats_ = unsigned( -1 );
     }
+    wsSubscriptionHub_.uninstallClientWatches();
     StopListening();
 }
 
@@ -2103,7 +2212,7 @@ dev::Verbosity SkaleServerOverride::methodTraceVerbosity( const std::string& str
     if ( strMethod == "skale_stats" || strMethod == "skale_performanceTrackingStatus" ||
          strMethod == "skale_performanceTrackingStart" ||
          strMethod == "skale_performanceTrackingStop" ||
-         strMethod == "skale_performanceTrackingFetch" )
+         strMethod == "skale_performanceTrackingFetch" || strMethod == "skale_spanTracingFetch" )
         return dev::VerbositySilent;
 
     // print special
@@ -2406,29 +2515,71 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
             } break;
             }  // switch( ehldr )
             //
+            // per-origin batch size cap
+            if ( isBatch ) {
+                size_t cntMaxForOrigin = unddos_.max_batch_size_for_origin( str_unddos_origin );
+                if ( cntMaxForOrigin > 0 && jarrRequest.size() > cntMaxForOrigin ) {
+                    std::string e =
+                        "Bad JSON RPC request, too much requests in batch for origin " +
+                        str_unddos_origin;
+                    logTraceServerTraffic( false, dev::VerbosityError, ipVer,
+                        bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
+                        cc::warn( e ) );
+                    nlohmann::json joErrorResponce;
+                    joErrorResponce["id"] = joID;
+                    joErrorResponce["result"] = "error";
+                    joErrorResponce["error"] = std::string( e );
+                    std::string strResponse = joErrorResponce.dump();
+                    stats::register_stats_exception( bIsSSL ? "HTTPS" : "HTTP", "POST" );
+                    stats::register_stats_exception( "RPC", "batch_json_rpc_request" );
+                    res.set_header( "access-control-allow-origin", "*" );
+                    res.set_header( "vary", "Origin" );
+                    res.set_content( strResponse.c_str(), "application/json" );
+                    stats::register_stats_answer(
+                        bIsSSL ? "HTTPS" : "HTTP", "POST", res.body_.size() );
+                    return true;
+                }
+            }
             //
-            nlohmann::json jarrBatchAnswer;
-            if ( isBatch )
-                jarrBatchAnswer = nlohmann::json::array();
-            for ( const nlohmann::json& joRequest : jarrRequest ) {
-                std::string strBody = joRequest.dump();  // = req.body_;
-                std::string strPerformanceQueueName = skutils::tools::format(
-                    "rpc/%s/%zu", bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex() );
-                std::string strPerformanceActionName = skutils::tools::format( "%s task %zu, %s",
-                    bIsSSL ? "HTTPS" : "HTTP", nTaskNumberCall_++, strMethod.c_str() );
-                skutils::task::performance::action a(
-                    strPerformanceQueueName, strPerformanceActionName, joRequest );
+            // HTTP request is one connection no matter how many requests its batch has
+            SkaleServerConnectionsTrackHelper sscth( *this );
+            //
+            // processes one request of batch, returns true if answer is binary and placed into
+            // buffer, otherwise JSON answer is placed into strResponse
+            auto fnProcessRequest = [&]( const nlohmann::json& joRequest,
+                                        std::string& strResponse,
+                                        std::vector< uint8_t >& buffer ) -> bool {
+                // request text is needed only by jsonrpccpp fallback and traffic trace, so batch
+                // element is serialized back only for them; single request is whole body
+                std::string strBatchElement;
+                auto fnBody = [&]() -> const std::string& {
+                    if ( !isBatch )
+                        return req.body_;
+                    if ( strBatchElement.empty() )
+                        strBatchElement = joRequest.dump();
+                    return strBatchElement;
+                };
+                // batch element is accounted with its share of the body
+                size_t nBodySize =
+                    isBatch ? req.body_.size() / jarrRequest.size() : req.body_.size();
+                std::string strMethod =
+                    skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+                nlohmann::json joID = joRequest["id"];
+                skutils::task::performance::action a;
+                if ( skutils::task::performance::is_tracking() )
+                    a.start( skutils::tools::format(
+                                 "rpc/%s/%zu", bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex() ),
+                        skutils::tools::format( "%s task %zu, %s", bIsSSL ? "HTTPS" : "HTTP",
+                            nTaskNumberCall_++, strMethod.c_str() ),
+                        joRequest );
                 //
-                skutils::stats::time_tracker::element_ptr_t rttElement;
-                rttElement.emplace( "RPC", bIsSSL ? "HTTPS" : "HTTP", strMethod.c_str(),
-                    pSrv->serverIndex(), ipVer );
+                skutils::stats::metrics::call_timer timer(
+                    "RPC", bIsSSL ? "RPC/HTTPS" : "RPC/HTTP", strMethod.c_str() );
                 //
-                SkaleServerConnectionsTrackHelper sscth( *this );
                 if ( pSO->methodTraceVerbosity( strMethod ) != dev::VerbositySilent )
                     logTraceServerTraffic( true, pSO->methodTraceVerbosity( strMethod ), ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
-                        cc::j( strBody ) );
-                std::string strResponse;
+                        cc::j( fnBody() ) );
                 bool bPassed = false;
                 try {
                     if ( is_connection_limit_overflow() ) {
@@ -2436,49 +2587,51 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                             ipVer, bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), nPort, esm );
                         throw std::runtime_error( "server too busy" );
                     }
-                    strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
                     if ( !handleAdminOriginFilter( strMethod, req.origin_ ) ) {
                         throw std::runtime_error( "origin not allowed for call attempt" );
                     }
-                    jsonrpc::IClientConnectionHandler* handler = this->GetHandler( "/" );
-                    if ( handler == nullptr )
-                        throw std::runtime_error( "No client connection handler found" );
                     //
+                    stats::register_stats_message( bIsSSL ? "HTTPS" : "HTTP", "POST", nBodySize );
                     stats::register_stats_message(
-                        bIsSSL ? "HTTPS" : "HTTP", "POST", strBody.size() );
-                    stats::register_stats_message(
-                        ( std::string( "RPC/" ) + ( bIsSSL ? "HTTPS" : "HTTP" ) ).c_str(),
-                        joRequest );
-                    stats::register_stats_message( "RPC", joRequest );
+                        bIsSSL ? "RPC/HTTPS" : "RPC/HTTP", strMethod.c_str(), nBodySize );
+                    stats::register_stats_message( "RPC", strMethod.c_str(), nBodySize );
                     //
-                    std::vector< uint8_t > buffer;
                     if ( handleRequestWithBinaryAnswer( esm, joRequest, buffer ) ) {
-                        res.set_header( "access-control-allow-origin", "*" );
-                        res.set_header( "vary", "Origin" );
-                        res.set_content(
-                            ( char* ) buffer.data(), buffer.size(), "application/octet-stream" );
                         stats::register_stats_answer(
                             bIsSSL ? "HTTPS" : "HTTP", "POST", buffer.size() );
-                        rttElement->stop();
                         return true;
                     }
-                    if ( !pSrv->handleHttpSpecificRequest(
-                             req.origin_, esm, strBody, strResponse ) ) {
-                        handler->HandleRequest( strBody.c_str(), strResponse );
+                    // request is already parsed, so jsonrpccpp which parses it once again is
+                    // used only for methods having no native handler
+                    nlohmann::json joResponse;
+                    if ( handleSerializedRpcRequest( joRequest, strResponse ) ) {
+                        if ( !a.is_skipped() )
+                            joResponse = nlohmann::json::parse( strResponse );
+                    } else if ( pSrv->handleParsedRequest(
+                                    req.origin_, esm, joRequest, joResponse ) )
+                        strResponse = joResponse.dump();
+                    else {
+                        jsonrpc::IClientConnectionHandler* handler = this->GetHandler( "/" );
+                        if ( handler == nullptr )
+                            throw std::runtime_error( "No client connection handler found" );
+                        handler->HandleRequest( fnBody(), strResponse );
+                        // line feed of jsoncpp writer is dropped to match native answers
+                        if ( !strResponse.empty() && strResponse.back() == '\n' )
+                            strResponse.pop_back();
+                        if ( !a.is_skipped() )
+                            joResponse = nlohmann::json::parse( strResponse );
                     }
                     //
                     stats::register_stats_answer(
                         bIsSSL ? "HTTPS" : "HTTP", "POST", strResponse.size() );
-                    nlohmann::json joResponse = nlohmann::json::parse( strResponse );
                     stats::register_stats_answer(
-                        ( std::string( "RPC/" ) + ( bIsSSL ? "HTTPS" : "HTTP" ) ).c_str(),
-                        joRequest, joResponse );
-                    stats::register_stats_answer( "RPC", joRequest, joResponse );
+                        bIsSSL ? "RPC/HTTPS" : "RPC/HTTP", strMethod.c_str(), strResponse.size() );
+                    stats::register_stats_answer( "RPC", strMethod.c_str(), strResponse.size() );
                     //
-                    a.set_json_out( joResponse );
+                    if ( !a.is_skipped() )
+                        a.set_json_out( joResponse );
                     bPassed = true;
                 } catch ( const std::exception& ex ) {
-                    rttElement->setError();
                     logTraceServerTraffic( false, dev::VerbosityError, ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
                         cc::warn( ex.what() ) );
@@ -2495,7 +2648,6 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                     }
                     a.set_json_err( joErrorResponce );
                 } catch ( ... ) {
-                    rttElement->setError();
                     const char* e = "unknown exception in SkaleServerOverride";
                     logTraceServerTraffic( false, dev::VerbosityError, ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
@@ -2517,31 +2669,101 @@ bool SkaleServerOverride::implStartListening( std::shared_ptr< SkaleRelayHTTP >&
                     logTraceServerTraffic( false, methodTraceVerbosity( strMethod ), ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
                         cc::j( strResponse ) );
-                if ( isBatch ) {
-                    nlohmann::json joAnswerPart = nlohmann::json::parse( strResponse );
-                    jarrBatchAnswer.push_back( joAnswerPart );
-                } else {
-                    res.set_header( "access-control-allow-origin", "*" );
-                    res.set_header( "vary", "Origin" );
-                    res.set_content( strResponse.c_str(), "application/json" );
-                }
                 if ( !bPassed )
                     stats::register_stats_answer(
-                        bIsSSL ? "HTTPS" : "HTTP", "POST", res.body_.size() );
-                rttElement->stop();
-                double lfExecutionDuration = rttElement->getDurationInSeconds();  // in seconds
+                        bIsSSL ? "HTTPS" : "HTTP", "POST", strResponse.size() );
+                double lfExecutionDuration = timer.stop();  // in seconds
                 if ( lfExecutionDuration >=
                      pSO->opts_.lfExecutionDurationMaxForPerformanceWarning_ )
                     pSO->logPerformanceWarning( lfExecutionDuration, ipVer,
                         bIsSSL ? "HTTPS" : "HTTP", pSrv->serverIndex(), esm, req.origin_.c_str(),
                         strMethod.c_str(), joID );
-            }  // for( const nlohmann::json & joRequest : jarrRequest )
-            if ( isBatch ) {
-                std::string strResponse = jarrBatchAnswer.dump();
-                res.set_header( "access-control-allow-origin", "*" );
-                res.set_header( "vary", "Origin" );
-                res.set_content( strResponse.c_str(), "application/json" );
+                return false;
+            };
+            //
+            // read-only batch elements are spread over bounded set of worker queues
+            std::vector< std::string > vecResponses( jarrRequest.size() );
+            size_t cntWorkers = 0;
+            if ( isBatch && jarrRequest.size() > 1 && maxParallelismInBatchJsonRpcRequest_ > 0 &&
+                 isReadOnlyBatchJsonRpcRequest( jarrRequest ) )
+                cntWorkers = unddos_.acquire_batch_workers_for_origin( str_unddos_origin,
+                    std::min( maxParallelismInBatchJsonRpcRequest_, jarrRequest.size() ) );
+            if ( cntWorkers > 0 ) {
+                // helper jobs may start late, after all requests are claimed and this handler
+                // returned, so they touch nothing but the shared counters until they claim one;
+                // connection thread waits only for claimed requests, never for jobs in queues
+                struct batch_latch_t {
+                    std::atomic_size_t nNextRequest{0}, cntFinished{0};
+                    std::mutex mtx;
+                    std::condition_variable cv;
+                };
+                auto pLatch = std::make_shared< batch_latch_t >();
+                const size_t cntRequests = jarrRequest.size();
+                auto fnWorker = [pLatch, cntRequests, &jarrRequest, &vecResponses,
+                                    &fnProcessRequest]() -> void {
+                    std::vector< uint8_t > buffer;  // read-only methods never answer binary
+                    size_t i;
+                    while ( ( i = pLatch->nNextRequest++ ) < cntRequests ) {
+                        fnProcessRequest( jarrRequest[i], vecResponses[i], buffer );
+                        if ( ++pLatch->cntFinished == cntRequests ) {
+                            std::lock_guard< std::mutex > lock( pLatch->mtx );
+                            pLatch->cv.notify_all();
+                        }
+                    }
+                };
+                size_t nFirstQueue = nBatchQueueRoundRobin_++;
+                for ( size_t w = 1; w < cntWorkers; ++w ) {
+                    skutils::dispatch::queue_id_t idQueue = skutils::tools::format(
+                        "rpc-batch-worker-%zu",
+                        ( nFirstQueue + w ) % maxParallelismInBatchJsonRpcRequest_ );
+                    skutils::dispatch::async( idQueue, fnWorker );
+                }
+                fnWorker();  // connection thread is worker too
+                {
+                    std::unique_lock< std::mutex > lock( pLatch->mtx );
+                    pLatch->cv.wait( lock, [&]() { return pLatch->cntFinished == cntRequests; } );
+                }
+                unddos_.release_batch_workers_for_origin( str_unddos_origin, cntWorkers );
+                statsBatches_.cntParallel_++;
+                statsBatches_.cntParallelRequests_ += jarrRequest.size();
+                statsBatches_.cntWorkers_ += cntWorkers;
+                size_t nFanOutMax = statsBatches_.nFanOutMax_;
+                while ( nFanOutMax < cntWorkers &&
+                        !statsBatches_.nFanOutMax_.compare_exchange_weak( nFanOutMax, cntWorkers ) )
+                    ;
+            } else {
+                if ( isBatch )
+                    statsBatches_.cntSequential_++;
+                for ( size_t i = 0; i < jarrRequest.size(); ++i ) {
+                    std::vector< uint8_t > buffer;
+                    if ( fnProcessRequest( jarrRequest[i], vecResponses[i], buffer ) ) {
+                        res.set_header( "access-control-allow-origin", "*" );
+                        res.set_header( "vary", "Origin" );
+                        res.set_content(
+                            ( char* ) buffer.data(), buffer.size(), "application/octet-stream" );
+                        return true;
+                    }
+                }
             }
+            std::string strResponse;
+            if ( isBatch ) {
+                // answer parts are already serialized, so just join them
+                size_t nResponseSize = 2 + vecResponses.size();
+                for ( const std::string& strAnswerPart : vecResponses )
+                    nResponseSize += strAnswerPart.size();
+                strResponse.reserve( nResponseSize );
+                strResponse += '[';
+                for ( size_t i = 0; i < vecResponses.size(); ++i ) {
+                    if ( i > 0 )
+                        strResponse += ',';
+                    strResponse += vecResponses[i];
+                }
+                strResponse += ']';
+            } else
+                strResponse = vecResponses[0];
+            res.set_header( "access-control-allow-origin", "*" );
+            res.set_header( "vary", "Origin" );
+            res.set_content( strResponse.c_str(), "application/json" );
             return true;
         } );
         // check if somebody is already listening
@@ -3004,8 +3226,7 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
     joStats["blocks"] = generateBlocksStats();
     //
     nlohmann::json joExecutionPerformance = nlohmann::json::object();
-    joExecutionPerformance["RPC"] =
-        skutils::stats::time_tracker::queue::getQueueForSubsystem( "RPC" ).getAllStats();
+    joExecutionPerformance["RPC"] = skutils::stats::metrics::execution_performance( "RPC" );
     joStats["executionPerformance"] = joExecutionPerformance;
     joStats["protocols"]["http"]["listenerCount"] =
         serversHTTP4std_.size() + serversHTTP4nfo_.size() + serversHTTP6std_.size() +
@@ -3015,8 +3236,7 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
         serversHTTPS6nfo_.size();
     joStats["protocols"]["wss"]["listenerCount"] = serversWSS4std_.size() + serversWSS4nfo_.size() +
                                                    serversWSS6std_.size() + serversWSS6nfo_.size();
-    {  // block for subsystem stats using optimized locking only once
-        stats::lock_type_stats lock( stats::g_mtx_stats );
+    {  // block
         joStats["protocols"]["http"]["stats"] = stats::generate_subsystem_stats( "HTTP" );
         joStats["protocols"]["http"]["rpc"] = stats::generate_subsystem_stats( "RPC/HTTP" );
         joStats["protocols"]["https"]["stats"] = stats::generate_subsystem_stats( "HTTPS" );
@@ -3029,7 +3249,7 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
         joStats["protocols"]["wss"]["stats"] = stats::generate_subsystem_stats( "WSS" );
         joStats["protocols"]["wss"]["rpc"] = stats::generate_subsystem_stats( "RPC/WSS" );
         joStats["rpc"] = stats::generate_subsystem_stats( "RPC" );
-    }  // block for subsystem stats using optimized locking only once
+    }  // block
     //
     skutils::tools::load_monitor& lm = stat_get_load_monitor();
     double lfCpuLoad = lm.last_cpu_load();
@@ -3038,9 +3258,41 @@ nlohmann::json SkaleServerOverride::provideSkaleStats() {  // abstract from
     double lfMemUsage = skutils::tools::mem_usage();
     joStats["system"]["mem_usage"] = lfMemUsage;
     joStats["unddos"] = unddos_.stats();
+    joStats["batches"] = generateBatchStats();
+    joStats["jsonCache"] = generateJsonCacheStats();
+    joStats["wsSubscriptions"] = wsSubscriptionHub_.stats();
     return joStats;
 }
 
+bool SkaleServerOverride::isReadOnlyBatchJsonRpcRequest( const nlohmann::json& jarrRequest ) {
+    static const std::set< std::string > g_setReadOnlyMethods = {"web3_clientVersion",
+        "net_version", "eth_chainId", "eth_blockNumber", "eth_gasPrice", "eth_call",
+        "eth_estimateGas", "eth_getBalance", "eth_getCode", "eth_getStorageAt",
+        "eth_getTransactionCount", "eth_getLogs", "eth_getBlockByHash", "eth_getBlockByNumber",
+        "eth_getBlockTransactionCountByHash", "eth_getBlockTransactionCountByNumber",
+        "eth_getTransactionByHash", "eth_getTransactionByBlockHashAndIndex",
+        "eth_getTransactionByBlockNumberAndIndex", "eth_getTransactionReceipt"};
+    for ( const nlohmann::json& joRequest : jarrRequest ) {
+        std::string strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+        if ( g_setReadOnlyMethods.find( strMethod ) == g_setReadOnlyMethods.end() )
+            return false;
+    }
+    return true;
+}
+
+nlohmann::json SkaleServerOverride::generateBatchStats() const {
+    nlohmann::json joBatches = nlohmann::json::object();
+    joBatches["maxParallelism"] = maxParallelismInBatchJsonRpcRequest_;
+    joBatches["sequential"] = size_t( statsBatches_.cntSequential_ );
+    joBatches["parallel"] = size_t( statsBatches_.cntParallel_ );
+    joBatches["parallelRequests"] = size_t( statsBatches_.cntParallelRequests_ );
+    size_t cntParallel = statsBatches_.cntParallel_;
+    joBatches["averageFanOut"] =
+        cntParallel ? double( statsBatches_.cntWorkers_ ) / double( cntParallel ) : 0.0;
+    joBatches["maxFanOut"] = size_t( statsBatches_.nFanOutMax_ );
+    return joBatches;
+}
+
 bool SkaleServerOverride::handleInformationalRequest(
     const nlohmann::json& joRequest, nlohmann::json& joResponse ) {
     std::string strMethod = joRequest["method"].get< std::string >();
@@ -3146,6 +3398,253 @@ void SkaleServerOverride::informational_eth_getBalance(
     }
 }
 
+static std::string stat_json_value_to_string( const Json::Value& jv ) {
+    Json::FastWriter fastWriter;
+    std::string s = fastWriter.write( jv );
+    if ( !s.empty() && s.back() == '\n' )
+        s.pop_back();
+    return s;
+}
+
+void SkaleServerOverride::setNativeRpcHandler(
+    const std::string& strMethod, fn_native_rpc_handler_t fn ) {
+    if ( fn )
+        mapNativeRpcHandlers_[strMethod] = fn;
+    else
+        mapNativeRpcHandlers_.erase( strMethod );
+}
+
+bool SkaleServerOverride::handleNativeRpcRequest(
+    const nlohmann::json& joRequest, nlohmann::json& joResponse ) {
+    std::string strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+    native_rpc_map_t::const_iterator itFind = mapNativeRpcHandlers_.find( strMethod );
+    if ( itFind == mapNativeRpcHandlers_.end() )
+        return false;
+    // only requests jsonrpccpp passes to its method handler as is are answered natively, so
+    // validation errors, notifications and unusual ids stay with jsonrpccpp
+    if ( joRequest.count( "jsonrpc" ) == 0 || joRequest["jsonrpc"] != "2.0" )
+        return false;
+    if ( joRequest.count( "id" ) == 0 ||
+         !( joRequest["id"].is_number_integer() || joRequest["id"].is_string() ) )
+        return false;
+    if ( joRequest.count( "params" ) > 0 && !joRequest["params"].is_array() &&
+         !joRequest["params"].is_object() )
+        return false;
+    try {
+        itFind->second( joRequest, joResponse );
+    } catch ( const jsonrpc::JsonRpcException& ex ) {
+        // same error object as jsonrpccpp makes of exception thrown by method handler
+        joResponse.erase( "result" );
+        joResponse["error"]["code"] = ex.GetCode();
+        joResponse["error"]["message"] = ex.GetMessage();
+        joResponse["error"]["data"] =
+            nlohmann::json::parse( stat_json_value_to_string( ex.GetData() ) );
+    }
+    return true;
+}
+
+void SkaleServerOverride::installDefaultNativeRpcHandlers() {
+    // cheap getters, answers must be same as ones of libweb3jsonrpc
+    setNativeRpcHandler( "eth_blockNumber",
+        [this]( const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) -> void {
+            auto pEthereum = ethereum();
+            if ( !pEthereum )
+                throw std::runtime_error( "internal error, no Ethereum interface found" );
+            joResponse["result"] = dev::toJS( pEthereum->number() );
+        } );
+    setNativeRpcHandler( "eth_chainId",
+        [this]( const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) -> void {
+            auto pEthereum = ethereum();
+            if ( !pEthereum )
+                throw std::runtime_error( "internal error, no Ethereum interface found" );
+            joResponse["result"] = dev::toJS( pEthereum->chainId() );
+        } );
+    setNativeRpcHandler( "eth_gasPrice",
+        [this]( const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) -> void {
+            auto pEthereum = ethereum();
+            if ( !pEthereum )
+                throw std::runtime_error( "internal error, no Ethereum interface found" );
+            joResponse["result"] = dev::toJS( pEthereum->gasBidPrice() );
+        } );
+    setNativeRpcHandler( "net_version",
+        [this]( const nlohmann::json& /*joRequest*/, nlohmann::json& joResponse ) -> void {
+            joResponse["result"] = dev::toJS( chainParams().chainID );
+        } );
+    // snapshot info is produced by libweb3jsonrpc, only jsoncpp round trip is skipped here
+    if ( opts_.fn_snapshot_info_ )
+        setNativeRpcHandler( "skale_getSnapshot",
+            [this]( const nlohmann::json& joRequest, nlohmann::json& joResponse ) -> void {
+                joResponse["result"] = opts_.fn_snapshot_info_(
+                    joRequest.count( "params" ) > 0 ? joRequest["params"] : nlohmann::json() );
+            } );
+}
+
+void SkaleServerOverride::setSerializedRpcHandler(
+    const std::string& strMethod, fn_serialized_rpc_handler_t fn ) {
+    if ( fn )
+        mapSerializedRpcHandlers_[strMethod] = fn;
+    else
+        mapSerializedRpcHandlers_.erase( strMethod );
+}
+
+bool SkaleServerOverride::handleSerializedRpcRequest(
+    const nlohmann::json& joRequest, std::string& strResponse ) {
+    if ( joRequest.count( "id" ) == 0 )
+        return false;  // notifications are left to jsonrpccpp
+    std::string strMethod = skutils::tools::getFieldSafe< std::string >( joRequest, "method" );
+    serialized_rpc_map_t::const_iterator itFind = mapSerializedRpcHandlers_.find( strMethod );
+    if ( itFind == mapSerializedRpcHandlers_.end() )
+        return false;
+    std::string strResult;
+    if ( !itFind->second( joRequest, strResult ) )
+        return false;
+    std::string strID = joRequest["id"].dump();
+    strResponse.clear();
+    strResponse.reserve( strID.size() + strResult.size() + 40 );
+    strResponse += "{\"id\":";
+    strResponse += strID;
+    strResponse += ",\"jsonrpc\":\"2.0\",\"result\":";
+    strResponse += strResult;
+    strResponse += "}";
+    return true;
+}
+
+void SkaleServerOverride::installDefaultSerializedRpcHandlers() {
+    // answers must be same as ones of libweb3jsonrpc, anything unusual goes there
+    auto fnBlock = [this]( const nlohmann::json& joRequest, std::string& strResult,
+                       bool isByNumber ) -> bool {
+        if ( joRequest.count( "params" ) == 0 || !joRequest["params"].is_array() )
+            return false;
+        const nlohmann::json& jarrParams = joRequest["params"];
+        if ( jarrParams.size() != 2 || !jarrParams[0].is_string() || !jarrParams[1].is_boolean() )
+            return false;
+        auto pEthereum = ethereum();
+        if ( !pEthereum )
+            return false;
+        try {
+            std::string strBlock = jarrParams[0].get< std::string >();
+            bool bIncludeTransactions = jarrParams[1].get< bool >();
+            dev::h256 h;
+            if ( isByNumber ) {
+                if ( strBlock == "pending" )
+                    return false;  // not final
+                dev::eth::BlockNumber n = dev::eth::jsToBlockNumber( strBlock );
+                if ( !pEthereum->isKnown( n ) )
+                    return false;
+                h = pEthereum->hashFromNumber( n );
+            } else
+                h = dev::jsToFixed< 32 >( strBlock );
+            if ( !pEthereum->isKnown( h ) )
+                return false;
+            dev::SerializedCache::value_ptr p = serializedBlockJson( h, bIncludeTransactions );
+            if ( !p )
+                return false;
+            strResult = *p;
+            return true;
+        } catch ( ... ) {
+            return false;  // let libweb3jsonrpc produce proper error
+        }
+    };
+    setSerializedRpcHandler( "eth_getBlockByNumber",
+        [fnBlock]( const nlohmann::json& joRequest, std::string& strResult ) -> bool {
+            return fnBlock( joRequest, strResult, true );
+        } );
+    setSerializedRpcHandler( "eth_getBlockByHash",
+        [fnBlock]( const nlohmann::json& joRequest, std::string& strResult ) -> bool {
+            return fnBlock( joRequest, strResult, false );
+        } );
+    auto fnTransaction = [this]( const nlohmann::json& joRequest, std::string& strResult,
+                             bool isReceipt ) -> bool {
+        if ( joRequest.count( "params" ) == 0 || !joRequest["params"].is_array() )
+            return false;
+        const nlohmann::json& jarrParams = joRequest["params"];
+        if ( jarrParams.size() != 1 || !jarrParams[0].is_string() )
+            return false;
+        auto pEthereum = ethereum();
+        if ( !pEthereum )
+            return false;
+        try {
+            dev::h256 h = dev::jsToFixed< 32 >( jarrParams[0].get< std::string >() );
+            if ( !pEthereum->isKnownTransaction( h ) )
+                return false;  // pending ones may still change
+            std::string strKey = ( isReceipt ? "r" : "t" ) + h.hex();
+            dev::SerializedCache::value_ptr p = serializedJsonCache_.get( strKey );
+            if ( !p ) {
+                Json::Value jv;
+                if ( isReceipt )
+                    jv = dev::eth::toJson( pEthereum->localisedTransactionReceipt( h ) );
+                else
+                    jv = dev::eth::toJson( pEthereum->localisedTransaction( h ) );
+                p = serializedJsonCache_.insert( strKey, stat_json_value_to_string( jv ) );
+            }
+            strResult = *p;
+            return true;
+        } catch ( ... ) {
+            return false;
+        }
+    };
+    setSerializedRpcHandler( "eth_getTransactionByHash",
+        [fnTransaction]( const nlohmann::json& joRequest, std::string& strResult ) -> bool {
+            return fnTransaction( joRequest, strResult, false );
+        } );
+    setSerializedRpcHandler( "eth_getTransactionReceipt",
+        [fnTransaction]( const nlohmann::json& joRequest, std::string& strResult ) -> bool {
+            return fnTransaction( joRequest, strResult, true );
+        } );
+}
+
+dev::SerializedCache::value_ptr SkaleServerOverride::serializedBlockJson(
+    const dev::h256& hBlock, bool bIncludeTransactions ) {
+    auto pEthereum = ethereum();
+    if ( !pEthereum )
+        return dev::SerializedCache::value_ptr();
+    std::string strKey = ( bIncludeTransactions ? "B" : "b" ) + hBlock.hex();
+    dev::SerializedCache::value_ptr p = serializedJsonCache_.get( strKey );
+    if ( p )
+        return p;
+    Json::Value jv;
+    if ( bIncludeTransactions )
+        jv = dev::eth::toJson( pEthereum->blockInfo( hBlock ), pEthereum->blockDetails( hBlock ),
+            pEthereum->uncleHashes( hBlock ), pEthereum->transactions( hBlock ),
+            pEthereum->sealEngine() );
+    else
+        jv = dev::eth::toJson( pEthereum->blockInfo( hBlock ), pEthereum->blockDetails( hBlock ),
+            pEthereum->uncleHashes( hBlock ), pEthereum->transactionHashes( hBlock ),
+            pEthereum->sealEngine() );
+    return serializedJsonCache_.insert( strKey, stat_json_value_to_string( jv ) );
+}
+
+nlohmann::json SkaleServerOverride::generateJsonCacheStats() const {
+    nlohmann::json joCache = nlohmann::json::object();
+    joCache["hits"] = serializedJsonCache_.hits();
+    joCache["misses"] = serializedJsonCache_.misses();
+    joCache["entries"] = serializedJsonCache_.size();
+    joCache["bytes"] = serializedJsonCache_.bytes();
+    joCache["maxBytes"] = serializedJsonCache_.maxBytes();
+    return joCache;
+}
+
+void SkaleServerOverride::writeOpenMetrics(
+    skutils::stats::metrics::open_metrics_writer& w ) const {
+    typedef skutils::stats::metrics::open_metrics_writer writer;
+    const std::string strCache = writer::label( "cache", "json" );
+    w.family( "skaled_cache_hits", "counter", "Cache lookups found entry." );
+    w.sample( "skaled_cache_hits_total", strCache, uint64_t( serializedJsonCache_.hits() ) );
+    w.family( "skaled_cache_misses", "counter", "Cache lookups missed entry." );
+    w.sample( "skaled_cache_misses_total", strCache, uint64_t( serializedJsonCache_.misses() ) );
+    w.family( "skaled_cache_bytes", "gauge", "Size of cached entries." );
+    w.sample( "skaled_cache_bytes", strCache, uint64_t( serializedJsonCache_.bytes() ) );
+    nlohmann::json joSubscriptions = wsSubscriptionHub_.stats();
+    w.family( "skaled_ws_subscriptions", "gauge", "Active WebSocket subscriptions." );
+    for ( const char* strKind : {"logs", "newHeads", "newPendingTransactions"} )
+        w.sample( "skaled_ws_subscriptions", writer::label( "kind", strKind ),
+            joSubscriptions[strKind].get< uint64_t >() );
+    w.family( "skaled_ws_notifications", "counter", "WebSocket notifications." );
+    for ( const char* strState : {"sent", "dropped"} )
+        w.sample( "skaled_ws_notifications_total", writer::label( "state", strState ),
+            joSubscriptions[strState].get< uint64_t >() );
+}
+
 bool SkaleServerOverride::handleRequestWithBinaryAnswer(
     e_server_mode_t /*esm*/, const nlohmann::json& joRequest, std::vector< uint8_t >& buffer ) {
     buffer.clear();
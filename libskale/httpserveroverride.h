@@ -48,11 +48,13 @@ typedef intptr_t ssize_t;
 #include <memory>
 #include <mutex>
 #include <set>
+#include <shared_mutex>
 #include <string>
 
 #include <skutils/console_colors.h>
 #include <skutils/dispatch.h>
 #include <skutils/http.h>
+#include <skutils/open_metrics.h>
 #include <skutils/stats.h>
 #include <skutils/unddos.h>
 #include <skutils/utils.h>
@@ -60,6 +62,7 @@ typedef intptr_t ssize_t;
 #include <json.hpp>
 
 #include <libdevcore/Log.h>
+#include <libdevcore/SerializedCache.h>
 #include <libethereum/ChainParams.h>
 #include <libethereum/Interface.h>
 #include <libethereum/LogFilter.h>
@@ -125,7 +128,26 @@ struct SkaleServerConnectionsTrackHelper {
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class SkaleWsPeer : public skutils::ws::peer {
+// receiver of notifications queued by SkaleWsSubscriptionFanOut, implemented by SkaleWsPeer
+class SkaleWsSubscriber {
+public:
+    std::atomic_size_t nPendingNotifications_ = 0;  // queued by SkaleWsSubscriptionFanOut, not sent
+    virtual ~SkaleWsSubscriber() {}
+    virtual size_t ref_retain() = 0;
+    virtual size_t ref_release() = 0;
+    virtual bool isConnected() const noexcept = 0;
+    virtual const std::string& notificationQueueID() const = 0;
+    virtual bool sendNotification(
+        const std::string& strSubscriptionType, const std::string& strNotification ) = 0;
+    // subscription was closed by SkaleWsSubscriptionFanOut, not by peer, called in
+    // notificationQueueID() queue
+    virtual void onSubscriptionClosed( unsigned idSubscription ) = 0;
+};  /// class SkaleWsSubscriber
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class SkaleWsPeer : public skutils::ws::peer, public SkaleWsSubscriber {
 public:
     std::atomic_size_t nTaskNumberInPeer_ = 0;
     const std::string m_strPeerQueueID;
@@ -142,6 +164,14 @@ public:
     void onLogMessage(
         skutils::ws::e_ws_log_message_type_t eWSLMT, const std::string& msg ) override;
 
+    size_t ref_retain() override { return skutils::ws::peer::ref_retain(); }
+    size_t ref_release() override { return skutils::ws::peer::ref_release(); }
+    bool isConnected() const noexcept override { return skutils::ws::peer::isConnected(); }
+    const std::string& notificationQueueID() const override { return m_strPeerQueueID; }
+    bool sendNotification(
+        const std::string& strSubscriptionType, const std::string& strNotification ) override;
+    void onSubscriptionClosed( unsigned idSubscription ) override;
+
     std::string desc( bool isColored = true ) const {
         return getShortPeerDescription( isColored, false, false );
     }
@@ -160,6 +190,31 @@ protected:
 public:
     bool handleRequestWithBinaryAnswer( e_server_mode_t esm, const nlohmann::json& joRequest );
 
+    // binary eth_sendRawTransaction frame is g_binaryRawTransactionsMagic followed by raw
+    // transaction RLPs, each prefixed with its 32-bit little endian length; answer is
+    // g_binaryRawTransactionsAnswerMagic, 32-bit little endian count and then, per transaction,
+    // either one dev::eth::ImportResult byte followed by 32 bytes of transaction hash, or
+    // g_binaryRawTransactionUndecodable byte followed by 32-bit little endian length and error
+    // description text for transaction that could not be decoded; frame that is rejected as
+    // a whole (malformed, too many transactions, banned) is answered with
+    // g_binaryRawTransactionsErrorMagic followed by error description text
+    static const char g_binaryRawTransactionsMagic[4];
+    static const char g_binaryRawTransactionsAnswerMagic[4];
+    static const char g_binaryRawTransactionsErrorMagic[4];
+    static const uint8_t g_binaryRawTransactionUndecodable = 0xff;
+    struct binary_raw_transaction_result_t {
+        dev::eth::ImportResult result_ = dev::eth::ImportResult::Malformed;
+        dev::h256 hash_;
+        std::string strError_;  // not empty if transaction was not decoded
+    };
+    static bool isBinaryRawTransactionsFrame( const std::string& msg );
+    static std::vector< dev::bytesConstRef > decodeBinaryRawTransactions(
+        const std::string& msg, size_t nMaxCount );  // throws
+    static std::string encodeBinaryRawTransactionsAnswer(
+        const std::vector< binary_raw_transaction_result_t >& vecResults );
+    static std::string encodeBinaryRawTransactionsError( const std::string& strError );
+    void handleBinaryRawTransactions( const std::string& msg );
+
     bool handleWebSocketSpecificRequest(
         e_server_mode_t esm, const nlohmann::json& joRequest, std::string& strResponse );
     bool handleWebSocketSpecificRequest(
@@ -195,6 +250,90 @@ private:
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// subscriptions and delivery of notifications to them, without knowledge of where events come from
+class SkaleWsSubscriptionFanOut {
+public:
+    typedef unsigned subscription_id_t;
+    // notifications queued to one peer and not sent yet, subscription which would exceed this is
+    // closed and peer gets error notification for it
+    static const size_t g_nMaxPendingNotificationsPerPeer = 1024;
+    typedef std::shared_ptr< const std::string > shared_text_t;
+
+protected:
+    struct subscriber_t {
+        subscription_id_t idSubscription_ = 0;
+        subscription_id_t idSubscriptionPublic_ = 0;  // as seen by peer, with type bits
+        skutils::retain_release_ptr< SkaleWsSubscriber > pPeer_;
+    };
+    typedef std::vector< subscriber_t > vec_subscribers_t;
+    struct log_filter_group_t {
+        dev::eth::LogFilter logFilter_;
+        vec_subscribers_t subscribers_;
+    };
+    // all subscriptions, replaced as a whole on each change and read without locking
+    struct subscriptions_t {
+        std::map< dev::h256, log_filter_group_t > mapLogFilterGroups_;  // by LogFilter::sha3()
+        vec_subscribers_t vecNewHeads_, vecNewHeadsWithTransactions_, vecNewPendingTransactions_;
+    };
+    typedef std::shared_ptr< const subscriptions_t > subscriptions_ptr_t;
+    typedef skutils::multithreading::recursive_mutex_type mutex_type;
+    typedef std::lock_guard< mutex_type > lock_type;
+    mutable mutex_type mtx_;
+    subscriptions_ptr_t pSubscriptions_;
+    subscriptions_ptr_t subscriptions() const;
+    void publish( const subscriptions_t& subscriptions );
+    std::atomic< subscription_id_t > next_subscription_;
+
+    std::atomic_size_t cntNotificationsSerialized_ = 0, cntNotificationsSent_ = 0,
+                       cntNotificationsDropped_ = 0, cntSubscriptionsClosed_ = 0;
+
+    // queued jobs may outlive this object, they run only while it is alive
+    struct lifetime_t {
+        std::shared_mutex mtx_;
+        bool isAlive_ = true;
+    };
+    std::shared_ptr< lifetime_t > pLifetime_;
+    void async( const std::string& strQueueID, std::function< void() > fn );
+    void stopAsync();  // waits for running jobs, queued ones are skipped
+
+    void fanOut( const char* strSubscriptionType, const vec_subscribers_t& subscribers,
+        const shared_text_t& pResult );
+    void closeSlowSubscription( const subscriber_t& subscriber );
+
+public:
+    SkaleWsSubscriptionFanOut();
+    virtual ~SkaleWsSubscriptionFanOut();
+    subscription_id_t subscribeLogs( SkaleWsSubscriber* pPeer, const dev::eth::LogFilter& logFilter,
+        subscription_id_t idTypeBits );
+    subscription_id_t subscribeNewHeads(
+        SkaleWsSubscriber* pPeer, bool bIncludeTransactions, subscription_id_t idTypeBits );
+    subscription_id_t subscribeNewPendingTransactions(
+        SkaleWsSubscriber* pPeer, subscription_id_t idTypeBits );
+    bool unsubscribe( const subscription_id_t& idSubscription );
+    nlohmann::json stats() const;
+};  /// class SkaleWsSubscriptionFanOut
+
+// feeds SkaleWsSubscriptionFanOut with new blocks and pending transactions of Client
+class SkaleWsSubscriptionHub : public SkaleWsSubscriptionFanOut {
+protected:
+    SkaleServerOverride& sso_;
+    unsigned iwNewBlock_ = unsigned( -1 ), iwNewPendingTransaction_ = unsigned( -1 );
+    std::atomic_size_t cntBlocks_ = 0;
+
+    void onNewBlock( const dev::h256& hBlock, const dev::eth::TransactionReceipts& receipts );
+    void onNewPendingTransaction( const dev::h256& hTransaction );
+
+public:
+    SkaleWsSubscriptionHub( SkaleServerOverride& sso );
+    ~SkaleWsSubscriptionHub() override;
+    void installClientWatches();
+    void uninstallClientWatches();
+    nlohmann::json stats() const;
+};  /// class SkaleWsSubscriptionHub
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class SkaleServerHelper {
 protected:
     int m_nServerIndex;
@@ -216,6 +355,7 @@ protected:
     std::string strBindAddr_, strInterfaceName_;
     std::string m_strScheme_;
     std::string m_strSchemeUC;
+    std::string m_strStatsSubSystem;  // "RPC/" and scheme, for per protocol RPC statistics
     int m_nPort = -1;
     SkaleServerOverride* m_pSO = nullptr;
     e_server_mode_t esm_;
@@ -248,6 +388,7 @@ public:
 
     std::string nfoGetScheme() const { return m_strScheme_; }
     std::string nfoGetSchemeUC() const { return m_strSchemeUC; }
+    const std::string& statsSubSystem() const { return m_strStatsSubSystem; }
 
     friend class SkaleWsPeer;
 };  /// class SkaleRelayWS
@@ -277,6 +418,9 @@ public:
         const std::string& strRequest, std::string& strResponse );
     bool handleHttpSpecificRequest( const std::string& strOrigin, e_server_mode_t esm,
         const nlohmann::json& joRequest, nlohmann::json& joResponse );
+    // protocol specific, HTTP specific or native handling of already parsed request
+    bool handleParsedRequest( const std::string& strOrigin, e_server_mode_t esm,
+        const nlohmann::json& joRequest, nlohmann::json& joResponse );
 
 protected:
     typedef void ( SkaleRelayHTTP::*rpc_method_t )( const std::string& strOrigin,
@@ -298,11 +442,15 @@ class SkaleServerOverride : public jsonrpc::AbstractServerConnector,
 public:
     typedef std::function< std::vector< uint8_t >( const nlohmann::json& joRequest ) >
         fn_binary_snapshot_download_t;
+    // answers skale_getSnapshot with given params, throws jsonrpc::JsonRpcException for errors
+    // jsonrpccpp reports as error objects
+    typedef std::function< nlohmann::json( const nlohmann::json& joParams ) > fn_snapshot_info_t;
 
     static const double g_lfDefaultExecutionDurationMaxForPerformanceWarning;  // in seconds,
                                                                                // default 1 second
 
     size_t maxCountInBatchJsonRpcRequest_ = 128;
+    size_t maxParallelismInBatchJsonRpcRequest_ = 8;  // 0 means sequential batch execution
 
     skutils::unddos::algorithm unddos_;
 
@@ -371,6 +519,7 @@ public:
     struct opts_t {
         net_opts_t netOpts_;
         fn_binary_snapshot_download_t fn_binary_snapshot_download_;
+        fn_snapshot_info_t fn_snapshot_info_;
         double lfExecutionDurationMaxForPerformanceWarning_ = 0;  // in seconds
         bool isTraceCalls_ = false;
         bool isTraceSpecialCalls_ = false;
@@ -381,6 +530,7 @@ public:
         opts_t& assign( const opts_t& other ) {
             netOpts_ = other.netOpts_;
             fn_binary_snapshot_download_ = other.fn_binary_snapshot_download_;
+            fn_snapshot_info_ = other.fn_snapshot_info_;
             lfExecutionDurationMaxForPerformanceWarning_ =
                 other.lfExecutionDurationMaxForPerformanceWarning_;
             isTraceCalls_ = other.isTraceCalls_;
@@ -481,6 +631,48 @@ protected:
 public:
     bool handleRequestWithBinaryAnswer(
         e_server_mode_t esm, const nlohmann::json& joRequest, std::vector< uint8_t >& buffer );
+
+    // native handlers work on already parsed request, jsonrpccpp handler is used only for
+    // methods without them and for requests of unusual form; should be set before
+    // StartListening(); answers must be byte-for-byte same as ones of jsonrpccpp
+    typedef std::function< void( const nlohmann::json& joRequest, nlohmann::json& joResponse ) >
+        fn_native_rpc_handler_t;
+    void setNativeRpcHandler( const std::string& strMethod, fn_native_rpc_handler_t fn );
+    bool handleNativeRpcRequest( const nlohmann::json& joRequest, nlohmann::json& joResponse );
+
+protected:
+    typedef std::map< std::string, fn_native_rpc_handler_t > native_rpc_map_t;
+    native_rpc_map_t mapNativeRpcHandlers_;
+    void installDefaultNativeRpcHandlers();
+
+public:
+    // serialized handlers answer with ready JSON text of "result" which is spliced into response
+    // as is; they return false to pass request further to native or jsonrpccpp handlers
+    typedef std::function< bool( const nlohmann::json& joRequest, std::string& strResult ) >
+        fn_serialized_rpc_handler_t;
+    void setSerializedRpcHandler( const std::string& strMethod, fn_serialized_rpc_handler_t fn );
+    bool handleSerializedRpcRequest( const nlohmann::json& joRequest, std::string& strResponse );
+
+protected:
+    typedef std::map< std::string, fn_serialized_rpc_handler_t > serialized_rpc_map_t;
+    serialized_rpc_map_t mapSerializedRpcHandlers_;
+    void installDefaultSerializedRpcHandlers();
+    // blocks, transactions and receipts never change once known, so their JSON is kept by hash
+    static const size_t g_nSerializedJsonCacheMaxBytes = 64 * 1024 * 1024;
+    dev::SerializedCache serializedJsonCache_{g_nSerializedJsonCacheMaxBytes};
+    nlohmann::json generateJsonCacheStats() const;
+    // JSON cache and subscriptions, RPC methods are exported by skutils::stats::metrics itself
+    skutils::stats::metrics::collector_id_t idMetricsCollector_ = 0;
+    void writeOpenMetrics( skutils::stats::metrics::open_metrics_writer& w ) const;
+
+public:
+    dev::SerializedCache::value_ptr serializedBlockJson(
+        const dev::h256& hBlock, bool bIncludeTransactions );
+
+protected:
+    SkaleWsSubscriptionHub wsSubscriptionHub_;
+
+public:
     bool handleAdminOriginFilter( const std::string& strMethod, const std::string& strOriginURL );
 
     bool isShutdownMode() const { return m_bShutdownMode; }
@@ -497,6 +689,18 @@ protected:
     void setSchainExitTime( SkaleServerHelper& sse, const std::string& strOrigin,
         const nlohmann::json& joRequest, nlohmann::json& joResponse );
 
+    static bool isReadOnlyBatchJsonRpcRequest( const nlohmann::json& jarrRequest );
+    struct batch_stats_t {
+        std::atomic_size_t cntSequential_ = 0;
+        std::atomic_size_t cntParallel_ = 0;
+        std::atomic_size_t cntParallelRequests_ = 0;
+        std::atomic_size_t cntWorkers_ = 0;
+        std::atomic_size_t nFanOutMax_ = 0;
+    };
+    batch_stats_t statsBatches_;
+    std::atomic_size_t nBatchQueueRoundRobin_ = 0;
+    nlohmann::json generateBatchStats() const;
+
     unsigned iwBlockStats_ = unsigned( -1 ), iwPendingTransactionStats_ = unsigned( -1 );
     skutils::stats::named_event_stats statsBlocks_, statsTransactions_, statsPendingTx_;
     nlohmann::json generateBlocksStats();
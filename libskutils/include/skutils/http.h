@@ -56,6 +56,7 @@ typedef int socket_t;
 #include <time.h>
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -78,6 +79,7 @@ typedef int socket_t;
 #include <skutils/dispatch.h>
 #include <skutils/multithreading.h>
 #include <skutils/network.h>
+#include <skutils/thread_pool.h>
 #include <skutils/url.h>
 #include <skutils/utils.h>
 
@@ -96,6 +98,17 @@ typedef int socket_t;
 
 #define __SKUTILS_HTTP_CLIENT_CONNECT_TIMEOUT_MILLISECONDS__ ( 60 * 1000 )
 
+#if ( defined __linux__ )
+#define __SKUTILS_HTTP_WITH_EVENT_LOOP__ 1
+#endif
+
+#define __SKUTILS_HTTP_EVENT_LOOP_WAIT_MILLISECONDS__ ( 1000 )
+#define __SKUTILS_HTTP_EVENT_LOOP_MAX_HEADERS_SIZE__ ( 64 * 1024 )
+#define __SKUTILS_HTTP_EVENT_LOOP_MAX_REQUEST_SIZE__ ( 32 * 1024 * 1024 )
+// per connection limits, socket is not read while either of them is reached
+#define __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_REQUESTS__ ( 64 )
+#define __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_OUTPUT_SIZE__ ( 32 * 1024 * 1024 )
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -239,6 +252,51 @@ private:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// reads one already received request, collects written response
+class memory_stream : public stream {
+public:
+    memory_stream( const std::string& in, std::string& out, const std::string& remote_addr );
+    virtual ~memory_stream();
+    virtual int read( char* ptr, size_t size );
+    virtual int write( const char* ptr, size_t size );
+    virtual std::string get_remote_addr() const;
+
+private:
+    const std::string& in_;
+    size_t pos_ = 0;
+    std::string& out_;
+    std::string remote_addr_;
+};  /// class memory_stream
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// client socket owned by server's event loop, all socket I/O is done with mtx_ locked
+class event_loop_connection {
+public:
+    const uint64_t id_;  // epoll event data, unlike socket it is never reused by server
+    const socket_t socket_;
+    const std::string origin_, remote_addr_;
+    std::mutex mtx_;
+    std::string in_;                      // received bytes not yet framed into requests
+    size_t frame_resume_ = 0;             // where framing of incomplete request in in_ continues
+    std::deque< std::string > pending_;  // complete requests, processed in order
+    std::string out_;                     // responses not yet accepted by socket
+    size_t cnt_served_ = 0;
+    bool busy_ = false;  // worker is draining pending_
+    bool close_after_flush_ = false;
+    bool closed_ = false;
+    bool reading_paused_ = false;  // EPOLLIN is dropped while pending_ or out_ is over limit
+    std::chrono::steady_clock::time_point tpLastActivity_;
+    event_loop_connection( uint64_t id, socket_t socket, const std::string& origin,
+        const std::string& remote_addr );
+};  /// class event_loop_connection
+
+typedef std::shared_ptr< event_loop_connection > event_loop_connection_ptr;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class server;
 
 class async_query_handler : public skutils::ref_retain_release {
@@ -426,6 +484,13 @@ public:
     void stop();
     virtual bool is_ssl() const { return false; }
 
+    // epoll based event loop, used for non-SSL server in async mode, set before listen
+    bool is_event_loop_mode() const { return is_event_loop_mode_; }
+    void set_event_loop_mode( bool is_event_loop_mode ) {
+        is_event_loop_mode_ = is_event_loop_mode;
+    }
+    size_t event_loop_connection_count() const;
+
 protected:
     bool process_request(
         const std::string& origin, stream& strm, bool last_connection, bool& connection_close );
@@ -452,6 +517,27 @@ private:
     virtual bool read_and_close_socket_sync( socket_t sock );
     virtual void read_and_close_socket_async( socket_t sock );
 
+    bool listen_internal_event_loop();
+    void event_loop_accept();
+    void event_loop_read( event_loop_connection_ptr pConn );
+    void event_loop_write( event_loop_connection_ptr pConn );
+    void event_loop_drain( event_loop_connection_ptr pConn );
+    bool event_loop_flush( event_loop_connection& conn );  // call with conn.mtx_ locked
+    bool event_loop_frame( event_loop_connection& conn );  // call with conn.mtx_ locked
+    bool event_loop_throttle( event_loop_connection& conn );  // call with conn.mtx_ locked
+    void event_loop_schedule( event_loop_connection_ptr pConn );  // call with conn.mtx_ locked
+    void event_loop_close( event_loop_connection_ptr pConn );
+    void event_loop_close_idle();
+    void event_loop_close_all();
+    event_loop_connection_ptr event_loop_find( uint64_t id ) const;
+
+    std::atomic_bool is_event_loop_mode_ = false;
+    int epoll_fd_ = -1;
+    mutable std::mutex event_loop_connections_mtx_;
+    std::map< uint64_t, event_loop_connection_ptr > event_loop_connections_;  // by id_
+    uint64_t event_loop_last_id_ = 0;  // 0 is id of listening socket
+    std::unique_ptr< skutils::work_stealing_pool > event_loop_workers_;
+
     std::atomic_bool is_in_loop_ = false;
     std::atomic_bool is_running_ = false;
     socket_t svr_sock_;
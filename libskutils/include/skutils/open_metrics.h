@@ -0,0 +1,86 @@
+#if ( !defined __SKUTILS_OPEN_METRICS_H )
+#define __SKUTILS_OPEN_METRICS_H 1
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <skutils/stats.h>
+
+namespace skutils {
+namespace http {
+class server;
+};  // namespace http
+};  // namespace skutils
+
+namespace skutils {
+namespace stats {
+namespace metrics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// text exposition format of OpenMetrics, every family must be declared once before its samples
+class open_metrics_writer {
+public:
+    open_metrics_writer() = default;
+    void family( const std::string& strName, const char* strType, const char* strHelp = nullptr );
+    void sample( const std::string& strName, const std::string& strLabels, double lfValue );
+    void sample( const std::string& strName, const std::string& strLabels, uint64_t nValue );
+    // emits _bucket, _count and _sum samples of histogram in seconds
+    void histogram_samples(
+        const std::string& strName, const std::string& strLabels, const latency_histogram& h );
+    // returns name="value" with value escaped
+    static std::string label( const char* strName, const std::string& strValue );
+    static std::string join_labels( const std::string& strLabelsA, const std::string& strLabelsB );
+    const std::string& text();  // terminated with # EOF
+
+private:
+    std::string str_;
+    bool isFinished_ = false;
+};  /// class open_metrics_writer
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// named series for node internals, labels are written with open_metrics_writer::label(), returned
+// references are valid forever, lock-free after first use of each series by calling thread
+latency_histogram& histogram( const char* strName, const std::string& strLabels = "" );
+sharded_counter& counter( const char* strName, const std::string& strLabels = "" );
+
+// collectors are called at scrape time to emit gauges of components
+typedef std::function< void( open_metrics_writer& w ) > fn_collector_t;
+typedef size_t collector_id_t;
+collector_id_t add_collector( fn_collector_t fn );
+void remove_collector( collector_id_t id );  // waits for running scrape to finish
+
+// RPC method metrics, named series and output of all collectors
+std::string open_metrics_text();
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// serves GET /metrics from one dedicated thread using synchronous HTTP server
+class exporter {
+public:
+    exporter();
+    exporter( const exporter& ) = delete;
+    exporter& operator=( const exporter& ) = delete;
+    virtual ~exporter();
+    bool start( int ipVer, const std::string& strAddr, int nPort );
+    void stop();
+    bool is_running() const;
+
+private:
+    std::unique_ptr< skutils::http::server > pServer_;
+    std::thread thread_;
+    std::atomic_bool isListenFailed_{false};
+};  /// class exporter
+
+};  // namespace metrics
+};  // namespace stats
+};  // namespace skutils
+
+#endif  /// (!defined __SKUTILS_OPEN_METRICS_H)
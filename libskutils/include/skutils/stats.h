@@ -190,6 +190,139 @@ double stat_compute_bps_last_known(
 double stat_compute_bps_til_now( const traffic_queue_t& qtr, bytes_count_t* p_nSummary = nullptr );
 };  // namespace named_traffic_stats
 
+namespace metrics {
+
+// counter split into cache line sized shards, each thread always increments the same shard
+class sharded_counter {
+public:
+    static constexpr size_t g_nShardCount = 8;
+
+    sharded_counter() = default;
+    sharded_counter( const sharded_counter& ) = delete;
+    sharded_counter& operator=( const sharded_counter& ) = delete;
+    void add( uint64_t n = 1 ) noexcept {
+        shards_[shard_index()].value_.fetch_add( n, std::memory_order_relaxed );
+    }
+    uint64_t load() const noexcept;
+    static size_t shard_index() noexcept;
+
+private:
+    struct alignas( 64 ) shard_t {
+        std::atomic_uint64_t value_{0};
+    };
+    shard_t shards_[g_nShardCount];
+};  /// class sharded_counter
+
+// log-linear histogram of durations in microseconds, 16 sub-buckets per power of two,
+// so reported percentiles are within 1/16 of the real value
+class latency_histogram {
+public:
+    static constexpr size_t g_nSubBucketBits = 4;
+    static constexpr size_t g_nSubBucketCount = size_t( 1 ) << g_nSubBucketBits;
+    static constexpr size_t g_nMaxValueBits = 36;  // ~19 hours, larger values are clamped
+    static constexpr size_t g_nBucketCount =
+        ( g_nMaxValueBits - g_nSubBucketBits + 1 ) * g_nSubBucketCount;
+
+    latency_histogram() = default;
+    latency_histogram( const latency_histogram& ) = delete;
+    latency_histogram& operator=( const latency_histogram& ) = delete;
+    void record( uint64_t nMicroseconds ) noexcept {
+        buckets_[bucket_index( nMicroseconds )].fetch_add( 1, std::memory_order_relaxed );
+        sum_.fetch_add( nMicroseconds, std::memory_order_relaxed );
+    }
+    uint64_t count() const noexcept;
+    uint64_t sum() const noexcept { return sum_.load( std::memory_order_relaxed ); }
+    uint64_t min() const noexcept;  // upper bound of lowest non-empty bucket, 0 if empty
+    uint64_t max() const noexcept;  // upper bound of highest non-empty bucket, 0 if empty
+    void load( uint64_t ( &arrCounts )[g_nBucketCount] ) const noexcept;
+    // returns upper bound of bucket containing given percentile (0.0...1.0), 0 if empty
+    uint64_t percentile( double lfPercentile ) const noexcept;
+    static size_t bucket_index( uint64_t nValue ) noexcept;
+    static uint64_t bucket_upper_bound( size_t nIndex ) noexcept;
+
+private:
+    std::atomic_uint64_t buckets_[g_nBucketCount] = {};
+    std::atomic_uint64_t sum_{0};
+};  /// class latency_histogram
+
+// records lifetime of scope into histogram
+class scoped_timer {
+public:
+    explicit scoped_timer( latency_histogram& h ) : h_( h ), tpStart_( clock::now() ) {}
+    scoped_timer( const scoped_timer& ) = delete;
+    scoped_timer& operator=( const scoped_timer& ) = delete;
+    ~scoped_timer() {
+        auto d = std::chrono::duration_cast< std::chrono::microseconds >( clock::now() - tpStart_ );
+        h_.record( uint64_t( d.count() ) );
+    }
+
+private:
+    latency_histogram& h_;
+    time_point tpStart_;
+};  /// class scoped_timer
+
+// records latency of one call into histograms of method in subsystem and in per protocol
+// subsystem, once, on stop() or destruction; names are not copied and must outlive timer
+class call_timer {
+public:
+    call_timer( const char* strSubSystem, const char* strSubSystemProtocol,
+        const char* strMethod ) noexcept
+        : strSubSystem_( strSubSystem ),
+          strSubSystemProtocol_( strSubSystemProtocol ),
+          strMethod_( strMethod ),
+          tpStart_( clock::now() ) {}
+    call_timer( const call_timer& ) = delete;
+    call_timer& operator=( const call_timer& ) = delete;
+    ~call_timer() {
+        try {
+            stop();
+        } catch ( ... ) {
+        }
+    }
+    double stop();  // returns duration in seconds
+
+private:
+    const char *strSubSystem_, *strSubSystemProtocol_, *strMethod_;
+    time_point tpStart_;
+    double lfSeconds_ = 0.0;
+    bool isStopped_ = false;
+};  /// class call_timer
+
+// statistics of one method in one subsystem, entries are never deleted so references stay valid
+class method_metrics {
+public:
+    sharded_counter calls_, answers_, errors_, exceptions_, bytes_recv_, bytes_sent_;
+    latency_histogram latency_;
+
+private:
+    // previous read, used for computing rates, guarded by registry mutex
+    friend nlohmann::json subsystem_stats( const char* strSubSystem );
+    time_point tpPrevRead_ = clock::now();
+    uint64_t arrPrev_[6] = {0, 0, 0, 0, 0, 0};
+    double arrRates_[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+};  /// class method_metrics
+
+extern size_t g_nMaxMethodsPerSubsystem;  // further methods are counted as unknown-method
+
+// lock-free and allocation-free after first use of each subsystem/method pair by calling
+// thread, and for any further method of subsystem which has g_nMaxMethodsPerSubsystem methods
+method_metrics& get( const char* strSubSystem, const char* strMethod );
+
+typedef std::function< void(
+    const std::string& strSubSystem, const std::string& strMethod, const method_metrics& mm ) >
+    fn_method_metrics_visitor_t;
+void for_each( fn_method_metrics_visitor_t fn );  // sorted by subsystem and method
+
+// calls, answers, errors, exceptions, traffic with per second rates computed since previous
+// read and latency percentiles of every method in subsystem
+nlohmann::json subsystem_stats( const char* strSubSystem );
+
+// minimal, maximal and average call time of "subsystem/protocol" subsystems and summary of
+// them, in format of time_tracker::queue::getAllStats() but computed over all recorded calls
+nlohmann::json execution_performance( const char* strSubSystem );
+
+};  // namespace metrics
+
 namespace time_tracker {
 
 class element : public skutils::ref_retain_release {
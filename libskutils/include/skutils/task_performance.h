@@ -2,7 +2,7 @@
 #define __SKUTILS_TASK_PERFORMANCE_H 1
 
 #include <atomic>
-#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -30,175 +30,50 @@ typedef std::string string;
 
 typedef nlohmann::json json;
 
-typedef skutils::multithreading::mutex_type mutex_type;
-typedef skutils::multithreading::recursive_mutex_type recursive_mutex_type;
-
-class item;
-class queue;
 class tracker;
 class action;
 
-typedef skutils::retain_release_ptr< item > item_ptr;
-typedef skutils::retain_release_ptr< queue > queue_ptr;
 typedef skutils::retain_release_ptr< tracker > tracker_ptr;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class lockable {
-public:
-    typedef recursive_mutex_type mutex_type;
-    typedef std::lock_guard< mutex_type > lock_type;
-
-    lockable();
-    lockable( const lockable& ) = delete;
-    lockable( lockable&& ) = delete;
-    virtual ~lockable();
-    lockable& operator=( const lockable& ) = delete;
-    lockable& operator=( lockable&& ) = delete;
-    mutex_type& mtx() const;
-};
-
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class describable {
-    const string strName_;
-    json jsonIn_, jsonOut_, jsonErr_;
-
-public:
-    describable( const string& strName, const json& jsnIn );
-    describable( const describable& ) = delete;
-    describable( describable&& ) = delete;
-    virtual ~describable();
-    describable& operator=( const describable& ) = delete;
-    describable& operator=( describable&& ) = delete;
-    const string& get_name() const;
-    virtual json get_json_in() const;
-    virtual json get_json_out() const;
-    virtual json get_json_err() const;
-    virtual void set_json_in( const json& jsn );
-    virtual void set_json_out( const json& jsn );
-    virtual void set_json_err( const json& jsn );
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class index_holder {
-    atomic_index_type nextItemIndex_;
-
+// record of one action, overwritten when ring wraps around
+class slot {
 public:
-    index_holder();
-    index_holder( const index_holder& ) = delete;
-    index_holder( index_holder&& ) = delete;
-    virtual ~index_holder();
-    index_holder& operator=( const index_holder& ) = delete;
-    index_holder& operator=( index_holder&& ) = delete;
-    index_type alloc_index();
-    index_type get_index() const;
-    void reset();
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class time_holder {
-    time_point tpStart_, tpEnd_;
-    atomic_bool isRunning_;
-
+    static constexpr uint64_t g_nFlagHasError = 1, g_nFlagInTruncated = 2,
+                              g_nFlagOutTruncated = 4;
+    static constexpr size_t g_nMaxTextLength = 8 * 1024;  // for action name and payloads
+    // zero - empty, odd - being written, 2*(index+1) - complete record of action index
+    std::atomic< uint64_t > seq_{0};
+    std::atomic< uint64_t > nsStart_{0}, nsEnd_{0};  // system clock, zero end means running
+    std::atomic< uint64_t > flags_{0};
+    // texts are swapped in and copied out under mtx_ of this slot only, queue name is never
+    // truncated because actions are grouped by it
+    mutable std::mutex mtx_;
+    string queue_, name_;
+    string in_, out_;  // dumped JSON of input and output or error
+};  /// class slot
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// records actions into preallocated ring of slots without global locks, JSON is composed only
+// when data is fetched; slots are allocated when tracking is started first time
+class tracker : public skutils::ref_retain_release {
 public:
-    time_holder( bool isRunning );
-    time_holder( const time_holder& ) = delete;
-    time_holder( time_holder&& ) = delete;
-    virtual ~time_holder();
-    time_holder& operator=( const time_holder& ) = delete;
-    time_holder& operator=( index_holder&& ) = delete;
-    bool is_finished() const;
-    virtual bool is_running() const;
-    virtual void set_running( bool b = true );
-    time_point tp_start() const;
-    time_point tp_end() const;
-    std::chrono::nanoseconds tp_duration() const;
-    string tp_start_s( bool isUTC = true, bool isDaysInsteadOfYMD = false ) const;
-    string tp_end_s( bool isUTC = true, bool isDaysInsteadOfYMD = false ) const;
-    string tp_duration_s() const;
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class item : public skutils::ref_retain_release, public describable, public time_holder {
-    mutable queue_ptr pQueue_;
-    index_type indexQ_, indexT_;
-
-public:
-    item( const string& strName, const json& jsn, queue_ptr pQueue, index_type indexQ,
-        index_type indexT );
-    item( const item& ) = delete;
-    item( item&& ) = delete;
-    virtual ~item();
-    item& operator=( const item& ) = delete;
-    item& operator=( item&& ) = delete;
-    queue_ptr get_queue() const;
-    tracker_ptr get_tracker() const;
-    index_type get_index_in_queue() const;
-    index_type get_index_in_tracker() const;
-    json compose_json() const;
-    bool is_running() const override;
-    void set_running( bool b = true ) override;
-    void finish();
-    json get_json_in() const override;
-    json get_json_out() const override;
-    json get_json_err() const override;
-    void set_json_in( const json& jsn ) override;
-    void set_json_out( const json& jsn ) override;
-    void set_json_err( const json& jsn ) override;
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class queue : public skutils::ref_retain_release,
-              public describable,
-              public lockable,
-              public index_holder {
-    mutable tracker_ptr pTracker_;
-
-    typedef std::map< index_type, item_ptr > map_type;
-    mutable map_type map_;
-
-public:
-    queue( const string& strName, const json& jsn, tracker_ptr pTracker );
-    queue( const queue& ) = delete;
-    queue( queue&& ) = delete;
-    virtual ~queue();
-    queue& operator=( const queue& ) = delete;
-    queue& operator=( queue&& ) = delete;
+    static constexpr size_t g_nRingCapacity = 16384;  // power of 2
 
 private:
-    void reset();
-
-public:
-    tracker_ptr get_tracker() const;
-    item_ptr new_item( const string& strName, const json& jsn );
-    json compose_json( index_type minIndexT = 0 ) const;
-};
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-class tracker : public skutils::ref_retain_release,
-                public lockable,
-                public index_holder,
-                public time_holder {
-    typedef std::map< string, queue_ptr > map_type;
-    mutable map_type map_;
-
-    atomic_bool isEnabled_ = true;
-    atomic_index_type safeMaxItemCount_ = 10 * 1000 * 1000;
-    atomic_index_type sessionMaxItemCount_ = 0;  // zero means use safeMaxItemCount_
+    std::unique_ptr< slot[] > ring_;
+    atomic_index_type nextIndex_{0};     // never reset, so stale slots never match new indices
+    atomic_index_type sessionIndex_{0};  // first index of current session
+    atomic_bool isEnabled_{true};
+    atomic_bool isRunning_{false};
+    std::atomic< uint64_t > nsSessionStart_{0}, nsSessionEnd_{0};
+    atomic_index_type safeMaxItemCount_{10 * 1000 * 1000};
+    atomic_index_type sessionMaxItemCount_{0};  // zero means use safeMaxItemCount_
+    mutable std::mutex mtx_;                    // guards session state changes
     string strFirstEncounteredStopReason_;
 
 public:
@@ -209,37 +84,47 @@ public:
     tracker& operator=( const tracker& ) = delete;
     tracker& operator=( tracker&& ) = delete;
 
-private:
-    void reset();
-
-public:
     bool is_enabled() const;
     void set_enabled( bool b );
     size_t get_safe_max_item_count() const;
     void set_safe_max_item_count( size_t n );
     size_t get_session_max_item_count() const;
     void set_session_max_item_count( size_t n );
-    bool is_running() const override;
-    void set_running( bool b = true ) override;
-    queue_ptr get_queue( const string& strName );
+    bool is_running() const;
     json compose_json( index_type minIndexT = 0 ) const;
     void cancel();
     void start();
     json stop( index_type minIndexT = 0 );
     void came_accross_with_possible_session_stop_reason( const string& strPossibleStopReason );
     string get_first_encountered_stop_reason() const;
-};
+
+private:
+    friend class action;
+    // return false if action is not recorded
+    bool begin_record( const string& strQueueName, const string& strActionName,
+        const json& jsnIn, index_type& indexOut );
+    void end_record( index_type index, uint64_t nsEnd );
+    void update_record( index_type index, const json& jsn, uint64_t nFlag );
+    slot* lock_slot( index_type index );
+    static void unlock_slot( slot* pSlot, index_type index );
+};  /// class tracker
 
 extern tracker_ptr get_default_tracker();
 
+// cheap check of default tracker, use it to skip preparing names and JSON payloads of actions
+extern bool is_tracking();
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class action {
-    bool isSkipped_ = false;
-    item_ptr pItem_;
+    bool isSkipped_ = true;
+    bool isFinished_ = false;
+    index_type index_ = 0;
+    tracker_ptr pTracker_;  // set only if not skipped
 
 public:
+    action();  // skipped until start() is called
     action( const string& strQueueName, const string& strActionName, const json& jsnAction,
         tracker_ptr pTracker );
     action( const string& strQueueName, const string& strActionName, const json& jsnAction );
@@ -250,20 +135,13 @@ public:
     action& operator=( const action& ) = delete;
     action& operator=( action&& ) = delete;
 
-private:
-    void init( const string& strQueueName, const string& strActionName, const json& jsnAction,
-        tracker_ptr pTracker );
-
-public:
-    json get_json_in() const;
-    json get_json_out() const;
-    json get_json_err() const;
+    void start( const string& strQueueName, const string& strActionName,
+        const json& jsnAction = json::object(), tracker_ptr pTracker = tracker_ptr() );
     void set_json_in( const json& jsn );
     void set_json_out( const json& jsn );
     void set_json_err( const json& jsn );
-    item_ptr get_item() const;
-    queue_ptr get_queue() const;
     tracker_ptr get_tracker() const;
+    index_type get_index_in_tracker() const;
     void finish();
     bool is_skipped() const;
 };
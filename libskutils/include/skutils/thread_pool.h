@@ -1,9 +1,12 @@
 #if ( !defined __SKUTILS_THREAD_POOL_H )
 #define __SKUTILS_THREAD_POOL_H 1
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -150,6 +153,42 @@ public:
     void notify_all() { conditional_lock_.notify_all(); }
 };  /// class thread_pool
 
+// every worker owns a deque of jobs: it pops its own newest job first and, when idle, steals
+// the oldest job of another worker, so one long job never delays jobs queued behind it
+class work_stealing_pool {
+public:
+    typedef std::function< void() > job_t;
+
+private:
+    struct worker_queue {
+        std::mutex mtx_;
+        std::deque< job_t > jobs_;
+    };
+    std::vector< std::unique_ptr< worker_queue > > queues_;
+    std::vector< std::thread > threads_;
+    std::atomic_size_t next_queue_, pending_;
+    std::atomic_bool shutdown_flag_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_lock_;
+    static thread_local work_stealing_pool* g_current_pool;
+    static thread_local size_t g_current_index;
+    bool pop_own( size_t i, job_t& job );
+    bool steal( size_t i, job_t& job );
+    void worker_loop( size_t i );
+
+public:
+    work_stealing_pool( const size_t nNumberOfThreads = 0 );  // 0 means use CPU count
+    work_stealing_pool( const work_stealing_pool& ) = delete;
+    work_stealing_pool( work_stealing_pool&& ) = delete;
+    work_stealing_pool& operator=( const work_stealing_pool& ) = delete;
+    work_stealing_pool& operator=( work_stealing_pool&& ) = delete;
+    ~work_stealing_pool();
+    size_t number_of_threads() const { return threads_.size(); }
+    size_t pending_count() const { return pending_; }
+    void submit( job_t job );
+    void shutdown();  // waits for running jobs, drops queued ones
+};  /// class work_stealing_pool
+
 };  // namespace skutils
 
 #endif  /// (!defined __SKUTILS_THREAD_POOL_H)
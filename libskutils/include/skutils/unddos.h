@@ -7,10 +7,16 @@
 #include <time.h>
 #include <algorithm>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
 #include <limits>
 #include <list>
+#include <memory>
 #include <set>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <skutils/multithreading.h>
@@ -68,6 +74,8 @@ public:
     duration ban_peak_ = duration( 0 );
     duration ban_lengthy_ = duration( 0 );
     size_t max_ws_conn_ = 0;
+    size_t max_batch_size_ = 0;         // 0 means server-wide limit only
+    size_t max_batch_parallelism_ = 0;  // 0 means server-wide limit only
     map_custom_method_settings_t map_custom_method_settings_;
     origin_entry_setting();
     origin_entry_setting( const origin_entry_setting& other );
@@ -144,129 +152,34 @@ public:
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class time_entry {
-public:
-    time_tick_mark ttm_ = time_tick_mark( 0 );
-    time_entry( time_tick_mark ttm = time_tick_mark( 0 ) );
-    time_entry( const time_entry& other );
-    time_entry( time_entry&& other );
-    virtual ~time_entry();
-    time_entry& operator=( const time_entry& other );
-    bool empty() const;
-    operator bool() const { return ( !empty() ); }
-    bool operator!() const { return empty(); }
-    void clear();
-    time_entry& assign( const time_entry& other );
-    int compare( const time_entry& other ) const;
-    bool operator==( const time_entry& other ) const {
-        return ( compare( other ) == 0 ) ? true : false;
-    }
-    bool operator!=( const time_entry& other ) const {
-        return ( compare( other ) != 0 ) ? true : false;
-    }
-    bool operator<( const time_entry& other ) const {
-        return ( compare( other ) < 0 ) ? true : false;
-    }
-    bool operator<=( const time_entry& other ) const {
-        return ( compare( other ) <= 0 ) ? true : false;
-    }
-    bool operator>( const time_entry& other ) const {
-        return ( compare( other ) > 0 ) ? true : false;
-    }
-    bool operator>=( const time_entry& other ) const {
-        return ( compare( other ) >= 0 ) ? true : false;
-    }
-};  /// class time_entry
-
-typedef std::list< time_entry > time_entries_t;
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
+// calls of one origin counted in per-second buckets, hot path uses atomics only
 class tracked_origin {
 public:
-    std::string origin_;
-    time_entries_t time_entries_;
-    time_tick_mark ban_until_ = time_tick_mark( 0 );
-    tracked_origin( const char* origin = nullptr, time_tick_mark ttm = time_tick_mark( 0 ) );
-    tracked_origin( const std::string& origin, time_tick_mark ttm = time_tick_mark( 0 ) );
-    tracked_origin( const tracked_origin& other );
-    tracked_origin( tracked_origin&& other );
-    virtual ~tracked_origin();
-    operator std::string() const { return origin_; }
-    tracked_origin& operator=( const tracked_origin& other );
-    bool empty() const;
-    operator bool() const { return ( !empty() ); }
-    bool operator!() const { return empty(); }
-    void clear();
-    tracked_origin& assign( const tracked_origin& other );
-    int compare( const tracked_origin& other ) const;
-    int compare( const char* origin ) const;
-    int compare( const std::string& origin ) const;
-    //
-    bool operator==( const tracked_origin& other ) const {
-        return ( compare( other ) == 0 ) ? true : false;
-    }
-    bool operator!=( const tracked_origin& other ) const {
-        return ( compare( other ) != 0 ) ? true : false;
-    }
-    bool operator<( const tracked_origin& other ) const {
-        return ( compare( other ) < 0 ) ? true : false;
-    }
-    bool operator<=( const tracked_origin& other ) const {
-        return ( compare( other ) <= 0 ) ? true : false;
-    }
-    bool operator>( const tracked_origin& other ) const {
-        return ( compare( other ) > 0 ) ? true : false;
-    }
-    bool operator>=( const tracked_origin& other ) const {
-        return ( compare( other ) >= 0 ) ? true : false;
-    }
-    //
-    bool operator==( const char* origin ) const {
-        return ( compare( origin ) == 0 ) ? true : false;
-    }
-    bool operator!=( const char* origin ) const {
-        return ( compare( origin ) != 0 ) ? true : false;
-    }
-    bool operator<( const char* origin ) const { return ( compare( origin ) < 0 ) ? true : false; }
-    bool operator<=( const char* origin ) const {
-        return ( compare( origin ) <= 0 ) ? true : false;
-    }
-    bool operator>( const char* origin ) const { return ( compare( origin ) > 0 ) ? true : false; }
-    bool operator>=( const char* origin ) const {
-        return ( compare( origin ) >= 0 ) ? true : false;
-    }
-    //
-    bool operator==( const std::string& origin ) const {
-        return ( compare( origin ) == 0 ) ? true : false;
-    }
-    bool operator!=( const std::string& origin ) const {
-        return ( compare( origin ) != 0 ) ? true : false;
-    }
-    bool operator<( const std::string& origin ) const {
-        return ( compare( origin ) < 0 ) ? true : false;
-    }
-    bool operator<=( const std::string& origin ) const {
-        return ( compare( origin ) <= 0 ) ? true : false;
-    }
-    bool operator>( const std::string& origin ) const {
-        return ( compare( origin ) > 0 ) ? true : false;
-    }
-    bool operator>=( const std::string& origin ) const {
-        return ( compare( origin ) >= 0 ) ? true : false;
-    }
-    //
-    size_t unload_old_data_by_time_to_past(
-        time_tick_mark ttmNow = time_tick_mark( 0 ), duration durationToPast = duration( 60 ) );
-    size_t unload_old_data_by_count( size_t cntEntriesMax );
+    static constexpr size_t c_bucket_count = 64;  // seconds of history kept, power of 2
+    tracked_origin();
+    tracked_origin( const tracked_origin& ) = delete;
+    tracked_origin& operator=( const tracked_origin& ) = delete;
+    void add_call( time_tick_mark ttm );
     size_t count_to_past( time_tick_mark ttmNow = time_tick_mark( 0 ),
         duration durationToPast = duration( 60 ) ) const;
+    time_tick_mark last_call() const { return last_call_; }
+    void set_ban( time_tick_mark ttmUntil ) { ban_until_ = ttmUntil; }
     bool clear_ban();
     bool check_ban( time_tick_mark ttmNow = time_tick_mark( 0 ), bool isAutoClear = true );
+    bool is_banned() const { return ban_until_ != time_tick_mark( 0 ); }
+    // settings entry matched for this origin, re-matched when settings are replaced; packs
+    // settings version in high 32 bits and index of entry in low ones, 0 means not matched yet
+    std::atomic_uint64_t oe_cache_{0};
+
+private:
+    static constexpr int c_count_bits = 24;
+    static constexpr uint64_t c_count_mask = ( uint64_t( 1 ) << c_count_bits ) - 1;
+    std::atomic_uint64_t buckets_[c_bucket_count];  // second << c_count_bits | count
+    std::atomic< time_tick_mark > last_call_{0};
+    std::atomic< time_tick_mark > ban_until_{0};
 };  /// class tracked_origin
 
-typedef std::set< tracked_origin > tracked_origins_t;
+typedef std::shared_ptr< tracked_origin > tracked_origin_ptr;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -282,11 +195,47 @@ enum class e_high_load_detection_result_t {
 class algorithm {
     typedef skutils::multithreading::recursive_mutex_type mutex_type;
     typedef std::lock_guard< mutex_type > lock_type;
-    mutable mutex_type mtx_;
+    mutable mutex_type mtx_;  // settings, ws connection and batch worker counts
     mutable settings settings_;
-    tracked_origins_t tracked_origins_;
     typedef std::map< std::string, size_t > map_ws_conn_counts_t;
     map_ws_conn_counts_t map_ws_conn_counts_;
+    typedef std::map< std::string, size_t > map_batch_worker_counts_t;
+    map_batch_worker_counts_t map_batch_worker_counts_;
+    //
+    // immutable copy of settings_ used by call counting without locking mtx_; replaced copy
+    // is deleted as soon as calls which may have started reading it are done: each call is
+    // counted in reader counter of the epoch it started in, and publishing flips the epoch and
+    // waits for counter of previous one to drain
+    struct published_settings {
+        settings settings_;
+        uint64_t version_;
+    };
+    class settings_reader;
+    mutable std::atomic< const published_settings* > current_settings_{nullptr};
+    mutable uint64_t settings_version_ = 0;
+    mutable std::atomic_uint64_t settings_epoch_{0};
+    mutable std::atomic_size_t settings_readers_[2] = {{0}, {0}};
+    void publish_settings() const;  // call with mtx_ locked
+    static const origin_entry_setting& find_origin_entry_setting_cached(
+        const published_settings& ps, tracked_origin& to, const char* origin );
+    //
+    // tracked origins are spread over shards, each with own lock taken only for lookup
+    struct shard {
+        std::shared_mutex mtx_;
+        std::unordered_map< std::string, tracked_origin_ptr > map_;
+    };
+    static constexpr size_t c_shard_count = 64;
+    mutable shard shards_[c_shard_count];
+    shard& shard_of( const char* origin ) const;
+    tracked_origin_ptr find_tracked_origin( const char* origin ) const;
+    tracked_origin_ptr find_or_add_tracked_origin( const char* origin, bool& isAdded );
+    //
+    // background sweeper unloading idle origins
+    std::thread sweeper_;
+    std::mutex sweeper_mtx_;
+    std::condition_variable sweeper_cv_;
+    bool sweeper_stop_ = false;
+    void sweeper_loop();
 
 public:
     algorithm();
@@ -327,6 +276,19 @@ public:
     bool unregister_ws_conn_for_origin( const std::string& origin ) {
         return unregister_ws_conn_for_origin( origin.c_str() );
     }
+    size_t max_batch_size_for_origin( const char* origin ) const;  // 0 means unlimited
+    size_t max_batch_size_for_origin( const std::string& origin ) const {
+        return max_batch_size_for_origin( origin.c_str() );
+    }
+    // returns count of parallel batch workers granted to origin, at most cntWanted
+    size_t acquire_batch_workers_for_origin( const char* origin, size_t cntWanted );
+    size_t acquire_batch_workers_for_origin( const std::string& origin, size_t cntWanted ) {
+        return acquire_batch_workers_for_origin( origin.c_str(), cntWanted );
+    }
+    void release_batch_workers_for_origin( const char* origin, size_t cnt );
+    void release_batch_workers_for_origin( const std::string& origin, size_t cnt ) {
+        release_batch_workers_for_origin( origin.c_str(), cnt );
+    }
     bool load_settings_from_json( const nlohmann::json& joUnDdosSettings );
     settings get_settings() const;
     void set_settings( const settings& new_settings ) const;
@@ -1008,12 +1008,10 @@ bool queue::impl_job_run( job_t /*&*/ fn ) {  // run explicitly specified job sy
             std::cout.flush();
 #endif
             //
-            std::string strPerformanceQueueName =
-                skutils::tools::format( "dispatch/queue/%s", id_.c_str() );
-            std::string strPerformanceActionName =
-                skutils::tools::format( "task %zu", nTaskNumberInQueue_++ );
-            skutils::task::performance::action a(
-                strPerformanceQueueName, strPerformanceActionName );
+            skutils::task::performance::action a;
+            if ( skutils::task::performance::is_tracking() )
+                a.start( skutils::tools::format( "dispatch/queue/%s", id_.c_str() ),
+                    skutils::tools::format( "task %zu", nTaskNumberInQueue_++ ) );
             //
             fn();
 #if ( defined __SKUTILS_DISPATCH_DEBUG_CONSOLE_TRACE_QUEUE_STATES__ )
@@ -1307,11 +1305,11 @@ void domain::impl_startup( size_t nWaitMilliSeconds /*= size_t(-1)*/ ) {
                                         break;
                                     for ( ; true; ) {
                                         //
-                                        std::string strPerformanceActionName =
-                                            skutils::tools::format(
-                                                "task %zu", nTaskNumberInThisThread++ );
-                                        skutils::task::performance::action a(
-                                            strPerformanceQueueName, strPerformanceActionName );
+                                        skutils::task::performance::action a;
+                                        if ( skutils::task::performance::is_tracking() )
+                                            a.start( strPerformanceQueueName,
+                                                skutils::tools::format(
+                                                    "task %zu", nTaskNumberInThisThread++ ) );
                                         //
                                         if ( !run_one() )
                                             break;
@@ -14,6 +14,11 @@
 
 #endif  // (!defined _WIN32)
 
+#if ( defined __SKUTILS_HTTP_WITH_EVENT_LOOP__ )
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#endif  // (defined __SKUTILS_HTTP_WITH_EVENT_LOOP__)
+
 //#define __SKUTILS_HTTP_DEBUG_CONSOLE_TRACE_HTTP_TASK_STATES__ 1
 
 namespace skutils {
@@ -327,6 +332,93 @@ std::string get_remote_addr( socket_t sock ) {
     return std::string();
 }
 
+// returns 1 and sets len if in[start...start+len) is complete request, 0 if more bytes needed,
+// -1 on malformed or too large request, body framing follows read_content(); resume is offset
+// of first chunk not yet received, it is kept between calls so chunked body is scanned only once
+int frame_request( const std::string& in, size_t start, size_t& len, size_t& resume ) {
+    len = 0;
+    size_t pos = start + resume;
+    resume = 0;
+    if ( pos == start ) {
+        size_t posHeadersEnd = in.find( "\r\n\r\n", start );
+        if ( posHeadersEnd == std::string::npos )
+            return ( in.size() - start > __SKUTILS_HTTP_EVENT_LOOP_MAX_HEADERS_SIZE__ ) ? -1 : 0;
+        if ( posHeadersEnd - start > __SKUTILS_HTTP_EVENT_LOOP_MAX_HEADERS_SIZE__ )
+            return -1;
+        const size_t posBody = posHeadersEnd + 2 * g_nSizeOfCrLf;
+        size_t content_length = 0;
+        bool has_content_length = false, has_transfer_encoding = false;
+        pos = in.find( g_strCrLf, start ) + g_nSizeOfCrLf;  // skip request line
+        while ( pos < posHeadersEnd ) {
+            size_t posEOL = in.find( g_strCrLf, pos );
+            size_t posColon = in.find( ':', pos );
+            if ( posColon != std::string::npos && posColon < posEOL ) {
+                std::string key = in.substr( pos, posColon - pos );
+                std::string val = skutils::tools::trim_copy(
+                    in.substr( posColon + 1, posEOL - posColon - 1 ) );
+                if ( strcasecmp( key.c_str(), "Content-Length" ) == 0 ) {
+                    char* pEnd = nullptr;
+                    unsigned long long n = strtoull( val.c_str(), &pEnd, 10 );
+                    if ( pEnd == val.c_str() || n > __SKUTILS_HTTP_EVENT_LOOP_MAX_REQUEST_SIZE__ ||
+                         ( has_content_length && content_length != size_t( n ) ) )
+                        return -1;
+                    content_length = size_t( n );
+                    has_content_length = true;
+                } else if ( strcasecmp( key.c_str(), "Transfer-Encoding" ) == 0 ) {
+                    // only chunked body can be framed here
+                    if ( has_transfer_encoding || strcasecmp( val.c_str(), "chunked" ) != 0 )
+                        return -1;
+                    has_transfer_encoding = true;
+                }
+            }
+            pos = posEOL + g_nSizeOfCrLf;
+        }
+        // both headers make framing ambiguous and enable request smuggling, RFC 7230 3.3.3
+        if ( has_content_length && has_transfer_encoding )
+            return -1;
+        if ( !has_transfer_encoding ) {
+            if ( in.size() < posBody + content_length )
+                return 0;
+            len = posBody + content_length - start;
+            return 1;
+        }
+        pos = posBody;
+    }
+    for ( ;; ) {
+        if ( pos - start > __SKUTILS_HTTP_EVENT_LOOP_MAX_REQUEST_SIZE__ )
+            return -1;
+        size_t posEOL = in.find( g_strCrLf, pos );
+        if ( posEOL == std::string::npos ) {
+            resume = pos - start;
+            return 0;
+        }
+        const char* pBegin = in.c_str() + pos;
+        char* pEnd = nullptr;
+        size_t chunk_len = size_t( strtoull( pBegin, &pEnd, 16 ) );
+        if ( pEnd == pBegin )
+            return -1;
+        const size_t posChunk = posEOL + g_nSizeOfCrLf;
+        if ( chunk_len == 0 ) {
+            if ( in.size() < posChunk + g_nSizeOfCrLf ) {
+                resume = pos - start;
+                return 0;
+            }
+            if ( in.compare( posChunk, g_nSizeOfCrLf, g_strCrLf ) != 0 )
+                return -1;
+            len = posChunk + g_nSizeOfCrLf - start;
+            return 1;
+        }
+        if ( chunk_len > __SKUTILS_HTTP_EVENT_LOOP_MAX_REQUEST_SIZE__ ||
+             posChunk + chunk_len - start > __SKUTILS_HTTP_EVENT_LOOP_MAX_REQUEST_SIZE__ )
+            return -1;
+        if ( in.size() < posChunk + chunk_len + g_nSizeOfCrLf ) {
+            resume = pos - start;
+            return 0;
+        }
+        pos = posChunk + chunk_len + g_nSizeOfCrLf;
+    }
+}
+
 template < class Fn >
 void split( const char* b, const char* e, char d, Fn fn ) {
     int i = 0;
@@ -1154,6 +1246,44 @@ const std::string& buffer_stream::get_buffer() const {
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+memory_stream::memory_stream(
+    const std::string& in, std::string& out, const std::string& remote_addr )
+    : in_( in ), out_( out ), remote_addr_( remote_addr ) {}
+memory_stream::~memory_stream() {}
+
+int memory_stream::read( char* ptr, size_t size ) {
+    if ( ptr == nullptr || size == 0 )
+        return 0;
+    size_t cnt = in_.copy( ptr, size, pos_ );
+    pos_ += cnt;
+    return static_cast< int >( cnt );
+}
+
+int memory_stream::write( const char* ptr, size_t size ) {
+    if ( ptr == nullptr || size == 0 )
+        return 0;
+    out_.append( ptr, size );
+    return static_cast< int >( size );
+}
+
+std::string memory_stream::get_remote_addr() const {
+    return remote_addr_;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+event_loop_connection::event_loop_connection( uint64_t id, socket_t socket,
+    const std::string& origin, const std::string& remote_addr )
+    : id_( id ),
+      socket_( socket ),
+      origin_( origin ),
+      remote_addr_( remote_addr ),
+      tpLastActivity_( std::chrono::steady_clock::now() ) {}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 SSL_socket_stream::SSL_socket_stream( socket_t sock, SSL* ssl ) : sock_( sock ), ssl_( ssl ) {}
 
 SSL_socket_stream::~SSL_socket_stream() {}
@@ -1643,6 +1773,9 @@ server::server( size_t a_max_handler_queues, bool is_async_http_transfer_mode )
       svr_sock_( INVALID_SOCKET ),
       max_handler_queues_( a_max_handler_queues ),
       current_handler_queue_( 0 ) {
+#if ( defined __SKUTILS_HTTP_WITH_EVENT_LOOP__ )
+    is_event_loop_mode_ = is_async_http_transfer_mode;
+#endif
     if ( max_handler_queues_ < 1 )
         max_handler_queues_ = 1;
 #ifndef _WIN32
@@ -1914,6 +2047,10 @@ int server::bind_internal( int ipVer, const char* host, int port, int socket_fla
 }
 
 bool server::listen_internal() {
+#if ( defined __SKUTILS_HTTP_WITH_EVENT_LOOP__ )
+    if ( is_event_loop_mode_ && !is_ssl() )
+        return listen_internal_event_loop();
+#endif
     suspend_adding_tasks_ = false;
     is_in_loop_ = true;
     auto ret = true;
@@ -1953,6 +2090,374 @@ bool server::listen_internal() {
     return ret;
 }
 
+size_t server::event_loop_connection_count() const {
+    std::lock_guard< std::mutex > lock( event_loop_connections_mtx_ );
+    return event_loop_connections_.size();
+}
+
+#if ( defined __SKUTILS_HTTP_WITH_EVENT_LOOP__ )
+
+static bool is_event_loop_over_limits( const event_loop_connection& conn ) {
+    return conn.pending_.size() >= __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_REQUESTS__ ||
+           conn.out_.size() >= __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_OUTPUT_SIZE__;
+}
+
+bool server::listen_internal_event_loop() {
+    is_in_loop_ = true;
+    auto ret = true;
+    try {
+        epoll_fd_ = epoll_create1( EPOLL_CLOEXEC );
+        if ( epoll_fd_ < 0 )
+            throw std::runtime_error( "failed to create HTTP server event loop" );
+        detail::set_nonblocking( svr_sock_, true );
+        struct epoll_event ev;
+        memset( &ev, 0, sizeof( ev ) );
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = 0;  // connection ids start from 1
+        if ( epoll_ctl( epoll_fd_, EPOLL_CTL_ADD, svr_sock_, &ev ) < 0 )
+            throw std::runtime_error( "failed to add HTTP server socket into event loop" );
+        // handlers may block, so keep at least as many workers as configured handler queues
+        event_loop_workers_.reset( new skutils::work_stealing_pool(
+            std::max( skutils::tools::cpu_count(), max_handler_queues_ ) ) );
+        is_running_ = true;
+        event_loop_accept();  // connections which arrived before epoll registration
+        const int nMaxEvents = 256;
+        struct epoll_event events[nMaxEvents];
+        auto tpLastIdleCheck = std::chrono::steady_clock::now();
+        for ( ; is_running_; ) {
+            int n = epoll_wait(
+                epoll_fd_, events, nMaxEvents, __SKUTILS_HTTP_EVENT_LOOP_WAIT_MILLISECONDS__ );
+            if ( n < 0 && errno != EINTR )
+                break;
+            MICROPROFILE_SCOPEI( "skutils", "http::server::event_loop", MP_PALEGREEN );
+            for ( int i = 0; i < n; ++i ) {
+                // dispatched by id, socket of closed connection can be reused by new one
+                // while its events are still in this batch
+                uint64_t id = events[i].data.u64;
+                if ( id == 0 ) {
+                    event_loop_accept();
+                    continue;
+                }
+                event_loop_connection_ptr pConn = event_loop_find( id );
+                if ( !pConn )
+                    continue;
+                uint32_t flags = events[i].events;
+                if ( flags & ( EPOLLIN | EPOLLRDHUP ) )
+                    event_loop_read( pConn );
+                if ( flags & EPOLLOUT )
+                    event_loop_write( pConn );
+                if ( flags & ( EPOLLERR | EPOLLHUP ) )
+                    event_loop_close( pConn );
+            }
+            auto tpNow = std::chrono::steady_clock::now();
+            if ( tpNow - tpLastIdleCheck >=
+                 std::chrono::milliseconds( __SKUTILS_HTTP_EVENT_LOOP_WAIT_MILLISECONDS__ ) ) {
+                tpLastIdleCheck = tpNow;
+                event_loop_close_idle();
+            }
+        }
+    } catch ( const std::exception& ex ) {
+        std::cerr << ex.what() << std::endl;
+        ret = false;
+    }
+    if ( event_loop_workers_ )
+        event_loop_workers_->shutdown();  // waits for requests being processed
+    event_loop_close_all();
+    event_loop_workers_.reset();
+    if ( epoll_fd_ >= 0 ) {
+        ::close( epoll_fd_ );
+        epoll_fd_ = -1;
+    }
+    is_running_ = false;
+    is_in_loop_ = false;
+    return ret;
+}
+
+void server::event_loop_accept() {
+    for ( ;; ) {
+        socket_t sock = accept4( svr_sock_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC );
+        if ( sock == INVALID_SOCKET ) {
+            if ( errno == EINTR || errno == ECONNABORTED )
+                continue;
+            break;  // EAGAIN or fatal, both mean nothing to accept now
+        }
+        int yes = 1;
+        setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, ( char* ) &yes, sizeof( yes ) );
+        event_loop_connection_ptr pConn =
+            std::make_shared< event_loop_connection >( ++event_loop_last_id_, sock,
+                skutils::network::get_fd_name_as_url( sock, "HTTP", true ),
+                detail::get_remote_addr( sock ) );
+        {  // block
+            std::lock_guard< std::mutex > lock( event_loop_connections_mtx_ );
+            event_loop_connections_[pConn->id_] = pConn;
+        }  // block
+        struct epoll_event ev;
+        memset( &ev, 0, sizeof( ev ) );
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = pConn->id_;
+        if ( epoll_ctl( epoll_fd_, EPOLL_CTL_ADD, sock, &ev ) < 0 )
+            event_loop_close( pConn );
+    }
+}
+
+event_loop_connection_ptr server::event_loop_find( uint64_t id ) const {
+    std::lock_guard< std::mutex > lock( event_loop_connections_mtx_ );
+    auto itFind = event_loop_connections_.find( id );
+    if ( itFind == event_loop_connections_.end() )
+        return event_loop_connection_ptr();
+    return itFind->second;
+}
+
+void server::event_loop_read( event_loop_connection_ptr pConn ) {
+    event_loop_connection& conn = *pConn;
+    bool is_fatal = false;
+    {  // block
+        std::lock_guard< std::mutex > lock( conn.mtx_ );
+        if ( conn.closed_ || conn.reading_paused_ )
+            return;
+        bool is_peer_closed = false;
+        char buf[16 * 1024];
+        for ( ;; ) {  // edge triggered, so read everything available until limits are reached
+            if ( is_event_loop_over_limits( conn ) )
+                break;  // rest stays in socket, EPOLLIN is re-armed when connection drains
+            ssize_t n = recv( conn.socket_, buf, sizeof( buf ), 0 );
+            if ( n > 0 ) {
+                if ( conn.close_after_flush_ )
+                    continue;  // no more requests are served on this connection
+                conn.in_.append( buf, size_t( n ) );
+                if ( !event_loop_frame( conn ) ) {
+                    is_fatal = true;
+                    break;
+                }
+                continue;
+            }
+            if ( n == 0 ) {
+                is_peer_closed = true;
+                break;
+            }
+            if ( errno == EINTR )
+                continue;
+            if ( errno != EAGAIN && errno != EWOULDBLOCK )
+                is_fatal = true;
+            break;
+        }
+        conn.tpLastActivity_ = std::chrono::steady_clock::now();
+        if ( is_peer_closed && !is_fatal ) {
+            conn.in_.clear();
+            conn.frame_resume_ = 0;
+            conn.close_after_flush_ = true;  // answer what was received, then close
+            if ( !conn.busy_ && conn.pending_.empty() )
+                is_fatal = true;
+        }
+        if ( !is_fatal && !event_loop_throttle( conn ) )
+            is_fatal = true;
+        if ( !is_fatal )
+            event_loop_schedule( pConn );
+    }  // block
+    if ( is_fatal )
+        event_loop_close( pConn );
+}
+
+void server::event_loop_write( event_loop_connection_ptr pConn ) {
+    event_loop_connection& conn = *pConn;
+    bool is_close = false;
+    {  // block
+        std::lock_guard< std::mutex > lock( conn.mtx_ );
+        if ( conn.closed_ )
+            return;
+        if ( !event_loop_flush( conn ) )
+            is_close = true;
+        else if ( conn.close_after_flush_ && conn.out_.empty() && !conn.busy_ )
+            is_close = true;
+        else if ( !event_loop_throttle( conn ) )
+            is_close = true;
+        else
+            event_loop_schedule( pConn );  // requests framed while resuming
+    }  // block
+    if ( is_close )
+        event_loop_close( pConn );
+}
+
+bool server::event_loop_flush( event_loop_connection& conn ) {
+    size_t pos = 0, cnt = conn.out_.size();
+    while ( pos < cnt ) {
+        ssize_t n = send( conn.socket_, conn.out_.data() + pos, cnt - pos, MSG_NOSIGNAL );
+        if ( n > 0 ) {
+            pos += size_t( n );
+            continue;
+        }
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 && ( errno == EAGAIN || errno == EWOULDBLOCK ) )
+            break;  // rest is written on EPOLLOUT
+        return false;
+    }
+    if ( pos > 0 )
+        conn.out_.erase( 0, pos );
+    return true;
+}
+
+bool server::event_loop_frame( event_loop_connection& conn ) {
+    size_t pos = 0;
+    bool is_ok = true;
+    while ( conn.pending_.size() < __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_REQUESTS__ ) {
+        while ( conn.in_.compare( pos, g_nSizeOfCrLf, g_strCrLf ) == 0 )
+            pos += g_nSizeOfCrLf;  // empty lines between pipelined requests
+        if ( pos >= conn.in_.size() )
+            break;
+        size_t len = 0;
+        int rc = detail::frame_request( conn.in_, pos, len, conn.frame_resume_ );
+        if ( rc < 0 ) {
+            is_ok = false;
+            break;
+        }
+        if ( rc == 0 )
+            break;
+        conn.pending_.emplace_back( conn.in_, pos, len );
+        pos += len;
+    }
+    if ( pos > 0 )
+        conn.in_.erase( 0, pos );
+    return is_ok;
+}
+
+bool server::event_loop_throttle( event_loop_connection& conn ) {
+    if ( conn.closed_ )
+        return true;
+    if ( conn.reading_paused_ && !conn.close_after_flush_ &&
+         !is_event_loop_over_limits( conn ) && !event_loop_frame( conn ) )
+        return false;  // requests received before pause are still in in_
+    const bool is_over = is_event_loop_over_limits( conn );
+    if ( is_over == conn.reading_paused_ )
+        return true;
+    struct epoll_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLOUT | EPOLLET;
+    if ( !is_over )
+        ev.events |= EPOLLIN | EPOLLRDHUP;  // re-arming reports data which arrived meanwhile
+    ev.data.u64 = conn.id_;
+    if ( epoll_ctl( epoll_fd_, EPOLL_CTL_MOD, conn.socket_, &ev ) < 0 )
+        return false;
+    conn.reading_paused_ = is_over;
+    return true;
+}
+
+void server::event_loop_schedule( event_loop_connection_ptr pConn ) {
+    event_loop_connection& conn = *pConn;
+    if ( conn.busy_ || conn.pending_.empty() || !event_loop_workers_ )
+        return;
+    conn.busy_ = true;
+    event_loop_workers_->submit( [this, pConn]() { event_loop_drain( pConn ); } );
+}
+
+void server::event_loop_drain( event_loop_connection_ptr pConn ) {
+    event_loop_connection& conn = *pConn;
+    const size_t keep_alive_max_count = get_keep_alive_max_count();
+    for ( ;; ) {
+        std::string strRequest;
+        bool last_connection = true;
+        bool is_done = false, is_close = false;
+        {  // block
+            std::lock_guard< std::mutex > lock( conn.mtx_ );
+            if ( conn.closed_ || conn.pending_.empty() ) {
+                conn.busy_ = false;
+                is_done = true;
+                is_close = ( !conn.closed_ ) && conn.close_after_flush_ && conn.out_.empty();
+            } else {
+                strRequest = std::move( conn.pending_.front() );
+                conn.pending_.pop_front();
+                ++conn.cnt_served_;
+                last_connection =
+                    ( keep_alive_max_count == 0 || conn.cnt_served_ >= keep_alive_max_count );
+            }
+        }  // block
+        if ( is_done ) {
+            if ( is_close )
+                event_loop_close( pConn );
+            return;
+        }
+        std::string strResponse;
+        memory_stream strm( strRequest, strResponse, conn.remote_addr_ );
+        bool connection_close = false;
+        try {
+            if ( !process_request( conn.origin_, strm, last_connection, connection_close ) )
+                connection_close = true;
+        } catch ( ... ) {
+            connection_close = true;
+        }
+        bool is_fatal = false;
+        {  // block
+            std::lock_guard< std::mutex > lock( conn.mtx_ );
+            if ( conn.closed_ )
+                continue;
+            conn.out_ += strResponse;
+            conn.tpLastActivity_ = std::chrono::steady_clock::now();
+            if ( connection_close || last_connection ) {
+                conn.close_after_flush_ = true;
+                conn.pending_.clear();
+            }
+            if ( !event_loop_flush( conn ) || !event_loop_throttle( conn ) )
+                is_fatal = true;
+        }  // block
+        if ( is_fatal )
+            event_loop_close( pConn );
+    }
+}
+
+void server::event_loop_close( event_loop_connection_ptr pConn ) {
+    event_loop_connection& conn = *pConn;
+    {  // block
+        std::lock_guard< std::mutex > lock( conn.mtx_ );
+        if ( conn.closed_ )
+            return;
+        conn.closed_ = true;
+        conn.pending_.clear();
+        if ( epoll_fd_ >= 0 )
+            epoll_ctl( epoll_fd_, EPOLL_CTL_DEL, conn.socket_, nullptr );
+        {  // block
+            std::lock_guard< std::mutex > lockMap( event_loop_connections_mtx_ );
+            event_loop_connections_.erase( conn.id_ );
+        }  // block
+        detail::shutdown_socket( conn.socket_ );
+        detail::close_socket( conn.socket_ );
+    }  // block
+}
+
+void server::event_loop_close_idle() {
+    std::vector< event_loop_connection_ptr > vecConnections;
+    {  // block
+        std::lock_guard< std::mutex > lock( event_loop_connections_mtx_ );
+        for ( const auto& pr : event_loop_connections_ )
+            vecConnections.push_back( pr.second );
+    }  // block
+    auto tpNow = std::chrono::steady_clock::now();
+    for ( event_loop_connection_ptr pConn : vecConnections ) {
+        bool is_idle = false;
+        {  // block
+            std::lock_guard< std::mutex > lock( pConn->mtx_ );
+            is_idle = ( !pConn->busy_ ) && pConn->pending_.empty() &&
+                      ( tpNow - pConn->tpLastActivity_ >
+                          std::chrono::milliseconds(
+                              __SKUTILS_HTTP_KEEPALIVE_TIMEOUT_MILLISECONDS__ ) );
+        }  // block
+        if ( is_idle )
+            event_loop_close( pConn );
+    }
+}
+
+void server::event_loop_close_all() {
+    std::vector< event_loop_connection_ptr > vecConnections;
+    {  // block
+        std::lock_guard< std::mutex > lock( event_loop_connections_mtx_ );
+        for ( const auto& pr : event_loop_connections_ )
+            vecConnections.push_back( pr.second );
+    }  // block
+    for ( event_loop_connection_ptr pConn : vecConnections )
+        event_loop_close( pConn );
+}
+
+#endif  // (defined __SKUTILS_HTTP_WITH_EVENT_LOOP__)
+
 server::tasks_mutex_type& server::tasks_mtx() {
     return skutils::get_ref_mtx();
 }
@@ -0,0 +1,303 @@
+#include <skutils/http.h>
+#include <skutils/multithreading.h>
+#include <skutils/open_metrics.h>
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace skutils {
+namespace stats {
+namespace metrics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// bucket bounds exported for every histogram, in seconds
+static const double g_arrExportedBucketBounds[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+    0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0};
+
+static std::string stat_format_double( double lfValue ) {
+    char buf[64];
+    ::snprintf( buf, sizeof( buf ), "%.9g", lfValue );
+    return buf;
+}
+
+void open_metrics_writer::family(
+    const std::string& strName, const char* strType, const char* strHelp ) {
+    str_ += "# TYPE " + strName + " " + strType + "\n";
+    if ( strHelp != nullptr && strHelp[0] != '\0' )
+        str_ += "# HELP " + strName + " " + strHelp + "\n";
+}
+
+void open_metrics_writer::sample(
+    const std::string& strName, const std::string& strLabels, double lfValue ) {
+    str_ += strName;
+    if ( !strLabels.empty() )
+        str_ += "{" + strLabels + "}";
+    str_ += " " + stat_format_double( lfValue ) + "\n";
+}
+
+void open_metrics_writer::sample(
+    const std::string& strName, const std::string& strLabels, uint64_t nValue ) {
+    str_ += strName;
+    if ( !strLabels.empty() )
+        str_ += "{" + strLabels + "}";
+    str_ += " " + std::to_string( nValue ) + "\n";
+}
+
+void open_metrics_writer::histogram_samples(
+    const std::string& strName, const std::string& strLabels, const latency_histogram& h ) {
+    uint64_t arrCounts[latency_histogram::g_nBucketCount];
+    h.load( arrCounts );
+    uint64_t nCumulative = 0;
+    size_t i = 0;
+    for ( double lfBound : g_arrExportedBucketBounds ) {
+        uint64_t nBoundMicroseconds = uint64_t( lfBound * 1000000.0 );
+        for ( ; i < latency_histogram::g_nBucketCount &&
+                latency_histogram::bucket_upper_bound( i ) <= nBoundMicroseconds;
+              ++i )
+            nCumulative += arrCounts[i];
+        std::string strBound = stat_format_double( lfBound );
+        if ( strBound.find( '.' ) == std::string::npos )
+            strBound += ".0";  // canonical float form of le
+        sample( strName + "_bucket", join_labels( strLabels, label( "le", strBound ) ),
+            nCumulative );
+    }
+    for ( ; i < latency_histogram::g_nBucketCount; ++i )
+        nCumulative += arrCounts[i];
+    sample( strName + "_bucket", join_labels( strLabels, label( "le", "+Inf" ) ), nCumulative );
+    sample( strName + "_count", strLabels, nCumulative );
+    sample( strName + "_sum", strLabels, double( h.sum() ) / 1000000.0 );
+}
+
+std::string open_metrics_writer::label( const char* strName, const std::string& strValue ) {
+    std::string s = strName;
+    s += "=\"";
+    for ( char c : strValue ) {
+        switch ( c ) {
+        case '\\':
+            s += "\\\\";
+            break;
+        case '"':
+            s += "\\\"";
+            break;
+        case '\n':
+            s += "\\n";
+            break;
+        default:
+            s += c;
+            break;
+        }
+    }
+    s += "\"";
+    return s;
+}
+
+std::string open_metrics_writer::join_labels(
+    const std::string& strLabelsA, const std::string& strLabelsB ) {
+    if ( strLabelsA.empty() )
+        return strLabelsB;
+    if ( strLabelsB.empty() )
+        return strLabelsA;
+    return strLabelsA + "," + strLabelsB;
+}
+
+const std::string& open_metrics_writer::text() {
+    if ( !isFinished_ ) {
+        str_ += "# EOF\n";
+        isFinished_ = true;
+    }
+    return str_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+class named_series {
+public:
+    typedef std::map< std::string, std::unique_ptr< T > > map_labels_t;
+    typedef std::map< std::string, map_labels_t > map_names_t;
+
+    static named_series& instance() {
+        static named_series* g_pInstance = new named_series;  // used by exiting threads
+        return ( *g_pInstance );
+    }
+
+    T& get( const char* strName, const std::string& strLabels ) {
+        static thread_local std::map< std::string, T* > g_mapThreadCache;
+        std::string strKey = std::string( strName ) + "{" + strLabels + "}";
+        auto itCached = g_mapThreadCache.find( strKey );
+        if ( itCached != g_mapThreadCache.end() )
+            return ( *( itCached->second ) );
+        std::lock_guard< std::mutex > lock( mtx_ );
+        std::unique_ptr< T >& p = map_[strName][strLabels];
+        if ( !p )
+            p.reset( new T );
+        g_mapThreadCache[strKey] = p.get();
+        return ( *p );
+    }
+
+    template < typename F >
+    void for_each_name( F fn ) {
+        std::lock_guard< std::mutex > lock( mtx_ );
+        for ( const auto& entry : map_ )
+            fn( entry.first, entry.second );
+    }
+
+private:
+    std::mutex mtx_;
+    map_names_t map_;
+};  /// class named_series
+
+latency_histogram& histogram( const char* strName, const std::string& strLabels ) {
+    return named_series< latency_histogram >::instance().get( strName, strLabels );
+}
+
+sharded_counter& counter( const char* strName, const std::string& strLabels ) {
+    return named_series< sharded_counter >::instance().get( strName, strLabels );
+}
+
+typedef std::map< collector_id_t, fn_collector_t > map_collectors_t;
+
+static std::mutex& collectors_mtx() {
+    static std::mutex* g_pMtx = new std::mutex;
+    return ( *g_pMtx );
+}
+static map_collectors_t& collectors_map() {
+    static map_collectors_t* g_pMap = new map_collectors_t;
+    return ( *g_pMap );
+}
+
+collector_id_t add_collector( fn_collector_t fn ) {
+    static collector_id_t g_nLastID = 0;
+    std::lock_guard< std::mutex > lock( collectors_mtx() );
+    collector_id_t id = ++g_nLastID;
+    collectors_map()[id] = fn;
+    return id;
+}
+
+void remove_collector( collector_id_t id ) {
+    std::lock_guard< std::mutex > lock( collectors_mtx() );
+    collectors_map().erase( id );
+}
+
+static void stat_write_rpc_metrics( open_metrics_writer& w ) {
+    struct method_entry_t {
+        std::string strLabels;
+        uint64_t arrCounts[6];
+        const method_metrics* pMetrics;
+    };
+    std::vector< method_entry_t > vecMethods;
+    for_each( [&]( const std::string& strSubSystem, const std::string& strMethod,
+                  const method_metrics& mm ) {
+        method_entry_t e;
+        e.strLabels = open_metrics_writer::label( "subsystem", strSubSystem );
+        e.strLabels = open_metrics_writer::join_labels(
+            e.strLabels, open_metrics_writer::label( "method", strMethod ) );
+        e.arrCounts[0] = mm.calls_.load();
+        e.arrCounts[1] = mm.answers_.load();
+        e.arrCounts[2] = mm.errors_.load();
+        e.arrCounts[3] = mm.exceptions_.load();
+        e.arrCounts[4] = mm.bytes_recv_.load();
+        e.arrCounts[5] = mm.bytes_sent_.load();
+        e.pMetrics = &mm;  // entries are never deleted
+        vecMethods.push_back( e );
+    } );
+    static const char* g_arrNames[6] = {"skaled_rpc_calls", "skaled_rpc_answers",
+        "skaled_rpc_errors", "skaled_rpc_exceptions", "skaled_rpc_received_bytes",
+        "skaled_rpc_sent_bytes"};
+    static const char* g_arrHelps[6] = {"Calls received.", "Answers sent.", "Calls failed.",
+        "Calls thrown exception.", "Bytes of calls received.", "Bytes of answers sent."};
+    for ( size_t i = 0; i < 6; ++i ) {
+        w.family( g_arrNames[i], "counter", g_arrHelps[i] );
+        for ( const method_entry_t& e : vecMethods )
+            w.sample( std::string( g_arrNames[i] ) + "_total", e.strLabels, e.arrCounts[i] );
+    }
+    w.family( "skaled_rpc_latency_seconds", "histogram", "Call handling time." );
+    for ( const method_entry_t& e : vecMethods ) {
+        if ( e.pMetrics->latency_.count() > 0 )
+            w.histogram_samples( "skaled_rpc_latency_seconds", e.strLabels, e.pMetrics->latency_ );
+    }
+}
+
+std::string open_metrics_text() {
+    open_metrics_writer w;
+    stat_write_rpc_metrics( w );
+    named_series< latency_histogram >::instance().for_each_name(
+        [&]( const std::string& strName,
+            const named_series< latency_histogram >::map_labels_t& mapLabels ) {
+            w.family( strName, "histogram" );
+            for ( const auto& entry : mapLabels )
+                w.histogram_samples( strName, entry.first, *( entry.second ) );
+        } );
+    named_series< sharded_counter >::instance().for_each_name(
+        [&]( const std::string& strName,
+            const named_series< sharded_counter >::map_labels_t& mapLabels ) {
+            w.family( strName, "counter" );
+            for ( const auto& entry : mapLabels )
+                w.sample( strName + "_total", entry.first, entry.second->load() );
+        } );
+    // block
+    {
+        std::lock_guard< std::mutex > lock( collectors_mtx() );
+        for ( const auto& entry : collectors_map() ) {
+            try {
+                entry.second( w );
+            } catch ( ... ) {
+            }
+        }
+    }
+    return w.text();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+exporter::exporter() {}
+
+exporter::~exporter() {
+    stop();
+}
+
+bool exporter::start( int ipVer, const std::string& strAddr, int nPort ) {
+    stop();
+    // one handler queue and synchronous mode, so scrapes are served by listening thread only
+    pServer_.reset( new skutils::http::server( 1, false ) );
+    pServer_->set_keep_alive_max_count( 1 );
+    pServer_->Get( "/metrics", []( const skutils::http::request&, skutils::http::response& res ) {
+        res.set_content(
+            open_metrics_text(), "application/openmetrics-text; version=1.0.0; charset=utf-8" );
+    } );
+    isListenFailed_ = false;
+    skutils::http::server* pServer = pServer_.get();
+    thread_ = std::thread( [this, pServer, ipVer, strAddr, nPort]() {
+        skutils::multithreading::threadNameAppender tn( "/metrics" );
+        if ( !pServer->listen( ipVer, strAddr.c_str(), nPort ) )
+            isListenFailed_ = true;
+    } );
+    while ( ( !pServer->is_running() ) && ( !isListenFailed_ ) )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    if ( pServer->is_running() )
+        return true;
+    stop();
+    return false;
+}
+
+void exporter::stop() {
+    if ( pServer_ && pServer_->is_running() )
+        pServer_->stop();
+    if ( thread_.joinable() )
+        thread_.join();
+    pServer_.reset();
+}
+
+bool exporter::is_running() const {
+    return pServer_ && pServer_->is_running();
+}
+
+};  // namespace metrics
+};  // namespace stats
+};  // namespace skutils
@@ -2,6 +2,9 @@
 #include <skutils/stats.h>
 #include <skutils/utils.h>
 
+#include <cmath>
+#include <memory>
+
 namespace skutils {
 namespace stats {
 
@@ -388,6 +391,309 @@ double stat_compute_bps_til_now(
 
 };  // namespace named_traffic_stats
 
+namespace metrics {
+
+size_t sharded_counter::shard_index() noexcept {
+    static std::atomic_size_t g_nNextShard{0};
+    static thread_local size_t g_nShard =
+        g_nNextShard.fetch_add( 1, std::memory_order_relaxed ) % g_nShardCount;
+    return g_nShard;
+}
+
+uint64_t sharded_counter::load() const noexcept {
+    uint64_t n = 0;
+    for ( const shard_t& shard : shards_ )
+        n += shard.value_.load( std::memory_order_relaxed );
+    return n;
+}
+
+size_t latency_histogram::bucket_index( uint64_t nValue ) noexcept {
+    if ( nValue < g_nSubBucketCount )
+        return size_t( nValue );
+    size_t nExp = 63 - size_t( __builtin_clzll( nValue ) );
+    if ( nExp >= g_nMaxValueBits )
+        return g_nBucketCount - 1;
+    size_t nShift = nExp - g_nSubBucketBits;
+    size_t nSub = size_t( nValue >> nShift ) - g_nSubBucketCount;
+    return ( nShift + 1 ) * g_nSubBucketCount + nSub;
+}
+
+uint64_t latency_histogram::bucket_upper_bound( size_t nIndex ) noexcept {
+    if ( nIndex < g_nSubBucketCount )
+        return uint64_t( nIndex );
+    size_t nShift = nIndex / g_nSubBucketCount - 1;
+    uint64_t nLower = uint64_t( g_nSubBucketCount + nIndex % g_nSubBucketCount ) << nShift;
+    return nLower + ( uint64_t( 1 ) << nShift ) - 1;
+}
+
+uint64_t latency_histogram::count() const noexcept {
+    uint64_t n = 0;
+    for ( const std::atomic_uint64_t& bucket : buckets_ )
+        n += bucket.load( std::memory_order_relaxed );
+    return n;
+}
+
+uint64_t latency_histogram::min() const noexcept {
+    for ( size_t i = 0; i < g_nBucketCount; ++i ) {
+        if ( buckets_[i].load( std::memory_order_relaxed ) != 0 )
+            return bucket_upper_bound( i );
+    }
+    return 0;
+}
+
+uint64_t latency_histogram::max() const noexcept {
+    for ( size_t i = g_nBucketCount; i > 0; --i ) {
+        if ( buckets_[i - 1].load( std::memory_order_relaxed ) != 0 )
+            return bucket_upper_bound( i - 1 );
+    }
+    return 0;
+}
+
+void latency_histogram::load( uint64_t ( &arrCounts )[g_nBucketCount] ) const noexcept {
+    for ( size_t i = 0; i < g_nBucketCount; ++i )
+        arrCounts[i] = buckets_[i].load( std::memory_order_relaxed );
+}
+
+uint64_t latency_histogram::percentile( double lfPercentile ) const noexcept {
+    uint64_t arrCounts[g_nBucketCount];
+    load( arrCounts );
+    uint64_t nTotal = 0;
+    for ( uint64_t n : arrCounts )
+        nTotal += n;
+    if ( nTotal == 0 )
+        return 0;
+    lfPercentile = std::min( std::max( lfPercentile, 0.0 ), 1.0 );
+    uint64_t nRank = std::max( uint64_t( 1 ), uint64_t( std::ceil( lfPercentile * nTotal ) ) );
+    uint64_t nSeen = 0;
+    for ( size_t i = 0; i < g_nBucketCount; ++i ) {
+        nSeen += arrCounts[i];
+        if ( nSeen >= nRank )
+            return bucket_upper_bound( i );
+    }
+    return bucket_upper_bound( g_nBucketCount - 1 );
+}
+
+size_t g_nMaxMethodsPerSubsystem = 1024;
+
+// keys are compared with const char* without building strings
+typedef std::map< std::string, std::unique_ptr< method_metrics >, std::less<> >
+    map_method_metrics_t;
+struct subsystem_metrics_t {
+    map_method_metrics_t mapMethods_;  // guarded by registry mutex until isFull_ is set
+    method_metrics* pUnknown_ = nullptr;
+    std::atomic_bool isFull_{false};  // no more methods are added, map is read without lock
+};
+typedef std::map< std::string, std::unique_ptr< subsystem_metrics_t >, std::less<> >
+    map_subsystem_metrics_t;
+
+static std::mutex& registry_mtx() {
+    static std::mutex* g_pMtx = new std::mutex;  // never destroyed, used by exiting threads
+    return ( *g_pMtx );
+}
+static map_subsystem_metrics_t& registry_map() {
+    static map_subsystem_metrics_t* g_pMap = new map_subsystem_metrics_t;
+    return ( *g_pMap );
+}
+
+static subsystem_metrics_t& get_subsystem( const char* strSubSystem ) {
+    std::lock_guard< std::mutex > lock( registry_mtx() );
+    map_subsystem_metrics_t& mapSubSystems = registry_map();
+    auto itFind = mapSubSystems.find( strSubSystem );
+    if ( itFind == mapSubSystems.end() )
+        itFind = mapSubSystems
+                     .emplace( strSubSystem,
+                         std::unique_ptr< subsystem_metrics_t >( new subsystem_metrics_t ) )
+                     .first;
+    return ( *( itFind->second ) );
+}
+
+method_metrics& get( const char* strSubSystem, const char* strMethod ) {
+    if ( strSubSystem == nullptr || strSubSystem[0] == '\0' )
+        strSubSystem = "N/A";
+    if ( strMethod == nullptr || strMethod[0] == '\0' )
+        strMethod = time_tracker::element::g_strMethodNameUnknown;
+    struct thread_cache_t {
+        subsystem_metrics_t* pSubSystem_ = nullptr;
+        std::map< std::string, method_metrics*, std::less<> > mapMethods_;
+    };
+    static thread_local std::map< std::string, thread_cache_t, std::less<> > g_mapThreadCache;
+    auto itCache = g_mapThreadCache.find( strSubSystem );
+    if ( itCache == g_mapThreadCache.end() ) {
+        thread_cache_t cache;
+        cache.pSubSystem_ = &get_subsystem( strSubSystem );
+        itCache = g_mapThreadCache.emplace( strSubSystem, std::move( cache ) ).first;
+    }
+    thread_cache_t& cache = itCache->second;
+    auto itCached = cache.mapMethods_.find( strMethod );
+    if ( itCached != cache.mapMethods_.end() )
+        return ( *( itCached->second ) );
+    subsystem_metrics_t& subSystem = *( cache.pSubSystem_ );
+    method_metrics* pMetrics = nullptr;
+    if ( subSystem.isFull_.load( std::memory_order_acquire ) ) {
+        auto itFind = subSystem.mapMethods_.find( strMethod );
+        if ( itFind == subSystem.mapMethods_.end() )
+            return ( *subSystem.pUnknown_ );  // not cached per thread, names come from peers
+        pMetrics = itFind->second.get();
+    } else {
+        std::lock_guard< std::mutex > lock( registry_mtx() );
+        auto itFind = subSystem.mapMethods_.find( strMethod );
+        if ( itFind != subSystem.mapMethods_.end() )
+            pMetrics = itFind->second.get();
+        else if ( subSystem.mapMethods_.size() < g_nMaxMethodsPerSubsystem ) {
+            pMetrics = new method_metrics;
+            subSystem.mapMethods_.emplace(
+                strMethod, std::unique_ptr< method_metrics >( pMetrics ) );
+        } else {
+            std::unique_ptr< method_metrics >& pUnknown =
+                subSystem.mapMethods_[time_tracker::element::g_strMethodNameUnknown];
+            if ( !pUnknown )
+                pUnknown.reset( new method_metrics );
+            subSystem.pUnknown_ = pUnknown.get();
+            subSystem.isFull_.store( true, std::memory_order_release );
+            return ( *subSystem.pUnknown_ );
+        }
+    }
+    cache.mapMethods_.emplace( strMethod, pMetrics );
+    return ( *pMetrics );
+}
+
+double call_timer::stop() {
+    if ( isStopped_ )
+        return lfSeconds_;
+    isStopped_ = true;
+    auto d = std::chrono::duration_cast< std::chrono::microseconds >( clock::now() - tpStart_ );
+    uint64_t nMicroseconds = uint64_t( d.count() );
+    get( strSubSystem_, strMethod_ ).latency_.record( nMicroseconds );
+    get( strSubSystemProtocol_, strMethod_ ).latency_.record( nMicroseconds );
+    lfSeconds_ = nMicroseconds / 1000000.0;
+    return lfSeconds_;
+}
+
+void for_each( fn_method_metrics_visitor_t fn ) {
+    if ( !fn )
+        return;
+    std::lock_guard< std::mutex > lock( registry_mtx() );
+    for ( const auto& subSystem : registry_map() ) {
+        for ( const auto& method : subSystem.second->mapMethods_ )
+            fn( subSystem.first, method.first, *( method.second ) );
+    }
+}
+
+nlohmann::json subsystem_stats( const char* strSubSystem ) {
+    nlohmann::json jo = nlohmann::json::object();
+    std::lock_guard< std::mutex > lock( registry_mtx() );
+    map_subsystem_metrics_t& mapSubSystems = registry_map();
+    auto itSubSystem = mapSubSystems.find(
+        ( strSubSystem != nullptr && strSubSystem[0] != '\0' ) ? strSubSystem : "N/A" );
+    if ( itSubSystem == mapSubSystems.end() )
+        return jo;
+    time_point tpNow = clock::now();
+    for ( auto& entry : itSubSystem->second->mapMethods_ ) {
+        method_metrics& mm = *( entry.second );
+        uint64_t arrNow[6] = {mm.calls_.load(), mm.answers_.load(), mm.errors_.load(),
+            mm.exceptions_.load(), mm.bytes_recv_.load(), mm.bytes_sent_.load()};
+        double lfSeconds =
+            std::chrono::duration_cast< std::chrono::duration< double > >( tpNow - mm.tpPrevRead_ )
+                .count();
+        if ( lfSeconds >= 1.0 ) {  // otherwise rates of previous read are reported again
+            for ( size_t i = 0; i < 6; ++i ) {
+                mm.arrRates_[i] = double( arrNow[i] - mm.arrPrev_[i] ) / lfSeconds;
+                mm.arrPrev_[i] = arrNow[i];
+            }
+            mm.tpPrevRead_ = tpNow;
+        }
+        nlohmann::json joMethod = nlohmann::json::object();
+        joMethod["cps"] = mm.arrRates_[0];
+        joMethod["aps"] = mm.arrRates_[1];
+        joMethod["erps"] = mm.arrRates_[2];
+        joMethod["exps"] = mm.arrRates_[3];
+        joMethod["bps_recv"] = mm.arrRates_[4];
+        joMethod["bps_sent"] = mm.arrRates_[5];
+        joMethod["calls"] = arrNow[0];
+        joMethod["answers"] = arrNow[1];
+        joMethod["errors"] = arrNow[2];
+        joMethod["exceptions"] = arrNow[3];
+        joMethod["bytes_recv"] = arrNow[4];
+        joMethod["bytes_sent"] = arrNow[5];
+        // seconds, like time tracker call times
+        joMethod["latency_p50"] = mm.latency_.percentile( 0.5 ) / 1000000.0;
+        joMethod["latency_p99"] = mm.latency_.percentile( 0.99 ) / 1000000.0;
+        joMethod["latency_p999"] = mm.latency_.percentile( 0.999 ) / 1000000.0;
+        jo[entry.first] = joMethod;
+    }
+    return jo;
+}
+
+nlohmann::json execution_performance( const char* strSubSystem ) {
+    const std::string strPrefix = std::string( strSubSystem ) + "/";
+    const char* strUnknown = time_tracker::element::g_strMethodNameUnknown;
+    nlohmann::json joProtocols = nlohmann::json::object();
+    uint64_t nMin = 0, nMax = 0, nSum = 0, nCount = 0;
+    std::string strMethodMin( strUnknown ), strMethodMax( strUnknown ), strProtocolMin( "N/A" ),
+        strProtocolMax( "N/A" );
+    std::lock_guard< std::mutex > lock( registry_mtx() );
+    for ( const auto& subSystem : registry_map() ) {
+        if ( subSystem.first.compare( 0, strPrefix.size(), strPrefix ) != 0 )
+            continue;
+        const std::string strProtocol = subSystem.first.substr( strPrefix.size() );
+        uint64_t nProtocolMin = 0, nProtocolMax = 0, nProtocolSum = 0, nProtocolCount = 0;
+        std::string strProtocolMethodMin( strUnknown ), strProtocolMethodMax( strUnknown );
+        for ( const auto& method : subSystem.second->mapMethods_ ) {
+            const latency_histogram& h = method.second->latency_;
+            uint64_t n = h.count();
+            if ( n == 0 )
+                continue;
+            uint64_t nMethodMin = h.min(), nMethodMax = h.max();
+            if ( nProtocolCount == 0 || nMethodMin < nProtocolMin ) {
+                nProtocolMin = nMethodMin;
+                strProtocolMethodMin = method.first;
+            }
+            if ( nProtocolCount == 0 || nMethodMax > nProtocolMax ) {
+                nProtocolMax = nMethodMax;
+                strProtocolMethodMax = method.first;
+            }
+            nProtocolSum += h.sum();
+            nProtocolCount += n;
+        }
+        if ( nProtocolCount == 0 )
+            continue;
+        if ( nCount == 0 || nProtocolMin < nMin ) {
+            nMin = nProtocolMin;
+            strMethodMin = strProtocolMethodMin;
+            strProtocolMin = strProtocol;
+        }
+        if ( nCount == 0 || nProtocolMax > nMax ) {
+            nMax = nProtocolMax;
+            strMethodMax = strProtocolMethodMax;
+            strProtocolMax = strProtocol;
+        }
+        nSum += nProtocolSum;
+        nCount += nProtocolCount;
+        // seconds, like time tracker call times
+        nlohmann::json joProtocol = nlohmann::json::object();
+        joProtocol["callTimeMin"] = nProtocolMin / 1000000.0;
+        joProtocol["callTimeMax"] = nProtocolMax / 1000000.0;
+        joProtocol["callTimeAvg"] = double( nProtocolSum ) / nProtocolCount / 1000000.0;
+        joProtocol["methodMin"] = strProtocolMethodMin;
+        joProtocol["methodMax"] = strProtocolMethodMax;
+        joProtocols[strProtocol] = joProtocol;
+    }
+    nlohmann::json joSummary = nlohmann::json::object();
+    joSummary["callTimeMin"] = nMin / 1000000.0;
+    joSummary["callTimeMax"] = nMax / 1000000.0;
+    joSummary["callTimeAvg"] = ( nCount > 0 ) ? double( nSum ) / nCount / 1000000.0 : 0.0;
+    joSummary["methodMin"] = strMethodMin;
+    joSummary["methodMax"] = strMethodMax;
+    joSummary["protocolMin"] = strProtocolMin;
+    joSummary["protocolMax"] = strProtocolMax;
+    nlohmann::json joStatsAll = nlohmann::json::object();
+    joStatsAll["summary"] = joSummary;
+    joStatsAll["protocols"] = joProtocols;
+    return joStatsAll;
+}
+
+};  // namespace metrics
+
 namespace time_tracker {
 
 const char element::g_strMethodNameUnknown[] = "unknown-method";
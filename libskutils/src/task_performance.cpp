@@ -11,302 +11,45 @@ namespace performance {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-lockable::lockable() {}
-
-lockable::~lockable() {}
-
-lockable::mutex_type& lockable::mtx() const {
-    //  static skutils::multithreading::recursive_mutex_type g_lockable_mtx(
-    //      "skutils::task::performance::lockable::g_lockable_mtx");
-    //  return g_lockable_mtx;
-    return skutils::get_ref_mtx();
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-describable::describable( const string& strName, const json& jsnIn )
-    : strName_( strName ),
-      jsonIn_( jsnIn ),
-      jsonOut_( json::object() ),
-      jsonErr_( json::object() ) {
-    if ( strName_.empty() )
-        throw std::runtime_error(
-            "Attempt to instantiate performance describable "
-            "instance without name provided" );
-}
-
-describable::~describable() {}
-
-const string& describable::get_name() const {
-    return strName_;
-}
-
-json describable::get_json_in() const {
-    return jsonIn_;
-}
-json describable::get_json_out() const {
-    return jsonOut_;
-}
-json describable::get_json_err() const {
-    return jsonErr_;
-}
-void describable::set_json_in( const json& jsn ) {
-    jsonIn_ = jsn;
-}
-void describable::set_json_out( const json& jsn ) {
-    jsonOut_ = jsn;
-}
-void describable::set_json_err( const json& jsn ) {
-    jsonErr_ = jsn;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-index_holder::index_holder() : nextItemIndex_( 0 ) {}
-
-index_holder::~index_holder() {}
-
-index_type index_holder::alloc_index() {
-    index_type n = nextItemIndex_++;
-    return n;
+static uint64_t stat_now_ns() {
+    return uint64_t( std::chrono::duration_cast< std::chrono::nanoseconds >(
+        clock::now().time_since_epoch() )
+                         .count() );
 }
 
-index_type index_holder::get_index() const {
-    index_type n = nextItemIndex_;
-    return n;
+static time_point stat_ns_2_time_point( uint64_t ns ) {
+    return time_point(
+        std::chrono::duration_cast< clock::duration >( std::chrono::nanoseconds( ns ) ) );
 }
 
-void index_holder::reset() {
-    nextItemIndex_ = 0;
+// returns false if text is truncated
+static bool stat_limit_text( string& s ) {
+    if ( s.size() <= slot::g_nMaxTextLength )
+        return true;
+    s.resize( slot::g_nMaxTextLength );
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-time_holder::time_holder( bool isRunning ) : tpStart_( clock::now() ), isRunning_( isRunning ) {
-    tpEnd_ = tpStart_;
-}
-
-time_holder::~time_holder() {}
-
-bool time_holder::is_finished() const {
-    bool b = isRunning_ ? false : true;
-    return b;
-}
-
-bool time_holder::is_running() const {
-    bool b = isRunning_ ? true : false;
-    return b;
-}
-void time_holder::set_running( bool b ) {
-    if ( is_running() ) {
-        if ( b )
-            return;
-        isRunning_ = false;
-        tpEnd_ = clock::now();
-    } else {
-        if ( !b )
-            return;
-        isRunning_ = true;
-        tpStart_ = tpEnd_ = clock::now();
-    }
-}
-
-time_point time_holder::tp_start() const {
-    return tpStart_;
-}
-time_point time_holder::tp_end() const {
-    return is_finished() ? tpEnd_ : clock::now();
-}
-std::chrono::nanoseconds time_holder::tp_duration() const {
-    std::chrono::nanoseconds d = tp_end() - tp_start();
-    return d;
-}
-string time_holder::tp_start_s( bool isUTC, bool isDaysInsteadOfYMD ) const {
-    string s = cc::time2string( tp_start(), isUTC, isDaysInsteadOfYMD, false );
-    return s;
-}
-string time_holder::tp_end_s( bool isUTC, bool isDaysInsteadOfYMD ) const {
-    string s = cc::time2string( tp_end(), isUTC, isDaysInsteadOfYMD, false );
-    return s;
-}
-string time_holder::tp_duration_s() const {
-    string s = cc::duration2string( tp_duration() );
-    return s;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-item::item(
-    const string& strName, const json& jsn, queue_ptr pQueue, index_type indexQ, index_type indexT )
-    : describable( strName, jsn ),
-      time_holder( false ),
-      pQueue_( pQueue ),
-      indexQ_( indexQ ),
-      indexT_( indexT ) {
-    if ( !pQueue_ )
-        throw std::runtime_error(
-            "Attempt to instantiate performance item without queue provided" );
-}
-
-item::~item() {}
-
-queue_ptr item::get_queue() const {
-    return pQueue_;
-}
-
-tracker_ptr item::get_tracker() const {
-    return get_queue()->get_tracker();
-}
-
-index_type item::get_index_in_queue() const {
-    return indexQ_;
-}
-index_type item::get_index_in_tracker() const {
-    return indexT_;
-}
-
-json item::compose_json() const {
-    json jsn = json::object();
-    jsn["name"] = get_name();
-    jsn["iq"] = get_index_in_queue();
-    jsn["it"] = get_index_in_tracker();
-    jsn["jsnIn"] = get_json_in();
-    jsn["jsnOut"] = get_json_out();
-    jsn["jsnErr"] = get_json_err();
-    jsn["fin"] = is_finished();
-    jsn["tsStart"] = tp_start_s();
-    jsn["tsEnd"] = tp_end_s();
-    jsn["duration"] = tp_duration_s();
-    return jsn;
-}
-
-bool item::is_running() const {
-    bool b = time_holder::is_running();
-    return b;
-}
-
-void item::set_running( bool b ) {
-    time_holder::set_running( b );
-}
-
-void item::finish() {
-    set_running( false );
-}
-
-json item::get_json_in() const {
-    json jsn;
-    {  // block
-        lockable::lock_type lock( get_queue()->mtx() );
-        jsn = describable::get_json_in();
-    }  // block
-    return jsn;
-}
-json item::get_json_out() const {
-    json jsn;
-    {  // block
-        lockable::lock_type lock( get_queue()->mtx() );
-        jsn = describable::get_json_out();
-    }  // block
-    return jsn;
-}
-json item::get_json_err() const {
-    json jsn;
-    {  // block
-        lockable::lock_type lock( get_queue()->mtx() );
-        jsn = describable::get_json_err();
-    }  // block
-    return jsn;
-}
-void item::set_json_in( const json& jsn ) {
-    lockable::lock_type lock( get_queue()->mtx() );
-    describable::set_json_in( jsn );
-}
-void item::set_json_out( const json& jsn ) {
-    lockable::lock_type lock( get_queue()->mtx() );
-    describable::set_json_out( jsn );
-}
-void item::set_json_err( const json& jsn ) {
-    lockable::lock_type lock( get_queue()->mtx() );
-    describable::set_json_err( jsn );
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-queue::queue( const string& strName, const json& jsn, tracker_ptr pTracker )
-    : describable( strName, jsn ), pTracker_( pTracker ? pTracker : get_default_tracker() ) {
-    if ( !pTracker_ )
-        throw std::runtime_error(
-            "Attempt to instantiate performance queue without tracker provided" );
-}
-
-queue::~queue() {
-    reset();
-}
-
-void queue::reset() {
-    lockable::lock_type lock( mtx() );
-    map_.clear();
-    index_holder::reset();
-}
-
-tracker_ptr queue::get_tracker() const {
-    return pTracker_;
-}
-
-item_ptr queue::new_item( const string& strName, const json& jsn ) {
-    item_ptr pItem;
-    {  // block
-        lockable::lock_type lock( mtx() );
-        queue_ptr pThisQueue = this;
-        index_type indexQ = alloc_index();
-        index_type indexT = get_tracker()->alloc_index();
-        pItem = item_ptr::make( strName, jsn, pThisQueue, indexQ, indexT );
-        map_[indexQ] = pItem;
-        pItem->set_running( true );
-    }  // block
-    return pItem;
+static tracker_ptr& stat_default_tracker() {
+    static tracker_ptr g_pDefaultTracker = tracker_ptr::make();
+    return g_pDefaultTracker;
 }
 
-json queue::compose_json( index_type minIndexT ) const {
-    json jsn = json::array();
-    {  // block
-        lockable::lock_type lock( mtx() );
-        map_type::iterator itWalk = map_.begin(), itEnd = map_.end();
-        for ( ; itWalk != itEnd; ++itWalk ) {
-            // size_t indexQ = itWalk->first;
-            item_ptr pItem = itWalk->second;
-            if ( pItem->get_index_in_tracker() < minIndexT )
-                continue;
-            jsn.push_back( pItem->compose_json() );
-        }
-    }  // block
-    return jsn;
+tracker_ptr get_default_tracker() {
+    return stat_default_tracker();
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-tracker_ptr get_default_tracker() {
-    static tracker_ptr g_pDefaultTracker = tracker_ptr::make();
-    return g_pDefaultTracker;
+bool is_tracking() {
+    return stat_default_tracker().get_unconst()->is_running();
 }
 
-tracker::tracker() : time_holder( false ) {}
+tracker::tracker() {}
 
 tracker::~tracker() {
-    set_running( false );
-    reset();
-}
-
-void tracker::reset() {
-    lockable::lock_type lock( mtx() );
-    map_.clear();
-    index_holder::reset();
+    isRunning_ = false;
 }
 
 bool tracker::is_enabled() const {
@@ -348,210 +91,286 @@ void tracker::set_session_max_item_count( size_t n ) {
 }
 
 bool tracker::is_running() const {
-    bool b = time_holder::is_running();
-    return b;
+    return isRunning_.load( std::memory_order_acquire );
 }
-void tracker::set_running( bool b ) {
-    lockable::lock_type lock( mtx() );
-    time_holder::set_running( b );
-    if ( !b )
-        reset();
+
+bool tracker::begin_record( const string& strQueueName, const string& strActionName,
+    const json& jsnIn, index_type& indexOut ) {
+    if ( !is_enabled() ) {
+        return false;
+    }
+    if ( !is_running() ) {
+        return false;
+    }
+    index_type index = nextIndex_++;
+    index_type nInSession = index - sessionIndex_;
+    if ( nInSession >= get_safe_max_item_count() ) {
+        came_accross_with_possible_session_stop_reason( "max limit of events reached" );
+        return false;
+    }
+    if ( nInSession >= get_session_max_item_count() ) {
+        came_accross_with_possible_session_stop_reason( "number of requested of events saved" );
+        return false;
+    }
+    slot& s = ring_[index & ( g_nRingCapacity - 1 )];
+    uint64_t nSeq = s.seq_.load( std::memory_order_relaxed );
+    // slot is being written by late writer of older index or already reused by newer one
+    if ( ( nSeq & 1 ) != 0 || nSeq > 2 * ( index + 1 ) ||
+         !s.seq_.compare_exchange_strong( nSeq, 2 * index + 1, std::memory_order_acquire ) )
+        return false;
+    std::atomic_thread_fence( std::memory_order_release );
+    s.nsStart_.store( stat_now_ns(), std::memory_order_relaxed );
+    s.nsEnd_.store( 0, std::memory_order_relaxed );
+    uint64_t nFlags = 0;
+    // texts are prepared outside of slot lock and previous ones are freed after it
+    string strQueue( strQueueName ), strName( strActionName ), strIn = jsnIn.dump(), strOut;
+    stat_limit_text( strName );
+    if ( !stat_limit_text( strIn ) )
+        nFlags |= slot::g_nFlagInTruncated;
+    {  // block
+        std::lock_guard< std::mutex > lock( s.mtx_ );
+        s.queue_.swap( strQueue );
+        s.name_.swap( strName );
+        s.in_.swap( strIn );
+        s.out_.swap( strOut );
+    }  // block
+    s.flags_.store( nFlags, std::memory_order_relaxed );
+    s.seq_.store( 2 * ( index + 1 ), std::memory_order_release );
+    indexOut = index;
+    return true;
+}
+
+slot* tracker::lock_slot( index_type index ) {
+    slot& s = ring_[index & ( g_nRingCapacity - 1 )];
+    uint64_t nSeq = 2 * ( index + 1 );
+    if ( !s.seq_.compare_exchange_strong( nSeq, 2 * index + 1, std::memory_order_acquire ) )
+        return nullptr;  // overwritten by newer action
+    std::atomic_thread_fence( std::memory_order_release );
+    return &s;
 }
 
-queue_ptr tracker::get_queue( const string& strName ) {
-    queue_ptr pQueue;
+void tracker::unlock_slot( slot* pSlot, index_type index ) {
+    pSlot->seq_.store( 2 * ( index + 1 ), std::memory_order_release );
+}
+
+void tracker::end_record( index_type index, uint64_t nsEnd ) {
+    slot* pSlot = lock_slot( index );
+    if ( !pSlot )
+        return;
+    pSlot->nsEnd_.store( nsEnd, std::memory_order_relaxed );
+    unlock_slot( pSlot, index );
+}
+
+void tracker::update_record( index_type index, const json& jsn, uint64_t nFlag ) {
+    string strDump = jsn.dump();
+    bool isComplete = stat_limit_text( strDump );
+    slot* pSlot = lock_slot( index );
+    if ( !pSlot )
+        return;
+    uint64_t nFlags = pSlot->flags_.load( std::memory_order_relaxed );
+    if ( nFlag == slot::g_nFlagInTruncated ) {
+        nFlags &= ~slot::g_nFlagInTruncated;
+        if ( !isComplete )
+            nFlags |= slot::g_nFlagInTruncated;
+    } else {
+        nFlags &= ~( slot::g_nFlagOutTruncated | slot::g_nFlagHasError );
+        if ( !isComplete )
+            nFlags |= slot::g_nFlagOutTruncated;
+        if ( nFlag == slot::g_nFlagHasError )
+            nFlags |= slot::g_nFlagHasError;
+    }
     {  // block
-        lockable::lock_type lock( mtx() );
-        tracker_ptr pThisTracker = this;
-        map_type::iterator itFind = map_.find( strName ), itEnd = map_.end();
-        if ( itFind != itEnd )
-            pQueue = itFind->second;
-        else {
-            pQueue = queue_ptr::make( strName, json::object(), pThisTracker );
-            map_[strName] = pQueue;
-        }
+        std::lock_guard< std::mutex > lock( pSlot->mtx_ );
+        ( nFlag == slot::g_nFlagInTruncated ? pSlot->in_ : pSlot->out_ ).swap( strDump );
     }  // block
-    return pQueue;
+    pSlot->flags_.store( nFlags, std::memory_order_relaxed );
+    unlock_slot( pSlot, index );
+}
+
+// truncated payloads are returned as strings
+static json stat_payload_2_json( const string& strDump, bool isTruncated ) {
+    if ( strDump.empty() )
+        return json::object();
+    if ( isTruncated )
+        return json( strDump + "..." );
+    try {
+        return json::parse( strDump );
+    } catch ( ... ) {
+        return json( strDump );
+    }
 }
 
 json tracker::compose_json( index_type minIndexT ) const {
     json jsn = json::object();
     json jsnQueues = json::object();
-    size_t idxFetchPointNextTime = 0;
-    {  // block
-        lockable::lock_type lock( mtx() );
-        idxFetchPointNextTime = get_index();
-        map_type::iterator itWalk = map_.begin(), itEnd = map_.end();
-        for ( ; itWalk != itEnd; ++itWalk ) {
-            string strName = itWalk->first;
-            queue_ptr pQueue = itWalk->second;
-            jsnQueues[strName] = pQueue->compose_json( minIndexT );
+    index_type nSessionIndex = sessionIndex_, nNextIndex = nextIndex_;
+    uint64_t nsSessionStart = nsSessionStart_, nsSessionEnd = nsSessionEnd_;
+    bool isSessionRunning = is_running();
+    uint64_t nsNow = stat_now_ns();
+    if ( !isSessionRunning )
+        nsNow = nsSessionEnd;
+    index_type nFirst = nSessionIndex + minIndexT;
+    if ( nNextIndex > g_nRingCapacity && nFirst < nNextIndex - g_nRingCapacity )
+        nFirst = nNextIndex - g_nRingCapacity;
+    for ( index_type index = nFirst; ring_ && index < nNextIndex; ++index ) {
+        const slot& s = ring_[index & ( g_nRingCapacity - 1 )];
+        uint64_t nSeq = 2 * ( index + 1 );
+        string strQueue, strName, strIn, strOut;
+        uint64_t nsStart = 0, nsEnd = 0, nFlags = 0;
+        bool isRead = false;
+        for ( size_t nAttempt = 0; nAttempt < 3 && !isRead; ++nAttempt ) {
+            if ( s.seq_.load( std::memory_order_acquire ) != nSeq )
+                continue;  // being written, not yet written or overwritten
+            nsStart = s.nsStart_.load( std::memory_order_relaxed );
+            nsEnd = s.nsEnd_.load( std::memory_order_relaxed );
+            nFlags = s.flags_.load( std::memory_order_relaxed );
+            {  // block
+                std::lock_guard< std::mutex > lock( s.mtx_ );
+                strQueue = s.queue_;
+                strName = s.name_;
+                strIn = s.in_;
+                strOut = s.out_;
+            }  // block
+            std::atomic_thread_fence( std::memory_order_acquire );
+            isRead = s.seq_.load( std::memory_order_relaxed ) == nSeq;
         }
-    }  // block
+        if ( !isRead )
+            continue;
+        bool isFinished = nsEnd != 0;
+        if ( !isFinished )
+            nsEnd = nsNow > nsStart ? nsNow : nsStart;
+        json jsnOut =
+            stat_payload_2_json( strOut, ( nFlags & slot::g_nFlagOutTruncated ) != 0 );
+        json jsnItem = json::object();
+        jsnItem["name"] = strName;
+        jsnItem["it"] = index - nSessionIndex;
+        jsnItem["jsnIn"] =
+            stat_payload_2_json( strIn, ( nFlags & slot::g_nFlagInTruncated ) != 0 );
+        jsnItem["jsnOut"] = ( nFlags & slot::g_nFlagHasError ) ? json::object() : jsnOut;
+        jsnItem["jsnErr"] = ( nFlags & slot::g_nFlagHasError ) ? jsnOut : json::object();
+        jsnItem["fin"] = isFinished;
+        jsnItem["tsStart"] =
+            cc::time2string( stat_ns_2_time_point( nsStart ), true, false, false );
+        jsnItem["tsEnd"] = cc::time2string( stat_ns_2_time_point( nsEnd ), true, false, false );
+        jsnItem["duration"] = cc::duration2string( std::chrono::nanoseconds( nsEnd - nsStart ) );
+        json& jarrQueue = jsnQueues[strQueue];
+        if ( !jarrQueue.is_array() )
+            jarrQueue = json::array();
+        jarrQueue.push_back( jsnItem );
+    }
     jsn["queues"] = jsnQueues;
-    jsn["nextTimeFetchIndex"] = idxFetchPointNextTime;
-    jsn["tsStart"] = tp_start_s();  // entire session start, not time point of minIndexT
-    jsn["tsEnd"] = tp_end_s();
+    jsn["nextTimeFetchIndex"] = nNextIndex - nSessionIndex;
+    // entire session start, not time point of minIndexT
+    jsn["tsStart"] = cc::time2string( stat_ns_2_time_point( nsSessionStart ), true, false, false );
+    jsn["tsEnd"] = cc::time2string( stat_ns_2_time_point( nsNow ), true, false, false );
     return jsn;
 }
 
 void tracker::cancel() {
-    lockable::lock_type lock( mtx() );
-    set_running( false );
+    std::lock_guard< std::mutex > lock( mtx_ );
+    if ( !isRunning_ )
+        return;
+    nsSessionEnd_ = stat_now_ns();
+    isRunning_ = false;
 }
 
 void tracker::start() {
-    lockable::lock_type lock( mtx() );
+    std::lock_guard< std::mutex > lock( mtx_ );
     strFirstEncounteredStopReason_.clear();
-    set_running( true );
+    if ( isRunning_ )
+        return;
+    if ( !ring_ )
+        ring_.reset( new slot[g_nRingCapacity] );
+    sessionIndex_ = nextIndex_.load();
+    nsSessionStart_ = nsSessionEnd_ = stat_now_ns();
+    isRunning_.store( true, std::memory_order_release );
 }
 
 json tracker::stop( index_type minIndexT ) {
-    json jsn = json::object();
-    {  // block
-        lockable::lock_type lock( mtx() );
-        came_accross_with_possible_session_stop_reason(
-            "performance tracker stopped by user request" );
-        jsn = compose_json( minIndexT );
-        set_running( false );
-    }  // block
-    return jsn;
+    came_accross_with_possible_session_stop_reason( "performance tracker stopped by user request" );
+    cancel();
+    return compose_json( minIndexT );
 }
 
 void tracker::came_accross_with_possible_session_stop_reason(
     const string& strPossibleStopReason ) {
     if ( strPossibleStopReason.empty() )
         return;
-    lockable::lock_type lock( mtx() );
+    std::lock_guard< std::mutex > lock( mtx_ );
     if ( strFirstEncounteredStopReason_.empty() )
         strFirstEncounteredStopReason_ = strPossibleStopReason;
 }
 
 string tracker::get_first_encountered_stop_reason() const {
-    string s;
-    {  // block
-        lockable::lock_type lock( mtx() );
-        s = strFirstEncounteredStopReason_;
-    }  // block
-    return s;
+    std::lock_guard< std::mutex > lock( mtx_ );
+    return strFirstEncounteredStopReason_;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+action::action() {}
+
 action::action( const string& strQueueName, const string& strActionName, const json& jsnAction,
     tracker_ptr pTracker ) {
-    init( strQueueName, strActionName, jsnAction, pTracker );
+    start( strQueueName, strActionName, jsnAction, pTracker );
 }
 
 action::action( const string& strQueueName, const string& strActionName, const json& jsnAction ) {
-    init( strQueueName, strActionName, jsnAction, get_default_tracker() );
+    start( strQueueName, strActionName, jsnAction );
 }
 
 action::action( const string& strQueueName, const string& strActionName ) {
-    init( strQueueName, strActionName, json::object(), get_default_tracker() );
+    start( strQueueName, strActionName );
 }
 
 action::~action() {
     finish();
 }
 
-void action::init( const string& strQueueName, const string& strActionName, const json& jsnAction,
-    tracker_ptr pTracker ) {
-    isSkipped_ = false;
-    if ( !pTracker ) {
-        pTracker = get_default_tracker();
-        if ( !pTracker )
-            throw std::runtime_error(
-                "Attempt to instantiate performance action without tracker provided" );
-    }
-    if ( !pTracker->is_enabled() ) {
-        isSkipped_ = true;
-        return;
-    }
-    if ( !pTracker->is_running() ) {
-        isSkipped_ = true;
-        return;
-    }
-    if ( pTracker->get_index() >= pTracker->get_safe_max_item_count() ) {
-        isSkipped_ = true;
-        pTracker->came_accross_with_possible_session_stop_reason( "max limit of events reached" );
-        return;
-    }
-    if ( pTracker->get_index() >= pTracker->get_session_max_item_count() ) {
-        isSkipped_ = true;
-        pTracker->came_accross_with_possible_session_stop_reason(
-            "number of requested of events saved" );
+void action::start( const string& strQueueName, const string& strActionName,
+    const json& jsnAction, tracker_ptr pTracker ) {
+    finish();
+    isSkipped_ = true;
+    isFinished_ = false;
+    tracker* pRawTracker = pTracker ? pTracker.get() : stat_default_tracker().get();
+    if ( !pRawTracker->is_running() )
+        return;  // do not touch reference counter when not tracking
+    if ( !pRawTracker->begin_record( strQueueName, strActionName, jsnAction, index_ ) )
         return;
-    }
-    queue_ptr pQueue = pTracker->get_queue( strQueueName );
-    pItem_ = pQueue->new_item( strActionName, jsnAction );
+    pTracker_ = pRawTracker;
+    isSkipped_ = false;
 }
 
-json action::get_json_in() const {
-    if ( isSkipped_ )
-        return json::object();
-    item_ptr pItem = get_item();
-    if ( !pItem )
-        return json::object();
-    return get_item()->get_json_in();
-}
-json action::get_json_out() const {
-    if ( isSkipped_ )
-        return json::object();
-    item_ptr pItem = get_item();
-    if ( !pItem )
-        return json::object();
-    return pItem->get_json_out();
-}
-json action::get_json_err() const {
-    if ( isSkipped_ )
-        return json::object();
-    item_ptr pItem = get_item();
-    if ( !pItem )
-        return json::object();
-    return pItem->get_json_err();
-}
 void action::set_json_in( const json& jsn ) {
     if ( isSkipped_ )
         return;
-    item_ptr pItem = get_item();
-    if ( pItem )
-        pItem->set_json_in( jsn );
+    pTracker_->update_record( index_, jsn, slot::g_nFlagInTruncated );
 }
 void action::set_json_out( const json& jsn ) {
     if ( isSkipped_ )
         return;
-    item_ptr pItem = get_item();
-    if ( pItem )
-        pItem->set_json_out( jsn );
+    pTracker_->update_record( index_, jsn, slot::g_nFlagOutTruncated );
 }
 void action::set_json_err( const json& jsn ) {
     if ( isSkipped_ )
         return;
-    item_ptr pItem = get_item();
-    if ( pItem )
-        pItem->set_json_err( jsn );
+    pTracker_->update_record( index_, jsn, slot::g_nFlagHasError );
 }
 
-item_ptr action::get_item() const {
-    if ( isSkipped_ )
-        throw std::runtime_error( "Attempt to access performance task action in skipped state" );
-    return pItem_;
-}
-
-queue_ptr action::get_queue() const {
-    return get_item()->get_queue();
+tracker_ptr action::get_tracker() const {
+    return pTracker_;
 }
 
-tracker_ptr action::get_tracker() const {
-    return get_queue()->get_tracker();
+index_type action::get_index_in_tracker() const {
+    return index_;
 }
 
 void action::finish() {
-    if ( isSkipped_ )
+    if ( isSkipped_ || isFinished_ )
         return;
-    get_item()->finish();
+    isFinished_ = true;
+    pTracker_->end_record( index_, stat_now_ns() );
 }
 
 bool action::is_skipped() const {
@@ -78,4 +78,110 @@ void thread_pool::shutdown() {
     threads_.clear();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+thread_local work_stealing_pool* work_stealing_pool::g_current_pool = nullptr;
+thread_local size_t work_stealing_pool::g_current_index = 0;
+
+work_stealing_pool::work_stealing_pool( const size_t nNumberOfThreads )
+    : next_queue_( 0 ), pending_( 0 ), shutdown_flag_( false ) {
+    size_t cnt = ( nNumberOfThreads > 0 ) ? nNumberOfThreads : skutils::tools::cpu_count();
+    if ( cnt < 1 )
+        cnt = 1;
+    for ( size_t i = 0; i < cnt; ++i )
+        queues_.emplace_back( new worker_queue );
+    for ( size_t i = 0; i < cnt; ++i )
+        threads_.emplace_back( [this, i]() { worker_loop( i ); } );
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    shutdown();
+}
+
+void work_stealing_pool::submit( job_t job ) {
+    if ( shutdown_flag_ )
+        return;
+    size_t i = ( g_current_pool == this ) ? g_current_index : ( next_queue_++ % queues_.size() );
+    {  // block
+        std::lock_guard< std::mutex > lock( queues_[i]->mtx_ );
+        queues_[i]->jobs_.push_back( std::move( job ) );
+    }  // block
+    {  // block
+        std::lock_guard< std::mutex > lock( wait_mutex_ );
+        ++pending_;
+    }  // block
+    wait_lock_.notify_one();
+}
+
+bool work_stealing_pool::pop_own( size_t i, job_t& job ) {
+    worker_queue& q = *queues_[i];
+    std::lock_guard< std::mutex > lock( q.mtx_ );
+    if ( q.jobs_.empty() )
+        return false;
+    job = std::move( q.jobs_.back() );
+    q.jobs_.pop_back();
+    return true;
+}
+
+bool work_stealing_pool::steal( size_t i, job_t& job ) {
+    size_t cnt = queues_.size();
+    for ( size_t j = 1; j < cnt; ++j ) {
+        worker_queue& q = *queues_[( i + j ) % cnt];
+        std::lock_guard< std::mutex > lock( q.mtx_ );
+        if ( q.jobs_.empty() )
+            continue;
+        job = std::move( q.jobs_.front() );
+        q.jobs_.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void work_stealing_pool::worker_loop( size_t i ) {
+    skutils::multithreading::threadNamer tn( skutils::tools::format( "ws%zu", i ) );
+    g_current_pool = this;
+    g_current_index = i;
+    job_t job;
+    for ( ;; ) {
+        if ( pop_own( i, job ) || steal( i, job ) ) {
+            --pending_;
+            try {
+                job();
+            } catch ( ... ) {
+            }
+            job = nullptr;
+            continue;
+        }
+        std::unique_lock< std::mutex > lock( wait_mutex_ );
+        wait_lock_.wait( lock, [this]() { return shutdown_flag_ || pending_ > 0; } );
+        if ( shutdown_flag_ )
+            break;
+    }
+    g_current_pool = nullptr;
+}
+
+void work_stealing_pool::shutdown() {
+    {  // block
+        std::lock_guard< std::mutex > lock( wait_mutex_ );
+        if ( shutdown_flag_ )
+            return;
+        shutdown_flag_ = true;
+    }  // block
+    wait_lock_.notify_all();
+    for ( std::thread& t : threads_ ) {
+        try {
+            if ( t.joinable() )
+                t.join();
+        } catch ( ... ) {
+        }
+    }
+    threads_.clear();
+    for ( auto& q : queues_ ) {
+        std::lock_guard< std::mutex > lock( q->mtx_ );
+        q->jobs_.clear();
+    }
+    pending_ = 0;
+}
+
 };  // namespace skutils
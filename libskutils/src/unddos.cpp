@@ -3,6 +3,15 @@
 namespace skutils {
 namespace unddos {
 
+// batch limits use 0 as "no per-origin limit", so it must not win in min()
+static size_t stat_min_limit( size_t a, size_t b ) {
+    if ( a == 0 )
+        return b;
+    if ( b == 0 )
+        return a;
+    return std::min( a, b );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -41,6 +50,8 @@ void origin_entry_setting::load_friendly_for_any_origin() {
     ban_peak_ = duration( 15 );
     ban_lengthy_ = duration( 120 );
     max_ws_conn_ = 50;
+    max_batch_size_ = 0;
+    max_batch_parallelism_ = 8;
     load_recommended_custom_methods_as_multiplier_of_default();
 }
 
@@ -52,6 +63,8 @@ void origin_entry_setting::load_reasonable_for_any_origin() {
     ban_peak_ = duration( 15 );
     ban_lengthy_ = duration( 120 );
     max_ws_conn_ = 10;
+    max_batch_size_ = 64;
+    max_batch_parallelism_ = 2;
     load_recommended_custom_methods_as_multiplier_of_default();
 }
 
@@ -63,6 +76,8 @@ void origin_entry_setting::load_unlim_for_any_origin() {
     ban_peak_ = duration( 0 );
     ban_lengthy_ = duration( 0 );
     max_ws_conn_ = std::numeric_limits< size_t >::max();
+    max_batch_size_ = 0;
+    max_batch_parallelism_ = std::numeric_limits< size_t >::max();
     load_recommended_custom_methods_as_multiplier_of_default();
 }
 
@@ -75,6 +90,8 @@ void origin_entry_setting::load_unlim_for_localhost_only() {
     ban_peak_ = duration( 0 );
     ban_lengthy_ = duration( 0 );
     max_ws_conn_ = std::numeric_limits< size_t >::max();
+    max_batch_size_ = 0;
+    max_batch_parallelism_ = std::numeric_limits< size_t >::max();
     load_recommended_custom_methods_as_multiplier_of_default();
 }
 
@@ -113,6 +130,8 @@ void origin_entry_setting::clear() {
     ban_peak_ = duration( 0 );
     ban_lengthy_ = duration( 0 );
     max_ws_conn_ = 0;
+    max_batch_size_ = 0;
+    max_batch_parallelism_ = 0;
     map_custom_method_settings_.clear();
 }
 
@@ -126,6 +145,8 @@ origin_entry_setting& origin_entry_setting::assign( const origin_entry_setting&
     ban_peak_ = other.ban_peak_;
     ban_lengthy_ = other.ban_lengthy_;
     max_ws_conn_ = other.max_ws_conn_;
+    max_batch_size_ = other.max_batch_size_;
+    max_batch_parallelism_ = other.max_batch_parallelism_;
     map_custom_method_settings_ = other.map_custom_method_settings_;
     return ( *this );
 }
@@ -140,6 +161,8 @@ origin_entry_setting& origin_entry_setting::merge( const origin_entry_setting& o
     ban_peak_ = std::max( ban_peak_, other.ban_peak_ );
     ban_lengthy_ = std::max( ban_lengthy_, other.ban_lengthy_ );
     max_ws_conn_ = std::min( max_ws_conn_, other.max_ws_conn_ );
+    max_batch_size_ = stat_min_limit( max_batch_size_, other.max_batch_size_ );
+    max_batch_parallelism_ = stat_min_limit( max_batch_parallelism_, other.max_batch_parallelism_ );
     if ( !other.map_custom_method_settings_.empty() ) {
         nlohmann::json joCMS = nlohmann::json::object();
         map_custom_method_settings_t::const_iterator itWalk =
@@ -183,6 +206,10 @@ void origin_entry_setting::fromJSON( const nlohmann::json& jo ) {
         ban_lengthy_ = jo["ban_lengthy"].get< size_t >();
     if ( jo.find( "max_ws_conn" ) != jo.end() )
         max_ws_conn_ = jo["max_ws_conn"].get< size_t >();
+    if ( jo.find( "max_batch_size" ) != jo.end() )
+        max_batch_size_ = jo["max_batch_size"].get< size_t >();
+    if ( jo.find( "max_batch_parallelism" ) != jo.end() )
+        max_batch_parallelism_ = jo["max_batch_parallelism"].get< size_t >();
     if ( jo.find( "custom_method_settings" ) != jo.end() ) {
         const nlohmann::json& joCMS = jo["custom_method_settings"];
         for ( auto it = joCMS.cbegin(); it != joCMS.cend(); ++it ) {
@@ -208,6 +235,8 @@ void origin_entry_setting::toJSON( nlohmann::json& jo ) const {
     jo["ban_peak"] = ban_peak_;
     jo["ban_lengthy"] = ban_lengthy_;
     jo["max_ws_conn"] = max_ws_conn_;
+    jo["max_batch_size"] = max_batch_size_;
+    jo["max_batch_parallelism"] = max_batch_parallelism_;
     if ( !map_custom_method_settings_.empty() ) {
         nlohmann::json joCMS = nlohmann::json::object();
         map_custom_method_settings_t::const_iterator itWalk = map_custom_method_settings_.cbegin(),
@@ -421,254 +450,241 @@ origin_entry_setting& settings::auto_append_any_origin_rule() {
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-time_entry::time_entry( time_tick_mark ttm ) : ttm_( ttm ) {}
-
-time_entry::time_entry( const time_entry& other ) {
-    assign( other );
-}
-
-time_entry::time_entry( time_entry&& other ) {
-    assign( other );
-    other.clear();
-}
-
-time_entry::~time_entry() {
-    clear();
-}
-
-time_entry& time_entry::operator=( const time_entry& other ) {
-    return assign( other );
-}
-
-bool time_entry::empty() const {
-    if ( ttm_ != time_tick_mark( 0 ) )
-        return false;
-    return true;
-}
-
-void time_entry::clear() {
-    ttm_ = time_tick_mark( 0 );
-}
-
-time_entry& time_entry::assign( const time_entry& other ) {
-    clear();
-    ttm_ = other.ttm_;
-    return ( *this );
-}
-
-int time_entry::compare( const time_entry& other ) const {
-    if ( ttm_ < other.ttm_ )
-        return -1;
-    if ( ttm_ > other.ttm_ )
-        return 1;
-    return 0;
-}
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-tracked_origin::tracked_origin( const char* origin, time_tick_mark ttm )
-    : origin_( ( origin != nullptr && origin[0] != '\0' ) ? origin : "" ) {
-    if ( ttm != time_tick_mark( 0 ) )
-        time_entries_.push_back( time_entry( ttm ) );
-}
-
-tracked_origin::tracked_origin( const std::string& origin, time_tick_mark ttm )
-    : origin_( origin ) {
-    if ( ttm != time_tick_mark( 0 ) )
-        time_entries_.push_back( time_entry( ttm ) );
-}
-
-tracked_origin::tracked_origin( const tracked_origin& other ) {
-    assign( other );
-}
-
-tracked_origin::tracked_origin( tracked_origin&& other ) {
-    assign( other );
-    other.clear();
-}
-
-tracked_origin::~tracked_origin() {
-    clear();
-}
-
-tracked_origin& tracked_origin::operator=( const tracked_origin& other ) {
-    return assign( other );
-}
-
-bool tracked_origin::empty() const {
-    if ( !origin_.empty() )
-        return false;
-    if ( !time_entries_.empty() )
-        return false;
-    return true;
-}
-
-void tracked_origin::clear() {
-    origin_.clear();
-    time_entries_.clear();
-    clear_ban();
-}
-
-tracked_origin& tracked_origin::assign( const tracked_origin& other ) {
-    clear();
-    origin_ = other.origin_;
-    time_entries_ = other.time_entries_;
-    ban_until_ = other.ban_until_;
-    return ( *this );
-}
-
-int tracked_origin::compare( const tracked_origin& other ) const {
-    int n = origin_.compare( other.origin_ );
-    return n;
-}
-int tracked_origin::compare( const char* origin ) const {
-    int n = origin_.compare( origin ? origin : "" );
-    return n;
-}
-int tracked_origin::compare( const std::string& origin ) const {
-    int n = origin_.compare( origin );
-    return n;
-}
-
-size_t tracked_origin::unload_old_data_by_time_to_past(
-    time_tick_mark ttmNow, duration durationToPast ) {
-    if ( durationToPast == duration( 0 ) )
-        return 0;
-    adjust_now_tick_mark( ttmNow );
-    time_tick_mark ttmUntil = ttmNow - durationToPast;
-    size_t cntRemoved = 0;
-    adjust_now_tick_mark( ttmNow );
-    while ( !time_entries_.empty() ) {
-        const time_entry& te = time_entries_.front();
-        if ( te.ttm_ < ttmUntil ) {
-            time_entries_.pop_front();
-            ++cntRemoved;
-        } else
+tracked_origin::tracked_origin() {
+    for ( size_t i = 0; i < c_bucket_count; ++i )
+        buckets_[i] = 0;
+}
+
+void tracked_origin::add_call( time_tick_mark ttm ) {
+    const uint64_t tag = uint64_t( ttm );
+    std::atomic_uint64_t& bucket = buckets_[tag & ( c_bucket_count - 1 )];
+    uint64_t cur = bucket.load( std::memory_order_relaxed );
+    for ( ;; ) {
+        uint64_t next;
+        uint64_t curTag = cur >> c_count_bits;
+        if ( curTag == tag ) {
+            if ( ( cur & c_count_mask ) == c_count_mask )
+                break;  // saturated
+            next = cur + 1;
+        } else if ( curTag > tag )
+            break;  // bucket already reused by newer second, this call is out of any window
+        else
+            next = ( tag << c_count_bits ) | 1;
+        if ( bucket.compare_exchange_weak( cur, next, std::memory_order_relaxed ) )
             break;
     }
-    return cntRemoved;
-}
-
-size_t tracked_origin::unload_old_data_by_count( size_t cntEntriesMax ) {
-    size_t cntRemoved = 0;
-    while ( time_entries_.size() > cntEntriesMax ) {
-        time_entries_.pop_front();
-        ++cntRemoved;
+    time_tick_mark ttmLast = last_call_.load( std::memory_order_relaxed );
+    while ( ttmLast < ttm &&
+            !last_call_.compare_exchange_weak( ttmLast, ttm, std::memory_order_relaxed ) ) {
     }
-    return cntRemoved;
 }
 
 size_t tracked_origin::count_to_past( time_tick_mark ttmNow, duration durationToPast ) const {
-    // if ( durationToPast == duration( 0 ) )
-    //    return 0;
     adjust_now_tick_mark( ttmNow );
-    time_tick_mark ttmUntil = ttmNow - durationToPast;
+    if ( durationToPast < 0 )
+        return 0;
+    if ( size_t( durationToPast ) >= c_bucket_count )
+        durationToPast = duration( c_bucket_count - 1 );
     size_t cnt = 0;
-    time_entries_t::const_reverse_iterator itWalk = time_entries_.crbegin(),
-                                           itEnd = time_entries_.crend();
-    for ( ; itWalk != itEnd; ++itWalk ) {
-        const time_entry& te = ( *itWalk );
-        if ( ttmUntil <= te.ttm_ && te.ttm_ <= ttmNow )
-            ++cnt;
+    for ( time_tick_mark ttm = ttmNow - durationToPast; ttm <= ttmNow; ++ttm ) {
+        const uint64_t tag = uint64_t( ttm );
+        uint64_t cur = buckets_[tag & ( c_bucket_count - 1 )].load( std::memory_order_relaxed );
+        if ( ( cur >> c_count_bits ) == tag )
+            cnt += size_t( cur & c_count_mask );
     }
     return cnt;
 }
 
 bool tracked_origin::clear_ban() {
-    if ( ban_until_ == time_tick_mark( 0 ) )
-        return false;
-    ban_until_ = time_tick_mark( 0 );
-    return true;  // was cleared
+    return ban_until_.exchange( time_tick_mark( 0 ) ) != time_tick_mark( 0 );  // was cleared
 }
 
 bool tracked_origin::check_ban( time_tick_mark ttmNow, bool isAutoClear ) {
-    if ( ban_until_ == time_tick_mark( 0 ) )
+    time_tick_mark ttmBanUntil = ban_until_;
+    if ( ttmBanUntil == time_tick_mark( 0 ) )
         return false;
     adjust_now_tick_mark( ttmNow );
-    if ( ttmNow <= ban_until_ )
+    if ( ttmNow <= ttmBanUntil )
         return true;
     if ( isAutoClear )
-        clear_ban();
+        ban_until_.compare_exchange_strong( ttmBanUntil, time_tick_mark( 0 ) );
     return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-algorithm::algorithm() {}
+algorithm::algorithm() {
+    lock_type lock( mtx_ );
+    publish_settings();
+    sweeper_ = std::thread( [this]() { sweeper_loop(); } );
+}
 
 algorithm::algorithm( const settings& st ) {
+    lock_type lock( mtx_ );
     settings_ = st;
+    publish_settings();
+    sweeper_ = std::thread( [this]() { sweeper_loop(); } );
 }
 
-algorithm::~algorithm() {}
+algorithm::~algorithm() {
+    {
+        std::lock_guard< std::mutex > lock( sweeper_mtx_ );
+        sweeper_stop_ = true;
+    }
+    sweeper_cv_.notify_all();
+    if ( sweeper_.joinable() )
+        sweeper_.join();
+    delete current_settings_.load();
+}
 
 algorithm& algorithm::operator=( const settings& st ) {
     lock_type lock( mtx_ );
     settings_ = st;
+    publish_settings();
     return ( *this );
 }
 
+// keeps published settings it has seen alive until destroyed
+class algorithm::settings_reader {
+public:
+    explicit settings_reader( const algorithm& a ) {
+        for ( ;; ) {
+            const uint64_t nEpoch = a.settings_epoch_;
+            pReaders_ = &a.settings_readers_[nEpoch & 1];
+            ++( *pReaders_ );
+            if ( a.settings_epoch_ == nEpoch )
+                break;
+            --( *pReaders_ );  // publisher may have missed this reader, retry in new epoch
+        }
+        pSettings_ = a.current_settings_;
+    }
+    settings_reader( const settings_reader& ) = delete;
+    settings_reader& operator=( const settings_reader& ) = delete;
+    ~settings_reader() { --( *pReaders_ ); }
+    const published_settings& operator*() const { return *pSettings_; }
+    const published_settings* operator->() const { return pSettings_; }
+
+private:
+    std::atomic_size_t* pReaders_;
+    const published_settings* pSettings_;
+};
+
+void algorithm::publish_settings() const {
+    settings_.auto_append_any_origin_rule();
+    const published_settings* pOld =
+        current_settings_.exchange( new published_settings{settings_, ++settings_version_} );
+    if ( !pOld )
+        return;
+    // readers of previous epoch are the only ones which could load pOld, calls are short
+    const uint64_t nEpoch = settings_epoch_++;
+    while ( settings_readers_[nEpoch & 1] != 0 )
+        std::this_thread::yield();
+    delete pOld;
+}
+
+const origin_entry_setting& algorithm::find_origin_entry_setting_cached(
+    const published_settings& ps, tracked_origin& to, const char* origin ) {
+    const uint64_t nCached = to.oe_cache_;
+    if ( ( nCached >> 32 ) == ( ps.version_ & 0xFFFFFFFF ) && nCached != 0 )
+        return ps.settings_.origins_[nCached & 0xFFFFFFFF];
+    size_t i = ps.settings_.find_origin_entry_setting_match( origin );
+    if ( i == std::string::npos )
+        i = ps.settings_.find_origin_entry_setting_match( "*" );  // published settings have it
+    to.oe_cache_ = ( ( ps.version_ & 0xFFFFFFFF ) << 32 ) | uint64_t( i );
+    return ps.settings_.origins_[i];
+}
+
+algorithm::shard& algorithm::shard_of( const char* origin ) const {
+    size_t h = std::hash< std::string >()( origin );
+    return shards_[h % c_shard_count];
+}
+
+tracked_origin_ptr algorithm::find_tracked_origin( const char* origin ) const {
+    shard& sh = shard_of( origin );
+    std::shared_lock< std::shared_mutex > lock( sh.mtx_ );
+    auto itFind = sh.map_.find( origin );
+    if ( itFind == sh.map_.end() )
+        return tracked_origin_ptr();
+    return itFind->second;
+}
+
+tracked_origin_ptr algorithm::find_or_add_tracked_origin( const char* origin, bool& isAdded ) {
+    isAdded = false;
+    tracked_origin_ptr pTO = find_tracked_origin( origin );
+    if ( pTO )
+        return pTO;
+    shard& sh = shard_of( origin );
+    std::unique_lock< std::shared_mutex > lock( sh.mtx_ );
+    tracked_origin_ptr& pSlot = sh.map_[origin];
+    if ( !pSlot ) {
+        pSlot = std::make_shared< tracked_origin >();
+        isAdded = true;
+    }
+    return pSlot;
+}
+
+void algorithm::sweeper_loop() {
+    std::unique_lock< std::mutex > lock( sweeper_mtx_ );
+    while ( !sweeper_stop_ ) {
+        sweeper_cv_.wait_for( lock, std::chrono::seconds( 1 ) );
+        if ( sweeper_stop_ )
+            break;
+        lock.unlock();
+        try {
+            unload_old_data_by_time_to_past();
+        } catch ( ... ) {
+        }
+        lock.lock();
+    }
+}
+
 size_t algorithm::unload_old_data_by_time_to_past(
     time_tick_mark ttmNow, duration durationToPast ) {
-    if ( !settings_.enabled_ )
-        return 0;
     if ( durationToPast == duration( 0 ) )
         return 0;
     adjust_now_tick_mark( ttmNow );
-    lock_type lock( mtx_ );
     size_t cnt = 0;
-    std::set< std::string > setOriginsTorRemove;
-    tracked_origins_t::iterator itWalk = tracked_origins_.begin(), itEnd = tracked_origins_.end();
-    for ( ; itWalk != itEnd; ++itWalk ) {
-        tracked_origin& to = const_cast< tracked_origin& >( *itWalk );
-        size_t cntWalk = to.unload_old_data_by_time_to_past( ttmNow, durationToPast );
-        cnt += cntWalk;
-        if ( to.time_entries_.empty() ) {
-            setOriginsTorRemove.insert( to.origin_ );  // TO-FIX: do not unload banned
+    for ( size_t i = 0; i < c_shard_count; ++i ) {
+        shard& sh = shards_[i];
+        std::unique_lock< std::shared_mutex > lock( sh.mtx_ );
+        for ( auto itWalk = sh.map_.begin(); itWalk != sh.map_.end(); ) {
+            tracked_origin& to = *( itWalk->second );
+            if ( to.last_call() < ttmNow - durationToPast && !to.check_ban( ttmNow ) ) {
+                itWalk = sh.map_.erase( itWalk );
+                ++cnt;
+            } else
+                ++itWalk;
         }
     }
-    for ( const std::string& origin : setOriginsTorRemove )
-        tracked_origins_.erase( origin );
     return cnt;
 }
 
 e_high_load_detection_result_t algorithm::register_call_from_origin(
     const char* origin, const char* strMethod, time_tick_mark ttmNow, duration durationToPast ) {
-    if ( !settings_.enabled_ )
+    settings_reader ps( *this );
+    if ( !ps->settings_.enabled_ )
         return e_high_load_detection_result_t::ehldr_no_error;
     if ( origin == nullptr || origin[0] == '\0' )
         return e_high_load_detection_result_t::ehldr_bad_origin;
     adjust_now_tick_mark( ttmNow );
-    lock_type lock( mtx_ );
-    unload_old_data_by_time_to_past( ttmNow, durationToPast );  // unload first
-    tracked_origins_t::iterator itFind = tracked_origins_.find( origin ),
-                                itEnd = tracked_origins_.end();
-    if ( itFind == itEnd ) {
-        tracked_origin to( origin, ttmNow );
-        tracked_origins_.insert( to );
+    bool isAdded = false;
+    tracked_origin_ptr pTO = find_or_add_tracked_origin( origin, isAdded );
+    tracked_origin& to = *pTO;
+    to.add_call( ttmNow );
+    if ( isAdded )
         return e_high_load_detection_result_t::ehldr_no_error;
-    }
-    // return detect_high_load( origin.ttmNow, durationToPast )
-    tracked_origin& to = const_cast< tracked_origin& >( *itFind );
-    to.time_entries_.push_back( time_entry( ttmNow ) );
     if ( to.check_ban( ttmNow ) )
         return e_high_load_detection_result_t::ehldr_ban;  // still banned
-    const origin_entry_setting& oe = settings_.find_origin_entry_setting( origin );
-    // const size_t cntUnloaded = to.unload_old_data_by_count( oe.max_calls_per_minute( strMethod )
-    // ); if ( cntUnloaded > oe.max_calls_per_minute_ ) {
-    //    to.ban_until_ = ttmNow + oe.ban_lengthy_;
-    //    return e_high_load_detection_result_t::ehldr_peak;  // ban by too high load per minute
-    //}
+    const origin_entry_setting& oe = find_origin_entry_setting_cached( *ps, to, origin );
     size_t cntPast = to.count_to_past( ttmNow, durationToPast );  // 60
     if ( cntPast > oe.max_calls_per_minute( strMethod ) ) {
-        to.ban_until_ = ttmNow + oe.ban_lengthy_;
+        to.set_ban( ttmNow + oe.ban_lengthy_ );
         return e_high_load_detection_result_t::ehldr_lengthy;  // ban by too high load per second
     }
     cntPast = to.count_to_past( ttmNow, 1 );
     if ( cntPast > oe.max_calls_per_second( strMethod ) ) {
-        to.ban_until_ = ttmNow + oe.ban_peak_;
+        to.set_ban( ttmNow + oe.ban_peak_ );
         return e_high_load_detection_result_t::ehldr_lengthy;  // ban by too high load per second
     }
     return e_high_load_detection_result_t::ehldr_no_error;
@@ -730,13 +746,55 @@ bool algorithm::unregister_ws_conn_for_origin( const char* origin ) {
     return true;
 }
 
+size_t algorithm::max_batch_size_for_origin( const char* origin ) const {
+    if ( !settings_.enabled_ )
+        return 0;
+    if ( origin == nullptr || origin[0] == '\0' )
+        return 0;
+    lock_type lock( mtx_ );
+    const origin_entry_setting& oe = settings_.find_origin_entry_setting( origin );
+    return oe.max_batch_size_;
+}
+
+size_t algorithm::acquire_batch_workers_for_origin( const char* origin, size_t cntWanted ) {
+    if ( cntWanted == 0 )
+        return 0;
+    if ( origin == nullptr || origin[0] == '\0' )
+        return 0;
+    lock_type lock( mtx_ );
+    size_t cntMax = cntWanted;
+    if ( settings_.enabled_ ) {
+        const origin_entry_setting& oe = settings_.find_origin_entry_setting( origin );
+        if ( oe.max_batch_parallelism_ > 0 )
+            cntMax = oe.max_batch_parallelism_;
+    }
+    size_t& cntBusy = map_batch_worker_counts_[origin];
+    size_t cntGranted = ( cntBusy < cntMax ) ? std::min( cntWanted, cntMax - cntBusy ) : 0;
+    cntBusy += cntGranted;
+    if ( cntBusy == 0 )
+        map_batch_worker_counts_.erase( origin );
+    return cntGranted;
+}
+
+void algorithm::release_batch_workers_for_origin( const char* origin, size_t cnt ) {
+    if ( cnt == 0 || origin == nullptr || origin[0] == '\0' )
+        return;
+    lock_type lock( mtx_ );
+    map_batch_worker_counts_t::iterator itFind = map_batch_worker_counts_.find( origin );
+    if ( itFind == map_batch_worker_counts_.end() )
+        return;
+    itFind->second = ( itFind->second > cnt ) ? ( itFind->second - cnt ) : 0;
+    if ( itFind->second == 0 )
+        map_batch_worker_counts_.erase( itFind );
+}
+
 bool algorithm::load_settings_from_json( const nlohmann::json& joUnDdosSettings ) {
     lock_type lock( mtx_ );
     try {
         settings new_settings;
         new_settings.fromJSON( joUnDdosSettings );
         settings_ = new_settings;
-        settings_.auto_append_any_origin_rule();
+        publish_settings();
         return true;
     } catch ( ... ) {
         return false;
@@ -753,7 +811,7 @@ settings algorithm::get_settings() const {
 void algorithm::set_settings( const settings& new_settings ) const {
     lock_type lock( mtx_ );
     settings_ = new_settings;
-    settings_.auto_append_any_origin_rule();
+    publish_settings();
 }
 
 nlohmann::json algorithm::get_settings_json() const {
@@ -765,25 +823,31 @@ nlohmann::json algorithm::get_settings_json() const {
 }
 
 nlohmann::json algorithm::stats( time_tick_mark ttmNow, duration durationToPast ) const {
+    adjust_now_tick_mark( ttmNow );
     lock_type lock( mtx_ );
-    ( const_cast< algorithm* >( this ) )
-        ->unload_old_data_by_time_to_past( ttmNow, durationToPast );  // unload first
     nlohmann::json joStats = nlohmann::json::object();
     nlohmann::json joCounts = nlohmann::json::object();
     nlohmann::json joCalls = nlohmann::json::object();
     nlohmann::json joWsConns = nlohmann::json::object();
     size_t cntRpcBan = 0, cntRpcNormal = 0, cntWsBan = 0, cntWsNormal = 0;
-    for ( const tracked_origin& to : tracked_origins_ ) {
-        nlohmann::json joOriginCallInfo = nlohmann::json::object();
-        bool isBan = ( to.ban_until_ != time_tick_mark( 0 ) ) ? true : false;
-        joOriginCallInfo["cps"] = to.count_to_past( ttmNow, 1 );
-        joOriginCallInfo["cpm"] = to.count_to_past( ttmNow, durationToPast );
-        joOriginCallInfo["ban"] = isBan;
-        joCalls[to.origin_] = joOriginCallInfo;
-        if ( isBan )
-            ++cntRpcBan;
-        else
-            ++cntRpcNormal;
+    for ( size_t i = 0; i < c_shard_count; ++i ) {
+        shard& sh = shards_[i];
+        std::shared_lock< std::shared_mutex > lockShard( sh.mtx_ );
+        for ( const auto& pr : sh.map_ ) {
+            const tracked_origin& to = *( pr.second );
+            if ( to.last_call() < ttmNow - durationToPast && !to.is_banned() )
+                continue;  // not yet unloaded by sweeper
+            nlohmann::json joOriginCallInfo = nlohmann::json::object();
+            bool isBan = to.is_banned();
+            joOriginCallInfo["cps"] = to.count_to_past( ttmNow, 1 );
+            joOriginCallInfo["cpm"] = to.count_to_past( ttmNow, durationToPast );
+            joOriginCallInfo["ban"] = isBan;
+            joCalls[pr.first] = joOriginCallInfo;
+            if ( isBan )
+                ++cntRpcBan;
+            else
+                ++cntRpcNormal;
+        }
     }
     for ( const map_ws_conn_counts_t::value_type& pr : map_ws_conn_counts_ ) {
         nlohmann::json joWsConnInfo = nlohmann::json::object();
@@ -800,9 +864,13 @@ nlohmann::json algorithm::stats( time_tick_mark ttmNow, duration durationToPast
     joCounts["rpc_normal"] = cntRpcNormal;
     joCounts["ws_ban"] = cntWsBan;
     joCounts["ws_normal"] = cntWsNormal;
+    nlohmann::json joBatchWorkers = nlohmann::json::object();
+    for ( const map_batch_worker_counts_t::value_type& pr : map_batch_worker_counts_ )
+        joBatchWorkers[pr.first] = pr.second;
     joStats["counts"] = joCounts;
     joStats["calls"] = joCalls;
     joStats["ws_conns"] = joWsConns;
+    joStats["batch_workers"] = joBatchWorkers;
     return joStats;
 }
 
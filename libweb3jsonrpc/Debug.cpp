@@ -45,26 +45,18 @@ h256 Debug::blockHash( string const& _blockNumberOrHash ) const {
     }
 }
 
-State Debug::stateAt( std::string const& /*_blockHashOrNumber*/, int _txIndex ) const {
+State Debug::stateAt( std::string const& _blockHashOrNumber, int _txIndex ) const {
     if ( _txIndex < 0 )
         throw jsonrpc::JsonRpcException( "Negative index" );
 
-    throw logic_error( "State at is not supported in Skale state" );
+    // only the final state of the latest block is kept
+    h256 const hash = _blockHashOrNumber == "latest" ? m_eth.blockChain().currentHash() :
+                                                       blockHash( _blockHashOrNumber );
+    if ( hash != m_eth.blockChain().currentHash() ||
+         static_cast< size_t >( _txIndex ) < m_eth.blockChain().transactionHashes( hash ).size() )
+        throw logic_error( "State at is supported in Skale state only after the latest block" );
 
-    //    Block block = m_eth.block(blockHash(_blockHashOrNumber));
-    //    auto const txCount = block.pending().size();
-
-    //    State state(State::Null);
-    //    if (static_cast<size_t>(_txIndex) < txCount)
-    //        createIntermediateState(state, block, _txIndex, m_eth.blockChain());
-    //    else if (static_cast<size_t>(_txIndex) == txCount)
-    //        // the final state of block (after applying rewards)
-    //        state = block.state();
-    //    else
-    //        throw jsonrpc::JsonRpcException("Transaction index " + toString(_txIndex) +
-    //                                        " out of range for block " + _blockHashOrNumber);
-
-    //    return state;
+    return m_eth.latestBlock().state().startRead();
 }
 
 Json::Value Debug::traceTransaction(
@@ -144,7 +136,7 @@ Json::Value Debug::debug_traceBlockByNumber( int /*_blockNumber*/, Json::Value c
 }
 
 Json::Value Debug::debug_accountRangeAt( string const& _blockHashOrNumber, int _txIndex,
-    string const& /*_addressHash*/, int _maxResults ) {
+    string const& _addressHash, int _maxResults ) {
     Json::Value ret( Json::objectValue );
 
     if ( _maxResults <= 0 )
@@ -153,15 +145,17 @@ Json::Value Debug::debug_accountRangeAt( string const& _blockHashOrNumber, int _
     try {
         State const state = stateAt( _blockHashOrNumber, _txIndex );
 
-        throw std::logic_error( "Addresses list is not suppoted in Skale state" );
-        //        auto const addressMap = state.addresses(h256(_addressHash), _maxResults);
+        // Skale state is not keyed by hashes, so start and nextKey are unhashed addresses
+        auto const balances = state.addresses(
+            jsToAddress( _addressHash ), static_cast< size_t >( _maxResults ) );
 
-        //        Json::Value addressList(Json::objectValue);
-        //        for (auto const& record : addressMap.first)
-        //            addressList[toString(record.first)] = toString(record.second);
+        Json::Value addressList( Json::objectValue );
+        for ( auto const& record : balances.first )
+            addressList[toString( sha3( record.first ) )] = toString( record.first );
 
-        //        ret["addressMap"] = addressList;
-        //        ret["nextKey"] = toString(addressMap.second);
+        ret["addressMap"] = addressList;
+        if ( balances.second )
+            ret["nextKey"] = toString( *balances.second );
     } catch ( Exception const& _e ) {
         cwarn << diagnostic_information( _e );
         throw jsonrpc::JsonRpcException( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS );
@@ -171,7 +165,7 @@ Json::Value Debug::debug_accountRangeAt( string const& _blockHashOrNumber, int _
 }
 
 Json::Value Debug::debug_storageRangeAt( string const& _blockHashOrNumber, int _txIndex,
-    string const& /*_address*/, string const& /*_begin*/, int _maxResults ) {
+    string const& _address, string const& _begin, int _maxResults ) {
     Json::Value ret( Json::objectValue );
     ret["complete"] = true;
     ret["storage"] = Json::Value( Json::objectValue );
@@ -182,26 +176,22 @@ Json::Value Debug::debug_storageRangeAt( string const& _blockHashOrNumber, int _
     try {
         State const state = stateAt( _blockHashOrNumber, _txIndex );
 
-        throw std::logic_error( "Obtaining of full storage is not suppoted in Skale state" );
-        //        map<h256, pair<u256, u256>> const storage(state.storage(Address(_address)));
-
-        //        // begin is inclusive
-        //        auto itBegin = storage.lower_bound(h256fromHex(_begin));
-        //        for (auto it = itBegin; it != storage.end(); ++it)
-        //        {
-        //            if (ret["storage"].size() == static_cast<unsigned>(_maxResults))
-        //            {
-        //                ret["nextKey"] = toCompactHexPrefixed(it->first, 1);
-        //                break;
-        //            }
-
-        //            Json::Value keyValue(Json::objectValue);
-        //            std::string hashedKey = toCompactHexPrefixed(it->first, 1);
-        //            keyValue["key"] = toCompactHexPrefixed(it->second.first, 1);
-        //            keyValue["value"] = toCompactHexPrefixed(it->second.second, 1);
-
-        //            ret["storage"][hashedKey] = keyValue;
-        //        }
+        // Skale state is not keyed by hashes, so begin and nextKey are unhashed storage keys
+        auto const storage = state.storage(
+            jsToAddress( _address ), jsToU256( _begin ), static_cast< size_t >( _maxResults ) );
+
+        for ( auto const& record : storage.first ) {
+            Json::Value keyValue( Json::objectValue );
+            keyValue["key"] = toCompactHexPrefixed( record.first, 1 );
+            keyValue["value"] = toCompactHexPrefixed( record.second, 1 );
+
+            ret["storage"][toJS( sha3( h256( record.first ) ) )] = keyValue;
+        }
+
+        if ( storage.second ) {
+            ret["complete"] = false;
+            ret["nextKey"] = toCompactHexPrefixed( *storage.second, 1 );
+        }
     } catch ( Exception const& _e ) {
         cwarn << diagnostic_information( _e );
         throw jsonrpc::JsonRpcException( jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS );
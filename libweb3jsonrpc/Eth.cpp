@@ -27,6 +27,7 @@
 #include "AccountHolder.h"
 #include <jsonrpccpp/common/exception.h>
 #include <libdevcore/CommonData.h>
+#include <libdevcore/Tracing.h>
 #include <libethashseal/EthashClient.h>
 #include <libethcore/CommonJS.h>
 #include <libethereum/Client.h>
@@ -275,6 +276,7 @@ Json::Value Eth::eth_inspectTransaction( std::string const& _rlp ) {
 
 /// skale
 string Eth::eth_sendRawTransaction( std::string const& _rlp ) {
+    tracing::ScopedSpan span( "rpc_send_raw_transaction" );
     try {
         // Don't need to check the transaction signature (CheckTransaction::None) since it will
         // be checked as a part of transaction import
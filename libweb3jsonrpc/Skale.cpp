@@ -177,15 +177,19 @@ nlohmann::json Skale::impl_skale_getSnapshot( const nlohmann::json& joRequest, C
 }
 
 Json::Value Skale::skale_getSnapshot( const Json::Value& request ) {
+    Json::FastWriter fastWriter;
+    std::string strRequest = fastWriter.write( request );
+    nlohmann::json joRequest = nlohmann::json::parse( strRequest );
+    nlohmann::json joResponse = impl_skale_getSnapshotRpc( joRequest );
+    std::string strResponse = joResponse.dump();
+    Json::Value response;
+    Json::Reader().parse( strResponse, response );
+    return response;
+}
+
+nlohmann::json Skale::impl_skale_getSnapshotRpc( const nlohmann::json& joRequest ) {
     try {
-        Json::FastWriter fastWriter;
-        std::string strRequest = fastWriter.write( request );
-        nlohmann::json joRequest = nlohmann::json::parse( strRequest );
-        nlohmann::json joResponse = impl_skale_getSnapshot( joRequest, m_client );
-        std::string strResponse = joResponse.dump();
-        Json::Value response;
-        Json::Reader().parse( strResponse, response );
-        return response;
+        return impl_skale_getSnapshot( joRequest, m_client );
     } catch ( Exception const& ) {
         throw jsonrpc::JsonRpcException( exceptionToErrorMessage() );
     }
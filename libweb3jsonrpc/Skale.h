@@ -79,6 +79,8 @@ public:
 public:
     nlohmann::json impl_skale_getSnapshot(
         const nlohmann::json& joRequest, dev::eth::Client& client );
+    // same as skale_getSnapshot() but without jsoncpp conversions, for native RPC handler
+    nlohmann::json impl_skale_getSnapshotRpc( const nlohmann::json& joRequest );
     std::vector< uint8_t > ll_impl_skale_downloadSnapshotFragment(
         const fs::path& fp, size_t idxFrom, size_t sizeOfChunk );
     std::vector< uint8_t > impl_skale_downloadSnapshotFragmentBinary(
@@ -30,6 +30,7 @@
 #include <libdevcore/BMPBN.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/Tracing.h>
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
@@ -219,6 +220,48 @@ Json::Value SkaleDebug::skale_performanceTrackingFetch( const Json::Value& reque
     }
 }
 
+Json::Value SkaleDebug::skale_spanTracingStart( const Json::Value& /*request*/ ) {
+    tracing::setEnabled( true );
+    Json::Value ret( Json::objectValue );
+    ret["success"] = true;
+    ret["tracingIsEnabled"] = tracing::enabled();
+    return ret;
+}
+
+Json::Value SkaleDebug::skale_spanTracingStop( const Json::Value& /*request*/ ) {
+    tracing::setEnabled( false );
+    Json::Value ret( Json::objectValue );
+    ret["success"] = true;
+    ret["tracingIsEnabled"] = tracing::enabled();
+    return ret;
+}
+
+// returns Chrome trace event object in "trace", save it to file to open in Perfetto UI
+Json::Value SkaleDebug::skale_spanTracingFetch( const Json::Value& request ) {
+    std::string strLogPrefix = cc::deep_info( "Span tracing fetch" );
+    try {
+        // accepts { "lastMs": N } either as the only positional parameter or as is
+        const Json::Value& joOptions =
+            ( request.isArray() && request.size() > 0 ) ? request[0u] : request;
+        uint64_t sinceNs = 0;
+        if ( joOptions.isObject() && joOptions.isMember( "lastMs" ) ) {
+            uint64_t nowNs = tracing::nowNs();
+            uint64_t lastNs = joOptions["lastMs"].asUInt64() * 1000000;
+            sinceNs = nowNs > lastNs ? nowNs - lastNs : 0;
+        }
+        Json::Value ret( Json::objectValue );
+        ret["success"] = true;
+        ret["tracingIsEnabled"] = tracing::enabled();
+        Json::Reader().parse( tracing::chromeTraceJson( sinceNs ), ret["trace"] );
+        return ret;
+    } catch ( const std::exception& ex ) {
+        clog( VerbosityError, "IMA" )
+            << ( strLogPrefix + " " + cc::fatal( "FATAL:" ) +
+                   cc::error( " Exception while processing request: " ) + cc::warn( ex.what() ) );
+        throw jsonrpc::JsonRpcException( ex.what() );
+    }
+}
+
 
 };  // namespace rpc
 };  // namespace dev
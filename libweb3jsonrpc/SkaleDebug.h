@@ -58,6 +58,9 @@ public:
     virtual Json::Value skale_performanceTrackingStart( const Json::Value& request ) override;
     virtual Json::Value skale_performanceTrackingStop( const Json::Value& request ) override;
     virtual Json::Value skale_performanceTrackingFetch( const Json::Value& request ) override;
+    virtual Json::Value skale_spanTracingStart( const Json::Value& request ) override;
+    virtual Json::Value skale_spanTracingStop( const Json::Value& request ) override;
+    virtual Json::Value skale_spanTracingFetch( const Json::Value& request ) override;
 };
 
 };  // namespace rpc
@@ -45,6 +45,15 @@ public:
         this->bindAndAddMethod( jsonrpc::Procedure( "skale_performanceTrackingFetch",
                                     jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
             &dev::rpc::SkaleDebugFace::skale_performanceTrackingFetchI );
+        this->bindAndAddMethod( jsonrpc::Procedure( "skale_spanTracingStart",
+                                    jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
+            &dev::rpc::SkaleDebugFace::skale_spanTracingStartI );
+        this->bindAndAddMethod( jsonrpc::Procedure( "skale_spanTracingStop",
+                                    jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
+            &dev::rpc::SkaleDebugFace::skale_spanTracingStopI );
+        this->bindAndAddMethod( jsonrpc::Procedure( "skale_spanTracingFetch",
+                                    jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, NULL ),
+            &dev::rpc::SkaleDebugFace::skale_spanTracingFetchI );
     }
 
     inline virtual void skale_performanceTrackingStatusI(
@@ -63,11 +72,26 @@ public:
         const Json::Value& request, Json::Value& response ) {
         response = this->skale_performanceTrackingFetch( request );
     }
+    inline virtual void skale_spanTracingStartI(
+        const Json::Value& request, Json::Value& response ) {
+        response = this->skale_spanTracingStart( request );
+    }
+    inline virtual void skale_spanTracingStopI(
+        const Json::Value& request, Json::Value& response ) {
+        response = this->skale_spanTracingStop( request );
+    }
+    inline virtual void skale_spanTracingFetchI(
+        const Json::Value& request, Json::Value& response ) {
+        response = this->skale_spanTracingFetch( request );
+    }
 
     virtual Json::Value skale_performanceTrackingStatus( const Json::Value& request ) = 0;
     virtual Json::Value skale_performanceTrackingStart( const Json::Value& request ) = 0;
     virtual Json::Value skale_performanceTrackingStop( const Json::Value& request ) = 0;
     virtual Json::Value skale_performanceTrackingFetch( const Json::Value& request ) = 0;
+    virtual Json::Value skale_spanTracingStart( const Json::Value& request ) = 0;
+    virtual Json::Value skale_spanTracingStop( const Json::Value& request ) = 0;
+    virtual Json::Value skale_spanTracingFetch( const Json::Value& request ) = 0;
 
 };  /// class SkaleDebugFace
 
@@ -31,6 +31,7 @@
 #include <libdevcore/BMPBN.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/Log.h>
 
 #include <skutils/console_colors.h>
 #include <skutils/eth_utils.h>
@@ -589,6 +590,10 @@ Json::Value SkaleStats::skale_stats() {
     try {
         nlohmann::json joStats = consumeSkaleStats();
 
+        nlohmann::json joLogging = nlohmann::json::object();
+        joLogging["droppedRecords"] = dev::droppedLogRecords();
+        joStats["logging"] = joLogging;
+
         // HACK Add stats from SkaleDebug
         // TODO Why we need all this absatract infrastructure?
         const dev::eth::Client* c = dynamic_cast< dev::eth::Client* const >( this->client() );
@@ -604,6 +609,7 @@ Json::Value SkaleStats::skale_stats() {
             }  // while
 
             joStats["tracepoints"] = joTrace;
+            joStats["broadcast"] = h->getBroadcastStats();
 
         }  // if client
 
@@ -0,0 +1,191 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file main.cpp
+ * @date 2020
+ * RLP encoding and decoding benchmark.
+ */
+
+#include <libdevcore/Address.h>
+#include <libdevcore/RLP.h>
+
+#include <cmath>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace dev;
+
+double measure_performance( function< void() > code, const double accuracity = 1.0 ) {
+    const double test_duration = 1;
+    double frequency = 1;
+    size_t total_count = 0;
+    double start = clock();
+    while ( true ) {
+        const size_t count =
+            max( static_cast< size_t >( round( frequency * test_duration ) ), size_t( 1 ) );
+        for ( size_t i = 0; i < count; ++i ) {
+            code();
+        }
+        total_count += count;
+        double finish = clock();
+
+        double new_freqency = total_count / ( finish - start ) * CLOCKS_PER_SEC;
+        if ( fabs( new_freqency - frequency ) < accuracity ) {
+            return new_freqency;
+        } else {
+            frequency = new_freqency;
+        }
+    }
+}
+
+void report( string const& _name, double _frequency, size_t _items = 1 ) {
+    cout << _name << ": " << 1e9 / ( _frequency * _items ) << " ns" << endl;
+}
+
+struct TransactionFields {
+    u256 nonce;
+    u256 gasPrice;
+    u256 gas;
+    Address to;
+    u256 value;
+    bytes data;
+    u256 v;
+    u256 r;
+    u256 s;
+};
+
+vector< TransactionFields > randomTransactions( size_t _count ) {
+    mt19937_64 engine( 1 );
+    auto const number = [&]( unsigned _bytes ) {
+        u256 ret;
+        for ( unsigned i = 0; i < _bytes; ++i )
+            ret = ( ret << 8 ) | ( engine() & 0xff );
+        return ret;
+    };
+    vector< TransactionFields > ret( _count );
+    for ( auto& t : ret ) {
+        t.nonce = number( 2 );
+        t.gasPrice = number( 5 );
+        t.gas = number( 3 );
+        t.to = Address( u160( number( 20 ) ) );
+        t.value = number( 9 );
+        t.data.resize( engine() % 200 );
+        for ( auto& b : t.data )
+            b = engine();
+        t.v = 27 + engine() % 2;
+        t.r = number( 32 );
+        t.s = number( 32 );
+    }
+    return ret;
+}
+
+void streamTransaction( RLPStream& _s, TransactionFields const& _t ) {
+    _s.appendList( 9 ) << _t.nonce << _t.gasPrice << _t.gas << _t.to << _t.value << _t.data
+                       << _t.v << _t.r << _t.s;
+}
+
+int main() {
+    size_t const count = 1000;
+    vector< TransactionFields > const transactions = randomTransactions( count );
+
+    vector< u256 > numbers;
+    for ( auto const& t : transactions )
+        numbers.insert( numbers.end(), {t.nonce, t.gasPrice, t.value, t.r} );
+    vector< bytes > encodedNumbers;
+    for ( auto const& n : numbers )
+        encodedNumbers.push_back( rlp( n ) );
+
+    report( "u256 encode", measure_performance( [&]() {
+        RLPStream s;
+        for ( auto const& n : numbers )
+            s << n;
+    } ),
+        numbers.size() );
+
+    report( "u256 decode", measure_performance( [&]() {
+        u256 sum;
+        for ( auto const& e : encodedNumbers )
+            sum += RLP( e ).toInt< u256 >();
+        if ( sum == 1 )
+            cout << sum;
+    } ),
+        encodedNumbers.size() );
+
+    report( "transaction encode", measure_performance( [&]() {
+        for ( auto const& t : transactions ) {
+            RLPStream s;
+            streamTransaction( s, t );
+        }
+    } ),
+        count );
+
+    // same stream and buffer for every transaction, as in block assembly
+    report( "transaction encode, reused stream", measure_performance( [&]() {
+        RLPStream s;
+        for ( auto const& t : transactions ) {
+            s.clear();
+            streamTransaction( s, t );
+        }
+    } ),
+        count );
+
+    vector< bytes > encodedTransactions;
+    size_t payloadSize = 0;
+    for ( auto const& t : transactions ) {
+        RLPStream s;
+        streamTransaction( s, t );
+        encodedTransactions.push_back( s.out() );
+        payloadSize += encodedTransactions.back().size();
+    }
+
+    report( "transaction list encode", measure_performance( [&]() {
+        RLPStream s( count );
+        for ( auto const& e : encodedTransactions )
+            s.appendRaw( e );
+    } ),
+        count );
+
+    report( "transaction list encode, sized", measure_performance( [&]() {
+        RLPStream s;
+        s.appendList( count, payloadSize );
+        for ( auto const& e : encodedTransactions )
+            s.appendRaw( e );
+    } ),
+        count );
+
+    RLPStream list( count );
+    for ( auto const& e : encodedTransactions )
+        list.appendRaw( e );
+    bytes const block = list.out();
+
+    report( "transaction list decode", measure_performance( [&]() {
+        u256 sum;
+        for ( auto const& tx : RLP( block ) ) {
+            sum += tx[0].toInt< u256 >() + tx[4].toInt< u256 >() + tx[8].toInt< u256 >();
+            sum += tx[3].toHash< Address >().data()[0] + tx[5].size();
+        }
+        if ( sum == 1 )
+            cout << sum;
+    } ),
+        count );
+
+    return 0;
+}
@@ -93,6 +93,7 @@
 #include <time.h>
 
 #include <skutils/console_colors.h>
+#include <skutils/open_metrics.h>
 #include <skutils/rest_call.h>
 #include <skutils/task_performance.h>
 #include <skutils/utils.h>
@@ -193,7 +194,8 @@ void removeEmptyOptions( po::parsed_options& parsed ) {
     const set< string > filteredOptions = {"http-port", "https-port", "ws-port", "wss-port",
         "http-port6", "https-port6", "ws-port6", "wss-port6", "info-http-port", "info-https-port",
         "info-ws-port", "info-wss-port", "info-http-port6", "info-https-port6", "info-ws-port6",
-        "info-wss-port6", "ws-log", "ssl-key", "ssl-cert", "acceptors", "info-acceptors"};
+        "info-wss-port6", "metrics-port", "ws-log", "ssl-key", "ssl-cert", "acceptors",
+        "info-acceptors"};
     const set< string > emptyValues = {"NULL", "null", "None"};
 
     parsed.options.erase( remove_if( parsed.options.begin(), parsed.options.end(),
@@ -549,6 +551,8 @@ int main( int argc, char** argv ) try {
     addClientOption( "info-wss-port6", po::value< string >()->value_name( "<port>" ),
         "Run informational web3 WSS(IPv6) server(s) on specified port(and next set of ports if "
         "--info-acceptors > 1)" );
+    addClientOption( "metrics-port", po::value< string >()->value_name( "<port>" ),
+        "Serve node metrics in OpenMetrics text format on /metrics at specified port(IPv4)" );
 
     std::string strPerformanceWarningDurationOptionDescription =
         "Specifies time margin in floating point format, in seconds, for displaying performance "
@@ -599,6 +603,9 @@ int main( int argc, char** argv ) try {
 
     addClientOption( "max-batch", po::value< size_t >()->value_name( "<count>" ),
         "Maximum count of requests in JSON RPC batch request array" );
+    addClientOption( "max-batch-parallelism", po::value< size_t >()->value_name( "<count>" ),
+        "Maximum count of worker queues executing read-only requests of one JSON RPC batch "
+        "request array in parallel, 0 means sequential execution" );
 
     addClientOption( "admin", po::value< string >()->value_name( "<password>" ),
         "Specify admin session key for JSON-RPC (default: auto-generated and printed at "
@@ -2430,7 +2437,8 @@ int main( int argc, char** argv ) try {
             //
             size_t maxConnections = 0,
                    max_http_handler_queues = __SKUTILS_HTTP_DEFAULT_MAX_PARALLEL_QUEUES_COUNT__,
-                   cntServersStd = 1, cntServersNfo = 0, cntInBatch = 128;
+                   cntServersStd = 1, cntServersNfo = 0, cntInBatch = 128,
+                   cntBatchParallelism = 8;
             bool is_async_http_transfer_mode = true;
 
             // First, get "max-connections" true/false from config.json
@@ -2511,6 +2519,17 @@ int main( int argc, char** argv ) try {
                 cntInBatch = vm["max-batch"].as< size_t >();
             if ( cntInBatch < 1 )
                 cntInBatch = 1;
+            if ( chainConfigParsed ) {
+                try {
+                    cntBatchParallelism =
+                        joConfig["skaleConfig"]["nodeInfo"]["max-batch-parallelism"]
+                            .get< size_t >();
+                } catch ( ... ) {
+                    cntBatchParallelism = 8;
+                }
+            }
+            if ( vm.count( "max-batch-parallelism" ) )
+                cntBatchParallelism = vm["max-batch-parallelism"].as< size_t >();
 
             // First, get "ws-mode" true/false from config.json
             // Second, get it from command line parameter (higher priority source)
@@ -2567,6 +2586,9 @@ int main( int argc, char** argv ) try {
             clog( VerbosityDebug, "main" )
                 << cc::debug( "...." ) + cc::info( "Max count in batch JSON RPC request" )
                 << cc::debug( "...... " ) << cc::size10( cntInBatch );
+            clog( VerbosityDebug, "main" )
+                << cc::debug( "...." ) + cc::info( "Max parallelism in batch JSON RPC request" )
+                << cc::debug( " " ) << cc::size10( cntBatchParallelism );
             clog( VerbosityDebug, "main" )
                 << cc::debug( "...." ) + cc::info( "Parallel RPC connection acceptors" )
                 << cc::debug( "........ " ) << cc::size10( cntServersStd );
@@ -2578,8 +2600,14 @@ int main( int argc, char** argv ) try {
                 return skaleFace->impl_skale_downloadSnapshotFragmentBinary( joRequest );
             };
             //
+            SkaleServerOverride::fn_snapshot_info_t fn_snapshot_info =
+                [=]( const nlohmann::json& joParams ) -> nlohmann::json {
+                return skaleFace->impl_skale_getSnapshotRpc( joParams );
+            };
+            //
             SkaleServerOverride::opts_t serverOpts;
             serverOpts.fn_binary_snapshot_download_ = fn_binary_snapshot_download;
+            serverOpts.fn_snapshot_info_ = fn_snapshot_info;
             serverOpts.netOpts_.bindOptsStandard_.cntServers_ = cntServersStd;
             serverOpts.netOpts_.bindOptsStandard_.strAddrHTTP4_ = chainParams.nodeInfo.ip;
             serverOpts.netOpts_.bindOptsStandard_.nBasePortHTTP4_ = nExplicitPortHTTP4std;
@@ -2652,6 +2680,7 @@ int main( int argc, char** argv ) try {
             skale_server_connector->max_http_handler_queues_ = max_http_handler_queues;
             skale_server_connector->is_async_http_transfer_mode_ = is_async_http_transfer_mode;
             skale_server_connector->maxCountInBatchJsonRpcRequest_ = cntInBatch;
+            skale_server_connector->maxParallelismInBatchJsonRpcRequest_ = cntBatchParallelism;
             //
             skaleStatsFace->setProvider( skale_server_connector );
             skale_server_connector->setConsumer( skaleStatsFace );
@@ -3069,6 +3098,22 @@ int main( int argc, char** argv ) try {
             << cc::debug( "Done, programmatic shutdown via Web3 is disabled" );
     }
 
+    skutils::stats::metrics::exporter metricsExporter;
+    if ( vm.count( "metrics-port" ) ) {
+        int nPortMetrics = atoi( vm["metrics-port"].as< string >().c_str() );
+        std::string strAddrMetrics =
+            chainParams.nodeInfo.ip.empty() ? std::string( "127.0.0.1" ) : chainParams.nodeInfo.ip;
+        if ( 0 < nPortMetrics && nPortMetrics <= 65535 &&
+             metricsExporter.start( 4, strAddrMetrics, nPortMetrics ) )
+            clog( VerbosityInfo, "main" )
+                << cc::debug( "Serving " ) << cc::info( "metrics" ) << cc::debug( " on " )
+                << cc::info( strAddrMetrics ) << cc::debug( ":" ) << cc::num10( nPortMetrics );
+        else
+            clog( VerbosityError, "main" )
+                << cc::error( "Failed to serve metrics on port " )
+                << cc::warn( vm["metrics-port"].as< string >() );
+    }
+
     dev::setThreadName( "main" );
 
     if ( g_client ) {
@@ -3080,6 +3125,7 @@ int main( int argc, char** argv ) try {
         while ( !ExitHandler::shouldExit() )
             this_thread::sleep_for( chrono::milliseconds( 1000 ) );
     }
+    metricsExporter.stop();
     if ( g_jsonrpcIpcServer.get() ) {
         g_jsonrpcIpcServer->StopListening();
         g_jsonrpcIpcServer.reset( nullptr );
@@ -10,6 +10,8 @@ using namespace std;
 
 #include <libdevcore/Address.h>
 #include <libdevcore/FileSystem.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/RLP.h>
 
 #include <libskale/State.h>
 
@@ -180,9 +182,79 @@ void testState() {
          << " Mreads per second" << endl;
 }
 
+void testOverlayDBReads( OverlayDB const& db, size_t account_count ) {
+    size_t i = 0;
+    cout << "Account reads:" << endl;
+    cout << measure_performance(
+                [&db, &i, account_count]() {
+                    db.lookupAccount( Address( i + 1 ) );
+                    i = ( i + 1 ) % account_count;
+                },
+                1000 ) /
+                1e6
+         << " Mreads per second" << endl;
+    cout << endl;
+
+    cout << "Storage reads:" << endl;
+    cout << measure_performance(
+                [&db, &i, account_count]() {
+                    db.lookup( Address( 1 ), h256( i ) );
+                    i = ( i + 1 ) % account_count;
+                },
+                1000 ) /
+                1e6
+         << " Mreads per second" << endl;
+    cout << endl;
+}
+
+void testOverlayDB() {
+    fs::path db_path = "/tmp/skaled_overlaydb_benchmark/";
+    fs::remove_all( db_path );
+    const size_t account_count = 10000;
+    {
+        // format version 1 records
+        db::LevelDB db( db_path );
+        for ( size_t i = 0; i < account_count; ++i ) {
+            RLPStream rlpStream( 4 );
+            rlpStream << i << u256( i ) * 1000000000 << EmptySHA3 << 0;
+            db.insert( slicing::toSlice( Address( i + 1 ) ), slicing::toSlice( rlpStream.out() ) );
+            bytes key = Address( 1 ).asBytes() + h256( i ).asBytes();
+            db.insert( slicing::toSlice( key ), slicing::toSlice( h256( i ) ) );
+        }
+    }
+
+    OverlayDB db( std::unique_ptr< db::DatabaseFace >( new db::LevelDB( db_path ) ) );
+    cout << "Format version " << db.formatVersion() << endl << endl;
+    testOverlayDBReads( db, account_count );
+
+    double start = clock();
+    size_t converted = db.migrate();
+    cout << "Migrated " << converted << " records in "
+         << ( clock() - start ) / CLOCKS_PER_SEC << " seconds" << endl;
+    cout << "Format version " << db.formatVersion() << endl << endl;
+    testOverlayDBReads( db, account_count );
+
+    cout << "Writes of 100 accounts and storage slots:" << endl;
+    size_t i = 0;
+    cout << measure_performance(
+                [&db, &i, account_count]() {
+                    for ( size_t j = 0; j < 100; ++j, i = ( i + 1 ) % account_count ) {
+                        db.insertAccount( Address( i + 1 ), {i + 1, i, EmptySHA3, 0} );
+                        db.insert( Address( 1 ), h256( i ), h256( i + 1 ) );
+                    }
+                    db.commit();
+                },
+                10 )
+         << " commits per second" << endl;
+    cout << endl;
+
+    fs::remove_all( db_path );
+}
+
 int main() {
     //    debug();
     testState();
+    testOverlayDB();
     return 0;
 
     //    State state = State(0);
@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file DeltaLogDB.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/DeltaLogDB.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/TransientDirectory.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+
+using namespace std;
+using namespace dev;
+using namespace dev::db;
+namespace fs = boost::filesystem;
+
+namespace dev {
+namespace test {
+
+namespace {
+unique_ptr< DeltaLogDB > openDB( TransientDirectory const& _dir ) {
+    return unique_ptr< DeltaLogDB >( new DeltaLogDB(
+        unique_ptr< DatabaseFace >( new LevelDB( _dir.path() + "/state" ) ),
+        _dir.path() + "/state.log" ) );
+}
+
+map< string, string > contents( DatabaseFace const& _db, string const& _begin = string(),
+    string const& _end = string() ) {
+    map< string, string > ret;
+    _db.forEachInRange( _begin, _end, [&]( Slice _key, Slice _value ) {
+        BOOST_REQUIRE( ret.emplace( _key.toString(), _value.toString() ).second );
+        return true;
+    } );
+    return ret;
+}
+
+void commit( DatabaseFace& _db, string const& _insert, string const& _kill = string() ) {
+    auto batch = _db.createWriteBatch();
+    batch->insert( _insert, _insert + "v" );
+    if ( !_kill.empty() )
+        batch->kill( _kill );
+    _db.commit( move( batch ) );
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( DeltaLogDBTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( readsAndSnapshots ) {
+    TransientDirectory td;
+    auto db = openDB( td );
+    for ( char c = 'a'; c <= 'f'; ++c )
+        commit( *db, string( 1, c ) );
+    commit( *db, "g", "b" );
+    db->insert( string( "a" ), string( "x" ) );
+    db->kill( string( "f" ) );
+
+    auto snapshot = db->snapshot();
+    BOOST_REQUIRE( snapshot );
+    map< string, string > const expected = {
+        {"a", "x"}, {"c", "cv"}, {"d", "dv"}, {"e", "ev"}, {"g", "gv"}};
+    BOOST_CHECK( contents( *db ) == expected );
+    BOOST_CHECK( contents( *db, "b", "e" ) == ( map< string, string >{{"c", "cv"}, {"d", "dv"}} ) );
+    BOOST_CHECK_EQUAL( db->lookup( string( "a" ) ), "x" );
+    BOOST_CHECK( !db->exists( string( "b" ) ) );
+
+    commit( *db, "h", "a" );
+    BOOST_CHECK_EQUAL( snapshot->lookup( string( "a" ) ), "x" );
+    BOOST_CHECK( !snapshot->exists( string( "h" ) ) );
+    BOOST_CHECK( contents( *snapshot ) == expected );
+    BOOST_CHECK( !db->exists( string( "a" ) ) );
+    BOOST_CHECK_EQUAL( db->lookup( string( "h" ) ), "hv" );
+
+    db->flush();
+    BOOST_CHECK_EQUAL( fs::file_size( td.path() + "/state.log" ), 0 );
+    h256 const hash = db->hashBase();
+    db.reset();
+
+    LevelDB leveldb( td.path() + "/state" );
+    BOOST_CHECK_EQUAL( leveldb.hashBase(), hash );
+    BOOST_CHECK_EQUAL( leveldb.lookup( string( "h" ) ), "hv" );
+    BOOST_CHECK( !leveldb.exists( string( "a" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( replay ) {
+    TransientDirectory td;
+    TransientDirectory crashed;
+    {
+        auto db = openDB( td );
+        for ( char c = 'a'; c <= 'j'; ++c )
+            commit( *db, string( 1, c ) );
+        db->kill( string( "a" ) );
+        db->sync();
+        // log as it would be left by a crash before the batches were applied
+        fs::copy_file( td.path() + "/state.log", crashed.path() + "/state.log" );
+    }
+    BOOST_CHECK_EQUAL( fs::file_size( td.path() + "/state.log" ), 0 );
+
+    // torn last record is dropped
+    fs::resize_file( crashed.path() + "/state.log",
+        fs::file_size( crashed.path() + "/state.log" ) - 1 );
+    auto db = openDB( crashed );
+    BOOST_CHECK_EQUAL( db->replayed(), 10 );
+    BOOST_CHECK_EQUAL( fs::file_size( crashed.path() + "/state.log" ), 0 );
+    BOOST_CHECK_EQUAL( contents( *db ).size(), 10 );
+    BOOST_CHECK_EQUAL( db->lookup( string( "a" ) ), "av" );
+
+    // sequence continues after replay, and records are replayed once more on reopening
+    commit( *db, "k" );
+    db->sync();
+    fs::copy_file( crashed.path() + "/state.log", td.path() + "/next.log" );
+    db.reset();
+    fs::copy_file( td.path() + "/next.log", crashed.path() + "/state.log",
+        fs::copy_option::overwrite_if_exists );
+    db = openDB( crashed );
+    BOOST_CHECK_EQUAL( db->replayed(), 1 );
+    BOOST_CHECK_EQUAL( db->lookup( string( "k" ) ), "kv" );
+    BOOST_CHECK_EQUAL( contents( *db ).size(), 11 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
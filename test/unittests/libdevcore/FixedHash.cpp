@@ -23,6 +23,7 @@
 
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/SHA3.h>
+#include <test/tools/libtesteth/Options.h>
 #include <test/tools/libtesteth/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
 
@@ -141,6 +142,87 @@ BOOST_AUTO_TEST_CASE( FixedHashIncrement,
     BOOST_CHECK_EQUAL( ++h, zero );
 }
 
+// checks kernels against byte by byte reference
+template < unsigned N >
+void checkKernels( unsigned _seed ) {
+    std::mt19937 engine( _seed );
+    FixedHash< N > a, b;
+    a.randomize( engine );
+    b.randomize( engine );
+    b[0] = 0;  // sparse, like a bloom of one log
+
+    FixedHash< N > orExpected;
+    unsigned popcountExpected = 0;
+    for ( unsigned i = 0; i < N; ++i ) {
+        orExpected[i] = a[i] | b[i];
+        for ( unsigned bit = 0; bit < 8; ++bit )
+            popcountExpected += ( a[i] >> bit ) & 1;
+    }
+    BOOST_CHECK( ( a | b ) == orExpected );
+    BOOST_CHECK_EQUAL( a.popcount(), popcountExpected );
+    BOOST_CHECK_EQUAL( FixedHash< N >().popcount(), 0 );
+
+    BOOST_CHECK( orExpected.contains( a ) );
+    BOOST_CHECK( orExpected.contains( b ) );
+    BOOST_CHECK( orExpected.contains( FixedHash< N >() ) );
+    // a single missing bit anywhere is noticed
+    for ( unsigned i = 0; i < N; ++i ) {
+        FixedHash< N > c = orExpected;
+        c[i] = ~orExpected[i] & ( orExpected[i] + 1 );
+        if ( c[i] == 0 )
+            continue;
+        BOOST_CHECK( !orExpected.contains( c ) );
+        BOOST_CHECK( c.contains( c ) );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( FixedHashKernels ) {
+    for ( unsigned seed = 0; seed < 10; ++seed ) {
+        checkKernels< 256 >( seed );
+        checkKernels< 32 >( seed );
+        checkKernels< 20 >( seed );
+        checkKernels< 4 >( seed );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( FixedHashBloomPerf,
+    *boost::unit_test::label( "perf" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test FixedHashBloomPerf. Use --all to run it.\n";
+        return;
+    }
+
+    std::mt19937 engine( 1 );
+    std::vector< FixedHash< 256 > > blooms( 1024 );
+    for ( auto& b : blooms )
+        b.randomize( engine );
+    FixedHash< 256 > const needle = FixedHash< 256 >().shiftBloom< 3 >( sha3( "needle" ) );
+    int const n = 1000;
+
+    Timer timer;
+    FixedHash< 256 > all;
+    for ( int i = 0; i < n; ++i )
+        for ( auto const& b : blooms )
+            all |= b;
+    auto orTime = timer.duration() / ( n * blooms.size() );
+
+    timer.restart();
+    size_t found = 0;
+    for ( int i = 0; i < n; ++i )
+        for ( auto const& b : blooms )
+            found += b.contains( needle );
+    auto containsTime = timer.duration() / ( n * blooms.size() );
+
+    std::cout << "2048-bit bloom: or "
+              << std::chrono::duration_cast< std::chrono::nanoseconds >( orTime ).count()
+              << " ns, contains "
+              << std::chrono::duration_cast< std::chrono::nanoseconds >( containsTime ).count()
+              << " ns\n";
+    BOOST_CHECK( all.contains( needle ) );
+    BOOST_CHECK_LE( found, n * blooms.size() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }  // namespace test
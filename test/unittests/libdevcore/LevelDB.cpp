@@ -82,6 +82,39 @@ void test_leveldb( db::DatabaseFace* db ) {
     BOOST_REQUIRE( db->hashBase() != middle_hash );
 }
 
+vector< string > keys_in_range( db::DatabaseFace* db, string const& _begin, string const& _end ) {
+    vector< string > keys;
+    db->forEachInRange( _begin, _end, [&keys]( db::Slice _key, db::Slice ) -> bool {
+        keys.emplace_back( _key.begin(), _key.end() );
+        return true;
+    } );
+    return keys;
+}
+
+void test_range( db::DatabaseFace* db ) {
+    string const ff( 1, char( 0xFF ) );
+    for ( string const& key : vector< string >( {"a", "ab", "ab" + ff, "ac", "b", ff, ff + ff} ) )
+        db->insert( key, "v" + key );
+
+    BOOST_REQUIRE( keys_in_range( db, "", "" ) ==
+                   vector< string >( {"a", "ab", "ab" + ff, "ac", "b", ff, ff + ff} ) );
+    BOOST_REQUIRE( keys_in_range( db, "ab", db::prefixUpperBound( string( "ab" ) ) ) ==
+                   vector< string >( {"ab", "ab" + ff} ) );
+    BOOST_REQUIRE( keys_in_range( db, "aa", "b" ) == vector< string >( {"ab", "ab" + ff, "ac"} ) );
+    BOOST_REQUIRE( keys_in_range( db, ff, db::prefixUpperBound( ff ) ) ==
+                   vector< string >( {ff, ff + ff} ) );
+    BOOST_REQUIRE( keys_in_range( db, "c", "d" ).empty() );
+
+    // resume after early stop
+    string next;
+    db->forEachInRange( string(), string(), [&next]( db::Slice _key, db::Slice _value ) -> bool {
+        BOOST_REQUIRE( _value.contentsEqual( db::Slice( "v" + _key.toString() ).toVector() ) );
+        next = _key.toString() + char( 0 );
+        return false;
+    } );
+    BOOST_REQUIRE_EQUAL( keys_in_range( db, next, "" ).front(), "ab" );
+}
+
 BOOST_AUTO_TEST_CASE( ordinary_test ) {
     TransientDirectory td;
     db::LevelDB leveldb( td.path() );
@@ -109,6 +142,41 @@ BOOST_AUTO_TEST_CASE( split_test ) {
     BOOST_REQUIRE( db2->hashBase() != h2 );
 }
 
+BOOST_AUTO_TEST_CASE( range_test ) {
+    TransientDirectory td;
+    db::LevelDB leveldb( td.path() );
+    test_range( &leveldb );
+
+    TransientDirectory td2;
+    db::SplitDB splitdb( std::make_shared< db::LevelDB >( td2.path() ) );
+    db::DatabaseFace* db1 = splitdb.newInterface();
+    db::DatabaseFace* db2 = splitdb.newInterface();
+    db2->insert( string( "a" ), string( "other" ) );
+    test_range( db1 );
+    BOOST_REQUIRE( keys_in_range( db2, "", "" ) == vector< string >( {"a"} ) );
+}
+
+BOOST_AUTO_TEST_CASE( snapshot_test ) {
+    TransientDirectory td;
+    auto leveldb = std::make_unique< db::LevelDB >( td.path() );
+    leveldb->insert( string( "a" ), string( "va" ) );
+
+    std::unique_ptr< db::DatabaseFace > snapshot = leveldb->snapshot();
+    BOOST_REQUIRE( snapshot );
+    leveldb->insert( string( "b" ), string( "vb" ) );
+    leveldb->kill( string( "a" ) );
+
+    BOOST_REQUIRE_EQUAL( snapshot->lookup( string( "a" ) ), "va" );
+    BOOST_REQUIRE( !snapshot->exists( string( "b" ) ) );
+    BOOST_REQUIRE( keys_in_range( snapshot.get(), "", "" ) == vector< string >( {"a"} ) );
+    BOOST_REQUIRE( keys_in_range( snapshot->snapshot().get(), "", "" ) == vector< string >( {"a"} ) );
+    BOOST_REQUIRE_THROW( snapshot->insert( string( "c" ), string( "vc" ) ), db::DatabaseError );
+
+    // snapshot keeps database open
+    leveldb.reset();
+    BOOST_REQUIRE_EQUAL( snapshot->lookup( string( "a" ) ), "va" );
+}
+
 BOOST_AUTO_TEST_CASE( rotation_test ) {
     TransientDirectory td;
     const int nPieces = 5;
@@ -170,4 +238,28 @@ BOOST_AUTO_TEST_CASE( rotation_rewrite_test ) {
     BOOST_REQUIRE_EQUAL( rdb.lookup( string( "a" ) ), string( "va_new_new" ) );
 }
 
+BOOST_AUTO_TEST_CASE( rotation_range_test ) {
+    TransientDirectory td;
+    db::ManuallyRotatingLevelDB rdb( td.path(), 3 );
+
+    for ( int i = 0; i < 1000; ++i )
+        rdb.insert( to_string( 1000 + i ), string( "old" ) );
+    rdb.rotate();
+    for ( int i = 500; i < 1500; ++i )
+        rdb.insert( to_string( 1000 + i ), string( "new" ) );
+
+    int cnt = 0;
+    string last;
+    auto check = [&]( db::Slice _key, db::Slice _value ) -> bool {
+        string key = _key.toString();
+        BOOST_REQUIRE( key > last );
+        BOOST_REQUIRE_EQUAL( _value.toString(), key < "1500" ? "old" : "new" );
+        last = key;
+        ++cnt;
+        return true;
+    };
+    rdb.forEachInRange( string( "1" ), string( "3" ), check );
+    BOOST_REQUIRE_EQUAL( cnt, 1500 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
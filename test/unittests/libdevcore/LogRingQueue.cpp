@@ -0,0 +1,215 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LogRingQueue.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/LogRingQueue.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+#include <boost/log/sources/severity_channel_logger.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace dev {
+namespace test {
+
+namespace {
+char const c_channel[] = "LogRingQueueTest";
+
+// collects messages of the records fed to it
+class CollectingBackend
+    : public boost::log::sinks::basic_sink_backend< boost::log::sinks::concurrent_feeding > {
+public:
+    void consume( boost::log::record_view const& _rec ) {
+        auto message = boost::log::extract< string >( "Message", _rec );
+        lock_guard< mutex > lock( m_mutex );
+        m_messages.push_back( message ? message.get() : string() );
+    }
+
+    vector< string > messages() const {
+        lock_guard< mutex > lock( m_mutex );
+        return m_messages;
+    }
+
+    size_t size() const {
+        lock_guard< mutex > lock( m_mutex );
+        return m_messages.size();
+    }
+
+private:
+    mutable mutex m_mutex;
+    vector< string > m_messages;
+};
+
+using RingSink = boost::log::sinks::asynchronous_sink< CollectingBackend, LogRingQueue >;
+
+// sink with LogRingQueue that receives only records of this test
+class RingSinkFixture : public TestOutputHelperFixture {
+public:
+    explicit RingSinkFixture( bool _startThread = true )
+        : backend( boost::make_shared< CollectingBackend >() ),
+          sink( boost::make_shared< RingSink >( backend, _startThread ) ),
+          droppedBefore( LogRingQueue::droppedRecords() ) {
+        sink->set_filter(
+            boost::log::expressions::attr< string >( "Channel" ) == string( c_channel ) );
+        boost::log::core::get()->add_sink( sink );
+    }
+
+    ~RingSinkFixture() {
+        boost::log::core::get()->remove_sink( sink );
+        sink->stop();
+        sink->flush();
+    }
+
+    // severity is above any verbosity so that other sinks drop these records
+    static void log( string const& _message ) {
+        thread_local boost::log::sources::severity_channel_logger<> logger(
+            boost::log::keywords::severity = 100, boost::log::keywords::channel = c_channel );
+        BOOST_LOG( logger ) << _message;
+    }
+
+    uint64_t dropped() const { return LogRingQueue::droppedRecords() - droppedBefore; }
+
+    boost::shared_ptr< CollectingBackend > backend;
+    boost::shared_ptr< RingSink > sink;
+    uint64_t droppedBefore;
+};
+
+class StoppedRingSinkFixture : public RingSinkFixture {
+public:
+    StoppedRingSinkFixture() : RingSinkFixture( false ) {}
+};
+
+bool waitForSize( CollectingBackend const& _backend, size_t _size ) {
+    auto deadline = chrono::steady_clock::now() + chrono::seconds( 10 );
+    while ( _backend.size() < _size ) {
+        if ( chrono::steady_clock::now() > deadline )
+            return false;
+        this_thread::yield();
+    }
+    return true;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE( LogRingQueueTests )
+
+BOOST_FIXTURE_TEST_CASE( wrapAround, StoppedRingSinkFixture ) {
+    // three passes over the ring, each ending at a different slot
+    size_t const n = LogRingQueue::c_ringCapacity - 1;
+    for ( size_t pass = 0; pass < 3; ++pass ) {
+        for ( size_t i = 0; i < n; ++i )
+            log( to_string( pass * n + i ) );
+        sink->flush();
+    }
+
+    vector< string > messages = backend->messages();
+    BOOST_REQUIRE_EQUAL( messages.size(), 3 * n );
+    for ( size_t i = 0; i < messages.size(); ++i )
+        BOOST_REQUIRE_EQUAL( messages[i], to_string( i ) );
+    BOOST_CHECK_EQUAL( dropped(), 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( fullRingDrops, StoppedRingSinkFixture ) {
+    size_t const n = LogRingQueue::c_ringCapacity + 10;
+    for ( size_t i = 0; i < n; ++i )
+        log( to_string( i ) );
+    BOOST_CHECK_EQUAL( dropped(), 10 );
+
+    sink->flush();
+    vector< string > messages = backend->messages();
+    BOOST_REQUIRE_EQUAL( messages.size(), LogRingQueue::c_ringCapacity );
+    BOOST_CHECK_EQUAL( messages.front(), "0" );
+    BOOST_CHECK_EQUAL( messages.back(), to_string( LogRingQueue::c_ringCapacity - 1 ) );
+
+    // space freed by the consumer is used again
+    log( "after" );
+    sink->flush();
+    BOOST_CHECK_EQUAL( backend->messages().back(), "after" );
+}
+
+BOOST_FIXTURE_TEST_CASE( multipleProducers, RingSinkFixture ) {
+    size_t const nThreads = 4, nRecords = 20000;
+    vector< thread > producers;
+    for ( size_t t = 0; t < nThreads; ++t )
+        producers.emplace_back( [t]() {
+            for ( size_t i = 0; i < nRecords; ++i )
+                log( to_string( t ) + " " + to_string( i ) );
+        } );
+    for ( auto& producer : producers )
+        producer.join();
+    sink->stop();
+    sink->flush();
+
+    // records of each producer come in order, the ones not received were counted as dropped
+    vector< string > messages = backend->messages();
+    BOOST_CHECK_EQUAL( messages.size() + dropped(), nThreads * nRecords );
+    vector< long > last( nThreads, -1 );
+    for ( string const& message : messages ) {
+        size_t t = stoul( message.substr( 0, message.find( ' ' ) ) );
+        long i = stol( message.substr( message.find( ' ' ) + 1 ) );
+        BOOST_REQUIRE_LT( t, nThreads );
+        BOOST_REQUIRE_GT( i, last[t] );
+        last[t] = i;
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( consumerWakesUp, RingSinkFixture ) {
+    // each record is logged when the consumer has nothing to do and waits without timeout
+    for ( size_t i = 0; i < 1000; ++i ) {
+        log( to_string( i ) );
+        BOOST_REQUIRE( waitForSize( *backend, i + 1 ) );
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE( flushOnShutdown, RingSinkFixture ) {
+    size_t const nThreads = 3, nRecords = 1000;
+    vector< thread > producers;
+    for ( size_t t = 0; t < nThreads; ++t )
+        producers.emplace_back( []() {
+            for ( size_t i = 0; i < nRecords; ++i )
+                log( to_string( i ) );
+        } );
+    for ( auto& producer : producers )
+        producer.join();
+
+    // records left in rings of exited threads are fed by flush after the feeding thread stops
+    sink->stop();
+    sink->flush();
+    BOOST_CHECK_EQUAL( backend->size() + dropped(), nThreads * nRecords );
+    BOOST_CHECK_EQUAL( dropped(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
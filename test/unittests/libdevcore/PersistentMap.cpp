@@ -0,0 +1,139 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PersistentMap.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/PersistentMap.h>
+#include <libdevcore/PersistentStack.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <string>
+
+using namespace std;
+using namespace dev;
+
+namespace dev {
+namespace test {
+
+namespace {
+struct ConstantHash {
+    size_t operator()( unsigned ) const { return 42; }
+};
+
+template < class Map >
+map< unsigned, string > contents( Map const& _map ) {
+    map< unsigned, string > ret;
+    for ( auto const& entry : _map )
+        BOOST_REQUIRE( ret.insert( entry ).second );
+    BOOST_REQUIRE_EQUAL( ret.size(), _map.size() );
+    return ret;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( PersistentMapTest, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( insertFindErase ) {
+    PersistentMap< unsigned, string > m;
+    map< unsigned, string > expected;
+    for ( unsigned i = 0; i < 10000; ++i ) {
+        m[i * 7] = to_string( i );
+        expected[i * 7] = to_string( i );
+    }
+    BOOST_REQUIRE( contents( m ) == expected );
+    BOOST_REQUIRE_EQUAL( *m.find( 700 ), "100" );
+    BOOST_REQUIRE( !m.find( 701 ) );
+    BOOST_REQUIRE( !m.emplace( 700, "x" ).second );
+    BOOST_REQUIRE_EQUAL( *m.find( 700 ), "100" );
+
+    for ( unsigned i = 0; i < 10000; i += 2 ) {
+        BOOST_REQUIRE( m.erase( i * 7 ) );
+        expected.erase( i * 7 );
+    }
+    BOOST_REQUIRE( !m.erase( 0 ) );
+    BOOST_REQUIRE( contents( m ) == expected );
+
+    for ( auto const& entry : expected )
+        m.erase( entry.first );
+    BOOST_REQUIRE( m.empty() );
+    BOOST_REQUIRE( m.begin() == m.end() );
+}
+
+BOOST_AUTO_TEST_CASE( copiesAreIndependent ) {
+    PersistentMap< unsigned, string > m;
+    for ( unsigned i = 0; i < 1000; ++i )
+        m[i] = "a";
+    auto before = contents( m );
+
+    PersistentMap< unsigned, string > copy = m;
+    BOOST_REQUIRE_EQUAL( copy.find( 5 ), m.find( 5 ) );  // shared until modified
+    *copy.findMutable( 5 ) = "b";
+    copy[2000] = "c";
+    copy.erase( 6 );
+    BOOST_REQUIRE_NE( copy.find( 5 ), m.find( 5 ) );
+    BOOST_REQUIRE_EQUAL( copy.find( 7 ), m.find( 7 ) );
+
+    BOOST_REQUIRE( contents( m ) == before );
+    BOOST_REQUIRE_EQUAL( *copy.find( 5 ), "b" );
+    BOOST_REQUIRE_EQUAL( *copy.find( 2000 ), "c" );
+    BOOST_REQUIRE( !copy.find( 6 ) );
+    BOOST_REQUIRE_EQUAL( copy.size(), 1000 );
+
+    m.clear();
+    BOOST_REQUIRE_EQUAL( *copy.find( 7 ), "a" );
+}
+
+BOOST_AUTO_TEST_CASE( hashCollisions ) {
+    PersistentMap< unsigned, string, ConstantHash > m;
+    for ( unsigned i = 0; i < 10; ++i )
+        m[i] = to_string( i );
+    auto copy = m;
+    copy.erase( 3 );
+    copy[4] = "x";
+    BOOST_REQUIRE_EQUAL( contents( m ).size(), 10 );
+    BOOST_REQUIRE_EQUAL( *m.find( 4 ), "4" );
+    BOOST_REQUIRE_EQUAL( contents( copy ).size(), 9 );
+    BOOST_REQUIRE_EQUAL( *copy.find( 4 ), "x" );
+    BOOST_REQUIRE( !copy.find( 3 ) );
+}
+
+BOOST_AUTO_TEST_CASE( stack ) {
+    PersistentStack< unsigned > s;
+    for ( unsigned i = 0; i < 1000000; ++i )
+        s.emplace_back( i );
+    PersistentStack< unsigned > copy = s;
+    copy.pop_back();
+    copy.emplace_back( 0 );
+    BOOST_REQUIRE_EQUAL( s.size(), 1000000 );
+    BOOST_REQUIRE_EQUAL( s.back(), 999999 );
+    BOOST_REQUIRE_EQUAL( copy.back(), 0 );
+    BOOST_REQUIRE_EQUAL( copy.toVector()[999998], 999998 );
+
+    // long stacks are destroyed without recursion
+    s.clear();
+    copy = PersistentStack< unsigned >();
+    BOOST_REQUIRE( s.empty() && copy.empty() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,122 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SHA3.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/SHA3.h>
+#include <test/tools/libtesteth/Options.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+using namespace std;
+using namespace dev;
+
+namespace dev {
+namespace test {
+
+namespace {
+vector< bytes > randomInputs( vector< size_t > const& _sizes ) {
+    mt19937 engine( 1 );
+    vector< bytes > ret;
+    for ( size_t size : _sizes ) {
+        ret.emplace_back( size );
+        for ( auto& b : ret.back() )
+            b = engine();
+    }
+    return ret;
+}
+
+vector< bytesConstRef > refs( vector< bytes > const& _inputs ) {
+    vector< bytesConstRef > ret;
+    for ( auto const& i : _inputs )
+        ret.push_back( &i );
+    return ret;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SHA3Tests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( batchMatchesSingle ) {
+    // around block boundaries of Keccak-256, which absorbs 136 bytes at a time
+    vector< size_t > sizes = {0, 1, 20, 32, 135, 136, 137, 271, 272, 273, 1000};
+    mt19937 engine( 2 );
+    for ( unsigned i = 0; i < 30; ++i )
+        sizes.push_back( engine() % 700 );
+    vector< bytes > const inputs = randomInputs( sizes );
+
+    // every number of inputs, so that each lane count ends with idle lanes
+    for ( size_t count = 0; count <= inputs.size(); ++count ) {
+        vector< bytesConstRef > batch = refs( inputs );
+        batch.resize( count );
+        h256s const hashes = sha3( batch );
+        BOOST_REQUIRE_EQUAL( hashes.size(), count );
+        for ( size_t i = 0; i < count; ++i )
+            BOOST_CHECK_EQUAL( hashes[i], sha3( batch[i] ) );
+    }
+
+    BOOST_CHECK_EQUAL( sha3( vector< bytesConstRef >( 5 ) )[4], EmptySHA3 );
+}
+
+BOOST_AUTO_TEST_CASE( PerfSHA3Batch,
+    *boost::unit_test::label( "perf" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !test::Options::get().all ) {
+        std::cout << "Skipping test PerfSHA3Batch. Use --all to run it.\n";
+        return;
+    }
+
+    // transaction hashes and storage keys are typical inputs
+    for ( size_t size : {32, 120, 400} ) {
+        vector< bytes > const inputs = randomInputs( vector< size_t >( 1024, size ) );
+        vector< bytesConstRef > const batch = refs( inputs );
+        int const n = 99;
+
+        Timer timer;
+        h256 single;
+        for ( int i = 0; i < n; ++i )
+            for ( auto const& input : batch )
+                single ^= sha3( input );
+        auto singleTime = timer.duration() / ( n * batch.size() );
+
+        timer.restart();
+        h256s hashes( batch.size() );
+        h256 batched;
+        for ( int i = 0; i < n; ++i ) {
+            sha3( batch.data(), batch.size(), hashes.data() );
+            for ( auto const& h : hashes )
+                batched ^= h;
+        }
+        auto batchTime = timer.duration() / ( n * batch.size() );
+
+        std::cout << "keccak of " << size << " bytes: one by one "
+                  << std::chrono::duration_cast< std::chrono::nanoseconds >( singleTime ).count()
+                  << " ns, in batch "
+                  << std::chrono::duration_cast< std::chrono::nanoseconds >( batchTime ).count()
+                  << " ns\n";
+        BOOST_CHECK_EQUAL( single, batched );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
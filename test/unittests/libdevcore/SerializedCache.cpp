@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SerializedCache.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/SerializedCache.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+
+namespace dev {
+namespace test {
+
+BOOST_FIXTURE_TEST_SUITE( SerializedCacheTest, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( insertGet ) {
+    SerializedCache cache( 1024 );
+    BOOST_CHECK( !cache.get( "a" ) );
+    auto p = cache.insert( "a", "{\"x\":1}" );
+    BOOST_REQUIRE( p );
+    BOOST_CHECK_EQUAL( *cache.get( "a" ), "{\"x\":1}" );
+    BOOST_CHECK_EQUAL( cache.hits(), 1 );
+    BOOST_CHECK_EQUAL( cache.misses(), 1 );
+
+    // second insertion keeps the first value
+    auto p2 = cache.insert( "a", "{\"x\":2}" );
+    BOOST_CHECK_EQUAL( *p2, "{\"x\":1}" );
+    BOOST_CHECK_EQUAL( cache.size(), 1 );
+
+    cache.clear();
+    BOOST_CHECK( !cache.get( "a" ) );
+    BOOST_CHECK_EQUAL( cache.bytes(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( evictsLeastRecentlyUsed ) {
+    SerializedCache cache( 3 * ( 1 + 100 + 64 ) );
+    cache.insert( "a", string( 100, 'a' ) );
+    cache.insert( "b", string( 100, 'b' ) );
+    cache.insert( "c", string( 100, 'c' ) );
+    BOOST_CHECK( cache.get( "a" ) );
+
+    auto held = cache.get( "b" );
+    cache.get( "a" );
+    cache.get( "c" );
+    cache.insert( "d", string( 100, 'd' ) );
+    BOOST_CHECK( !cache.get( "b" ) );
+    BOOST_CHECK( cache.get( "a" ) );
+    BOOST_CHECK( cache.get( "d" ) );
+    BOOST_CHECK_LE( cache.bytes(), cache.maxBytes() );
+    // evicted value stays valid for its holder
+    BOOST_CHECK_EQUAL( *held, string( 100, 'b' ) );
+
+    // too large to be cached at all
+    auto big = cache.insert( "e", string( 1000, 'e' ) );
+    BOOST_CHECK_EQUAL( big->size(), 1000 );
+    BOOST_CHECK( !cache.get( "e" ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
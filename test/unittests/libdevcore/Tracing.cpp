@@ -0,0 +1,143 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Tracing.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/Log.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/Tracing.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <json.hpp>
+
+#include <thread>
+
+using namespace std;
+using namespace dev;
+
+namespace dev {
+namespace test {
+
+namespace {
+size_t countEvents( nlohmann::json const& _trace, string const& _name ) {
+    size_t ret = 0;
+    for ( auto const& event : _trace["traceEvents"] )
+        if ( event["name"] == _name )
+            ++ret;
+    return ret;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( TracingTest, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( spansAndMarks ) {
+    uint64_t since = tracing::nowNs();
+    {
+        tracing::ScopedSpan span( "test_span", 42 );
+        tracing::mark( "test_mark", tracing::hashArg( sha3( "x" ) ) );
+    }
+    nlohmann::json trace = nlohmann::json::parse( tracing::chromeTraceJson( since ) );
+
+    bool foundSpan = false, foundMark = false;
+    for ( auto const& event : trace["traceEvents"] ) {
+        if ( event["name"] == "test_span" ) {
+            foundSpan = true;
+            BOOST_CHECK_EQUAL( event["ph"], "X" );
+            BOOST_CHECK_EQUAL( event["args"]["arg"], 42 );
+            BOOST_CHECK( event["dur"].get< double >() >= 0 );
+        } else if ( event["name"] == "test_mark" ) {
+            foundMark = true;
+            BOOST_CHECK_EQUAL( event["ph"], "i" );
+            BOOST_CHECK_EQUAL(
+                event["args"]["arg"].get< uint64_t >(), tracing::hashArg( sha3( "x" ) ) );
+        }
+    }
+    BOOST_CHECK( foundSpan );
+    BOOST_CHECK( foundMark );
+
+    // spans ended earlier are skipped
+    BOOST_CHECK_EQUAL( countEvents( nlohmann::json::parse( tracing::chromeTraceJson(
+                                        tracing::nowNs() + 1000000000 ) ),
+                           "test_span" ),
+        0 );
+}
+
+BOOST_AUTO_TEST_CASE( disabled ) {
+    uint64_t since = tracing::nowNs();
+    tracing::setEnabled( false );
+    {
+        tracing::ScopedSpan span( "test_disabled" );
+        tracing::mark( "test_disabled" );
+    }
+    tracing::setEnabled( true );
+    BOOST_CHECK_EQUAL(
+        countEvents( nlohmann::json::parse( tracing::chromeTraceJson( since ) ), "test_disabled" ),
+        0 );
+}
+
+BOOST_AUTO_TEST_CASE( ringKeepsLatest ) {
+    uint64_t since = tracing::nowNs();
+    thread t( [] {
+        setThreadName( "tracingTest" );
+        for ( size_t i = 0; i < 3 * tracing::c_ringCapacity; ++i )
+            tracing::mark( "test_ring", i );
+    } );
+    t.join();
+
+    nlohmann::json trace = nlohmann::json::parse( tracing::chromeTraceJson( since ) );
+    uint64_t tid = 0;
+    for ( auto const& event : trace["traceEvents"] )
+        if ( event["ph"] == "M" && event["args"]["name"] == "tracingTest" )
+            tid = event["tid"];
+    BOOST_REQUIRE( tid != 0 );
+
+    size_t count = 0;
+    uint64_t minArg = uint64_t( -1 );
+    for ( auto const& event : trace["traceEvents"] )
+        if ( event["name"] == "test_ring" ) {
+            BOOST_CHECK_EQUAL( event["tid"], tid );
+            minArg = std::min( minArg, event["args"]["arg"].get< uint64_t >() );
+            ++count;
+        }
+    // slot next to be overwritten is never exported
+    BOOST_CHECK_EQUAL( count, tracing::c_ringCapacity - 1 );
+    BOOST_CHECK_EQUAL( minArg, 2 * tracing::c_ringCapacity + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrentFetch ) {
+    std::atomic_bool stop{false};
+    thread writer( [&stop] {
+        uint64_t i = 0;
+        while ( !stop )
+            tracing::mark( "test_concurrent", i++ );
+    } );
+    for ( size_t i = 0; i < 5; ++i ) {
+        nlohmann::json trace = nlohmann::json::parse( tracing::chromeTraceJson() );
+        BOOST_CHECK( countEvents( trace, "test_concurrent" ) <= tracing::c_ringCapacity );
+    }
+    stop = true;
+    writer.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -258,4 +258,72 @@ BOOST_AUTO_TEST_CASE( rlpRandom ) {
     }
 }
 
+BOOST_AUTO_TEST_CASE( fixedWidthNumbers ) {
+    vector< u256 > values = {0, 1, 0x7f, 0x80, 0xff, 0x100, u256( 1 ) << 64,
+        ( u256( 1 ) << 64 ) - 1, u256( 1 ) << 255, ~u256( 0 ), u256( "0x1234567890abcdef1" )};
+    for ( u256 const& v : values ) {
+        // same encoding as through bigint
+        bytes const encoded = rlp( v );
+        BOOST_CHECK( encoded == rlp( bigint( v ) ) );
+        BOOST_CHECK_EQUAL( RLP( encoded ).toInt< u256 >(), v );
+        BOOST_CHECK_EQUAL( RLP( encoded ).toInt< bigint >(), bigint( v ) );
+
+        u160 const v160( v & u256( ~u160( 0 ) ) );
+        bytes const encoded160 = rlp( v160 );
+        BOOST_CHECK( encoded160 == rlp( bigint( v160 ) ) );
+        BOOST_CHECK_EQUAL( RLP( encoded160 ).toInt< u160 >(), v160 );
+
+        uint64_t const v64 = uint64_t( v & u256( ~uint64_t( 0 ) ) );
+        BOOST_CHECK( rlp( v64 ) == rlp( bigint( v64 ) ) );
+    }
+    // leading zeroes are accepted on request
+    bytes const nonCanon = fromHex( "83000102" );
+    BOOST_CHECK_EQUAL( RLP( nonCanon ).toInt< u256 >( RLP::AllowNonCanon ), 0x102 );
+    BOOST_CHECK_EQUAL( RLP( RLPNull ).toInt< u160 >(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( listHeaders ) {
+    auto const headerSize = []( size_t _payloadSize ) {
+        return _payloadSize < 56 ? 1 : 1 + bytesRequired( _payloadSize );
+    };
+    // short and long lists, nested
+    for ( size_t n : {1, 3, 55, 56, 300, 70000} ) {
+        bytes item( n, 'x' );
+        RLPStream unsized( 2 );
+        unsized.appendList( 1 ) << item;
+        unsized << n;
+
+        size_t const itemSize = rlp( item ).size();
+        size_t const innerSize = headerSize( itemSize ) + itemSize;
+        RLPStream sized;
+        sized.appendList( 2, innerSize + rlp( n ).size() );
+        sized.appendList( 1, itemSize ) << item;
+        sized << n;
+        BOOST_CHECK( sized.out() == unsized.out() );
+
+        RLP decoded( unsized.out() );
+        BOOST_REQUIRE_EQUAL( decoded.itemCount(), 2 );
+        BOOST_CHECK( decoded[0][0].toBytes() == item );
+        BOOST_CHECK_EQUAL( decoded[1].toInt< size_t >(), n );
+        BOOST_CHECK_EQUAL( decoded.actualSize(), unsized.out().size() );
+    }
+
+    RLPStream wrongSize;
+    wrongSize.appendList( 2, 3 );
+    wrongSize << 1;
+    BOOST_CHECK_THROW( wrongSize << 1000, RLPException );
+}
+
+BOOST_AUTO_TEST_CASE( bufferReuse ) {
+    bytes buffer( 1000, 1 );
+    _byte_ const* data = buffer.data();
+    RLPStream s( move( buffer ) );
+    s.appendList( 2 ) << "cat"
+                      << "dog";
+    bytes out;
+    s.swapOut( out );
+    BOOST_CHECK( out == rlpList( "cat", "dog" ) );
+    BOOST_CHECK_EQUAL( out.data(), data );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
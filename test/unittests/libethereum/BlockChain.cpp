@@ -22,6 +22,7 @@
  * Blockchain test functions.
  */
 
+#include <libdevcore/TrieHash.h>
 #include <libethereum/Block.h>
 #include <libethereum/BlockChain.h>
 #include <libethereum/ChainParams.h>
@@ -35,6 +36,57 @@ using namespace dev::eth;
 using namespace dev::test;
 namespace utf = boost::unit_test;
 
+namespace {
+// seals a block of several transactions, imports it after _partialReceipts and checks that
+// encodings reused by sealing and import match the ones made per receipt
+void checkSealedBlockEncodings( TransactionReceipts _partialReceipts ) {
+    TestBlockChain testBlockchain( TestBlockChain::defaultGenesisBlock() );
+    TestBlock const& genesisBlock = testBlockchain.testGenesis();
+    BlockChain& blockchain = testBlockchain.interfaceUnsafe();
+
+    TestBlock testBlock;
+    for ( unsigned nonce = 1; nonce <= 3; ++nonce )
+        testBlock.addTransaction( TestTransaction::defaultTransaction( nonce ) );
+
+    Block block = blockchain.genesisBlock( genesisBlock.state() );
+    block.setAuthor( genesisBlock.beneficiary() );
+    ZeroGasPricer gp;
+    block.sync( blockchain );
+    block.sync( blockchain, testBlock.transactionQueue(), gp );
+    dev::eth::mine( block, blockchain, blockchain.sealEngine() );
+    BOOST_REQUIRE_EQUAL( block.pending().size(), 3 );
+
+    BytesMap transactionsMap;
+    BytesMap receiptsMap;
+    TransactionReceipts receipts = _partialReceipts;
+    for ( unsigned i = 0; i < block.pending().size(); ++i ) {
+        RLPStream k;
+        k << i;
+        RLPStream transactionRLP;
+        block.pending()[i].streamRLP( transactionRLP );
+        transactionsMap.insert( std::make_pair( k.out(), transactionRLP.out() ) );
+        bytes const receiptRLP = block.receipt( i ).rlp();
+        receiptsMap.insert( std::make_pair( k.out(), receiptRLP ) );
+        BOOST_CHECK( block.receiptRLP( i ) == receiptRLP );
+        receipts.push_back( block.receipt( i ) );
+    }
+    BOOST_CHECK_EQUAL( block.info().transactionsRoot(), hash256( transactionsMap ) );
+    BOOST_CHECK_EQUAL( block.info().receiptsRoot(), hash256( receiptsMap ) );
+
+    blockchain.import( block, &_partialReceipts );
+    h256 const hash = block.info().hash();
+    BOOST_REQUIRE( blockchain.isKnown( hash ) );
+    BlockReceipts const storedReceipts = blockchain.receipts( hash );
+    BlockLogBlooms const storedBlooms = blockchain.logBlooms( hash );
+    BOOST_REQUIRE_EQUAL( storedReceipts.receipts.size(), receipts.size() );
+    BOOST_REQUIRE_EQUAL( storedBlooms.blooms.size(), receipts.size() );
+    for ( size_t i = 0; i < receipts.size(); ++i ) {
+        BOOST_CHECK( storedReceipts.receipts[i].rlp() == receipts[i].rlp() );
+        BOOST_CHECK_EQUAL( storedBlooms.blooms[i], receipts[i].bloom() );
+    }
+}
+}  // namespace
+
 BOOST_FIXTURE_TEST_SUITE( BlockChainFrontierSuite, FrontierNoProofTestFixture )
 
 BOOST_AUTO_TEST_CASE( output ) {
@@ -204,6 +256,16 @@ BOOST_AUTO_TEST_CASE( insertWithoutParent ) {
     BOOST_REQUIRE_EQUAL( bcRef.chainStartBlockNumber(), 10 );
 }
 
+BOOST_AUTO_TEST_CASE( sealedBlockEncodings ) {
+    checkSealedBlockEncodings( TransactionReceipts() );
+}
+
+BOOST_AUTO_TEST_CASE( sealedBlockEncodingsWithPartialReceipts ) {
+    LogEntries const logs{LogEntry( Address( 1 ), h256s{h256( 2 ), h256( 3 )}, bytes{4, 5} )};
+    checkSealedBlockEncodings( TransactionReceipts{
+        TransactionReceipt( 1, 21000, logs ), TransactionReceipt( 0, 42000, LogEntries() )} );
+}
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
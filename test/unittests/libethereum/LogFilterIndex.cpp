@@ -0,0 +1,152 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file LogFilterIndex.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/SHA3.h>
+#include <libethereum/LogFilterIndex.h>
+#include <test/tools/libtesteth/Options.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace {
+h256Hash candidates( LogFilterIndex const& _index, LogEntry const& _e ) {
+    h256Hash ret;
+    _index.forEachCandidate( _e, [&]( h256 const& _id ) {
+        BOOST_CHECK( ret.insert( _id ).second );  // each candidate is reported once
+    } );
+    return ret;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( LogFilterIndexSuite, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( candidatesCoverMatches ) {
+    Address a1( 1 ), a2( 2 );
+    h256 t1( 11 ), t2( 12 ), t3( 13 );
+
+    vector< LogFilter > filters = {
+        LogFilter(),                               // everything
+        LogFilter().address( a1 ),                 // by address
+        LogFilter().address( a1 ).topic( 0, t1 ),  // by address and topic
+        LogFilter().topic( 0, t1 ),                // by first topic
+        LogFilter().topic( 1, t2 ),                // by second topic only
+        LogFilter().topic( 0, t3 ).topic( 2, t2 ),
+    };
+    LogFilterIndex index;
+    for ( auto const& f : filters )
+        index.insert( f.sha3(), f );
+    BOOST_CHECK_EQUAL( index.size(), filters.size() );
+
+    vector< LogEntry > entries = {
+        LogEntry( a1, {}, {} ),
+        LogEntry( a2, {t1}, {} ),
+        LogEntry( a1, {t1, t2}, {} ),
+        LogEntry( a2, {t3, t1, t2}, {} ),
+        LogEntry( a2, {t2}, {} ),
+    };
+    for ( auto const& e : entries ) {
+        h256Hash c = candidates( index, e );
+        for ( auto const& f : filters )
+            if ( f.matches( e ) )
+                BOOST_CHECK( c.count( f.sha3() ) );
+    }
+
+    // unrelated log reaches only filter without criteria
+    h256Hash c = candidates( index, LogEntry( Address( 3 ), {h256( 99 )}, {} ) );
+    BOOST_CHECK_EQUAL( c.size(), 1 );
+    BOOST_CHECK( c.count( filters[0].sha3() ) );
+
+    for ( auto const& f : filters )
+        index.erase( f.sha3(), f );
+    BOOST_CHECK_EQUAL( index.size(), 0 );
+    BOOST_CHECK( candidates( index, entries[2] ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( shortTopicListDoesNotMatch ) {
+    LogFilter f = LogFilter().topic( 1, h256( 5 ) );
+    BOOST_CHECK( !f.matches( LogEntry( Address( 1 ), {h256( 4 )}, {} ) ) );
+    BOOST_CHECK( f.matches( LogEntry( Address( 1 ), {h256( 4 ), h256( 5 )}, {} ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( bloomMatches ) {
+    Address a1( 1 ), a2( 2 );
+    h256 t1( 11 ), t2( 12 ), t3( 13 );
+    LogBloom const b1 = LogEntry( a1, {t1, t2}, {} ).bloom();
+    LogBloom const b2 = LogEntry( a2, {t3}, {} ).bloom();
+
+    BOOST_CHECK( LogFilter().matches( b1 ) );
+    BOOST_CHECK( LogFilter().address( a1 ).matches( b1 ) );
+    BOOST_CHECK( !LogFilter().address( a1 ).matches( b2 ) );
+    BOOST_CHECK( LogFilter().address( a2 ).address( a1 ).matches( b1 ) );
+    BOOST_CHECK( LogFilter().address( a1 ).topic( 1, t2 ).topic( 1, t3 ).matches( b1 ) );
+    BOOST_CHECK( !LogFilter().address( a1 ).topic( 0, t3 ).matches( b1 ) );
+    BOOST_CHECK( LogFilter().topic( 0, t3 ).matches( b1 | b2 ) );
+
+    // each possibility covers one address and all topics at a position
+    LogFilter f = LogFilter().address( a1 ).address( a2 ).topic( 0, t1 ).topic( 1, t2 );
+    f = f.topic( 1, t3 ).topic( 1, t3 );
+    vector< LogBloom > possibilities = f.bloomPossibilities();
+    BOOST_REQUIRE_EQUAL( possibilities.size(), 4 );
+    LogBloom const t23 = LogEntry( a1, {t2, t3}, {} ).bloom();
+    BOOST_CHECK( find( possibilities.begin(), possibilities.end(), t23 ) != possibilities.end() );
+    LogBloom const matching = LogEntry( a2, {t1, t3}, {} ).bloom();
+    BOOST_CHECK( f.matches( matching ) );
+    BOOST_CHECK( any_of( possibilities.begin(), possibilities.end(),
+        [&]( LogBloom const& _p ) { return matching.contains( _p ); } ) );
+    BOOST_CHECK_EQUAL( LogFilter().topic( 0, t1 ).topic( 2, t2 ).bloomPossibilities().size(), 2 );
+    BOOST_CHECK_EQUAL( LogFilter().address( a1 ).bloomPossibilities().size(), 1 );
+    BOOST_CHECK( LogFilter().bloomPossibilities().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( bloomMatchPerf,
+    *boost::unit_test::label( "perf" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !Options::get().all ) {
+        std::cout << "Skipping test bloomMatchPerf. Use --all to run it.\n";
+        return;
+    }
+
+    LogFilter f = LogFilter().address( Address( 1 ) ).address( Address( 2 ) );
+    for ( unsigned i = 0; i < 4; ++i )
+        f = f.topic( 0, h256( i ) );
+    vector< LogBloom > blooms;
+    for ( unsigned i = 0; i < 1024; ++i )
+        blooms.push_back( LogEntry( Address( i ), {h256( i % 7 )}, {} ).bloom() );
+    int const n = 100;
+
+    Timer timer;
+    size_t found = 0;
+    for ( int i = 0; i < n; ++i )
+        for ( auto const& b : blooms )
+            found += f.matches( b );
+    auto matchTime = timer.duration() / ( n * blooms.size() );
+    std::cout << "filter with 2 addresses and 4 topics matched against bloom in "
+              << std::chrono::duration_cast< std::chrono::nanoseconds >( matchTime ).count()
+              << " ns\n";
+    BOOST_CHECK_GE( found, 2 * n );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
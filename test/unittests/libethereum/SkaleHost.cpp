@@ -714,6 +714,48 @@ BOOST_AUTO_TEST_CASE( transactionDropReceive ) {
     BOOST_REQUIRE_EQUAL( txns.size(), 1 );
 }
 
+BOOST_AUTO_TEST_CASE( transactionReceiveBatch ) {
+    auto senderAddress = coinbase.address();
+    auto receiver = KeyPair::create();
+
+    Json::Value json;
+    json["from"] = toJS( senderAddress );
+    json["to"] = toJS( receiver.address() );
+    json["value"] = jsToDecimal( toJS( 10000 * dev::eth::szabo ) );
+
+    json["nonce"] = 0;
+    bytes tx0 = bytes_from_json( json );
+    json["nonce"] = 1;
+    bytes tx1 = bytes_from_json( json );
+    bytes txBad = tx1;
+    txBad.resize( txBad.size() / 2 );
+
+    std::vector< bytes > received;
+    bytes wire = ZmqBroadcaster::encodeBatch( {tx0, tx1, txBad} );
+    BOOST_REQUIRE( ZmqBroadcaster::decodeBatch(
+        reinterpret_cast< const char* >( wire.data() ), wire.size(), received ) );
+    BOOST_REQUIRE_EQUAL( received.size(), 3 );
+    BOOST_REQUIRE( received[1] == tx1 );
+
+    // legacy hex-encoded single transaction is not a batch
+    std::string legacy = toJS( tx0 );
+    std::vector< bytes > none;
+    BOOST_REQUIRE( !ZmqBroadcaster::decodeBatch( legacy.c_str(), legacy.size(), none ) );
+
+    h256s imported;
+    BOOST_REQUIRE_NO_THROW( imported = skaleHost->receiveTransactionsBatch( received ) );
+    BOOST_REQUIRE_EQUAL( imported.size(), 2 );
+    BOOST_REQUIRE_EQUAL( tq->knownTransactions().size(), 2 );
+
+    // transactions that were not imported come with the reason
+    std::vector< std::string > errors;
+    std::vector< ImportResult > results = client->importTransactionsBatch(
+        {Transaction( tx0, CheckTransaction::None )}, &errors );
+    BOOST_REQUIRE_EQUAL( errors.size(), 1 );
+    BOOST_REQUIRE( results[0] != ImportResult::Success );
+    BOOST_REQUIRE( !errors[0].empty() );
+}
+
 BOOST_AUTO_TEST_CASE( transactionDropQueue, 
     *boost::unit_test::precondition( dev::test::run_not_express ) ) {
     auto senderAddress = coinbase.address();
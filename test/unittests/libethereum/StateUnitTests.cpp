@@ -56,6 +56,66 @@ BOOST_AUTO_TEST_CASE( LoadAccountCode ) {
         std::equal( std::begin( codeData ), std::end( codeData ), std::begin( loadedCode ) ) );
 }
 
+BOOST_AUTO_TEST_CASE( copySharesCache ) {
+    Address addr{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"};
+    State state( 0 );
+    State s = state.startWrite();
+    s.addBalance( addr, 100 );
+    size_t savepoint = s.savepoint();
+    State copy = s;
+    copy.addBalance( addr, 1 );
+    s.setNonce( addr, 5 );
+    BOOST_CHECK_EQUAL( s.balance( addr ), 100 );
+    BOOST_CHECK_EQUAL( copy.balance( addr ), 101 );
+    BOOST_CHECK_EQUAL( copy.getNonce( addr ), 0 );
+    BOOST_CHECK_EQUAL( copy.savepoint(), s.savepoint() );
+    copy.rollback( savepoint );
+    BOOST_CHECK_EQUAL( copy.balance( addr ), 100 );
+    BOOST_CHECK_EQUAL( s.getNonce( addr ), 5 );
+}
+
+BOOST_AUTO_TEST_CASE( bench_copy,
+    *boost::unit_test::label( "bench" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !Options::get().all ) {
+        std::cout << "Skipping benchmark test because --all option is not specified.\n";
+        return;
+    }
+
+    unsigned const accountCount = 10000;
+    int const n = 1000;
+    State state( 0 );
+    State s = state.startWrite();
+    std::unordered_map< Address, Account > deepCache;
+    for ( unsigned i = 0; i < accountCount; ++i ) {
+        Address addr{i + 1};
+        s.addBalance( addr, i );
+        deepCache.emplace( addr, Account( 0, i, Account::Changedness::Changed ) );
+    }
+
+    // as it was before caches were shared
+    Timer timer;
+    for ( int i = 0; i < n; ++i ) {
+        std::unordered_map< Address, Account > copy = deepCache;
+        copy[Address{1}].addBalance( 1 );
+    }
+    auto deepCopy = timer.duration() / n;
+
+    timer.restart();
+    for ( int i = 0; i < n; ++i ) {
+        State copy = s;
+        copy.addBalance( Address{1}, 1 );
+    }
+    auto stateCopy = timer.duration() / n;
+
+    std::cout << "copy of " << accountCount << " cached accounts with one write: deep "
+              << std::chrono::duration_cast< std::chrono::nanoseconds >( deepCopy ).count()
+              << " ns, State "
+              << std::chrono::duration_cast< std::chrono::nanoseconds >( stateCopy ).count()
+              << " ns\n";
+    BOOST_CHECK_EQUAL( s.balance( Address{1} ), 0 );
+}
+
 class AddressRangeTestFixture : public TestOutputHelperFixture {
 public:
     AddressRangeTestFixture() {
@@ -155,6 +215,64 @@ BOOST_AUTO_TEST_CASE( addressesReturnsCreatedInCache,
         BOOST_CHECK( addresses.find( hashAndAddr.first ) != addresses.end() );
 }
 
+BOOST_AUTO_TEST_CASE( addressesByAddressArePaged ) {
+    State s = state.startRead();
+    std::map< Address, u256 > balances;
+    boost::optional< Address > next = Address();
+    for ( size_t cntParts = 0; next; ++cntParts ) {
+        BOOST_REQUIRE_LT( cntParts, addressCount );
+        auto part = s.addresses( *next, 3 );
+        BOOST_REQUIRE_LE( part.first.size(), 3 );
+        if ( part.second )
+            BOOST_CHECK( *part.second > part.first.rbegin()->first );
+        balances.insert( part.first.begin(), part.first.end() );
+        next = part.second;
+    }
+    BOOST_CHECK_EQUAL( balances.size(), addressCount );
+    for ( auto const& hashAndAddr : hashToAddress )
+        BOOST_CHECK_EQUAL( balances[hashAndAddr.second], 100 );
+}
+
+BOOST_AUTO_TEST_CASE( addressesByAddressUseCache ) {
+    State s = state.startRead();
+    s.kill( Address{1} );
+    s.addBalance( Address{addressCount + 10}, 5 );
+    // don't commmit
+
+    auto all = s.addresses( Address(), addressCount * 2 );
+    BOOST_CHECK( !all.second );
+    BOOST_CHECK_EQUAL( all.first.size(), addressCount );
+    BOOST_CHECK( all.first.count( Address{1} ) == 0 );
+    BOOST_CHECK_EQUAL( all.first[Address{addressCount + 10}], 5 );
+
+    // cached account after the part is returned with the next part
+    auto part = s.addresses( Address(), 3 );
+    std::map< Address, u256 > const expected = {{Address{0}, 100}, {Address{2}, 100}};
+    BOOST_CHECK( part.first == expected );
+    BOOST_REQUIRE( part.second );
+    BOOST_CHECK_EQUAL( *part.second, Address{3} );
+}
+
+BOOST_AUTO_TEST_CASE( readerDoesNotBlockCommit ) {
+    Address const& addr = hashToAddress.begin()->second;
+    State reader = state.startRead();
+
+    // would wait for the reader if it locked the database
+    State writer = state.startWrite();
+    writer.addBalance( addr, 1 );
+    writer.commit( State::CommitBehaviour::RemoveEmptyAccounts );
+
+    BOOST_CHECK_EQUAL( reader.balance( addr ), 100 );
+    BOOST_CHECK_EQUAL( reader.startRead().balance( addr ), 101 );
+    BOOST_CHECK_EQUAL( state.startRead().balance( addr ), 101 );
+
+    // writing after reading uses database, not the snapshot
+    State writer2 = reader.startWrite();
+    writer2.addBalance( addr, 1 );
+    writer2.commit( State::CommitBehaviour::RemoveEmptyAccounts );
+    BOOST_CHECK_EQUAL( state.startRead().balance( addr ), 102 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -229,6 +229,33 @@ BOOST_AUTO_TEST_CASE( tqImport ) {
     BOOST_REQUIRE( tq.waiting( from ) == 1 );
 }
 
+BOOST_AUTO_TEST_CASE( tqImportBatch ) {
+    dev::eth::TransactionQueue txq;
+
+    const u256 gasCost = 10 * szabo;
+    const u256 gas = 25000;
+    Address dest = Address( "0x095e7baea6a6c7c4c2dfeb977efac326af552d87" );
+    Secret sec = Secret( "0x45a915e4d060149eb4365960e6a7a45f334393093061116b197e3240065ff2d8" );
+    Transaction tx0( 0, gasCost, gas, dest, bytes(), 0, sec );
+    Transaction tx1( 0, gasCost, gas, dest, bytes(), 1, sec );
+    Transaction tx1_1( 1, gasCost, gas, dest, bytes(), 1, sec );
+
+    RLPStream streamRLP;
+    streamRLP.appendList( 9 );
+    streamRLP << 2 << gasCost << gas;
+    streamRLP << dest << 0 << bytes() << 0 << 0 << 0;
+    Transaction txZero( streamRLP.out(), CheckTransaction::None );
+
+    std::vector< ImportResult > res = txq.importBatch( Transactions{tx0, tx1, tx0, tx1_1, txZero} );
+    BOOST_REQUIRE_EQUAL( res.size(), 5 );
+    BOOST_CHECK( res[0] == ImportResult::Success );
+    BOOST_CHECK( res[1] == ImportResult::Success );
+    BOOST_CHECK( res[2] == ImportResult::AlreadyKnown );
+    BOOST_CHECK( res[3] == ImportResult::SameNonceAlreadyInQueue );
+    BOOST_CHECK( res[4] == ImportResult::ZeroSignature );
+    BOOST_CHECK( ( Transactions{tx0, tx1} ) == txq.topTransactions( 256 ) );
+}
+
 BOOST_AUTO_TEST_CASE( tqDrop ) {
     TransactionQueue tq;
     TestTransaction testTransaction = TestTransaction::defaultTransaction();
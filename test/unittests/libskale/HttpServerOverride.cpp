@@ -0,0 +1,314 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file HttpServerOverride.cpp
+ * @date 2020
+ */
+
+#include <libethcore/CommonJS.h>
+#include <libskale/httpserveroverride.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace std;
+using namespace dev;
+
+namespace dev {
+namespace test {
+
+namespace {
+string binaryFrame( vector< bytes > const& _rlps ) {
+    string ret( SkaleWsPeer::g_binaryRawTransactionsMagic,
+        sizeof( SkaleWsPeer::g_binaryRawTransactionsMagic ) );
+    for ( auto const& rlp : _rlps ) {
+        uint32_t len = rlp.size();
+        for ( size_t i = 0; i < 4; ++i )
+            ret.push_back( char( ( len >> ( 8 * i ) ) & 0xff ) );
+        ret.append( rlp.begin(), rlp.end() );
+    }
+    return ret;
+}
+
+bool waitFor( std::function< bool() > fn ) {
+    return skutils::dispatch::sleep_while_true( [&]() -> bool { return !fn(); },
+        skutils::dispatch::duration_from_milliseconds( 30 * 1000 ),
+        skutils::dispatch::duration_from_milliseconds( 1 ) );
+}
+
+// records notifications instead of sending them, can stall like peer which does not read
+class TestSubscriber : public SkaleWsSubscriber {
+public:
+    const std::string strQueueID_;
+    std::atomic_size_t cntRefs_{0};
+    std::atomic_bool isStalled_{false}, isSending_{false}, isFailing_{false};
+    mutable std::mutex mtx_;
+    vector< string > vecNotifications_;
+    vector< unsigned > vecClosed_;
+
+    TestSubscriber() : strQueueID_( skutils::dispatch::generate_id( this, "test_subscriber" ) ) {}
+    ~TestSubscriber() override {
+        waitFor( [&]() -> bool { return cntRefs_ == 0; } );  // queued jobs hold references
+        skutils::dispatch::remove( strQueueID_ );
+    }
+    size_t ref_retain() override { return ++cntRefs_; }
+    size_t ref_release() override { return --cntRefs_; }
+    bool isConnected() const noexcept override { return true; }
+    const string& notificationQueueID() const override { return strQueueID_; }
+    bool sendNotification(
+        const string& /*strSubscriptionType*/, const string& strNotification ) override {
+        isSending_ = true;
+        while ( isStalled_ )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        isSending_ = false;
+        if ( isFailing_ )
+            return false;
+        std::lock_guard< std::mutex > lock( mtx_ );
+        vecNotifications_.push_back( strNotification );
+        return true;
+    }
+    void onSubscriptionClosed( unsigned idSubscription ) override {
+        std::lock_guard< std::mutex > lock( mtx_ );
+        vecClosed_.push_back( idSubscription );
+    }
+    vector< string > notifications() const {
+        std::lock_guard< std::mutex > lock( mtx_ );
+        return vecNotifications_;
+    }
+    vector< unsigned > closed() const {
+        std::lock_guard< std::mutex > lock( mtx_ );
+        return vecClosed_;
+    }
+};
+
+class TestFanOut : public SkaleWsSubscriptionFanOut {
+public:
+    void newPendingTransaction( const string& strResult ) {
+        fanOut( "eth_subscription/newPendingTransactions",
+            subscriptions()->vecNewPendingTransactions_,
+            std::make_shared< const string >( strResult ) );
+    }
+};
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SkaleWsBinaryTransactionsTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( decode ) {
+    vector< bytes > const rlps = {bytes( 300, 1 ), bytes(), bytes{2, 3, 4}};
+    string const frame = binaryFrame( rlps );
+    BOOST_REQUIRE( SkaleWsPeer::isBinaryRawTransactionsFrame( frame ) );
+
+    vector< bytesConstRef > const decoded = SkaleWsPeer::decodeBinaryRawTransactions( frame, 3 );
+    BOOST_REQUIRE_EQUAL( decoded.size(), rlps.size() );
+    for ( size_t i = 0; i < rlps.size(); ++i )
+        BOOST_CHECK( decoded[i].toBytes() == rlps[i] );
+
+    BOOST_CHECK( SkaleWsPeer::decodeBinaryRawTransactions( binaryFrame( {} ), 0 ).empty() );
+}
+
+BOOST_AUTO_TEST_CASE( malformed ) {
+    string const json = "{\"jsonrpc\":\"2.0\",\"method\":\"eth_blockNumber\",\"id\":1}";
+    BOOST_CHECK( !SkaleWsPeer::isBinaryRawTransactionsFrame( json ) );
+    BOOST_CHECK_THROW( SkaleWsPeer::decodeBinaryRawTransactions( json, 10 ), std::runtime_error );
+
+    string const frame = binaryFrame( {bytes( 10, 1 ), bytes( 20, 2 )} );
+    // cut inside the second length and inside the second transaction
+    for ( size_t cut : {frame.size() - 20 - 2, frame.size() - 1} )
+        BOOST_CHECK_THROW( SkaleWsPeer::decodeBinaryRawTransactions( frame.substr( 0, cut ), 10 ),
+            std::runtime_error );
+
+    // length claims more than the frame holds
+    string huge = binaryFrame( {bytes( 10, 1 )} );
+    huge[4] = huge[5] = huge[6] = huge[7] = char( 0xff );
+    BOOST_CHECK_THROW( SkaleWsPeer::decodeBinaryRawTransactions( huge, 10 ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( tooManyTransactions ) {
+    string const frame = binaryFrame( vector< bytes >( 5, bytes( 3, 7 ) ) );
+    BOOST_CHECK_EQUAL( SkaleWsPeer::decodeBinaryRawTransactions( frame, 5 ).size(), 5 );
+    BOOST_CHECK_THROW( SkaleWsPeer::decodeBinaryRawTransactions( frame, 4 ), std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( answer ) {
+    vector< SkaleWsPeer::binary_raw_transaction_result_t > results( 3 );
+    results[0].result_ = eth::ImportResult::Success;
+    results[0].hash_ = h256( 1 );
+    results[1].result_ = eth::ImportResult::AlreadyKnown;
+    results[1].hash_ = h256( 2 );
+    results[2].strError_ = "bad RLP";
+    string const answer = SkaleWsPeer::encodeBinaryRawTransactionsAnswer( results );
+    BOOST_REQUIRE_EQUAL( answer.size(), 4 + 4 + 2 * ( 1 + 32 ) + 1 + 4 + 7 );
+    BOOST_CHECK_EQUAL( answer.substr( 0, 4 ),
+        string( SkaleWsPeer::g_binaryRawTransactionsAnswerMagic,
+            sizeof( SkaleWsPeer::g_binaryRawTransactionsAnswerMagic ) ) );
+    BOOST_CHECK_EQUAL( answer.substr( 4, 4 ), string( "\x03\x00\x00\x00", 4 ) );
+    BOOST_CHECK_EQUAL( answer[8], char( eth::ImportResult::Success ) );
+    BOOST_CHECK( h256( bytes( answer.begin() + 9, answer.begin() + 41 ) ) == h256( 1 ) );
+    BOOST_CHECK_EQUAL( answer[41], char( eth::ImportResult::AlreadyKnown ) );
+    BOOST_CHECK( h256( bytes( answer.begin() + 42, answer.begin() + 74 ) ) == h256( 2 ) );
+
+    // undecodable transaction has error text instead of hash
+    BOOST_CHECK_EQUAL( answer[74], char( SkaleWsPeer::g_binaryRawTransactionUndecodable ) );
+    BOOST_CHECK_EQUAL( answer.substr( 75, 4 ), string( "\x07\x00\x00\x00", 4 ) );
+    BOOST_CHECK_EQUAL( answer.substr( 79 ), "bad RLP" );
+
+    string const error = SkaleWsPeer::encodeBinaryRawTransactionsError( "too much" );
+    BOOST_CHECK_EQUAL( error, string( SkaleWsPeer::g_binaryRawTransactionsErrorMagic,
+                                  sizeof( SkaleWsPeer::g_binaryRawTransactionsErrorMagic ) ) +
+                                  "too much" );
+    BOOST_CHECK( !SkaleWsPeer::isBinaryRawTransactionsFrame( error ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_FIXTURE_TEST_SUITE( SkaleWsSubscriptionFanOutTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( subscribe ) {
+    TestSubscriber a, b;
+    TestFanOut fanOut;
+    eth::LogFilter filterAll, filterAddress;
+    filterAddress.address( Address( 1 ) );
+    set< SkaleWsSubscriptionFanOut::subscription_id_t > ids = {
+        fanOut.subscribeLogs( &a, filterAll, 0 ), fanOut.subscribeLogs( &b, filterAll, 0 ),
+        fanOut.subscribeLogs( &b, filterAddress, 0 ), fanOut.subscribeNewHeads( &a, false, 0 ),
+        fanOut.subscribeNewHeads( &b, true, 0 ), fanOut.subscribeNewPendingTransactions( &a, 0 )};
+    BOOST_CHECK_EQUAL( ids.size(), 6 );
+    BOOST_CHECK( ids.count( 0 ) == 0 );
+
+    nlohmann::json joStats = fanOut.stats();
+    BOOST_CHECK_EQUAL( joStats["logs"].get< size_t >(), 3 );
+    BOOST_CHECK_EQUAL( joStats["logFilters"].get< size_t >(), 2 );  // same filter shared
+    BOOST_CHECK_EQUAL( joStats["newHeads"].get< size_t >(), 2 );
+    BOOST_CHECK_EQUAL( joStats["newPendingTransactions"].get< size_t >(), 1 );
+    BOOST_CHECK_EQUAL( a.cntRefs_, 3 );
+    BOOST_CHECK_EQUAL( b.cntRefs_, 3 );
+}
+
+BOOST_AUTO_TEST_CASE( fanOutToPeers ) {
+    TestSubscriber a, b;
+    TestFanOut fanOut;
+    const SkaleWsSubscriptionFanOut::subscription_id_t idTypeBits = 0x20000000;
+    auto idA = fanOut.subscribeNewPendingTransactions( &a, idTypeBits );
+    auto idB = fanOut.subscribeNewPendingTransactions( &b, idTypeBits );
+    fanOut.newPendingTransaction( "\"0x01\"" );
+    BOOST_REQUIRE( waitFor( [&]() -> bool {
+        return a.notifications().size() == 1 && b.notifications().size() == 1;
+    } ) );
+    for ( auto pr : {make_pair( &a, idA ), make_pair( &b, idB )} ) {
+        nlohmann::json joNotification = nlohmann::json::parse( pr.first->notifications()[0] );
+        BOOST_CHECK_EQUAL( joNotification["method"].get< string >(), "eth_subscription" );
+        BOOST_CHECK_EQUAL( joNotification["params"]["subscription"].get< string >(),
+            toJS( pr.second | idTypeBits ) );
+        BOOST_CHECK_EQUAL( joNotification["params"]["result"].get< string >(), "0x01" );
+    }
+    BOOST_REQUIRE( waitFor(
+        [&]() -> bool { return fanOut.stats()["sent"].get< size_t >() == 2; } ) );
+    BOOST_CHECK_EQUAL( fanOut.stats()["serialized"].get< size_t >(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( unsubscribe ) {
+    TestSubscriber a, b;
+    TestFanOut fanOut;
+    auto idA = fanOut.subscribeNewPendingTransactions( &a, 0 );
+    fanOut.subscribeNewPendingTransactions( &b, 0 );
+    BOOST_CHECK( fanOut.unsubscribe( idA ) );
+    BOOST_CHECK( !fanOut.unsubscribe( idA ) );
+    BOOST_CHECK_EQUAL( fanOut.stats()["newPendingTransactions"].get< size_t >(), 1 );
+    BOOST_CHECK_EQUAL( a.cntRefs_, 0 );
+
+    fanOut.newPendingTransaction( "\"0x01\"" );
+    BOOST_REQUIRE( waitFor( [&]() -> bool { return b.notifications().size() == 1; } ) );
+    BOOST_CHECK( a.notifications().empty() );
+    BOOST_CHECK( a.closed().empty() );  // closed by peer itself
+}
+
+BOOST_AUTO_TEST_CASE( failedSend ) {
+    TestSubscriber a;
+    TestFanOut fanOut;
+    auto idA = fanOut.subscribeNewPendingTransactions( &a, 0 );
+    a.isFailing_ = true;
+    fanOut.newPendingTransaction( "\"0x01\"" );
+    BOOST_REQUIRE( waitFor( [&]() -> bool { return a.closed().size() == 1; } ) );
+    BOOST_CHECK_EQUAL( a.closed()[0], idA );
+    BOOST_CHECK_EQUAL( fanOut.stats()["newPendingTransactions"].get< size_t >(), 0 );
+    BOOST_CHECK( !fanOut.unsubscribe( idA ) );
+}
+
+BOOST_AUTO_TEST_CASE( slowPeer ) {
+    TestSubscriber slow, fast;
+    TestFanOut fanOut;
+    auto idSlow = fanOut.subscribeNewPendingTransactions( &slow, 0 );
+    fanOut.subscribeNewPendingTransactions( &fast, 0 );
+    slow.isStalled_ = true;
+    fanOut.newPendingTransaction( "0" );
+    BOOST_REQUIRE( waitFor( [&]() -> bool { return slow.isSending_; } ) );
+    const size_t cntMax = SkaleWsSubscriptionFanOut::g_nMaxPendingNotificationsPerPeer;
+    for ( size_t i = 1; i <= cntMax + 1; ++i )
+        fanOut.newPendingTransaction( to_string( i ) );
+
+    // subscription of slow peer is closed, fast one keeps receiving
+    nlohmann::json joStats = fanOut.stats();
+    BOOST_CHECK_EQUAL( joStats["closed"].get< size_t >(), 1 );
+    BOOST_CHECK_EQUAL( joStats["dropped"].get< size_t >(), 1 );
+    BOOST_CHECK_EQUAL( joStats["newPendingTransactions"].get< size_t >(), 1 );
+    BOOST_CHECK( !fanOut.unsubscribe( idSlow ) );
+    fanOut.newPendingTransaction( to_string( cntMax + 2 ) );
+    BOOST_REQUIRE(
+        waitFor( [&]() -> bool { return fast.notifications().size() == cntMax + 3; } ) );
+
+    // slow peer gets everything accepted before, then error
+    slow.isStalled_ = false;
+    BOOST_REQUIRE(
+        waitFor( [&]() -> bool { return slow.notifications().size() == cntMax + 2; } ) );
+    vector< string > vecNotifications = slow.notifications();
+    for ( size_t i = 0; i <= cntMax; ++i )
+        BOOST_CHECK_EQUAL(
+            nlohmann::json::parse( vecNotifications[i] )["params"]["result"].get< size_t >(), i );
+    nlohmann::json joError = nlohmann::json::parse( vecNotifications.back() );
+    BOOST_CHECK_EQUAL( joError["method"].get< string >(), "eth_subscription" );
+    BOOST_CHECK_EQUAL( joError["params"]["subscription"].get< string >(), toJS( idSlow ) );
+    BOOST_CHECK( joError["params"]["error"]["code"].is_number() );
+    BOOST_CHECK( joError["params"].count( "result" ) == 0 );
+    BOOST_CHECK( slow.closed() == vector< unsigned >{idSlow} );
+    BOOST_CHECK( fast.closed().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( destroyWithQueuedNotifications ) {
+    TestSubscriber slow;
+    std::unique_ptr< TestFanOut > pFanOut( new TestFanOut );
+    pFanOut->subscribeNewPendingTransactions( &slow, 0 );
+    slow.isStalled_ = true;
+    for ( size_t i = 0; i < 10; ++i )
+        pFanOut->newPendingTransaction( to_string( i ) );
+    BOOST_REQUIRE( waitFor( [&]() -> bool { return slow.isSending_; } ) );
+    // destruction waits for job being run, queued ones must not touch destroyed object
+    std::thread destroyer( [&]() { pFanOut.reset(); } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    slow.isStalled_ = false;
+    destroyer.join();
+    size_t cntDelivered = slow.notifications().size();
+    BOOST_CHECK_GE( cntDelivered, 1 );
+    BOOST_REQUIRE( waitFor( [&]() -> bool { return slow.cntRefs_ == 0; } ) );
+    BOOST_CHECK_EQUAL( slow.notifications().size(), cntDelivered );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,201 @@
+/*
+    Copyright (C) 2020-present, SKALE Labs
+
+    This file is part of skaled.
+
+    skaled is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skaled is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with skaled.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file OverlayDB.cpp
+ * @date 2020
+ */
+
+#include <libdevcore/Address.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/RLP.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libskale/OverlayDB.h>
+#include <test/tools/libtesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using skale::AccountRecord;
+using skale::slicing::toSlice;
+
+namespace dev {
+namespace test {
+
+namespace {
+bytes storageKey( Address const& _address, u256 const& _key ) {
+    return _address.asBytes() + h256( _key ).asBytes();
+}
+
+void checkAccount(
+    skale::OverlayDB const& _odb, Address const& _address, s256 const& _storageUsed ) {
+    boost::optional< AccountRecord > account = _odb.lookupAccount( _address );
+    BOOST_REQUIRE( account );
+    BOOST_CHECK_EQUAL( account->nonce, 1 );
+    BOOST_CHECK_EQUAL( account->balance, u256( 1 ) << 200 );
+    BOOST_CHECK_EQUAL( account->codeHash, h256( 3 ) );
+    BOOST_CHECK_EQUAL( account->storageUsed, _storageUsed );
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE( SkaleOverlayDBTests, TestOutputHelperFixture )
+
+BOOST_AUTO_TEST_CASE( defaultFormat ) {
+    TransientDirectory td;
+    Address const address( 42 );
+    {
+        skale::OverlayDB odb(
+            std::unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ) );
+        BOOST_REQUIRE_EQUAL( odb.formatVersion(), 1 );
+        odb.insertAccount( address, {1, u256( 1 ) << 200, h256( 3 ), 4} );
+        odb.insert( address, h256( 7 ), h256( 0 ) );
+        odb.commit();
+
+        auto db = odb.db();
+        BOOST_CHECK( !db->exists( toSlice( "stateFormatVersion" ) ) );
+        BOOST_CHECK_EQUAL( db->lookup( toSlice( storageKey( address, 7 ) ) ).size(), 32 );
+    }
+
+    // format of an existing database does not depend on the one requested for new databases
+    skale::OverlayDB odb(
+        std::unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ), 2 );
+    BOOST_REQUIRE_EQUAL( odb.formatVersion(), 1 );
+    checkAccount( odb, address, 4 );
+}
+
+BOOST_AUTO_TEST_CASE( compactFormat ) {
+    TransientDirectory td;
+    skale::OverlayDB odb(
+        std::unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ), 2 );
+    BOOST_REQUIRE_EQUAL( odb.formatVersion(), 2 );
+
+    Address const address( 42 );
+    odb.insertAccount( address, {1, u256( 1 ) << 200, h256( 3 ), -4} );
+    odb.insert( address, h256( 5 ), h256( 6 ) );
+    odb.insert( address, h256( 7 ), h256( 0 ) );
+    checkAccount( odb, address, -4 );
+    odb.commit();
+
+    checkAccount( odb, address, -4 );
+    BOOST_CHECK( !odb.lookupAccount( Address( 43 ) ) );
+    BOOST_CHECK_EQUAL( odb.lookup( address, h256( 5 ) ), 6 );
+    BOOST_CHECK_EQUAL( odb.lookup( address, h256( 7 ) ), 0 );
+    BOOST_CHECK_EQUAL( odb.storage( address ).size(), 1 );
+
+    auto db = odb.db();
+    BOOST_CHECK_EQUAL( db->lookup( toSlice( address ) ).size(), 128 );
+    BOOST_CHECK_EQUAL( db->lookup( toSlice( storageKey( address, 5 ) ) )[0], '\x06' );
+    BOOST_CHECK( !db->exists( toSlice( storageKey( address, 7 ) ) ) );
+    BOOST_CHECK_EQUAL( db->lookup( toSlice( "stateFormatVersion" ) ), "2" );
+
+    // the version is written only by the first commit
+    db->kill( toSlice( "stateFormatVersion" ) );
+    odb.insert( address, h256( 5 ), h256( 8 ) );
+    odb.commit();
+    BOOST_CHECK( !db->exists( toSlice( "stateFormatVersion" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( migration ) {
+    TransientDirectory td;
+    Address const address( 42 );
+    {
+        // records as they were written by format version 1
+        db::LevelDB db( td.path() );
+        RLPStream rlpStream( 4 );
+        rlpStream << 1 << ( u256( 1 ) << 200 ) << 3 << 4;
+        db.insert( toSlice( address ), toSlice( rlpStream.out() ) );
+        for ( unsigned i = 0; i < 10; ++i )
+            db.insert( toSlice( storageKey( address, i ) ), toSlice( h256( i ) ) );
+        db.insert( toSlice( "storageUsed" ), toSlice( "10" ) );
+    }
+
+    {
+        skale::OverlayDB odb(
+            std::unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ) );
+        BOOST_REQUIRE_EQUAL( odb.formatVersion(), 1 );
+        checkAccount( odb, address, 4 );
+        BOOST_CHECK_EQUAL( odb.lookup( address, h256( 5 ) ), 5 );
+        BOOST_CHECK_EQUAL( odb.storage( address ).size(), 10 );
+
+        BOOST_CHECK_EQUAL( odb.migrate( 3 ), 11 );
+        BOOST_CHECK_EQUAL( odb.formatVersion(), skale::OverlayDB::c_formatVersion );
+        BOOST_CHECK_EQUAL( odb.migrate(), 0 );
+    }
+
+    skale::OverlayDB odb( std::unique_ptr< db::DatabaseFace >( new db::LevelDB( td.path() ) ) );
+    BOOST_REQUIRE_EQUAL( odb.formatVersion(), skale::OverlayDB::c_formatVersion );
+    checkAccount( odb, address, 4 );
+    BOOST_CHECK_EQUAL( odb.lookup( address, h256( 5 ) ), 5 );
+    BOOST_CHECK_EQUAL( odb.lookup( address, h256( 0 ) ), 0 );
+    BOOST_CHECK_EQUAL( odb.storage( address ).size(), 9 );
+    BOOST_CHECK_EQUAL( odb.storageUsed(), 10 );
+    BOOST_CHECK( !odb.db()->exists( toSlice( storageKey( address, 0 ) ) ) );
+    BOOST_CHECK_EQUAL( odb.db()->lookup( toSlice( "stateFormatVersion" ) ), "2" );
+}
+
+BOOST_AUTO_TEST_CASE( partialReceiptJournal ) {
+    TransientDirectory td;
+    db::LevelDB leveldb( td.path() );
+    vector< bytes > const receipts = {
+        rlp( string( "a" ) ), rlp( string( "b" ) ), rlp( string( "c" ) )};
+    auto const receiptList = [&]( size_t _count ) {
+        RLPStream rlpStream( _count );
+        for ( size_t i = 0; i < _count; ++i )
+            rlpStream.appendRaw( receipts[i] );
+        return rlpStream.out();
+    };
+    auto const saved = [&]() {
+        return skale::OverlayDB::stat_safePartialTransactionReceipts( &leveldb );
+    };
+    vector< size_t > written;
+    auto const append = [&]( size_t _count ) {
+        written.clear();
+        auto batch = leveldb.createWriteBatch();
+        skale::OverlayDB::stat_appendPartialTransactionReceipt(
+            leveldb, *batch, _count, [&]( size_t _index ) {
+                written.push_back( _index );
+                return receipts[_index];
+            } );
+        leveldb.commit( move( batch ) );
+    };
+
+    // block recovered from receipts saved as a whole by older versions
+    leveldb.insert( toSlice( "safeLastTransactionReceipts" ), toSlice( receiptList( 2 ) ) );
+    BOOST_CHECK( saved() == receiptList( 2 ) );
+    append( 3 );
+    BOOST_CHECK( written == vector< size_t >( {0, 1, 2} ) );
+    BOOST_CHECK( !leveldb.exists( toSlice( "safeLastTransactionReceipts" ) ) );
+    BOOST_CHECK( saved() == receiptList( 3 ) );
+
+    // next block
+    append( 1 );
+    BOOST_CHECK( written == vector< size_t >( {0} ) );
+    append( 2 );
+    BOOST_CHECK( written == vector< size_t >( {1} ) );
+    BOOST_CHECK( saved() == receiptList( 2 ) );
+    size_t records = 0;
+    leveldb.forEach( [&]( db::Slice, db::Slice ) {
+        ++records;
+        return true;
+    } );
+    BOOST_CHECK_EQUAL( records, 3 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}  // namespace test
+}  // namespace dev
@@ -205,6 +205,7 @@ public:
     virtual ~test_server_http_base();
     void stop() override;
     void run() override;
+    skutils::http::server& http_server() { return *pServer_; }
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
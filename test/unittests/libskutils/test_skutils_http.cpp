@@ -3,6 +3,41 @@
 #include <boost/test/unit_test.hpp>
 #include <test/tools/libtesteth/TestHelper.h>
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int connect_to_test_server() {
+    int fd = -1;
+    for ( size_t i = 0; i < 10 && fd < 0; ++i ) {
+        fd = ::socket( AF_INET, SOCK_STREAM, 0 );
+        struct sockaddr_in sa;
+        memset( &sa, 0, sizeof( sa ) );
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons( skutils::test::g_nDefaultPort );
+        sa.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        if (::connect( fd, ( struct sockaddr* ) &sa, sizeof( sa ) ) != 0 ) {
+            ::close( fd );
+            fd = -1;
+            std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+        }
+    }
+    return fd;
+}
+
+static std::string recv_until_closed( int fd ) {
+    std::string strResponses;
+    char buf[4096];
+    for ( ;; ) {
+        ssize_t n = ::recv( fd, buf, sizeof( buf ), 0 );
+        if ( n <= 0 )
+            break;
+        strResponses.append( buf, size_t( n ) );
+    }
+    return strResponses;
+}
+
 BOOST_AUTO_TEST_SUITE( SkUtils )
 BOOST_AUTO_TEST_SUITE( http, *boost::unit_test::precondition( dev::test::option_all_tests ) )
 
@@ -51,6 +86,113 @@ BOOST_AUTO_TEST_CASE( http_busy_port ) {
     skutils::test::test_protocol_busy_port( "http", skutils::test::g_nDefaultPort );
 }
 
+BOOST_AUTO_TEST_CASE( http_pipelined_calls ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_pipelined_calls" );
+    skutils::test::with_test_server(
+        [&]( skutils::test::test_server& /*refServer*/ ) {
+            int fd = connect_to_test_server();
+            BOOST_REQUIRE( fd >= 0 );
+            // two requests in one packet, second one with chunked body, then split request
+            std::string strRequests =
+                "POST / HTTP/1.1\r\nContent-Type: application/json\r\nContent-Length: "
+                "7\r\n\r\n{\"a\":1}"
+                "POST / HTTP/1.1\r\nContent-Type: application/json\r\nTransfer-Encoding: "
+                "chunked\r\n\r\n3\r\n{\"b\r\n4\r\n\":2}\r\n0\r\n\r\n"
+                "POST / HTTP/1.1\r\nContent-Type: application/json\r\nConnection: "
+                "close\r\nContent-Length: 7\r\n\r\n{\"c\":3}";
+            size_t nSplit = strRequests.size() - 10;
+            BOOST_REQUIRE( ::send( fd, strRequests.data(), nSplit, 0 ) == ssize_t( nSplit ) );
+            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+            BOOST_REQUIRE( ::send( fd, strRequests.data() + nSplit, 10, 0 ) == 10 );
+            std::string strResponses = recv_until_closed( fd );
+            ::close( fd );
+            size_t posA = strResponses.find( "{\"a\":1}" );
+            size_t posB = strResponses.find( "{\"b\":2}" );
+            size_t posC = strResponses.find( "{\"c\":3}" );
+            BOOST_REQUIRE( posA != std::string::npos );
+            BOOST_REQUIRE( posB != std::string::npos );
+            BOOST_REQUIRE( posC != std::string::npos );
+            BOOST_REQUIRE( posA < posB && posB < posC );
+        },
+        "http_async", skutils::test::g_nDefaultPort );
+}
+
+BOOST_AUTO_TEST_CASE( http_pipelined_calls_over_limit ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_pipelined_calls_over_limit" );
+    skutils::test::with_test_server(
+        [&]( skutils::test::test_server& refServer ) {
+            int fd = connect_to_test_server();
+            BOOST_REQUIRE( fd >= 0 );
+            // more requests than server keeps pending, so it stops reading and resumes later
+            const size_t cntRequests = 4 * __SKUTILS_HTTP_EVENT_LOOP_MAX_PENDING_REQUESTS__;
+            dynamic_cast< skutils::test::test_server_http_base& >( refServer )
+                .http_server()
+                .set_keep_alive_max_count( cntRequests );
+            std::string strRequests;
+            for ( size_t i = 0; i < cntRequests; ++i ) {
+                std::string strBody = "{\"n\":" + std::to_string( i ) + "}";
+                strRequests += "POST / HTTP/1.1\r\nContent-Type: application/json\r\n";
+                if ( i + 1 == cntRequests )
+                    strRequests += "Connection: close\r\n";
+                strRequests +=
+                    "Content-Length: " + std::to_string( strBody.size() ) + "\r\n\r\n" + strBody;
+            }
+            BOOST_REQUIRE( ::send( fd, strRequests.data(), strRequests.size(), 0 ) ==
+                           ssize_t( strRequests.size() ) );
+            std::string strResponses = recv_until_closed( fd );
+            ::close( fd );
+            size_t posPrev = 0;
+            for ( size_t i = 0; i < cntRequests; ++i ) {
+                size_t pos = strResponses.find( "{\"n\":" + std::to_string( i ) + "}", posPrev );
+                BOOST_REQUIRE( pos != std::string::npos );
+                posPrev = pos;
+            }
+        },
+        "http_async", skutils::test::g_nDefaultPort );
+}
+
+BOOST_AUTO_TEST_CASE( http_chunked_body_in_pieces ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_chunked_body_in_pieces" );
+    skutils::test::with_test_server(
+        [&]( skutils::test::test_server& /*refServer*/ ) {
+            int fd = connect_to_test_server();
+            BOOST_REQUIRE( fd >= 0 );
+            // pieces end inside chunk size line, inside chunk data and before last CRLF
+            std::vector< std::string > vecPieces = {
+                "POST / HTTP/1.1\r\nContent-Type: application/json\r\nConnection: "
+                "close\r\nTransfer-Encoding: chunked\r\n\r\n3\r\n{\"d\r\n",
+                "4\r", "\n\":", "4}\r\n", "0\r\n", "\r\n"};
+            for ( const std::string& strPiece : vecPieces ) {
+                BOOST_REQUIRE( ::send( fd, strPiece.data(), strPiece.size(), 0 ) ==
+                               ssize_t( strPiece.size() ) );
+                std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            }
+            std::string strResponses = recv_until_closed( fd );
+            ::close( fd );
+            BOOST_REQUIRE( strResponses.find( "{\"d\":4}" ) != std::string::npos );
+        },
+        "http_async", skutils::test::g_nDefaultPort );
+}
+
+BOOST_AUTO_TEST_CASE( http_ambiguous_body_length ) {
+    skutils::test::test_print_header_name( "SkUtils/http/http_ambiguous_body_length" );
+    skutils::test::with_test_server(
+        [&]( skutils::test::test_server& /*refServer*/ ) {
+            int fd = connect_to_test_server();
+            BOOST_REQUIRE( fd >= 0 );
+            // body length given by both headers, connection is closed without answer
+            std::string strRequest =
+                "POST / HTTP/1.1\r\nContent-Type: application/json\r\nContent-Length: "
+                "12\r\nTransfer-Encoding: chunked\r\n\r\n7\r\n{\"e\":5}\r\n0\r\n\r\n";
+            BOOST_REQUIRE( ::send( fd, strRequest.data(), strRequest.size(), 0 ) ==
+                           ssize_t( strRequest.size() ) );
+            std::string strResponses = recv_until_closed( fd );
+            ::close( fd );
+            BOOST_REQUIRE( strResponses.empty() );
+        },
+        "http_async", skutils::test::g_nDefaultPort );
+}
+
 
 BOOST_AUTO_TEST_CASE( https_server_startup ) {
     skutils::test::test_print_header_name( "SkUtils/http/https_server_startup" );
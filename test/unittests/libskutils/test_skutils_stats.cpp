@@ -0,0 +1,138 @@
+#include <skutils/open_metrics.h>
+#include <skutils/stats.h>
+#include <boost/test/unit_test.hpp>
+#include <test/tools/libtesteth/TestHelper.h>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE( stats, *boost::unit_test::precondition( dev::test::option_all_tests ) )
+
+BOOST_AUTO_TEST_CASE( histogram_buckets ) {
+    typedef skutils::stats::metrics::latency_histogram hist_t;
+    for ( uint64_t v = 0; v < 100000; ++v ) {
+        size_t i = hist_t::bucket_index( v );
+        BOOST_REQUIRE( v <= hist_t::bucket_upper_bound( i ) );
+        if ( i > 0 )
+            BOOST_REQUIRE( v > hist_t::bucket_upper_bound( i - 1 ) );
+    }
+    BOOST_REQUIRE( hist_t::bucket_index( uint64_t( -1 ) ) == hist_t::g_nBucketCount - 1 );
+}
+
+BOOST_AUTO_TEST_CASE( histogram_percentiles ) {
+    skutils::stats::metrics::latency_histogram h;
+    BOOST_REQUIRE( h.percentile( 0.5 ) == 0 );
+    for ( uint64_t v = 1; v <= 10000; ++v )
+        h.record( v );
+    BOOST_REQUIRE( h.count() == 10000 );
+    uint64_t p50 = h.percentile( 0.5 ), p99 = h.percentile( 0.99 ),
+             p999 = h.percentile( 0.999 );
+    BOOST_REQUIRE( p50 >= 5000 && p50 <= 5000 + 5000 / 16 );
+    BOOST_REQUIRE( p99 >= 9900 && p99 <= 9900 + 9900 / 16 );
+    BOOST_REQUIRE( p999 >= 9990 && p999 <= 9990 + 9990 / 16 );
+}
+
+BOOST_AUTO_TEST_CASE( concurrent_counting ) {
+    skutils::stats::metrics::method_metrics& mm =
+        skutils::stats::metrics::get( "TEST/concurrent", "method" );
+    BOOST_REQUIRE( &mm == &skutils::stats::metrics::get( "TEST/concurrent", "method" ) );
+    const size_t cntThreads = 8, cntCallsPerThread = 100000;
+    std::vector< std::thread > vecThreads;
+    for ( size_t i = 0; i < cntThreads; ++i )
+        vecThreads.emplace_back( [&]() {
+            for ( size_t j = 0; j < cntCallsPerThread; ++j ) {
+                skutils::stats::metrics::method_metrics& x =
+                    skutils::stats::metrics::get( "TEST/concurrent", "method" );
+                x.calls_.add();
+                x.bytes_recv_.add( 2 );
+                x.latency_.record( j % 1000 );
+            }
+        } );
+    for ( std::thread& t : vecThreads )
+        t.join();
+    nlohmann::json jo = skutils::stats::metrics::subsystem_stats( "TEST/concurrent" );
+    BOOST_REQUIRE( jo["method"]["calls"].get< uint64_t >() == cntThreads * cntCallsPerThread );
+    BOOST_REQUIRE(
+        jo["method"]["bytes_recv"].get< uint64_t >() == 2 * cntThreads * cntCallsPerThread );
+    BOOST_REQUIRE( jo["method"]["answers"].get< uint64_t >() == 0 );
+    BOOST_REQUIRE( mm.latency_.count() == cntThreads * cntCallsPerThread );
+    BOOST_REQUIRE( jo["method"]["latency_p99"].get< double >() > 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( method_count_is_bounded ) {
+    size_t nSaved = skutils::stats::metrics::g_nMaxMethodsPerSubsystem;
+    skutils::stats::metrics::g_nMaxMethodsPerSubsystem = 4;
+    for ( size_t i = 0; i < 100; ++i )
+        skutils::stats::metrics::get( "TEST/bounded", std::to_string( i ).c_str() ).calls_.add();
+    skutils::stats::metrics::g_nMaxMethodsPerSubsystem = nSaved;
+    nlohmann::json jo = skutils::stats::metrics::subsystem_stats( "TEST/bounded" );
+    BOOST_REQUIRE( jo.size() == 5 );
+    const char* strUnknown = skutils::stats::time_tracker::element::g_strMethodNameUnknown;
+    BOOST_REQUIRE( jo[strUnknown]["calls"].get< uint64_t >() == 96 );
+    // known methods keep their entries, new ones share unknown-method entry from other threads
+    std::thread( []() {
+        skutils::stats::metrics::get( "TEST/bounded", "2" ).calls_.add();
+        skutils::stats::metrics::get( "TEST/bounded", "new" ).calls_.add();
+    } ).join();
+    jo = skutils::stats::metrics::subsystem_stats( "TEST/bounded" );
+    BOOST_REQUIRE( jo.size() == 5 );
+    BOOST_REQUIRE( jo["2"]["calls"].get< uint64_t >() == 2 );
+    BOOST_REQUIRE( jo[strUnknown]["calls"].get< uint64_t >() == 97 );
+}
+
+BOOST_AUTO_TEST_CASE( call_timer ) {
+    double lfSeconds = 0.0;
+    {  // block
+        skutils::stats::metrics::call_timer timer( "TEST/calls", "TEST/calls/PROTO", "slow" );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+        lfSeconds = timer.stop();
+        BOOST_REQUIRE( timer.stop() == lfSeconds );
+    }  // block, recorded once
+    { skutils::stats::metrics::call_timer timer( "TEST/calls", "TEST/calls/PROTO", "fast" ); }
+    BOOST_REQUIRE( lfSeconds >= 0.02 );
+    BOOST_REQUIRE( skutils::stats::metrics::get( "TEST/calls", "slow" ).latency_.count() == 1 );
+    BOOST_REQUIRE(
+        skutils::stats::metrics::get( "TEST/calls/PROTO", "slow" ).latency_.count() == 1 );
+    nlohmann::json jo = skutils::stats::metrics::execution_performance( "TEST/calls" );
+    BOOST_REQUIRE( jo["protocols"].size() == 1 );
+    nlohmann::json& joProto = jo["protocols"]["PROTO"];
+    BOOST_REQUIRE( joProto["methodMax"].get< std::string >() == "slow" );
+    BOOST_REQUIRE( joProto["methodMin"].get< std::string >() == "fast" );
+    BOOST_REQUIRE( joProto["callTimeMax"].get< double >() >= 0.02 );
+    BOOST_REQUIRE( joProto["callTimeMin"].get< double >() < 0.02 );
+    BOOST_REQUIRE( jo["summary"]["protocolMax"].get< std::string >() == "PROTO" );
+    BOOST_REQUIRE( jo["summary"]["callTimeAvg"].get< double >() >= 0.01 );
+}
+
+BOOST_AUTO_TEST_CASE( open_metrics_text ) {
+    typedef skutils::stats::metrics::open_metrics_writer writer_t;
+    BOOST_REQUIRE( writer_t::label( "l", "a\"b\\c\nd" ) == "l=\"a\\\"b\\\\c\\nd\"" );
+    skutils::stats::metrics::histogram( "test_om_seconds", writer_t::label( "stage", "s1" ) )
+        .record( 1500 );  // 1.5 ms
+    skutils::stats::metrics::counter( "test_om_events" ).add( 3 );
+    skutils::stats::metrics::collector_id_t id = skutils::stats::metrics::add_collector(
+        []( writer_t& w ) {
+            w.family( "test_om_depth", "gauge" );
+            w.sample( "test_om_depth", "", uint64_t( 7 ) );
+        } );
+    std::string s = skutils::stats::metrics::open_metrics_text();
+    skutils::stats::metrics::remove_collector( id );
+    BOOST_REQUIRE( s.find( "# TYPE test_om_seconds histogram\n" ) != std::string::npos );
+    BOOST_REQUIRE(
+        s.find( "test_om_seconds_bucket{stage=\"s1\",le=\"0.001\"} 0\n" ) != std::string::npos );
+    BOOST_REQUIRE( s.find( "test_om_seconds_bucket{stage=\"s1\",le=\"0.0025\"} 1\n" ) !=
+                   std::string::npos );
+    BOOST_REQUIRE(
+        s.find( "test_om_seconds_bucket{stage=\"s1\",le=\"+Inf\"} 1\n" ) != std::string::npos );
+    BOOST_REQUIRE( s.find( "test_om_seconds_count{stage=\"s1\"} 1\n" ) != std::string::npos );
+    BOOST_REQUIRE( s.find( "test_om_seconds_sum{stage=\"s1\"} 0.0015\n" ) != std::string::npos );
+    BOOST_REQUIRE( s.find( "# TYPE test_om_events counter\ntest_om_events_total 3\n" ) !=
+                   std::string::npos );
+    BOOST_REQUIRE( s.find( "test_om_depth 7\n" ) != std::string::npos );
+    BOOST_REQUIRE( s.size() >= 6 && s.compare( s.size() - 6, 6, "# EOF\n" ) == 0 );
+    BOOST_REQUIRE( skutils::stats::metrics::open_metrics_text().find( "test_om_depth" ) ==
+                   std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+#include <skutils/task_performance.h>
+#include <boost/test/unit_test.hpp>
+#include <test/tools/libtesteth/TestHelper.h>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( SkUtils )
+BOOST_AUTO_TEST_SUITE(
+    task_performance, *boost::unit_test::precondition( dev::test::option_all_tests ) )
+
+BOOST_AUTO_TEST_CASE( skipped_when_not_running ) {
+    skutils::task::performance::tracker_ptr pTracker =
+        skutils::task::performance::tracker_ptr::make();
+    skutils::task::performance::action a( "q", "a", nlohmann::json::object(), pTracker );
+    BOOST_REQUIRE( a.is_skipped() );
+    skutils::task::performance::action b;
+    BOOST_REQUIRE( b.is_skipped() );
+}
+
+BOOST_AUTO_TEST_CASE( records_and_fetches ) {
+    skutils::task::performance::tracker_ptr pTracker =
+        skutils::task::performance::tracker_ptr::make();
+    pTracker->start();
+    {
+        nlohmann::json jsnIn = nlohmann::json::object();
+        jsnIn["x"] = 1;
+        skutils::task::performance::action a( "queue1", "action1", jsnIn, pTracker );
+        BOOST_REQUIRE( !a.is_skipped() );
+        nlohmann::json jsnOut = nlohmann::json::object();
+        jsnOut["y"] = 2;
+        a.set_json_out( jsnOut );
+        skutils::task::performance::action b( "queue2", "action2", jsnIn, pTracker );
+        b.set_json_err(
+            std::string( skutils::task::performance::slot::g_nMaxTextLength, 'e' ) );
+        b.finish();
+    }
+    skutils::task::performance::action running(
+        "queue1", "running", nlohmann::json::object(), pTracker );
+    nlohmann::json jsn = pTracker->compose_json();
+    BOOST_REQUIRE( jsn["nextTimeFetchIndex"].get< size_t >() == 3 );
+    nlohmann::json& jarr1 = jsn["queues"]["queue1"];
+    BOOST_REQUIRE( jarr1.size() == 2 );
+    BOOST_REQUIRE( jarr1[0]["name"] == "action1" );
+    BOOST_REQUIRE( jarr1[0]["it"] == 0 );
+    BOOST_REQUIRE( jarr1[0]["jsnIn"]["x"] == 1 );
+    BOOST_REQUIRE( jarr1[0]["jsnOut"]["y"] == 2 );
+    BOOST_REQUIRE( jarr1[0]["fin"] == true );
+    BOOST_REQUIRE( jarr1[1]["fin"] == false );
+    nlohmann::json& jarr2 = jsn["queues"]["queue2"];
+    BOOST_REQUIRE( jarr2.size() == 1 );
+    BOOST_REQUIRE( jarr2[0]["jsnErr"].is_string() );  // truncated
+    BOOST_REQUIRE( jarr2[0]["jsnOut"].empty() );
+    // fetch continues from returned index
+    BOOST_REQUIRE( pTracker->compose_json( 2 )["queues"]["queue1"].size() == 1 );
+    BOOST_REQUIRE( pTracker->compose_json( 3 )["queues"].empty() );
+    // new session starts from zero index
+    pTracker->cancel();
+    pTracker->start();
+    skutils::task::performance::action c( "queue3", "action3", nlohmann::json::object(), pTracker );
+    jsn = pTracker->compose_json();
+    BOOST_REQUIRE( jsn["queues"].size() == 1 );
+    BOOST_REQUIRE( jsn["queues"]["queue3"][0]["it"] == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( long_names_and_payloads ) {
+    skutils::task::performance::tracker_ptr pTracker =
+        skutils::task::performance::tracker_ptr::make();
+    pTracker->start();
+    // queues differ only after long common prefix, like per-peer queues of one server
+    const std::string strPrefix = "rpc/WS/0/" + std::string( 200, 'p' );
+    nlohmann::json jsnIn = nlohmann::json::object();
+    jsnIn["data"] = std::string( 1000, 'd' );
+    {
+        skutils::task::performance::action a( strPrefix + "/peer1", "a", jsnIn, pTracker );
+        skutils::task::performance::action b( strPrefix + "/peer2", "b", jsnIn, pTracker );
+        b.set_json_out( jsnIn );
+    }
+    nlohmann::json jsn = pTracker->compose_json();
+    BOOST_REQUIRE( jsn["queues"].size() == 2 );
+    BOOST_REQUIRE( jsn["queues"][strPrefix + "/peer1"].size() == 1 );
+    BOOST_REQUIRE( jsn["queues"][strPrefix + "/peer2"].size() == 1 );
+    BOOST_REQUIRE( jsn["queues"][strPrefix + "/peer1"][0]["jsnIn"] == jsnIn );
+    BOOST_REQUIRE( jsn["queues"][strPrefix + "/peer2"][0]["jsnOut"] == jsnIn );
+}
+
+BOOST_AUTO_TEST_CASE( session_limit_and_ring_wrap ) {
+    typedef skutils::task::performance::tracker tracker_t;
+    skutils::task::performance::tracker_ptr pTracker =
+        skutils::task::performance::tracker_ptr::make();
+    pTracker->set_session_max_item_count( 10 );
+    pTracker->start();
+    for ( size_t i = 0; i < 20; ++i )
+        skutils::task::performance::action( "q", "a", nlohmann::json::object(), pTracker );
+    BOOST_REQUIRE( pTracker->compose_json()["queues"]["q"].size() == 10 );
+    BOOST_REQUIRE( pTracker->get_first_encountered_stop_reason() ==
+                   "number of requested of events saved" );
+    pTracker->cancel();
+    pTracker->set_session_max_item_count( 0 );
+    pTracker->start();
+    const size_t cntThreads = 4, cntPerThread = tracker_t::g_nRingCapacity;
+    std::vector< std::thread > vecThreads;
+    for ( size_t i = 0; i < cntThreads; ++i )
+        vecThreads.emplace_back( [&]() {
+            for ( size_t j = 0; j < cntPerThread; ++j )
+                skutils::task::performance::action( "q", "a", nlohmann::json::object(), pTracker );
+        } );
+    for ( std::thread& t : vecThreads )
+        t.join();
+    nlohmann::json jsn = pTracker->stop();
+    BOOST_REQUIRE( jsn["nextTimeFetchIndex"].get< size_t >() == cntThreads * cntPerThread );
+    BOOST_REQUIRE( jsn["queues"]["q"].size() <= tracker_t::g_nRingCapacity );
+    BOOST_REQUIRE( jsn["queues"]["q"].size() > 0 );
+    BOOST_REQUIRE( jsn["queues"]["q"][0]["it"].get< size_t >() >=
+                   cntThreads * cntPerThread - tracker_t::g_nRingCapacity );
+    BOOST_REQUIRE( !pTracker->is_running() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
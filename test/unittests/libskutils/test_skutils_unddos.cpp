@@ -1,6 +1,9 @@
 #include "test_skutils_helper.h"
 #include <boost/test/unit_test.hpp>
 #include <test/tools/libtesteth/TestHelper.h>
+#include <chrono>
+#include <iostream>
+#include <thread>
 
 BOOST_AUTO_TEST_SUITE( SkUtils )
 BOOST_AUTO_TEST_SUITE( unddos, *boost::unit_test::precondition( dev::test::option_all_tests ) )
@@ -15,6 +18,8 @@ static skutils::unddos::settings compose_test_unddos_settings() {
     oe1.max_ws_conn_ = 2;
     oe1.ban_peak_ = skutils::unddos::duration( 5 );
     oe1.ban_lengthy_ = skutils::unddos::duration( 10 );
+    oe1.max_batch_size_ = 16;
+    oe1.max_batch_parallelism_ = 3;
     settings.origins_.push_back( oe1 );
     //
     skutils::unddos::origin_entry_setting oe2;
@@ -55,6 +60,101 @@ BOOST_AUTO_TEST_CASE( ws_conn_counting ) {
     BOOST_REQUIRE( unddos.register_ws_conn_for_origin( "11.11.11.11" ) == skutils::unddos::e_high_load_detection_result_t::ehldr_no_error );
 }
 
+BOOST_AUTO_TEST_CASE( batch_workers_counting ) {
+    skutils::unddos::algorithm unddos;
+    unddos.set_settings( compose_test_unddos_settings() );
+    BOOST_REQUIRE( unddos.max_batch_size_for_origin( "11.11.11.11" ) == 16 );
+    BOOST_REQUIRE( unddos.max_batch_size_for_origin( "127.0.0.1" ) == 0 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "11.11.11.11", 2 ) == 2 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "11.11.11.11", 2 ) == 1 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "11.11.11.11", 2 ) == 0 );
+    unddos.release_batch_workers_for_origin( "11.11.11.11", 2 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "11.11.11.11", 8 ) == 2 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "127.0.0.1", 8 ) == 8 );
+    BOOST_REQUIRE( unddos.acquire_batch_workers_for_origin( "", 8 ) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( settings_reload_during_calls ) {
+    skutils::unddos::algorithm unddos;
+    skutils::unddos::settings settingsLimited = compose_test_unddos_settings();
+    skutils::unddos::settings settingsUnlim;
+    skutils::unddos::origin_entry_setting oe;
+    oe.load_unlim_for_any_origin();
+    settingsUnlim.origins_.push_back( oe );
+    unddos.set_settings( settingsUnlim );
+    std::atomic_bool isStop( false );
+    std::vector< std::thread > vecThreads;
+    for ( size_t i = 0; i < 4; ++i ) {
+        vecThreads.emplace_back( [&, i]() {
+            std::string strOrigin = i ? ( "10.0.0." + std::to_string( i ) ) : "11.11.11.11";
+            while ( !isStop )
+                unddos.register_call_from_origin( strOrigin, "eth_call" );
+        } );
+    }
+    // replaced settings are released while calls keep reading them
+    for ( size_t i = 0; i < 1000; ++i )
+        unddos.set_settings( ( i % 2 ) ? settingsUnlim : settingsLimited );
+    isStop = true;
+    for ( std::thread& t : vecThreads )
+        t.join();
+    // last published settings are in effect for origins matched under previous ones
+    unddos.set_settings( settingsLimited );
+    skutils::unddos::time_tick_mark ttmNow = skutils::unddos::now_tick_mark() + 120;
+    for ( size_t i = 0; i < 3; ++i )
+        BOOST_REQUIRE( unddos.register_call_from_origin( "11.11.11.11", ttmNow ) ==
+                       skutils::unddos::e_high_load_detection_result_t::ehldr_no_error );
+    BOOST_REQUIRE( unddos.register_call_from_origin( "11.11.11.11", ttmNow ) !=
+                   skutils::unddos::e_high_load_detection_result_t::ehldr_no_error );
+}
+
+static void bench_unddos_contention( bool isSingleOrigin ) {
+    skutils::unddos::algorithm unddos;
+    skutils::unddos::settings settings;
+    skutils::unddos::origin_entry_setting oe;
+    oe.load_unlim_for_any_origin();
+    settings.origins_.push_back( oe );
+    unddos.set_settings( settings );
+    const size_t cntThreads = std::max( size_t( 2 ), size_t( std::thread::hardware_concurrency() ) );
+    const size_t cntCallsPerThread = 200000;
+    std::vector< std::thread > vecThreads;
+    auto tpStart = std::chrono::steady_clock::now();
+    for ( size_t i = 0; i < cntThreads; ++i ) {
+        vecThreads.emplace_back( [&, i]() {
+            std::string strOrigin = isSingleOrigin ? std::string( "10.0.0.1" ) :
+                                                     ( "10.0.0." + std::to_string( i + 1 ) );
+            for ( size_t j = 0; j < cntCallsPerThread; ++j )
+                unddos.register_call_from_origin( strOrigin, "eth_call" );
+        } );
+    }
+    for ( std::thread& t : vecThreads )
+        t.join();
+    auto d = std::chrono::steady_clock::now() - tpStart;
+    double lfSeconds = std::chrono::duration_cast< std::chrono::duration< double > >( d ).count();
+    std::cout << boost::unit_test::framework::current_test_case().p_name << ": " << cntThreads
+              << " threads, " << ( double( cntThreads * cntCallsPerThread ) / lfSeconds )
+              << " calls/s\n";
+}
+
+BOOST_AUTO_TEST_CASE( bench_contention_distinct_origins,
+    *boost::unit_test::label( "bench" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !dev::test::Options::get().all ) {
+        std::cout << "Skipping test bench_contention_distinct_origins. Use --all to run it.\n";
+        return;
+    }
+    bench_unddos_contention( false );
+}
+
+BOOST_AUTO_TEST_CASE( bench_contention_single_origin,
+    *boost::unit_test::label( "bench" ) *
+        boost::unit_test::precondition( dev::test::run_not_express ) ) {
+    if ( !dev::test::Options::get().all ) {
+        std::cout << "Skipping test bench_contention_single_origin. Use --all to run it.\n";
+        return;
+    }
+    bench_unddos_contention( true );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -30,6 +30,7 @@
 #include <libethereum/ClientTest.h>
 #include <libethereum/TransactionQueue.h>
 #include <libp2p/Network.h>
+#include <libskale/httpserveroverride.h>
 #include <libweb3jsonrpc/AccountHolder.h>
 #include <libweb3jsonrpc/AdminEth.h>
 #include <libweb3jsonrpc/JsonHelper.h>
@@ -37,7 +38,8 @@
 #include <libweb3jsonrpc/Debug.h>
 #include <libweb3jsonrpc/Eth.h>
 #include <libweb3jsonrpc/ModularServer.h>
-// SKALE #include <libweb3jsonrpc/Net.h>
+#include <libweb3jsonrpc/Net.h>
+#include <libweb3jsonrpc/Skale.h>
 #include <libweb3jsonrpc/Test.h>
 #include <libweb3jsonrpc/Web3.h>
 #include <test/tools/libtesteth/TestHelper.h>
@@ -314,6 +316,57 @@ struct RestrictedAddressFixture : public JsonRpcFixture {
     boost::filesystem::path path;
 };
 
+// two HTTP servers over same jsonrpccpp handler, second one has no native RPC handlers
+struct NativeRpcFixture : public JsonRpcFixture {
+    NativeRpcFixture() {
+        chainParams = client->chainParams();
+        skaleFace = new rpc::Skale( *client );
+        SkaleServerOverride::opts_t opts;
+        opts.fn_snapshot_info_ = [this]( const nlohmann::json& joParams ) -> nlohmann::json {
+            return skaleFace->impl_skale_getSnapshotRpc( joParams );
+        };
+        SkaleServerOverride::net_bind_opts_t& bo = opts.netOpts_.bindOptsStandard_;
+        bo.nBasePortHTTP6_ = bo.nBasePortHTTPS4_ = bo.nBasePortHTTPS6_ = bo.nBasePortWS4_ =
+            bo.nBasePortWS6_ = bo.nBasePortWSS4_ = bo.nBasePortWSS6_ = -1;
+        bo.strAddrHTTP4_ = "127.0.0.1";
+
+        using SkaleServer = ModularServer< rpc::EthFace, rpc::SkaleFace, rpc::NetFace >;
+        skaleServer.reset( new SkaleServer( new rpc::Eth( *client, *accountHolder.get() ),
+            skaleFace, new rpc::Net( chainParams ) ) );
+        for ( int i = 0; i < 2; ++i ) {
+            bo.nBasePortHTTP4_ = c_basePort + i;
+            servers[i] = new SkaleServerOverride( chainParams, client.get(), opts );
+            skaleServer->addConnector( servers[i] );
+        }
+        for ( const char* strMethod :
+            {"eth_blockNumber", "eth_chainId", "eth_gasPrice", "net_version", "skale_getSnapshot"} )
+            servers[1]->setNativeRpcHandler( strMethod, nullptr );
+        for ( SkaleServerOverride* pServer : servers )
+            BOOST_REQUIRE( pServer->StartListening( e_server_mode_t::esm_standard ) );
+    }
+
+    // raw HTTP answer body of server
+    string post( size_t _server, string const& _body ) {
+        skutils::http::client cli( 4, "127.0.0.1", c_basePort + _server );
+        auto res = cli.Post( "/", _body, "application/json" );
+        BOOST_REQUIRE( res );
+        BOOST_REQUIRE_EQUAL( res->status_, 200 );
+        return res->body_;
+    }
+
+    // native answer must be byte-for-byte same as one of jsonrpccpp
+    void checkSame( string const& _body ) {
+        string strNative = post( 0, _body );
+        BOOST_CHECK_EQUAL( strNative, post( 1, _body ) );
+    }
+
+    static const int c_basePort = 7611;
+    ChainParams chainParams;
+    rpc::Skale* skaleFace;
+    SkaleServerOverride* servers[2];
+    unique_ptr< ModularServer<> > skaleServer;
+};
+
 string fromAscii( string _s ) {
     bytes b = asBytes( _s );
     return toHexPrefixed( b );
@@ -1855,4 +1908,47 @@ BOOST_AUTO_TEST_CASE( delegate_call ) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE( NativeRpcSuite, NativeRpcFixture )
+
+BOOST_AUTO_TEST_CASE( getters ) {
+    dev::eth::mineTransaction( *client, 1 );
+    for ( string strMethod : {"eth_blockNumber", "eth_chainId", "eth_gasPrice", "net_version"} )
+        for ( string strID : {"1", "0", "\"abc\"", "18446744073709551615", "-7"} ) {
+            checkSame( "{\"jsonrpc\":\"2.0\",\"method\":\"" + strMethod + "\",\"id\":" + strID +
+                       "}" );
+            checkSame( "{\"id\":" + strID + ",\"method\":\"" + strMethod +
+                       "\",\"params\":[],\"jsonrpc\":\"2.0\"}" );
+        }
+}
+
+BOOST_AUTO_TEST_CASE( unusualRequests ) {
+    // these are left to jsonrpccpp, which reports them its own way
+    checkSame( "{\"jsonrpc\":\"2.0\",\"method\":\"eth_blockNumber\",\"id\":1.5}" );
+    checkSame( "{\"jsonrpc\":\"2.0\",\"method\":\"eth_blockNumber\",\"id\":null}" );
+    checkSame( "{\"jsonrpc\":\"1.0\",\"method\":\"eth_chainId\",\"id\":1}" );
+    checkSame( "{\"method\":\"eth_chainId\",\"id\":1}" );
+    checkSame( "{\"jsonrpc\":\"2.0\",\"method\":\"net_version\",\"params\":7,\"id\":1}" );
+}
+
+BOOST_AUTO_TEST_CASE( batch ) {
+    checkSame(
+        "[{\"jsonrpc\":\"2.0\",\"method\":\"net_version\",\"id\":3},"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"eth_blockNumber\",\"id\":\"b\"},"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"eth_noSuchMethod\",\"id\":2},"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"eth_gasPrice\",\"id\":1},"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"eth_chainId\",\"id\":1.5},"
+        "{\"jsonrpc\":\"2.0\",\"method\":\"skale_getSnapshot\",\"params\":{\"blockNumber\":0},"
+        "\"id\":0}]" );
+}
+
+BOOST_AUTO_TEST_CASE( snapshotErrors ) {
+    // no snapshot is made by this chain, so only errors can be compared
+    for ( string strParams :
+        {"{\"blockNumber\":0}", "{\"blockNumber\":1000}", "{\"blockNumber\":\"latest\"}"} )
+        checkSame( "{\"jsonrpc\":\"2.0\",\"method\":\"skale_getSnapshot\",\"params\":" +
+                   strParams + ",\"id\":73}" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()